@@ -0,0 +1,15 @@
+# 三维地质场景基准测试（命令行程序），复用主程序的全部源文件
+#   qmake Scene3DBenchmark.pro && make
+#   Scene3DBenchmark --boreholes 200 --profiles 1000 --frames 300 --output result.json
+# 结果为 JSON：场景构建时间、内存占用、帧率与场景规模，详见 benchmarks/scene3dbenchmark.cpp
+
+include(ShieldVisualizationPlatform.pro)
+
+TARGET = Scene3DBenchmark
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES -= main.cpp
+SOURCES += benchmarks/scene3dbenchmark.cpp
+
+win32: LIBS += -lpsapi
@@ -1,4 +1,4 @@
-QT       += core gui widgets sql network 3dcore 3drender 3dinput 3dextras
+QT       += core gui widgets sql network concurrent 3dcore 3drender 3dinput 3dlogic 3dextras
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -16,12 +16,32 @@ SOURCES += \
     src/ui/projectmanagementwindow.cpp \
     src/ui/geological2dwidget.cpp \
     src/ui/geological3dwidget.cpp \
+    src/ui/instancedmarkermaterial.cpp \
+    src/ui/scenestatistics.cpp \
     src/ui/mapwidget.cpp \
     src/ui/positioningdialog.cpp \
+    src/ui/pagedtablemodel.cpp \
+    src/ui/excavationtablemodel.cpp \
+    src/ui/excavationtrendchart.cpp \
+    src/ui/prospectingtablemodel.cpp \
+    src/ui/warningtablemodel.cpp \
+    src/ui/actionbuttondelegate.cpp \
     src/utils/stylehelper.cpp \
     src/utils/CoordinateConverter.cpp \
     src/utils/DataImportTool.cpp \
     src/utils/GeoDataImporter.cpp \
+    src/utils/CsvImportPipeline.cpp \
+    src/utils/CsvTokenizer.cpp \
+    src/utils/ZipArchive.cpp \
+    src/utils/XlsxReader.cpp \
+    src/utils/GeologyMeshLayout.cpp \
+    src/utils/GeologyModelBuilder.cpp \
+    src/utils/GeologyChunkPlanner.cpp \
+    src/utils/ChainageAxis.cpp \
+    src/utils/TunnelAlignment.cpp \
+    src/utils/TunnelMeshBuilder.cpp \
+    src/utils/GeologySceneBuilder.cpp \
+    src/utils/PickingBvh.cpp \
     src/database/DatabaseManager.cpp \
     src/database/UserDAO.cpp \
     src/database/ProjectDAO.cpp \
@@ -33,6 +53,15 @@ SOURCES += \
     src/database/ShieldPositionDAO.cpp \
     src/database/ExcavationParameterDAO.cpp \
     src/database/ProspectingDataDAO.cpp \
+    src/database/DataSummaryDAO.cpp \
+    src/database/ExcavationRollupDAO.cpp \
+    src/database/RetentionPolicyDAO.cpp \
+    src/database/DataArchiver.cpp \
+    src/database/ExcavationColumnCache.cpp \
+    src/database/ExcavationSegmentStore.cpp \
+    src/database/AsyncDAO.cpp \
+    src/database/SqlQueryBuilder.cpp \
+    src/database/DataExporter.cpp \
     src/models/User.cpp \
     src/models/Project.cpp \
     src/models/Warning.cpp \
@@ -51,13 +80,34 @@ HEADERS += \
     src/ui/projectmanagementwindow.h \
     src/ui/geological2dwidget.h \
     src/ui/geological3dwidget.h \
+    src/ui/instancedmarkermaterial.h \
+    src/ui/scenestatistics.h \
     src/ui/mapwidget.h \
     src/ui/positioningdialog.h \
+    src/ui/pagedtablemodel.h \
+    src/ui/excavationtablemodel.h \
+    src/ui/excavationtrendchart.h \
+    src/ui/prospectingtablemodel.h \
+    src/ui/warningtablemodel.h \
+    src/ui/actionbuttondelegate.h \
     src/utils/stylehelper.h \
     src/utils/CoordinateConverter.h \
     src/utils/DataImportTool.h \
     src/utils/GeoDataImporter.h \
+    src/utils/CsvImportPipeline.h \
+    src/utils/CsvTokenizer.h \
+    src/utils/ZipArchive.h \
+    src/utils/XlsxReader.h \
+    src/utils/GeologyMeshLayout.h \
+    src/utils/GeologyModelBuilder.h \
+    src/utils/GeologyChunkPlanner.h \
+    src/utils/ChainageAxis.h \
+    src/utils/TunnelAlignment.h \
+    src/utils/TunnelMeshBuilder.h \
+    src/utils/GeologySceneBuilder.h \
+    src/utils/PickingBvh.h \
     src/database/DatabaseManager.h \
+    src/database/PageCursor.h \
     src/database/UserDAO.h \
     src/database/ProjectDAO.h \
     src/database/WarningDAO.h \
@@ -68,6 +118,16 @@ HEADERS += \
     src/database/ShieldPositionDAO.h \
     src/database/ExcavationParameterDAO.h \
     src/database/ProspectingDataDAO.h \
+    src/database/DataSummaryDAO.h \
+    src/database/ExcavationRollupDAO.h \
+    src/database/RetentionPolicyDAO.h \
+    src/database/DataArchiver.h \
+    src/database/ExcavationColumnCache.h \
+    src/database/ExcavationSegmentStore.h \
+    src/database/EpochTime.h \
+    src/database/AsyncDAO.h \
+    src/database/SqlQueryBuilder.h \
+    src/database/DataExporter.h \
     src/models/User.h \
     src/models/Project.h \
     src/models/Warning.h \
@@ -0,0 +1,14 @@
+# 工具类单元测试（QtTest 命令行程序），复用主程序的全部源文件
+#   qmake UtilsTest.pro && make && make check
+#   UtilsTest zipDynamicHuffman          // 只运行指定用例
+# 覆盖 ZIP/XLSX/CSV 解析与三维拾取 BVH，详见 tests/utilstest.cpp
+
+include(ShieldVisualizationPlatform.pro)
+
+TARGET = UtilsTest
+QT += testlib
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+SOURCES -= main.cpp
+SOURCES += tests/utilstest.cpp
@@ -0,0 +1,360 @@
+/**
+ * 三维地质场景基准测试
+ *
+ * 用合成数据（或数据库中的项目）构造 Geological3DWidget 的场景，等待分块网格全部生成后
+ * 离屏渲染指定帧数，以 JSON 输出场景构建时间、内存占用与帧率，便于比较网格生成的改动。
+ *
+ * 用法：
+ *   Scene3DBenchmark --boreholes 200 --profiles 1000 --frames 300 --output result.json
+ *   Scene3DBenchmark --project 1            // 使用本地数据库中的项目
+ *
+ * 默认使用 offscreen 平台（无显示器时由 Mesa 软件渲染），--onscreen 时在窗口中渲染。
+ * 默认清空网格缓存以测量实际生成时间，--warm-cache 时保留缓存。
+ */
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QDir>
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QDebug>
+#include <Qt3DExtras/Qt3DWindow>
+#include <Qt3DRender/QRenderCapture>
+#include <Qt3DRender/QCamera>
+#include <cmath>
+#include <functional>
+#include "../src/ui/geological3dwidget.h"
+#include "../src/utils/GeologySceneBuilder.h"
+#include "../src/database/DatabaseManager.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace {
+
+// 合成场景：钻孔间距、钻孔偏离轴线的距离、隧道埋深与断面尺寸（米）
+const double BOREHOLE_SPACING = 30.0;
+const double BOREHOLE_OFFSET = 15.0;
+const double TUNNEL_DEPTH = 20.0;
+const double TUNNEL_HALF_SIZE = 3.1;
+
+// 起点桩号 K12+000：钻孔的桩号里程与平面坐标、断面的投影里程都不相同
+const double START_CHAINAGE = 12000.0;
+
+// 合成钻孔的地层：名称与厚度范围（米），最后一层为基岩
+struct SyntheticLayer {
+    const char *code;
+    const char *rockName;
+    double minThickness;
+    double maxThickness;
+};
+
+const SyntheticLayer SYNTHETIC_LAYERS[] = {
+    { "1", "杂填土", 1.0, 3.0 },
+    { "2", "粉质黏土", 3.0, 8.0 },
+    { "3", "中砂", 2.0, 6.0 },
+    { "4", "强风化砂岩", 4.0, 10.0 },
+    { "5", "中风化砂岩", 20.0, 30.0 },
+};
+
+struct MemoryUsage {
+    qint64 currentBytes = -1;
+    qint64 peakBytes = -1;
+};
+
+MemoryUsage memoryUsage()
+{
+    MemoryUsage usage;
+#if defined(Q_OS_LINUX)
+    QFile file("/proc/self/status");
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QStringList lines = QString::fromLatin1(file.readAll()).split('\n');
+        for (const QString &line : lines) {
+            const QStringList fields = line.simplified().split(' ');
+            if (fields.size() < 2) {
+                continue;
+            }
+            if (fields[0] == "VmRSS:") {
+                usage.currentBytes = fields[1].toLongLong() * 1024;
+            } else if (fields[0] == "VmHWM:") {
+                usage.peakBytes = fields[1].toLongLong() * 1024;
+            }
+        }
+    }
+#elif defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        usage.currentBytes = static_cast<qint64>(counters.WorkingSetSize);
+        usage.peakBytes = static_cast<qint64>(counters.PeakWorkingSetSize);
+    }
+#endif
+    return usage;
+}
+
+// 轴线沿X轴、在Y方向缓慢摆动的合成隧道；钻孔交替分布在轴线两侧
+QVector3D axisPoint(double mileage)
+{
+    return QVector3D(mileage, 40.0 * std::sin(mileage / 400.0), 0.0f);
+}
+
+GeologyScene makeSyntheticScene(int boreholeCount, int profileCount, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    GeologyScene scene;
+    const double length = qMax(1, boreholeCount - 1) * BOREHOLE_SPACING;
+
+    auto surfaceAt = [](double mileage) {
+        return 50.0 + 5.0 * std::sin(mileage / 250.0);
+    };
+
+    for (int i = 0; i < boreholeCount; i++) {
+        const double mileage = i * BOREHOLE_SPACING;
+        const QVector3D axis = axisPoint(mileage);
+
+        BoreholeData borehole;
+        borehole.boreholeId = i + 1;
+        borehole.projectId = 0;
+        borehole.boreholeCode = QString("ZK%1").arg(i + 1, 4, 10, QChar('0'));
+        borehole.x = axis.x();
+        borehole.y = axis.y() + (i % 2 == 0 ? BOREHOLE_OFFSET : -BOREHOLE_OFFSET);
+        borehole.surfaceElevation = surfaceAt(mileage) + random.bounded(1.0);
+        borehole.mileage = START_CHAINAGE + mileage;
+
+        double depth = 0.0;
+        int layerNumber = 1;
+        for (const SyntheticLayer &synthetic : SYNTHETIC_LAYERS) {
+            BoreholeLayerData layer;
+            layer.layerId = 0;
+            layer.boreholeId = borehole.boreholeId;
+            layer.layerNumber = layerNumber++;
+            layer.layerCode = synthetic.code;
+            layer.rockName = synthetic.rockName;
+            layer.thickness = synthetic.minThickness
+                              + random.bounded(synthetic.maxThickness - synthetic.minThickness);
+            depth += layer.thickness;
+            layer.bottomDepth = depth;
+            layer.bottomElevation = borehole.surfaceElevation - depth;
+            borehole.layers.append(layer);
+        }
+        scene.boreholes.append(borehole);
+    }
+
+    for (int i = 0; i < profileCount; i++) {
+        const double mileage = profileCount > 1 ? length * i / (profileCount - 1) : 0.0;
+        const QVector3D center = axisPoint(mileage);
+        const QVector3D forward = (axisPoint(mileage + 1.0) - axisPoint(mileage - 1.0)).normalized();
+        const QVector3D left = QVector3D(-forward.y(), forward.x(), 0.0f) * TUNNEL_HALF_SIZE;
+        const double z = surfaceAt(mileage) - TUNNEL_DEPTH;
+
+        TunnelProfileData profile;
+        profile.profileId = i + 1;
+        profile.projectId = 0;
+        profile.topLeftX = profile.bottomLeftX = center.x() + left.x();
+        profile.topLeftY = profile.bottomLeftY = center.y() + left.y();
+        profile.topRightX = profile.bottomRightX = center.x() - left.x();
+        profile.topRightY = profile.bottomRightY = center.y() - left.y();
+        profile.topLeftZ = profile.topRightZ = z + TUNNEL_HALF_SIZE;
+        profile.bottomLeftZ = profile.bottomRightZ = z - TUNNEL_HALF_SIZE;
+        // 与 GeoDataImporter 导入的断面一致：里程为顶部中心的投影Y坐标，不是桩号里程
+        profile.mileage = (profile.topLeftY + profile.topRightY) / 2.0;
+        scene.tunnelProfiles.append(profile);
+    }
+
+    return scene;
+}
+
+// 等待信号或超时，返回是否超时
+template <typename Sender, typename Signal>
+bool waitFor(Sender *sender, Signal signal, int timeoutMs)
+{
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    QObject::connect(sender, signal, &loop, &QEventLoop::quit);
+    timeout.start(timeoutMs);
+    loop.exec();
+    return !timeout.isActive();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 平台须在创建 QApplication 之前确定
+    bool onscreen = false;
+    for (int i = 1; i < argc; i++) {
+        onscreen = onscreen || qstrcmp(argv[i], "--onscreen") == 0;
+    }
+    if (!onscreen && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    app.setApplicationName("Scene3DBenchmark");
+    app.setOrganizationName("山东科技大学");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("三维地质场景构建与渲染基准测试");
+    parser.addHelpOption();
+    QCommandLineOption boreholesOption("boreholes", "合成钻孔数", "N", "200");
+    QCommandLineOption profilesOption("profiles", "合成隧道断面数", "M", "1000");
+    QCommandLineOption framesOption("frames", "渲染帧数", "K", "300");
+    QCommandLineOption seedOption("seed", "合成数据的随机种子", "seed", "1");
+    QCommandLineOption projectOption("project", "使用本地数据库中的项目，不生成合成数据", "id");
+    QCommandLineOption outputOption("output", "结果写入文件（默认输出到标准输出）", "file");
+    QCommandLineOption timeoutOption("timeout", "每个阶段的超时（秒）", "seconds", "300");
+    QCommandLineOption warmCacheOption("warm-cache", "保留网格缓存");
+    QCommandLineOption onscreenOption("onscreen", "在窗口中渲染，不使用 offscreen 平台");
+    parser.addOptions({ boreholesOption, profilesOption, framesOption, seedOption, projectOption,
+                        outputOption, timeoutOption, warmCacheOption, onscreenOption });
+    parser.process(app);
+
+    const int frameCount = qMax(1, parser.value(framesOption).toInt());
+    const int timeoutMs = qMax(1, parser.value(timeoutOption).toInt()) * 1000;
+
+    if (!parser.isSet(warmCacheOption)) {
+        QDir(GeologySceneBuilder::cacheDirectory()).removeRecursively();
+    }
+
+    // 场景数据
+    GeologyScene scene;
+    QJsonObject sceneInfo;
+    if (parser.isSet(projectOption)) {
+        if (!DatabaseManager::instance().initDatabase()) {
+            qCritical() << "数据库初始化失败:" << DatabaseManager::instance().getLastError();
+            return 1;
+        }
+        const int projectId = parser.value(projectOption).toInt();
+        scene = GeologySceneBuilder::read(projectId);
+        if (!scene.error.isEmpty()) {
+            qCritical() << "读取项目失败:" << scene.error;
+            return 1;
+        }
+        sceneInfo["source"] = "project";
+        sceneInfo["projectId"] = projectId;
+    } else {
+        const quint32 seed = parser.value(seedOption).toUInt();
+        scene = makeSyntheticScene(qMax(0, parser.value(boreholesOption).toInt()),
+                                   qMax(0, parser.value(profilesOption).toInt()), seed);
+        sceneInfo["source"] = "synthetic";
+        sceneInfo["seed"] = static_cast<qint64>(seed);
+    }
+    sceneInfo["boreholes"] = static_cast<int>(scene.boreholes.size());
+    sceneInfo["tunnelProfiles"] = static_cast<int>(scene.tunnelProfiles.size());
+    sceneInfo["warmCache"] = parser.isSet(warmCacheOption);
+
+    // 场景构建：创建实体，并等待按焦点需要的分块网格全部生成
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+    Geological3DWidget widget(scene);
+    widget.resize(1280, 800);
+    widget.show();
+    const qint64 constructMs = buildTimer.elapsed();
+
+    bool timedOut = false;
+    if (widget.pendingChunkBuilds() > 0) {
+        timedOut = waitFor(&widget, &Geological3DWidget::chunksLoaded, timeoutMs);
+    }
+    const qint64 buildMs = buildTimer.elapsed();
+    const MemoryUsage afterBuild = memoryUsage();
+    const SceneStatistics::Snapshot snapshot = widget.sceneSnapshot();
+
+    // 渲染：每帧请求一次画面捕获，捕获完成即表示该帧已渲染；相机每帧绕视点转动一点
+    Qt3DExtras::Qt3DWindow *view = widget.window3D();
+    int renderedFrames = 0;
+    double firstFrameMs = 0.0;
+    double maxFrameMs = 0.0;
+    qint64 renderMs = 0;
+    if (view && !timedOut) {
+        Qt3DRender::QRenderCapture *capture = new Qt3DRender::QRenderCapture();
+        view->activeFrameGraph()->setParent(capture);
+        view->setActiveFrameGraph(capture);
+
+        QEventLoop loop;
+        QElapsedTimer renderTimer;
+        QElapsedTimer frameTimer;
+        std::function<void()> requestFrame = [&]() {
+            view->camera()->panAboutViewCenter(360.0f / frameCount);
+            frameTimer.start();
+            Qt3DRender::QRenderCaptureReply *reply = capture->requestCapture();
+            QObject::connect(reply, &Qt3DRender::QRenderCaptureReply::completed, &loop, [&, reply]() {
+                reply->deleteLater();
+                const double ms = frameTimer.nsecsElapsed() / 1.0e6;
+                if (renderedFrames == 0) {
+                    firstFrameMs = ms;
+                    renderTimer.start();  // 首帧包含缓冲上传与着色器编译，单独统计
+                } else {
+                    maxFrameMs = qMax(maxFrameMs, ms);
+                }
+                if (++renderedFrames < frameCount) {
+                    requestFrame();
+                } else {
+                    loop.quit();
+                }
+            });
+        };
+
+        QTimer timeout;
+        timeout.setSingleShot(true);
+        QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+        timeout.start(timeoutMs);
+        requestFrame();
+        loop.exec();
+        timedOut = !timeout.isActive();
+        renderMs = renderedFrames > 1 ? renderTimer.elapsed() : 0;
+    }
+    const MemoryUsage afterRender = memoryUsage();
+
+    QJsonObject build;
+    build["constructMs"] = constructMs;
+    build["sceneReadyMs"] = buildMs;
+
+    QJsonObject memory;
+    memory["afterBuildBytes"] = afterBuild.currentBytes;
+    memory["afterRenderBytes"] = afterRender.currentBytes;
+    memory["peakBytes"] = afterRender.peakBytes;
+
+    QJsonObject render;
+    render["frames"] = renderedFrames;
+    render["firstFrameMs"] = firstFrameMs;
+    render["steadyElapsedMs"] = renderMs;
+    render["fps"] = renderMs > 0 ? (renderedFrames - 1) * 1000.0 / renderMs : 0.0;
+    render["averageFrameMs"] = renderedFrames > 1 ? static_cast<double>(renderMs) / (renderedFrames - 1) : 0.0;
+    render["maxFrameMs"] = maxFrameMs;
+
+    QJsonObject statistics;
+    statistics["entities"] = snapshot.entityCount;
+    statistics["drawCalls"] = snapshot.drawCalls;
+    statistics["bufferBytes"] = snapshot.bufferBytes;
+
+    QJsonObject result;
+    result["scene"] = sceneInfo;
+    result["build"] = build;
+    result["memory"] = memory;
+    result["render"] = render;
+    result["statistics"] = statistics;
+    result["platform"] = QGuiApplication::platformName();
+    result["timedOut"] = timedOut;
+
+    const QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "无法写入结果文件:" << file.fileName();
+            return 1;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    return (timedOut || renderedFrames < frameCount) ? 1 : 0;
+}
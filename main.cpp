@@ -4,6 +4,7 @@
 #include <QIcon>
 #include "src/ui/loginwindow.h"
 #include "src/utils/stylehelper.h"
+#include "src/database/ExcavationSegmentStore.h"
 
 int main(int argc, char *argv[])
 {
@@ -20,6 +21,11 @@ int main(int argc, char *argv[])
     // 应用全局样式
     StyleHelper::applyGlobalStyle(&a);
     
+    // 退出前封存写入中的段文件（写入索引与文件尾，裁掉预留空间）
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, []() {
+        ExcavationSegmentStore::instance().sealAll();
+    });
+    
     // 显示登录窗口
     LoginWindow loginWindow;
     loginWindow.show();
@@ -0,0 +1,27 @@
+#version 150 core
+
+// 以相机位置为光源的简化 Phong 光照，颜色取自实例
+
+in vec3 worldPosition;
+in vec3 worldNormal;
+in vec4 color;
+
+out vec4 fragColor;
+
+uniform vec3 eyePosition;
+uniform float shininess;
+
+void main()
+{
+    vec3 n = normalize(worldNormal);
+    vec3 v = normalize(eyePosition - worldPosition);
+
+    float diffuse = max(dot(n, v), 0.0);
+    float specular = 0.0;
+    if (diffuse > 0.0) {
+        specular = pow(max(dot(reflect(-v, n), v), 0.0), shininess);
+    }
+
+    vec3 rgb = color.rgb * (0.35 + 0.65 * diffuse) + vec3(0.4 * specular);
+    fragColor = vec4(rgb, color.a);
+}
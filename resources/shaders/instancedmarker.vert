@@ -0,0 +1,30 @@
+#version 150 core
+
+// 钻孔标记实例化绘制：网格沿Y轴建模，转为Z轴向上，按实例高度拉伸并平移到实例位置
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in vec3 instancePosition;
+in float instanceHeight;
+in vec4 instanceColor;
+
+out vec3 worldPosition;
+out vec3 worldNormal;
+out vec4 color;
+
+uniform mat4 modelMatrix;
+uniform mat3 modelNormalMatrix;
+uniform mat4 viewProjectionMatrix;
+
+void main()
+{
+    vec3 local = vec3(vertexPosition.x, -vertexPosition.z, vertexPosition.y * instanceHeight);
+    vec3 normal = vec3(vertexNormal.x, -vertexNormal.z, vertexNormal.y);
+
+    vec4 world = modelMatrix * vec4(local + instancePosition, 1.0);
+    worldPosition = world.xyz;
+    worldNormal = normalize(modelNormalMatrix * normal);
+    color = instanceColor;
+
+    gl_Position = viewProjectionMatrix * world;
+}
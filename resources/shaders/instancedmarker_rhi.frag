@@ -0,0 +1,49 @@
+#version 450 core
+
+// 以相机位置为光源的简化 Phong 光照（RHI 后端）：与 instancedmarker.frag 相同
+
+layout(location = 0) in vec3 worldPosition;
+layout(location = 1) in vec3 worldNormal;
+layout(location = 2) in vec4 color;
+
+layout(location = 0) out vec4 fragColor;
+
+layout(std140, binding = 0) uniform qt3d_render_view_uniforms {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 uncorrectedProjectionMatrix;
+    mat4 clipCorrectionMatrix;
+    mat4 viewProjectionMatrix;
+    mat4 inverseViewMatrix;
+    mat4 inverseProjectionMatrix;
+    mat4 inverseViewProjectionMatrix;
+    mat4 viewportMatrix;
+    mat4 inverseViewportMatrix;
+    vec4 textureTransformMatrix;
+    vec3 eyePosition;
+    float aspectRatio;
+    float gamma;
+    float exposure;
+    float time;
+    float yUpInNDC;
+    float yUpInFBO;
+};
+
+layout(std140, binding = 2) uniform qt3d_custom_uniforms {
+    float shininess;
+};
+
+void main()
+{
+    vec3 n = normalize(worldNormal);
+    vec3 v = normalize(eyePosition - worldPosition);
+
+    float diffuse = max(dot(n, v), 0.0);
+    float specular = 0.0;
+    if (diffuse > 0.0) {
+        specular = pow(max(dot(reflect(-v, n), v), 0.0), shininess);
+    }
+
+    vec3 rgb = color.rgb * (0.35 + 0.65 * diffuse) + vec3(0.4 * specular);
+    fragColor = vec4(rgb, color.a);
+}
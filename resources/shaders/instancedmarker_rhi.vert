@@ -0,0 +1,57 @@
+#version 450 core
+
+// 钻孔标记实例化绘制（RHI 后端）：与 instancedmarker.vert 相同
+
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec3 vertexNormal;
+layout(location = 2) in vec3 instancePosition;
+layout(location = 3) in float instanceHeight;
+layout(location = 4) in vec4 instanceColor;
+
+layout(location = 0) out vec3 worldPosition;
+layout(location = 1) out vec3 worldNormal;
+layout(location = 2) out vec4 color;
+
+layout(std140, binding = 0) uniform qt3d_render_view_uniforms {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 uncorrectedProjectionMatrix;
+    mat4 clipCorrectionMatrix;
+    mat4 viewProjectionMatrix;
+    mat4 inverseViewMatrix;
+    mat4 inverseProjectionMatrix;
+    mat4 inverseViewProjectionMatrix;
+    mat4 viewportMatrix;
+    mat4 inverseViewportMatrix;
+    vec4 textureTransformMatrix;
+    vec3 eyePosition;
+    float aspectRatio;
+    float gamma;
+    float exposure;
+    float time;
+    float yUpInNDC;
+    float yUpInFBO;
+};
+
+layout(std140, binding = 1) uniform qt3d_command_uniforms {
+    mat4 modelMatrix;
+    mat4 inverseModelMatrix;
+    mat4 modelViewMatrix;
+    mat3 modelNormalMatrix;
+    mat4 inverseModelViewMatrix;
+    mat4 modelViewProjection;
+    mat4 inverseModelViewProjectionMatrix;
+};
+
+void main()
+{
+    vec3 local = vec3(vertexPosition.x, -vertexPosition.z, vertexPosition.y * instanceHeight);
+    vec3 normal = vec3(vertexNormal.x, -vertexNormal.z, vertexNormal.y);
+
+    vec4 world = modelMatrix * vec4(local + instancePosition, 1.0);
+    worldPosition = world.xyz;
+    worldNormal = normalize(modelNormalMatrix * normal);
+    color = instanceColor;
+
+    gl_Position = viewProjectionMatrix * world;
+}
@@ -2,6 +2,7 @@
 #include "ApiServer.h"
 #include "DataSimulator.h"
 #include "../database/DatabaseManager.h"
+#include "../database/ExcavationColumnCache.h"
 
 #include <QDebug>
 
@@ -50,12 +51,20 @@ void ApiManager::initialize(DatabaseManager* dbManager)
         m_apiServer = new ApiServer(dbManager, this);
         connect(m_apiServer, &ApiServer::statusChanged,
                 this, &ApiManager::apiServerStatusChanged);
+        connect(m_apiServer, &ApiServer::excavationDataReceived,
+                this, [](int projectId, const QJsonObject& data) {
+            ExcavationColumnCache::instance().appendFromJson(projectId, data);
+        });
     }
     
     if (!m_dataSimulator) {
         m_dataSimulator = new DataSimulator(dbManager, this);
         connect(m_dataSimulator, &DataSimulator::statusChanged,
                 this, &ApiManager::simulatorStatusChanged);
+        connect(m_dataSimulator, &DataSimulator::excavationDataGenerated,
+                this, [](int projectId, const QJsonObject& data) {
+            ExcavationColumnCache::instance().appendFromJson(projectId, data);
+        });
     }
     
     m_initialized = true;
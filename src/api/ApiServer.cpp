@@ -13,6 +13,35 @@
 #include <QSqlQuery>
 #include <QSqlError>
 
+namespace {
+
+// 从JSON读取一条掘进参数
+ExcavationParameter parseExcavationParameter(int projectId, const QJsonObject& data)
+{
+    ExcavationParameter param;
+    param.setProjectId(projectId);
+    param.setExcavationTime(QDateTime::fromString(
+        data["excavation_time"].toString(), Qt::ISODate));
+    param.setStakeMark(data["stake_mark"].toString());
+    param.setMileage(data["mileage"].toDouble());
+    param.setExcavationMode(data["excavation_mode"].toString());
+    param.setChamberPressure(data["chamber_pressure"].toDouble());
+    param.setThrustForce(data["thrust_force"].toDouble());
+    param.setCutterSpeed(data["cutter_speed"].toDouble());
+    param.setCutterTorque(data["cutter_torque"].toDouble());
+    param.setExcavationSpeed(data["excavation_speed"].toDouble());
+    param.setGroutingPressure(data["grouting_pressure"].toDouble());
+    param.setGroutingVolume(data["grouting_volume"].toDouble());
+    param.setSegmentNumber(data["segment_number"].toString());
+    param.setExcavationDuration(data["excavation_duration"].toInt());
+    param.setIdleDuration(data["idle_duration"].toInt());
+    param.setFaultDuration(data["fault_duration"].toInt());
+    param.setExcavationDistance(data["excavation_distance"].toDouble());
+    return param;
+}
+
+}
+
 ApiServer::ApiServer(DatabaseManager* dbManager, QObject* parent)
     : QObject(parent)
     , m_tcpServer(new QTcpServer(this))
@@ -148,6 +177,25 @@ void ApiServer::processRequest(QTcpSocket* socket, const QString& request)
             sendErrorResponse(socket, 400, "无效的JSON格式");
         }
     }
+    else if (httpReq.method == "POST" && httpReq.path == "/api/excavation/samples") {
+        QJsonDocument doc = QJsonDocument::fromJson(httpReq.body);
+        if (doc.isObject()) {
+            int accepted = handlePostExcavationSamples(doc.object());
+            QJsonObject response;
+            response["success"] = accepted >= 0;
+            response["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+            if (accepted >= 0) {
+                response["accepted"] = accepted;
+                response["message"] = "高频采样已写入";
+                sendResponse(socket, 200, "OK", response);
+            } else {
+                response["error"] = "写入高频采样失败";
+                sendResponse(socket, 500, "Internal Server Error", response);
+            }
+        } else {
+            sendErrorResponse(socket, 400, "无效的JSON格式");
+        }
+    }
     else if (httpReq.method == "POST" && httpReq.path == "/api/prospecting") {
         QJsonDocument doc = QJsonDocument::fromJson(httpReq.body);
         if (doc.isObject()) {
@@ -259,25 +307,7 @@ bool ApiServer::handlePostExcavationData(const QJsonObject& json)
     QJsonObject data = json["data"].toObject();
     
     // 创建ExcavationParameter对象
-    ExcavationParameter param;
-    param.setProjectId(projectId);
-    param.setExcavationTime(QDateTime::fromString(
-        data["excavation_time"].toString(), Qt::ISODate));
-    param.setStakeMark(data["stake_mark"].toString());
-    param.setMileage(data["mileage"].toDouble());
-    param.setExcavationMode(data["excavation_mode"].toString());
-    param.setChamberPressure(data["chamber_pressure"].toDouble());
-    param.setThrustForce(data["thrust_force"].toDouble());
-    param.setCutterSpeed(data["cutter_speed"].toDouble());
-    param.setCutterTorque(data["cutter_torque"].toDouble());
-    param.setExcavationSpeed(data["excavation_speed"].toDouble());
-    param.setGroutingPressure(data["grouting_pressure"].toDouble());
-    param.setGroutingVolume(data["grouting_volume"].toDouble());
-    param.setSegmentNumber(data["segment_number"].toString());
-    param.setExcavationDuration(data["excavation_duration"].toInt());
-    param.setIdleDuration(data["idle_duration"].toInt());
-    param.setFaultDuration(data["fault_duration"].toInt());
-    param.setExcavationDistance(data["excavation_distance"].toDouble());
+    ExcavationParameter param = parseExcavationParameter(projectId, data);
 
     // 保存到数据库
     ExcavationParameterDAO dao;
@@ -291,6 +321,35 @@ bool ApiServer::handlePostExcavationData(const QJsonObject& json)
     }
 }
 
+int ApiServer::handlePostExcavationSamples(const QJsonObject& json)
+{
+    if (!json.contains("project_id") || !json["samples"].isArray()) {
+        qWarning() << "高频采样数据缺少必要字段";
+        return -1;
+    }
+
+    int projectId = json["project_id"].toInt();
+    const QJsonArray samples = json["samples"].toArray();
+
+    // 高频采样只写入段文件存储，不进入 excavation_parameters 表；
+    // 段文件存储只能在主线程访问，服务器本身运行在主线程
+    ExcavationParameterDAO dao;
+    int accepted = 0;
+    for (const QJsonValue &sample : samples) {
+        ExcavationParameter param = parseExcavationParameter(projectId, sample.toObject());
+        if (!param.getExcavationTime().isValid()) {
+            continue;
+        }
+        if (!dao.appendHighFrequencySample(param)) {
+            qWarning() << "写入高频采样失败:" << dao.getLastError();
+            return accepted > 0 ? accepted : -1;
+        }
+        ++accepted;
+    }
+
+    return accepted;
+}
+
 bool ApiServer::handlePostProspectingData(const QJsonObject& json)
 {
     if (!json.contains("project_id") || !json.contains("data")) {
@@ -74,6 +74,7 @@ private:
     // API端点处理
     bool handlePostExcavationData(const QJsonObject& json);
     bool handlePostProspectingData(const QJsonObject& json);
+    int handlePostExcavationSamples(const QJsonObject& json);
     bool handleGetStatus(QTcpSocket* socket);
     bool handleGetProjects(QTcpSocket* socket);
 
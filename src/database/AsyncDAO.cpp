@@ -0,0 +1,22 @@
+#include "AsyncDAO.h"
+#include <QCoreApplication>
+
+QThreadPool* AsyncDAO::threadPool()
+{
+    // 以应用对象为父对象，退出时等待进行中的查询结束，
+    // 线程结束时其专用数据库连接随之关闭
+    static QThreadPool *pool = [] {
+        QThreadPool *p = new QThreadPool(QCoreApplication::instance());
+        p->setObjectName("DatabaseThreadPool");
+        p->setMaxThreadCount(MAX_THREADS);
+        return p;
+    }();
+    return pool;
+}
+
+void AsyncDAO::cancelOnDestroy(QObject *context, QFuture<void> future)
+{
+    QObject::connect(context, &QObject::destroyed, [future]() mutable {
+        future.cancel();
+    });
+}
@@ -0,0 +1,68 @@
+#ifndef ASYNCDAO_H
+#define ASYNCDAO_H
+
+#include <QObject>
+#include <QFuture>
+#include <QPromise>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief DAO 异步调用门面
+ *
+ * 把 DAO 调用放到专用的数据库线程池中执行，返回 QFuture，界面线程不再等待查询。
+ * 每个工作线程通过 DatabaseManager::getDatabase() 使用自己的连接。
+ *
+ * 用法：
+ *   AsyncDAO::run(this, [] { return ProjectDAO().getAllProjects(); })
+ *       .then(this, [this](const QList<Project> &projects) { ... });
+ *
+ * 传入的 context 被销毁时 QFuture 被取消：尚未开始的查询不再执行，
+ * 以 context 为上下文的续延也不会再被调用。
+ *
+ * 函数体内只应创建局部 DAO 对象并调用其查询方法；ExcavationColumnCache、
+ * ExcavationSegmentStore 等内存结构只能在主线程访问，写操作仍在主线程进行。
+ * 例外是导入、归档等批量写入：须分批提交短事务（见 DataExporter::importExcavation()、DataArchiver），
+ * 使主线程的写入在 busy_timeout 内取得写锁，内存结构的失效通知排队回主线程。
+ */
+class AsyncDAO
+{
+public:
+    // 数据库线程池
+    static QThreadPool* threadPool();
+
+    template <typename Function>
+    static QFuture<std::invoke_result_t<std::decay_t<Function>>> run(QObject *context, Function &&function)
+    {
+        using Result = std::invoke_result_t<std::decay_t<Function>>;
+
+        QFuture<Result> future = QtConcurrent::run(threadPool(),
+            [function = std::forward<Function>(function)](QPromise<Result> &promise) mutable {
+                // 排队期间已取消（如窗口已关闭）时不再访问数据库
+                if (promise.isCanceled()) {
+                    return;
+                }
+                if constexpr (std::is_void_v<Result>) {
+                    function();
+                } else {
+                    promise.addResult(function());
+                }
+            });
+
+        if (context) {
+            cancelOnDestroy(context, QFuture<void>(future));
+        }
+        return future;
+    }
+
+private:
+    // context 销毁时取消 future
+    static void cancelOnDestroy(QObject *context, QFuture<void> future);
+
+    // 同时执行的查询数，SQLite 写入串行，读取过多并发收益有限
+    static const int MAX_THREADS = 2;
+};
+
+#endif // ASYNCDAO_H
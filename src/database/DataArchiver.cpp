@@ -0,0 +1,467 @@
+#include "DataArchiver.h"
+#include "DatabaseManager.h"
+#include "DataSummaryDAO.h"
+#include "EpochTime.h"
+#include "ExcavationColumnCache.h"
+#include "ExcavationRollupDAO.h"
+#include "RetentionPolicyDAO.h"
+#include "AsyncDAO.h"
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QSqlError>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+namespace {
+
+// 每个归档数据块的起始标记 "SVAR"
+const quint32 ARCHIVE_CHUNK_MAGIC = 0x53564152;
+
+}
+
+DataArchiver* DataArchiver::s_instance = nullptr;
+
+DataArchiver::DataArchiver(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_sweepRows(0)
+    , m_batchIntervalMs(1000)
+    , m_batchSize(200)
+    , m_isRunning(false)
+    , m_batchRunning(false)
+    , m_sweepSerial(0)
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &DataArchiver::processBatch);
+}
+
+DataArchiver* DataArchiver::instance()
+{
+    if (!s_instance) {
+        s_instance = new DataArchiver();
+    }
+    return s_instance;
+}
+
+const QList<DataArchiver::ArchiveTarget> &DataArchiver::targets()
+{
+    static const QList<ArchiveTarget> list = {
+        {DataSummaryDAO::TYPE_EXCAVATION, "excavation_parameters", "id", true},
+        {DataSummaryDAO::TYPE_PROSPECTING, "prospecting_data", "prospecting_id", false}
+    };
+    return list;
+}
+
+void DataArchiver::start(int batchIntervalMs, int batchSize)
+{
+    if (m_isRunning) {
+        qWarning() << "数据归档任务已在运行";
+        return;
+    }
+
+    m_batchIntervalMs = batchIntervalMs;
+    m_batchSize = batchSize;
+    m_isRunning = true;
+    m_workItems.clear();
+    m_sweepRows = 0;
+    ++m_sweepSerial;
+
+    scheduleNext(m_batchIntervalMs);
+    qInfo() << "数据归档任务已启动，批次间隔:" << m_batchIntervalMs << "ms 每批:" << m_batchSize << "行";
+}
+
+void DataArchiver::stop()
+{
+    if (!m_isRunning) {
+        return;
+    }
+
+    m_timer->stop();
+    m_workItems.clear();
+    m_isRunning = false;
+    ++m_sweepSerial;
+    qInfo() << "数据归档任务已停止";
+}
+
+bool DataArchiver::isRunning() const
+{
+    return m_isRunning;
+}
+
+void DataArchiver::runNow()
+{
+    if (!m_isRunning) {
+        return;
+    }
+
+    m_workItems.clear();
+    m_sweepRows = 0;
+    ++m_sweepSerial;
+    scheduleNext(0);
+}
+
+void DataArchiver::scheduleNext(int intervalMs)
+{
+    m_timer->start(intervalMs);
+}
+
+QString DataArchiver::archiveDirectory()
+{
+    return QCoreApplication::applicationDirPath() + "/data/archive";
+}
+
+QString DataArchiver::archiveFilePath(int projectId, const QString &dataType)
+{
+    return QString("%1/%2_project_%3.sva").arg(archiveDirectory(), dataType).arg(projectId);
+}
+
+QList<DataArchiver::WorkItem> DataArchiver::buildWorkItems()
+{
+    QList<WorkItem> items;
+    RetentionPolicyDAO policyDao;
+    QDateTime now = QDateTime::currentDateTime();
+
+    for (const RetentionPolicyDAO::RetentionPolicy &policy : policyDao.getAllPolicies()) {
+        for (int i = 0; i < targets().size(); ++i) {
+            WorkItem item;
+            item.projectId = policy.projectId;
+            item.targetIndex = i;
+            item.cutoff = now.addDays(-policy.retentionDays);
+            items.append(item);
+        }
+    }
+    return items;
+}
+
+void DataArchiver::processBatch()
+{
+    // 上一批仍在数据库线程中执行时由其完成后重新调度
+    if (!m_isRunning || m_batchRunning) {
+        return;
+    }
+
+    m_batchRunning = true;
+    const int serial = m_sweepSerial;
+
+    if (m_workItems.isEmpty()) {
+        AsyncDAO::run(this, [] { return buildWorkItems(); })
+            .then(this, [this, serial](const QList<WorkItem> &items) {
+                m_batchRunning = false;
+                if (!m_isRunning) {
+                    return;
+                }
+                // 执行期间 runNow() 重置了本轮扫描，立即重新生成
+                if (serial != m_sweepSerial) {
+                    scheduleNext(0);
+                    return;
+                }
+                m_workItems = items;
+                scheduleNext(m_workItems.isEmpty() ? SWEEP_INTERVAL_MS : 0);
+            });
+        return;
+    }
+
+    const WorkItem item = m_workItems.first();
+    const int batchSize = m_batchSize;
+    AsyncDAO::run(this, [item, batchSize] { return archiveBatch(item, batchSize); })
+        .then(this, [this, serial, item](const BatchResult &result) {
+            m_batchRunning = false;
+            finishBatch(serial, item, result);
+        });
+}
+
+void DataArchiver::finishBatch(int serial, const WorkItem &item, const BatchResult &result)
+{
+    const QString dataType = targets().at(item.targetIndex).dataType;
+
+    // 已提交的删除无论本轮是否被重置都要使列缓存失效；列缓存只能在主线程访问
+    if (result.rowCount > 0 && dataType == DataSummaryDAO::TYPE_EXCAVATION) {
+        ExcavationColumnCache::instance().invalidate(item.projectId);
+    }
+
+    if (!m_isRunning) {
+        return;
+    }
+
+    // 执行期间 runNow() 重置了本轮扫描，结果不再计入
+    if (serial != m_sweepSerial) {
+        scheduleNext(0);
+        return;
+    }
+
+    if (result.rowCount < 0) {
+        // 出错的项本轮跳过，下一轮扫描重试
+        lastError = result.error;
+        emit errorOccurred(lastError);
+        m_workItems.removeFirst();
+    } else {
+        if (result.rowCount > 0) {
+            m_sweepRows += result.rowCount;
+            emit batchArchived(item.projectId, dataType, result.rowCount);
+        }
+        // 不足一批说明该项已无过期记录
+        if (result.rowCount < m_batchSize) {
+            m_workItems.removeFirst();
+        }
+    }
+
+    if (m_workItems.isEmpty()) {
+        if (m_sweepRows > 0) {
+            qInfo() << "数据归档扫描完成，本轮归档" << m_sweepRows << "行";
+        }
+        emit sweepFinished(m_sweepRows);
+        m_sweepRows = 0;
+        scheduleNext(SWEEP_INTERVAL_MS);
+    } else {
+        scheduleNext(m_batchIntervalMs);
+    }
+}
+
+DataArchiver::BatchResult DataArchiver::archiveBatch(const WorkItem &item, int batchSize)
+{
+    BatchResult result;
+    const ArchiveTarget &target = targets().at(item.targetIndex);
+    const bool isExcavation = (target.dataType == DataSummaryDAO::TYPE_EXCAVATION);
+
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    QSqlQuery query(db);
+
+    // 按时间从旧到新取一批过期记录（走 project_id + excavation_time 复合索引）
+    query.prepare(QString("SELECT * FROM %1 WHERE project_id = :projectId AND excavation_time < :cutoff "
+                          "ORDER BY excavation_time, %2 LIMIT :limit").arg(target.table, target.idColumn));
+    query.bindValue(":projectId", item.projectId);
+    if (target.epochTime) {
+        query.bindValue(":cutoff", EpochTime::toMs(item.cutoff));
+    } else {
+        query.bindValue(":cutoff", item.cutoff);
+    }
+    query.bindValue(":limit", batchSize);
+
+    if (!query.exec()) {
+        result.error = "查询过期记录失败: " + query.lastError().text();
+        qWarning() << result.error;
+        result.rowCount = -1;
+        return result;
+    }
+
+    QJsonArray rows;
+    QStringList ids;
+    QString archivedUntil;
+    qint64 excavationMinutes = 0;
+    qint64 idleMinutes = 0;
+    qint64 faultMinutes = 0;
+    double distance = 0.0;
+
+    while (query.next()) {
+        QSqlRecord record = query.record();
+        QJsonObject row;
+        for (int i = 0; i < record.count(); ++i) {
+            row.insert(record.fieldName(i), record.isNull(i) ? QJsonValue(QJsonValue::Null)
+                                                            : QJsonValue::fromVariant(record.value(i)));
+        }
+        rows.append(row);
+
+        ids << QString::number(record.value(target.idColumn).toInt());
+        archivedUntil = EpochTime::toDateTime(record.value("excavation_time")).toString(Qt::ISODateWithMs);
+
+        if (isExcavation) {
+            excavationMinutes += record.value("excavation_duration").toLongLong();
+            idleMinutes += record.value("idle_duration").toLongLong();
+            faultMinutes += record.value("fault_duration").toLongLong();
+            distance += record.value("excavation_distance").toDouble();
+        }
+    }
+    query.finish();
+
+    if (rows.isEmpty()) {
+        return result;
+    }
+
+    // 先写归档文件再删除明细；若删除失败，下一批会重复归档这些行，还原时按主键去重
+    QString filePath = archiveFilePath(item.projectId, target.dataType);
+    if (!appendChunk(filePath, rows, result.error)) {
+        result.rowCount = -1;
+        return result;
+    }
+
+    if (!db.transaction()) {
+        result.error = "开始事务失败: " + db.lastError().text();
+        qWarning() << result.error;
+        result.rowCount = -1;
+        return result;
+    }
+
+    QSqlQuery write(db);
+
+    // 归档删除不改变聚合：标记行使聚合删除触发器跳过本项目，删除后在同一事务中清除
+    bool holdOk = true;
+    if (isExcavation) {
+        write.prepare(ExcavationRollupDAO::holdStatement());
+        write.addBindValue(item.projectId);
+        holdOk = write.exec();
+    }
+
+    if (!holdOk || !write.exec(QString("DELETE FROM %1 WHERE %2 IN (%3)")
+                                   .arg(target.table, target.idColumn, ids.join(",")))) {
+        result.error = "删除已归档记录失败: " + write.lastError().text();
+        qWarning() << result.error;
+        db.rollback();
+        result.rowCount = -1;
+        return result;
+    }
+
+    if (isExcavation) {
+        write.prepare(ExcavationRollupDAO::releaseStatement());
+        write.addBindValue(item.projectId);
+        if (!write.exec()) {
+            result.error = "清除聚合删除标记失败: " + write.lastError().text();
+            qWarning() << result.error;
+            db.rollback();
+            result.rowCount = -1;
+            return result;
+        }
+    }
+
+    // 删除触发器会扣减累计统计，归档不应改变项目累计值，这里补回
+    if (isExcavation) {
+        write.prepare("UPDATE excavation_statistics SET "
+                      "record_count = record_count + :count, "
+                      "total_excavation_minutes = total_excavation_minutes + :excavationMinutes, "
+                      "total_idle_minutes = total_idle_minutes + :idleMinutes, "
+                      "total_fault_minutes = total_fault_minutes + :faultMinutes, "
+                      "total_distance = total_distance + :distance "
+                      "WHERE project_id = :projectId");
+        write.bindValue(":count", rows.size());
+        write.bindValue(":excavationMinutes", excavationMinutes);
+        write.bindValue(":idleMinutes", idleMinutes);
+        write.bindValue(":faultMinutes", faultMinutes);
+        write.bindValue(":distance", distance);
+        write.bindValue(":projectId", item.projectId);
+
+        if (!write.exec()) {
+            result.error = "更新掘进累计统计失败: " + write.lastError().text();
+            qWarning() << result.error;
+            db.rollback();
+            result.rowCount = -1;
+            return result;
+        }
+    }
+
+    write.prepare("INSERT OR IGNORE INTO data_archive_state (project_id, data_type) "
+                  "VALUES (:projectId, :dataType)");
+    write.bindValue(":projectId", item.projectId);
+    write.bindValue(":dataType", target.dataType);
+    bool stateOk = write.exec();
+
+    if (stateOk) {
+        write.prepare("UPDATE data_archive_state SET "
+                      "archive_file = :archiveFile, "
+                      "archived_rows = archived_rows + :count, "
+                      "archived_excavation_minutes = archived_excavation_minutes + :excavationMinutes, "
+                      "archived_idle_minutes = archived_idle_minutes + :idleMinutes, "
+                      "archived_fault_minutes = archived_fault_minutes + :faultMinutes, "
+                      "archived_distance = archived_distance + :distance, "
+                      "archived_until = :archivedUntil, "
+                      "last_archived_at = CURRENT_TIMESTAMP "
+                      "WHERE project_id = :projectId AND data_type = :dataType");
+        write.bindValue(":archiveFile", filePath);
+        write.bindValue(":count", rows.size());
+        write.bindValue(":excavationMinutes", excavationMinutes);
+        write.bindValue(":idleMinutes", idleMinutes);
+        write.bindValue(":faultMinutes", faultMinutes);
+        write.bindValue(":distance", distance);
+        write.bindValue(":archivedUntil", archivedUntil);
+        write.bindValue(":projectId", item.projectId);
+        write.bindValue(":dataType", target.dataType);
+        stateOk = write.exec();
+    }
+
+    if (!stateOk) {
+        result.error = "更新归档状态失败: " + write.lastError().text();
+        qWarning() << result.error;
+        db.rollback();
+        result.rowCount = -1;
+        return result;
+    }
+
+    if (!db.commit()) {
+        result.error = "提交事务失败: " + db.lastError().text();
+        qWarning() << result.error;
+        db.rollback();
+        result.rowCount = -1;
+        return result;
+    }
+
+    result.rowCount = rows.size();
+    return result;
+}
+
+bool DataArchiver::appendChunk(const QString &filePath, const QJsonArray &rows, QString &error)
+{
+    if (!QDir().mkpath(archiveDirectory())) {
+        error = "创建归档目录失败: " + archiveDirectory();
+        qWarning() << error;
+        return false;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        error = "打开归档文件失败: " + file.errorString();
+        qWarning() << error;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << ARCHIVE_CHUNK_MAGIC << qCompress(QJsonDocument(rows).toJson(QJsonDocument::Compact));
+
+    if (out.status() != QDataStream::Ok || !file.flush()) {
+        error = "写入归档文件失败: " + file.errorString();
+        qWarning() << error;
+        return false;
+    }
+
+    return true;
+}
+
+bool DataArchiver::readArchive(const QString &filePath, QJsonArray &rows, QString *errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = "打开归档文件失败: " + file.errorString();
+        }
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    while (!in.atEnd()) {
+        quint32 magic = 0;
+        QByteArray chunk;
+        in >> magic >> chunk;
+
+        if (in.status() != QDataStream::Ok || magic != ARCHIVE_CHUNK_MAGIC) {
+            qWarning() << "归档文件末尾数据块不完整，已忽略:" << filePath;
+            break;
+        }
+
+        QJsonDocument doc = QJsonDocument::fromJson(qUncompress(chunk));
+        if (!doc.isArray()) {
+            qWarning() << "归档数据块无法解析，已忽略:" << filePath;
+            break;
+        }
+
+        for (const QJsonValue &row : doc.array()) {
+            rows.append(row);
+        }
+    }
+
+    return true;
+}
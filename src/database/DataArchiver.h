@@ -0,0 +1,127 @@
+#ifndef DATAARCHIVER_H
+#define DATAARCHIVER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QList>
+
+/**
+ * @brief 明细数据归档任务
+ *
+ * 按 data_retention_policies 中各项目的保留天数，把过期的掘进参数与补勘数据
+ * 转存到只追加的压缩归档文件（data/archive 目录），再从数据库中删除。
+ * 删除时写入聚合删除标记（见 ExcavationRollupDAO::holdStatement()），多分辨率聚合不随归档变化；
+ * 掘进累计统计在同一事务中补回已归档部分。
+ *
+ * 任务由主线程的定时器调度，每次只处理一小批记录；读取、压缩写文件与删除明细都在
+ * 数据库线程池（AsyncDAO）中执行，只有列缓存失效回到主线程。读取与写文件在事务外完成，
+ * 删除明细的写事务只涉及一批主键，避免长时间占用数据库写锁。
+ *
+ * 归档文件由若干数据块组成，每块为 [魔数][qCompress 压缩的 JSON 行数组]，可用 readArchive() 读回。
+ */
+class DataArchiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DataArchiver* instance();
+
+    // 启动归档任务：batchIntervalMs 为批次间隔，batchSize 为每批行数
+    void start(int batchIntervalMs = 1000, int batchSize = 200);
+
+    // 停止归档任务（当前批次已提交的数据不受影响）
+    void stop();
+
+    // 获取运行状态
+    bool isRunning() const;
+
+    // 立即开始新一轮扫描（不等待扫描间隔）
+    void runNow();
+
+    // 归档目录与文件路径
+    static QString archiveDirectory();
+    static QString archiveFilePath(int projectId, const QString &dataType);
+
+    /**
+     * @brief 读取归档文件中的所有行
+     * 文件末尾不完整的数据块（写入中断）会被忽略
+     */
+    static bool readArchive(const QString &filePath, QJsonArray &rows, QString *errorMessage = nullptr);
+
+    // 获取最后的错误信息
+    QString getLastError() const { return lastError; }
+
+signals:
+    // 一批记录归档完成
+    void batchArchived(int projectId, const QString &dataType, int rowCount);
+
+    // 一轮扫描完成
+    void sweepFinished(qint64 archivedRows);
+
+    // 归档出错
+    void errorOccurred(const QString &message);
+
+private slots:
+    void processBatch();
+
+private:
+    explicit DataArchiver(QObject *parent = nullptr);
+    Q_DISABLE_COPY(DataArchiver)
+
+    // 可归档的明细表
+    struct ArchiveTarget {
+        QString dataType;
+        QString table;
+        QString idColumn;
+        bool epochTime;     // excavation_time 是否为毫秒时间戳
+    };
+
+    // 一轮扫描中待处理的 项目×数据类型
+    struct WorkItem {
+        int projectId = 0;
+        int targetIndex = 0;
+        QDateTime cutoff;       // 早于该时间的记录过期
+    };
+
+    // 一批的归档结果
+    struct BatchResult {
+        int rowCount = 0;       // 归档行数，出错为-1
+        QString error;
+    };
+
+    static const QList<ArchiveTarget> &targets();
+
+    // 按保留策略生成本轮待处理项（在数据库线程中调用）
+    static QList<WorkItem> buildWorkItems();
+
+    // 归档一批记录（在数据库线程中调用）
+    static BatchResult archiveBatch(const WorkItem &item, int batchSize);
+
+    // 回到主线程处理一批的结果并调度下一批
+    void finishBatch(int serial, const WorkItem &item, const BatchResult &result);
+
+    // 追加一个数据块到归档文件
+    static bool appendChunk(const QString &filePath, const QJsonArray &rows, QString &error);
+
+    void scheduleNext(int intervalMs);
+
+private:
+    static DataArchiver* s_instance;
+
+    // 一轮扫描结束后到下一轮的间隔
+    static const int SWEEP_INTERVAL_MS = 60 * 60 * 1000;
+
+    QTimer* m_timer;
+    QList<WorkItem> m_workItems;
+    qint64 m_sweepRows;
+    int m_batchIntervalMs;
+    int m_batchSize;
+    bool m_isRunning;
+    bool m_batchRunning;    // 一批正在数据库线程中执行
+    int m_sweepSerial;      // runNow()/stop() 后丢弃执行中批次对本轮的影响
+    QString lastError;
+};
+
+#endif // DATAARCHIVER_H
@@ -0,0 +1,794 @@
+#include "DataExporter.h"
+#include "AsyncDAO.h"
+#include "EpochTime.h"
+#include "DatabaseManager.h"
+#include "ExcavationColumnCache.h"
+#include "ProjectDAO.h"
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QBuffer>
+#include <QDataStream>
+#include <QTextStream>
+#include <QStringConverter>
+#include <QLocale>
+#include <QHash>
+#include <QSet>
+#include <QDebug>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// 列式文件魔数与版本
+const quint32 COLUMNAR_MAGIC = 0x53564331;     // "SVC1"
+const quint16 COLUMNAR_VERSION = 1;
+
+// 导入时每个事务写入的行数；每行触发汇总、统计与聚合触发器，事务持有写锁的时间须远小于 busy_timeout
+const int IMPORT_BATCH_SIZE = 500;
+
+void prepareStream(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+/**
+ * @brief 导出文件写入器
+ * 按批接收行数据，finish() 成功后目标文件才被替换
+ */
+class ExportWriter
+{
+public:
+    virtual ~ExportWriter() = default;
+
+    virtual bool begin(const QList<DataExporter::Column> &columns, const QStringList &titles, QString &error) = 0;
+    virtual void writeRow(const QVector<QVariant> &values) = 0;
+    virtual bool endBatch(QString &error) = 0;
+    virtual bool finish(QString &error) = 0;
+    virtual void cancel() = 0;
+};
+
+class CsvWriter : public ExportWriter
+{
+public:
+    explicit CsvWriter(const QString &filePath) : file(filePath) {}
+
+    bool begin(const QList<DataExporter::Column> &columns, const QStringList &titles, QString &error) override
+    {
+        // 以二进制方式写入，行尾固定为 RFC 4180 的 CRLF，字段内的换行原样保留
+        if (!file.open(QIODevice::WriteOnly)) {
+            error = "无法创建文件: " + file.errorString();
+            return false;
+        }
+        types.clear();
+        for (const auto &column : columns) {
+            types << column.type;
+        }
+        out.setDevice(&file);
+        out.setEncoding(QStringConverter::Utf8);
+        out.setGenerateByteOrderMark(true);
+
+        QStringList header;
+        for (const QString &title : titles) {
+            header << quoted(title);
+        }
+        out << header.join(',') << "\r\n";
+        return true;
+    }
+
+    void writeRow(const QVector<QVariant> &values) override
+    {
+        for (int i = 0; i < values.size(); ++i) {
+            if (i > 0) {
+                out << ',';
+            }
+            out << format(types[i], values[i]);
+        }
+        out << "\r\n";
+    }
+
+    bool endBatch(QString &error) override
+    {
+        out.flush();
+        if (out.status() != QTextStream::Ok || file.error() != QFileDevice::NoError) {
+            error = "写入文件失败: " + file.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    bool finish(QString &error) override
+    {
+        if (!endBatch(error)) {
+            return false;
+        }
+        if (!file.commit()) {
+            error = "保存文件失败: " + file.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    void cancel() override
+    {
+        file.cancelWriting();
+    }
+
+private:
+    static QString format(DataExporter::ColumnType type, const QVariant &value)
+    {
+        switch (type) {
+        case DataExporter::ColumnType::Float64:
+            return QString::number(value.toDouble(), 'g', QLocale::FloatingPointShortest);
+        case DataExporter::ColumnType::Int64:
+            return QString::number(value.toLongLong());
+        case DataExporter::ColumnType::DateTime: {
+            QDateTime time = value.toDateTime();
+            return time.isValid() ? time.toString("yyyy-MM-dd HH:mm:ss") : QString();
+        }
+        case DataExporter::ColumnType::String:
+            break;
+        }
+        return quoted(value.toString());
+    }
+
+    // 含逗号、引号或换行的字段加引号，内部引号双写
+    static QString quoted(const QString &field)
+    {
+        if (!field.contains(',') && !field.contains('"') && !field.contains('\n') && !field.contains('\r')) {
+            return field;
+        }
+        QString escaped = field;
+        escaped.replace('"', "\"\"");
+        return '"' + escaped + '"';
+    }
+
+    QSaveFile file;
+    QTextStream out;
+    QList<DataExporter::ColumnType> types;
+};
+
+class ColumnarWriter : public ExportWriter
+{
+public:
+    explicit ColumnarWriter(const QString &filePath) : file(filePath) {}
+
+    bool begin(const QList<DataExporter::Column> &columns, const QStringList &, QString &error) override
+    {
+        if (!file.open(QIODevice::WriteOnly)) {
+            error = "无法创建文件: " + file.errorString();
+            return false;
+        }
+        out.setDevice(&file);
+        prepareStream(out);
+
+        out << COLUMNAR_MAGIC << COLUMNAR_VERSION << static_cast<quint16>(columns.size());
+        buffers.clear();
+        streams.clear();
+        types.clear();
+        for (const auto &column : columns) {
+            out << column.name << static_cast<quint8>(column.type);
+            types << column.type;
+            buffers.emplace_back(std::make_unique<QByteArray>());
+            streams.emplace_back(std::make_unique<QDataStream>(buffers.back().get(), QIODevice::WriteOnly));
+            prepareStream(*streams.back());
+        }
+        rowCount = 0;
+        return true;
+    }
+
+    void writeRow(const QVector<QVariant> &values) override
+    {
+        for (int i = 0; i < values.size(); ++i) {
+            QDataStream &column = *streams[i];
+            switch (types[i]) {
+            case DataExporter::ColumnType::Float64:
+                column << values[i].toDouble();
+                break;
+            case DataExporter::ColumnType::Int64:
+                column << static_cast<qint64>(values[i].toLongLong());
+                break;
+            case DataExporter::ColumnType::DateTime:
+                column << static_cast<qint64>(EpochTime::toMs(values[i].toDateTime()));
+                break;
+            case DataExporter::ColumnType::String:
+                column << values[i].toString().toUtf8();
+                break;
+            }
+        }
+        ++rowCount;
+    }
+
+    bool endBatch(QString &error) override
+    {
+        // 行数为0的块是结束标记，空批次不写
+        if (rowCount > 0) {
+            out << static_cast<quint32>(rowCount);
+            for (size_t i = 0; i < buffers.size(); ++i) {
+                out << qCompress(*buffers[i]);
+                buffers[i]->clear();
+                streams[i]->device()->seek(0);
+            }
+            rowCount = 0;
+        }
+        if (out.status() != QDataStream::Ok || file.error() != QFileDevice::NoError) {
+            error = "写入文件失败: " + file.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    bool finish(QString &error) override
+    {
+        if (!endBatch(error)) {
+            return false;
+        }
+        out << static_cast<quint32>(0);
+        if (!file.commit()) {
+            error = "保存文件失败: " + file.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    void cancel() override
+    {
+        file.cancelWriting();
+    }
+
+private:
+    QSaveFile file;
+    QDataStream out;
+    QList<DataExporter::ColumnType> types;
+    std::vector<std::unique_ptr<QByteArray>> buffers;     // 当前批次各列的未压缩数据
+    std::vector<std::unique_ptr<QDataStream>> streams;
+    int rowCount = 0;
+};
+
+} // namespace
+
+DataExporter::DataExporter(QObject *parent)
+    : QObject(parent)
+    , canceled(false)
+{
+}
+
+DataExporter::~DataExporter()
+{
+    // 导出任务引用本对象，销毁前等待其结束
+    cancel();
+    task.waitForFinished();
+}
+
+bool DataExporter::exportExcavation(const ExcavationParameterDAO::ExcavationQuery &filter,
+                                    const QString &filePath, Format format)
+{
+    using Row = ExcavationParameterDAO::ExcavationRow;
+    using P = ExcavationParameter;
+
+    auto number = [](double (P::*getter)() const) {
+        return [getter](const Row &row) { return QVariant((row.param.*getter)()); };
+    };
+    auto integer = [](int (P::*getter)() const) {
+        return [getter](const Row &row) { return QVariant(static_cast<qint64>((row.param.*getter)())); };
+    };
+    auto text = [](QString (P::*getter)() const) {
+        return [getter](const Row &row) { return QVariant((row.param.*getter)()); };
+    };
+
+    const QList<Field<Row>> fields = {
+        {"project_name", "项目名称", ColumnType::String, [](const Row &row) { return QVariant(row.projectName); }},
+        {"excavation_time", "掘进时间", ColumnType::DateTime,
+         [](const Row &row) { return QVariant(row.param.getExcavationTime()); }},
+        {"stake_mark", "桩号", ColumnType::String, text(&P::getStakeMark)},
+        {"mileage", "里程", ColumnType::Float64, number(&P::getMileage)},
+        {"excavation_mode", "掘进模式", ColumnType::String, text(&P::getExcavationMode)},
+        {"chamber_pressure", "土仓土压力", ColumnType::Float64, number(&P::getChamberPressure)},
+        {"thrust_force", "千斤顶推力", ColumnType::Float64, number(&P::getThrustForce)},
+        {"cutter_speed", "刀盘转速", ColumnType::Float64, number(&P::getCutterSpeed)},
+        {"cutter_torque", "刀盘扭矩", ColumnType::Float64, number(&P::getCutterTorque)},
+        {"excavation_speed", "掘进速度", ColumnType::Float64, number(&P::getExcavationSpeed)},
+        {"grouting_pressure", "注浆压力", ColumnType::Float64, number(&P::getGroutingPressure)},
+        {"grouting_volume", "注浆量", ColumnType::Float64, number(&P::getGroutingVolume)},
+        {"segment_number", "管片号", ColumnType::String, text(&P::getSegmentNumber)},
+        {"excavation_duration", "掘进时长", ColumnType::Int64, integer(&P::getExcavationDuration)},
+        {"idle_duration", "闲置时长", ColumnType::Int64, integer(&P::getIdleDuration)},
+        {"fault_duration", "故障时长", ColumnType::Int64, integer(&P::getFaultDuration)},
+        {"excavation_distance", "掘进距离", ColumnType::Float64, number(&P::getExcavationDistance)}
+    };
+
+    return start([this, fields, filter, filePath, format]() {
+        ExcavationParameterDAO dao;
+        qint64 totalRows = 0;
+        for (const auto &summary : dao.summarizeExcavationByProject(filter)) {
+            totalRows += summary.recordCount;
+        }
+        if (!dao.getLastError().isEmpty()) {
+            totalRows = -1;
+        }
+
+        runExport<Row>(fields, filePath, format, totalRows,
+            [&filter](const PageCursor &after, QList<Row> &rows, QString &error) {
+                ExcavationParameterDAO::ExcavationQuery batchQuery = filter;
+                batchQuery.after = after;
+                batchQuery.limit = BATCH_SIZE;
+                ExcavationParameterDAO dao;
+                rows = dao.queryExcavationRows(batchQuery);
+                error = dao.getLastError();
+                return error.isEmpty();
+            },
+            [&filter](const Row &row) {
+                return ExcavationParameterDAO::cursorFor(row.param, filter.order);
+            });
+    });
+}
+
+bool DataExporter::exportProspecting(const ProspectingDataDAO::ProspectingQuery &filter,
+                                     const QString &filePath, Format format)
+{
+    using Row = ProspectingDataDAO::ProspectingRow;
+    using D = ProspectingData;
+
+    auto number = [](double (D::*getter)() const) {
+        return [getter](const Row &row) { return QVariant((row.data.*getter)()); };
+    };
+    auto text = [](QString (D::*getter)() const) {
+        return [getter](const Row &row) { return QVariant((row.data.*getter)()); };
+    };
+
+    const QList<Field<Row>> fields = {
+        {"project_name", "项目名称", ColumnType::String, [](const Row &row) { return QVariant(row.projectName); }},
+        {"excavation_time", "掘进时间", ColumnType::DateTime,
+         [](const Row &row) { return QVariant(row.data.getExcavationTime()); }},
+        {"stake_mark", "桩号", ColumnType::String, text(&D::getStakeMark)},
+        {"mileage", "里程", ColumnType::Float64, number(&D::getMileage)},
+        {"cutter_force", "刀盘推力", ColumnType::Float64, number(&D::getCutterForce)},
+        {"cutter_penetration_resistance", "刀盘贯入阻力", ColumnType::Float64,
+         number(&D::getCutterPenetrationResistance)},
+        {"face_friction_torque", "掌子面摩擦扭矩", ColumnType::Float64, number(&D::getFaceFrictionTorque)},
+        {"p_wave_velocity", "纵波波速", ColumnType::Float64, number(&D::getPWaveVelocity)},
+        {"s_wave_velocity", "横波波速", ColumnType::Float64, number(&D::getSWaveVelocity)},
+        {"wave_reflection_coeff", "波反射系数", ColumnType::Float64, number(&D::getWaveReflectionCoeff)},
+        {"apparent_resistivity", "视电阻率", ColumnType::Float64, number(&D::getApparentResistivity)},
+        {"stress_gradient", "应力梯度", ColumnType::Float64, number(&D::getStressGradient)},
+        {"water_probability", "含水概率", ColumnType::Float64, number(&D::getWaterProbability)},
+        {"rock_properties", "围岩性质", ColumnType::String, text(&D::getRockProperties)},
+        {"rock_danger_level", "围岩危险等级", ColumnType::String, text(&D::getRockDangerLevel)},
+        {"youngs_modulus", "杨氏模量", ColumnType::Float64, number(&D::getYoungsModulus)},
+        {"poisson_ratio", "泊松比", ColumnType::Float64, number(&D::getPoissonRatio)},
+        {"wave_velocity_ratio", "横纵波速比", ColumnType::Float64, number(&D::getWaveVelocityRatio)},
+        {"rock_type", "岩层类型", ColumnType::String, text(&D::getRockType)},
+        {"distribution_pattern", "分布形态", ColumnType::String, text(&D::getDistributionPattern)}
+    };
+
+    return start([this, fields, filter, filePath, format]() {
+        int totalRows = ProspectingDataDAO().countRows(filter);
+
+        runExport<Row>(fields, filePath, format, totalRows,
+            [&filter](const PageCursor &after, QList<Row> &rows, QString &error) {
+                ProspectingDataDAO::ProspectingQuery batchQuery = filter;
+                batchQuery.after = after;
+                batchQuery.limit = BATCH_SIZE;
+                ProspectingDataDAO dao;
+                rows = dao.queryRows(batchQuery);
+                error = dao.getLastError();
+                return error.isEmpty();
+            },
+            [](const Row &row) {
+                return ProspectingDataDAO::cursorFor(row.data);
+            });
+    });
+}
+
+bool DataExporter::exportWarnings(const WarningDAO::WarningQuery &filter,
+                                  const QString &filePath, Format format)
+{
+    using Row = WarningDAO::WarningRow;
+
+    const QList<Field<Row>> fields = {
+        {"project_name", "项目名称", ColumnType::String, [](const Row &row) { return QVariant(row.projectName); }},
+        {"warning_id", "预警编号", ColumnType::Int64,
+         [](const Row &row) { return QVariant(static_cast<qint64>(row.warning.getWarningId())); }},
+        {"warning_level", "预警级别", ColumnType::String,
+         [](const Row &row) { return QVariant(row.warning.getWarningLevel()); }},
+        {"warning_type", "预警类别", ColumnType::String,
+         [](const Row &row) { return QVariant(row.warning.getWarningType()); }},
+        {"latitude", "纬度", ColumnType::Float64, [](const Row &row) { return QVariant(row.warning.getLatitude()); }},
+        {"longitude", "经度", ColumnType::Float64, [](const Row &row) { return QVariant(row.warning.getLongitude()); }},
+        {"depth", "深度", ColumnType::Float64, [](const Row &row) { return QVariant(row.warning.getDepth()); }},
+        {"threshold_value", "阈值", ColumnType::Int64,
+         [](const Row &row) { return QVariant(static_cast<qint64>(row.warning.getThresholdValue())); }},
+        {"distance", "距离", ColumnType::Float64, [](const Row &row) { return QVariant(row.warning.getDistance()); }},
+        {"warning_time", "时间", ColumnType::DateTime,
+         [](const Row &row) { return QVariant(row.warning.getWarningTime()); }}
+    };
+
+    return start([this, fields, filter, filePath, format]() {
+        int totalRows = WarningDAO().countRows(filter);
+
+        runExport<Row>(fields, filePath, format, totalRows,
+            [&filter](const PageCursor &after, QList<Row> &rows, QString &error) {
+                WarningDAO::WarningQuery batchQuery = filter;
+                batchQuery.after = after;
+                batchQuery.limit = BATCH_SIZE;
+                WarningDAO dao;
+                rows = dao.queryRows(batchQuery);
+                error = dao.getLastError();
+                return error.isEmpty();
+            },
+            [](const Row &row) {
+                return row.cursor;
+            });
+    });
+}
+
+void DataExporter::cancel()
+{
+    canceled = true;
+}
+
+bool DataExporter::isRunning() const
+{
+    return task.isRunning();
+}
+
+bool DataExporter::importExcavation(const QString &filePath)
+{
+    return start([this, filePath]() {
+        DatabaseManager &dbManager = DatabaseManager::instance();
+        ExcavationParameterDAO dao;
+        ProjectDAO projectDao;
+        QHash<QString, int> projectIds;     // 项目名称到ID，不存在的项目为0
+        QSet<int> importedProjects;
+        QHash<QString, int> columnIndex;
+        qint64 importedRows = 0;      // 已提交的行数
+        qint64 pendingRows = 0;       // 当前事务中的行数
+        bool inTransaction = false;
+        qint64 skippedRows = 0;
+        QString error;
+
+        // 写入分批提交，其他连接（主线程的实时写入、归档）在批之间取得写锁
+        auto commitPending = [&]() {
+            if (!inTransaction) {
+                return true;
+            }
+            inTransaction = false;
+            if (!dbManager.commitTransaction()) {
+                error = dbManager.getLastError();
+                dbManager.rollbackTransaction();
+                pendingRows = 0;
+                return false;
+            }
+            importedRows += pendingRows;
+            pendingRows = 0;
+            return true;
+        };
+
+        emit progressChanged(0, -1);
+
+        QList<Column> columns;
+        QString readError;
+        bool readOk = readColumnar(filePath, columns, [&](const ColumnBlock &block) {
+            if (canceled) {
+                error = "导入已取消";
+                return false;
+            }
+
+            if (columnIndex.isEmpty()) {
+                for (int i = 0; i < columns.size(); ++i) {
+                    columnIndex.insert(columns[i].name, i);
+                }
+                if (!columnIndex.contains("project_name") || !columnIndex.contains("excavation_time")) {
+                    error = "不是掘进参数的导出文件（缺少项目名称或掘进时间列）";
+                    return false;
+                }
+            }
+
+            // 列不存在或类型不符时取默认值
+            auto number = [&](const char *name, int row) {
+                int column = columnIndex.value(name, -1);
+                return column >= 0 && row < block.floats[column].size() ? block.floats[column][row] : 0.0;
+            };
+            auto integer = [&](const char *name, int row) {
+                int column = columnIndex.value(name, -1);
+                return column >= 0 && row < block.integers[column].size() ? block.integers[column][row] : qint64(0);
+            };
+            auto text = [&](const char *name, int row) {
+                int column = columnIndex.value(name, -1);
+                return column >= 0 && row < block.strings[column].size() ? block.strings[column][row] : QString();
+            };
+
+            for (int row = 0; row < block.rowCount; ++row) {
+                const QString projectName = text("project_name", row);
+                auto project = projectIds.find(projectName);
+                if (project == projectIds.end()) {
+                    project = projectIds.insert(projectName, projectDao.getProjectByName(projectName).getProjectId());
+                }
+                if (project.value() <= 0) {
+                    ++skippedRows;
+                    continue;
+                }
+
+                ExcavationParameter param;
+                param.setProjectId(project.value());
+                // 列式文件中无效时间记为0
+                const qint64 timeMs = integer("excavation_time", row);
+                param.setExcavationTime(timeMs > 0 ? QDateTime::fromMSecsSinceEpoch(timeMs) : QDateTime());
+                param.setStakeMark(text("stake_mark", row));
+                param.setMileage(number("mileage", row));
+                param.setExcavationMode(text("excavation_mode", row));
+                param.setChamberPressure(number("chamber_pressure", row));
+                param.setThrustForce(number("thrust_force", row));
+                param.setCutterSpeed(number("cutter_speed", row));
+                param.setCutterTorque(number("cutter_torque", row));
+                param.setExcavationSpeed(number("excavation_speed", row));
+                param.setGroutingPressure(number("grouting_pressure", row));
+                param.setGroutingVolume(number("grouting_volume", row));
+                param.setSegmentNumber(text("segment_number", row));
+                param.setExcavationDuration(static_cast<int>(integer("excavation_duration", row)));
+                param.setIdleDuration(static_cast<int>(integer("idle_duration", row)));
+                param.setFaultDuration(static_cast<int>(integer("fault_duration", row)));
+                param.setExcavationDistance(number("excavation_distance", row));
+
+                if (!inTransaction) {
+                    if (!dbManager.beginTransaction()) {
+                        error = dbManager.getLastError();
+                        return false;
+                    }
+                    inTransaction = true;
+                }
+                if (!dao.insertExcavationParameter(param)) {
+                    error = dao.getLastError();
+                    return false;
+                }
+                importedProjects.insert(project.value());
+                if (++pendingRows >= IMPORT_BATCH_SIZE && !commitPending()) {
+                    return false;
+                }
+            }
+
+            emit progressChanged(importedRows + pendingRows, -1);
+            return true;
+        }, &readError);
+
+        const bool ok = readOk && error.isEmpty() && commitPending();
+        if (inTransaction) {
+            dbManager.rollbackTransaction();
+            inTransaction = false;
+        }
+
+        // 列缓存只能在主线程访问，导入的项目在主线程中丢弃缓存，下次访问重新加载；
+        // 失败时已提交的批同样需要丢弃
+        if (importedRows > 0) {
+            QMetaObject::invokeMethod(this, [importedProjects]() {
+                ExcavationColumnCache &cache = ExcavationColumnCache::instance();
+                for (int projectId : importedProjects) {
+                    cache.invalidate(projectId);
+                }
+            }, Qt::QueuedConnection);
+        }
+
+        if (!ok) {
+            QString message = error.isEmpty() ? readError : error;
+            if (importedRows > 0) {
+                message += QString("（此前已导入 %1 条记录）").arg(importedRows);
+            }
+            qWarning() << "导入失败:" << message;
+            emit finished(false, message);
+            return;
+        }
+
+        qDebug() << "导入完成:" << filePath << importedRows << "条";
+        QString message = QString("已导入 %1 条记录").arg(importedRows);
+        if (skippedRows > 0) {
+            message += QString("，%1 条记录的项目不存在，已跳过").arg(skippedRows);
+        }
+        emit finished(true, message);
+    });
+}
+
+DataExporter::Format DataExporter::formatForFile(const QString &filePath)
+{
+    return QFileInfo(filePath).suffix().compare("svc", Qt::CaseInsensitive) == 0 ? Format::Columnar : Format::Csv;
+}
+
+bool DataExporter::start(const std::function<void()> &job)
+{
+    if (isRunning()) {
+        return false;
+    }
+    canceled = false;
+    task = AsyncDAO::run(nullptr, job);
+    return true;
+}
+
+template <typename Row>
+void DataExporter::runExport(const QList<Field<Row>> &fields, const QString &filePath, Format format, qint64 totalRows,
+                             const std::function<bool(const PageCursor &, QList<Row> &, QString &)> &fetch,
+                             const std::function<PageCursor(const Row &)> &cursorOf)
+{
+    QList<Column> columns;
+    QStringList titles;
+    for (const auto &field : fields) {
+        columns.append({field.name, field.type});
+        titles << field.title;
+    }
+
+    std::unique_ptr<ExportWriter> writer;
+    if (format == Format::Columnar) {
+        writer = std::make_unique<ColumnarWriter>(filePath);
+    } else {
+        writer = std::make_unique<CsvWriter>(filePath);
+    }
+
+    QString error;
+    if (!writer->begin(columns, titles, error)) {
+        qWarning() << "导出失败:" << error;
+        emit finished(false, error);
+        return;
+    }
+
+    emit progressChanged(0, totalRows);
+
+    PageCursor after;
+    qint64 exportedRows = 0;
+    QList<Row> batch;
+    QVector<QVariant> values(fields.size());
+    for (;;) {
+        if (canceled) {
+            writer->cancel();
+            emit finished(false, "导出已取消");
+            return;
+        }
+
+        if (!fetch(after, batch, error)) {
+            writer->cancel();
+            qWarning() << "导出失败:" << error;
+            emit finished(false, error);
+            return;
+        }
+
+        for (const Row &row : batch) {
+            for (int i = 0; i < fields.size(); ++i) {
+                values[i] = fields[i].value(row);
+            }
+            writer->writeRow(values);
+        }
+        if (!writer->endBatch(error)) {
+            writer->cancel();
+            qWarning() << "导出失败:" << error;
+            emit finished(false, error);
+            return;
+        }
+
+        exportedRows += batch.size();
+        emit progressChanged(exportedRows, totalRows);
+
+        if (batch.size() < BATCH_SIZE) {
+            break;
+        }
+        after = cursorOf(batch.last());
+    }
+
+    if (!writer->finish(error)) {
+        writer->cancel();
+        qWarning() << "导出失败:" << error;
+        emit finished(false, error);
+        return;
+    }
+
+    qDebug() << "导出完成:" << filePath << exportedRows << "条";
+    emit finished(true, QString("已导出 %1 条记录").arg(exportedRows));
+}
+
+bool DataExporter::readColumnar(const QString &filePath, QList<Column> &columns,
+                                const std::function<bool(const ColumnBlock &)> &handler,
+                                QString *errorMessage)
+{
+    auto fail = [errorMessage](const QString &message) {
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        qWarning() << message;
+        return false;
+    };
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail("无法打开文件: " + file.errorString());
+    }
+
+    QDataStream in(&file);
+    prepareStream(in);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint16 columnCount = 0;
+    in >> magic >> version >> columnCount;
+    if (in.status() != QDataStream::Ok || magic != COLUMNAR_MAGIC) {
+        return fail("不是有效的列式导出文件: " + filePath);
+    }
+    if (version != COLUMNAR_VERSION) {
+        return fail(QString("不支持的列式文件版本: %1").arg(version));
+    }
+
+    columns.clear();
+    for (int i = 0; i < columnCount; ++i) {
+        Column column;
+        quint8 type = 0;
+        in >> column.name >> type;
+        if (type < static_cast<quint8>(ColumnType::Float64) || type > static_cast<quint8>(ColumnType::DateTime)) {
+            return fail(QString("列 %1 的类型无效").arg(column.name));
+        }
+        column.type = static_cast<ColumnType>(type);
+        columns.append(column);
+    }
+    if (in.status() != QDataStream::Ok) {
+        return fail("列式文件头不完整: " + filePath);
+    }
+
+    ColumnBlock block;
+    block.floats.resize(columnCount);
+    block.integers.resize(columnCount);
+    block.strings.resize(columnCount);
+
+    for (;;) {
+        quint32 rowCount = 0;
+        in >> rowCount;
+        if (in.status() != QDataStream::Ok) {
+            return fail("列式文件不完整（缺少结束块）: " + filePath);
+        }
+        if (rowCount == 0) {
+            return true;
+        }
+
+        block.rowCount = static_cast<int>(rowCount);
+        for (int i = 0; i < columnCount; ++i) {
+            QByteArray compressed;
+            in >> compressed;
+            if (in.status() != QDataStream::Ok) {
+                return fail("列式文件数据块不完整: " + filePath);
+            }
+
+            QByteArray raw = qUncompress(compressed);
+            QDataStream values(raw);
+            prepareStream(values);
+
+            block.floats[i].clear();
+            block.integers[i].clear();
+            block.strings[i].clear();
+            switch (columns[i].type) {
+            case ColumnType::Float64:
+                block.floats[i].resize(block.rowCount);
+                for (double &value : block.floats[i]) {
+                    values >> value;
+                }
+                break;
+            case ColumnType::Int64:
+            case ColumnType::DateTime:
+                block.integers[i].resize(block.rowCount);
+                for (qint64 &value : block.integers[i]) {
+                    values >> value;
+                }
+                break;
+            case ColumnType::String:
+                block.strings[i].reserve(block.rowCount);
+                for (int row = 0; row < block.rowCount; ++row) {
+                    QByteArray utf8;
+                    values >> utf8;
+                    block.strings[i].append(QString::fromUtf8(utf8));
+                }
+                break;
+            }
+            if (values.status() != QDataStream::Ok) {
+                return fail(QString("列 %1 的数据损坏").arg(columns[i].name));
+            }
+        }
+
+        if (!handler(block)) {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef DATAEXPORTER_H
+#define DATAEXPORTER_H
+
+#include "ExcavationParameterDAO.h"
+#include "ProspectingDataDAO.h"
+#include "WarningDAO.h"
+#include <QObject>
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief 管理表格数据导出
+ *
+ * 按查询条件直接从数据库分批读取（游标分页，每批 BATCH_SIZE 行），写完一批即释放，
+ * 内存占用与导出行数无关。导出在数据库线程池中执行，通过信号报告进度与结果，
+ * 可随时取消；写入使用 QSaveFile，取消或出错时不会留下不完整的目标文件。
+ *
+ * 支持两种格式：
+ *   Csv      UTF-8（带 BOM，便于 Excel 识别），字段按 RFC 4180 加引号转义
+ *   Columnar 列式压缩文件（.svc），供重新导入时按列直接读取数值
+ *
+ * 掘进参数的列式文件可通过 importExcavation() 重新导入（按列名取值，项目按名称匹配）。
+ *
+ * 列式文件布局（QDataStream，小端）：
+ *   [魔数][版本][列数][列名、列类型 × 列数]
+ *   [数据块 × N]   每块为 [行数][qCompress 压缩的列数据 × 列数]
+ *   [行数为0的结束块]
+ * 列数据中数值列为连续的 double/qint64，文本列为逐个 UTF-8 字节数组。
+ * 时间列在读取结果中与 Int64 列一样放在 integers 中。
+ * 没有结束块的文件视为写入不完整。
+ */
+class DataExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Format {
+        Csv,
+        Columnar
+    };
+
+    enum class ColumnType : quint8 {
+        Float64 = 1,
+        Int64 = 2,
+        String = 3,
+        DateTime = 4        // 列式文件中为毫秒时间戳（无效时间为0），CSV中为本地时间文本
+    };
+
+    struct Column {
+        QString name;
+        ColumnType type = ColumnType::String;
+    };
+
+    /**
+     * @brief 列式文件中的一个数据块
+     * 各数组按列序号索引，只有对应类型的列有数据
+     */
+    struct ColumnBlock {
+        int rowCount = 0;
+        QVector<QVector<double>> floats;
+        QVector<QVector<qint64>> integers;
+        QVector<QStringList> strings;
+    };
+
+    explicit DataExporter(QObject *parent = nullptr);
+    ~DataExporter();
+
+    // 按条件导出掘进参数，导出按条件中的排序方式进行，返回 false 表示已有导出在进行
+    bool exportExcavation(const ExcavationParameterDAO::ExcavationQuery &filter,
+                          const QString &filePath, Format format);
+
+    // 按条件导出补勘数据
+    bool exportProspecting(const ProspectingDataDAO::ProspectingQuery &filter,
+                           const QString &filePath, Format format);
+
+    // 按条件导出预警
+    bool exportWarnings(const WarningDAO::WarningQuery &filter,
+                        const QString &filePath, Format format);
+
+    /**
+     * @brief 导入掘进参数的列式导出文件
+     * 在数据库线程池中执行，每 IMPORT_BATCH_SIZE 行提交一个短事务，主线程的写入最多等待一批；
+     * 出错或取消时只回滚当前批，已提交的行保留，结果中给出已导入的行数。
+     * 进度与结果同样通过 progressChanged()、finished() 报告。名称不存在的项目的行被跳过。
+     * @return 已有导出或导入在进行时返回 false
+     */
+    bool importExcavation(const QString &filePath);
+
+    // 取消正在进行的导出或导入
+    void cancel();
+
+    // 是否有导出或导入在进行
+    bool isRunning() const;
+
+    // 按文件扩展名判断格式，.svc 为列式文件，其余为CSV
+    static Format formatForFile(const QString &filePath);
+
+    /**
+     * @brief 读取列式文件
+     * @param columns 输出列定义
+     * @param handler 每读出一块调用一次，返回 false 停止读取
+     * @return 文件完整且读取成功返回 true
+     */
+    static bool readColumnar(const QString &filePath, QList<Column> &columns,
+                             const std::function<bool(const ColumnBlock &)> &handler,
+                             QString *errorMessage = nullptr);
+
+signals:
+    // 导出（导入）进度，totalRows 为-1表示总数未知
+    void progressChanged(qint64 exportedRows, qint64 totalRows);
+
+    // 导出（导入）结束（成功、失败或取消）
+    void finished(bool success, const QString &message);
+
+private:
+    // 一列的导出定义：列式文件列名、CSV表头与取值
+    template <typename Row>
+    struct Field {
+        QString name;
+        QString title;
+        ColumnType type;
+        std::function<QVariant(const Row &)> value;
+    };
+
+    /**
+     * @brief 分批读取并写出
+     * fetch 读取 after 之后的一批，返回 false 表示查询出错；cursorOf 生成下一批的游标
+     */
+    template <typename Row>
+    void runExport(const QList<Field<Row>> &fields, const QString &filePath, Format format, qint64 totalRows,
+                   const std::function<bool(const PageCursor &, QList<Row> &, QString &)> &fetch,
+                   const std::function<PageCursor(const Row &)> &cursorOf);
+
+    bool start(const std::function<void()> &job);
+
+private:
+    // 每批读取行数
+    static const int BATCH_SIZE = 2000;
+
+    QFuture<void> task;
+    std::atomic_bool canceled;
+};
+
+#endif // DATAEXPORTER_H
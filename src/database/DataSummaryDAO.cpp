@@ -0,0 +1,90 @@
+#include "DataSummaryDAO.h"
+#include "DatabaseManager.h"
+#include "EpochTime.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+#include <QVariant>
+
+const QString DataSummaryDAO::TYPE_EXCAVATION = "excavation";
+const QString DataSummaryDAO::TYPE_PROSPECTING = "prospecting";
+const QString DataSummaryDAO::TYPE_WARNING = "warning";
+
+DataSummaryDAO::DataSummaryDAO()
+{
+}
+
+DataSummaryDAO::DataSummary DataSummaryDAO::getSummary(int projectId, const QString &dataType)
+{
+    DataSummary summary;
+    summary.projectId = projectId;
+    summary.dataType = dataType;
+    
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare("SELECT row_count, latest_id, min_time, max_time, min_mileage, max_mileage "
+                  "FROM project_data_summary "
+                  "WHERE project_id = :projectId AND data_type = :dataType");
+    query.bindValue(":projectId", projectId);
+    query.bindValue(":dataType", dataType);
+    
+    if (!query.exec()) {
+        lastError = "查询数据汇总失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return summary;
+    }
+    
+    if (query.next()) {
+        summary.rowCount = query.value("row_count").toInt();
+        summary.latestId = query.value("latest_id").toInt();
+        summary.minTime = EpochTime::toDateTime(query.value("min_time"));
+        summary.maxTime = EpochTime::toDateTime(query.value("max_time"));
+        summary.minMileage = query.value("min_mileage").toDouble();
+        summary.maxMileage = query.value("max_mileage").toDouble();
+    }
+    
+    return summary;
+}
+
+QList<DataSummaryDAO::DataSummary> DataSummaryDAO::getSummariesByType(const QString &dataType)
+{
+    QList<DataSummary> summaries;
+    
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare("SELECT project_id, row_count, latest_id, min_time, max_time, min_mileage, max_mileage "
+                  "FROM project_data_summary WHERE data_type = :dataType "
+                  "ORDER BY project_id");
+    query.bindValue(":dataType", dataType);
+    
+    if (!query.exec()) {
+        lastError = "查询数据汇总失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return summaries;
+    }
+    
+    while (query.next()) {
+        DataSummary summary;
+        summary.projectId = query.value("project_id").toInt();
+        summary.dataType = dataType;
+        summary.rowCount = query.value("row_count").toInt();
+        summary.latestId = query.value("latest_id").toInt();
+        summary.minTime = EpochTime::toDateTime(query.value("min_time"));
+        summary.maxTime = EpochTime::toDateTime(query.value("max_time"));
+        summary.minMileage = query.value("min_mileage").toDouble();
+        summary.maxMileage = query.value("max_mileage").toDouble();
+        summaries.append(summary);
+    }
+    
+    return summaries;
+}
+
+bool DataSummaryDAO::rebuild()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+    
+    if (!dbManager.rebuildDataSummary()) {
+        lastError = dbManager.getLastError();
+        return false;
+    }
+    
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef DATASUMMARYDAO_H
+#define DATASUMMARYDAO_H
+
+#include <QString>
+#include <QList>
+#include <QDateTime>
+
+/**
+ * @brief 项目数据汇总访问对象
+ * 
+ * 读取由触发器维护的 project_data_summary 表，
+ * 每个项目每类明细数据只需读取一行即可得到记录数、最新记录与范围
+ */
+class DataSummaryDAO
+{
+public:
+    struct DataSummary {
+        int projectId = 0;
+        QString dataType;           // 数据类型，见 TYPE_* 常量
+        int rowCount = 0;           // 记录数
+        int latestId = 0;           // 最新记录ID（按时间）
+        QDateTime minTime;          // 最早时间
+        QDateTime maxTime;          // 最晚时间
+        double minMileage = 0.0;    // 最小里程（预警无里程）
+        double maxMileage = 0.0;    // 最大里程
+    };
+
+    // 数据类型常量
+    static const QString TYPE_EXCAVATION;
+    static const QString TYPE_PROSPECTING;
+    static const QString TYPE_WARNING;
+
+    DataSummaryDAO();
+    
+    // 获取项目某类数据的汇总，无记录时返回 rowCount 为0的汇总
+    DataSummary getSummary(int projectId, const QString &dataType);
+    
+    // 获取所有项目某类数据的汇总
+    QList<DataSummary> getSummariesByType(const QString &dataType);
+    
+    // 按明细表重新统计所有汇总（对账）
+    bool rebuild();
+    
+    // 获取最后的错误信息
+    QString getLastError() const { return lastError; }
+
+private:
+    QString lastError;
+};
+
+#endif // DATASUMMARYDAO_H
@@ -1,17 +1,45 @@
 #include "DatabaseManager.h"
+#include "ExcavationRollupDAO.h"
+#include "EpochTime.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDir>
 #include <QDebug>
 #include <QCryptographicHash>
 #include <QApplication>
+#include <QThread>
+#include <QThreadStorage>
 
 const QString DatabaseManager::DB_CONNECTION_NAME = "shield_db_connection";
 const QString DatabaseManager::DB_DRIVER = "QSQLITE";
 const QString DatabaseManager::DB_FILE_NAME = "shield_platform.db";
 
+namespace {
+
+// 工作线程专用连接，随线程结束析构时关闭并注销
+struct ThreadConnection {
+    QString name;
+    
+    ~ThreadConnection()
+    {
+        {
+            QSqlDatabase db = QSqlDatabase::database(name, false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+    }
+};
+
+QThreadStorage<ThreadConnection*> threadConnections;
+
+// 各线程最后的错误信息：工作线程池中的事务与查询失败时互不覆盖
+QThreadStorage<QString> threadErrors;
+
+}
+
 DatabaseManager::DatabaseManager()
     : initialized(false)
+    , ownerThread(nullptr)
 {
     // 数据库文件路径：应用程序目录下的data文件夹
     QString appPath = QApplication::applicationDirPath();
@@ -26,6 +54,16 @@ DatabaseManager::DatabaseManager()
     qDebug() << "数据库路径:" << databasePath;
 }
 
+QString DatabaseManager::getLastError() const
+{
+    return threadErrors.localData();
+}
+
+QString &DatabaseManager::lastError()
+{
+    return threadErrors.localData();
+}
+
 DatabaseManager::~DatabaseManager()
 {
     closeDatabase();
@@ -47,8 +85,8 @@ bool DatabaseManager::initDatabase()
     
     // 检查SQLite驱动是否可用
     if (!QSqlDatabase::isDriverAvailable(DB_DRIVER)) {
-        lastError = "SQLite驱动不可用";
-        qCritical() << lastError;
+        lastError() = "SQLite驱动不可用";
+        qCritical() << lastError();
         return false;
     }
     
@@ -58,12 +96,20 @@ bool DatabaseManager::initDatabase()
     
     // 打开数据库
     if (!database.open()) {
-        lastError = "无法打开数据库: " + database.lastError().text();
-        qCritical() << lastError;
+        lastError() = "无法打开数据库: " + database.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
     qDebug() << "数据库连接成功";
+    ownerThread = QThread::currentThread();
+    
+    // WAL 模式下读连接与写连接互不阻塞，工作线程查询时主线程仍可写入
+    QSqlQuery pragmaQuery(database);
+    if (!pragmaQuery.exec("PRAGMA journal_mode = WAL")) {
+        qWarning() << "启用WAL模式失败:" << pragmaQuery.lastError().text();
+    }
+    pragmaQuery.exec(QString("PRAGMA busy_timeout = %1").arg(BUSY_TIMEOUT_MS));
     
     // 检查数据库文件是否是新建的（判断是否存在users表）
     bool isNewDatabase = !tableExists("users");
@@ -73,19 +119,31 @@ bool DatabaseManager::initDatabase()
         
         // 创建表
         if (!createTables()) {
-            lastError = "创建数据库表失败";
-            qCritical() << lastError;
+            lastError() = "创建数据库表失败";
+            qCritical() << lastError();
             return false;
         }
         
         // 插入默认数据
         if (!insertDefaultData()) {
-            lastError = "插入默认数据失败";
-            qWarning() << lastError;
+            lastError() = "插入默认数据失败";
+            qWarning() << lastError();
             // 注意：这里不返回false，因为表已经创建成功
         }
     }
     
+    // 旧库的掘进时间为 DATETIME 文本，迁移为毫秒时间戳；失败时保留原数据继续启动
+    if (!migrateExcavationTimestamps()) {
+        qCritical() << "掘进参数时间戳迁移失败:" << lastError();
+    }
+    
+    // 索引与汇总表缺失只影响查询性能，失败时不阻止启动
+    createIndexes();
+    createRetentionTables();
+    createSummaryTables();
+    createRollupTables();
+    createSegmentTables();
+    
     initialized = true;
     return true;
 }
@@ -95,9 +153,41 @@ QSqlDatabase DatabaseManager::getDatabase()
     if (!initialized) {
         initDatabase();
     }
+    if (ownerThread && QThread::currentThread() != ownerThread) {
+        return threadDatabase();
+    }
     return QSqlDatabase::database(DB_CONNECTION_NAME);
 }
 
+QSqlDatabase DatabaseManager::threadDatabase()
+{
+    if (threadConnections.hasLocalData()) {
+        return QSqlDatabase::database(threadConnections.localData()->name);
+    }
+    
+    QString name = QString("%1_%2").arg(DB_CONNECTION_NAME)
+                       .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(DB_DRIVER, name);
+        db.setDatabaseName(databasePath);
+        
+        if (!db.open()) {
+            qWarning() << "无法打开工作线程数据库连接:" << db.lastError().text();
+            db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(name);
+            return QSqlDatabase();
+        }
+        
+        QSqlQuery pragmaQuery(db);
+        pragmaQuery.exec(QString("PRAGMA busy_timeout = %1").arg(BUSY_TIMEOUT_MS));
+    }
+    
+    ThreadConnection *connection = new ThreadConnection;
+    connection->name = name;
+    threadConnections.setLocalData(connection);
+    return QSqlDatabase::database(name);
+}
+
 bool DatabaseManager::isConnected() const
 {
     return initialized && database.isOpen();
@@ -120,8 +210,8 @@ bool DatabaseManager::executeQuery(const QString &query)
     QSqlQuery sqlQuery(getDatabase());
     
     if (!sqlQuery.exec(query)) {
-        lastError = "SQL执行失败: " + sqlQuery.lastError().text();
-        qCritical() << lastError << "\nSQL:" << query;
+        lastError() = "SQL执行失败: " + sqlQuery.lastError().text();
+        qCritical() << lastError() << "\nSQL:" << query;
         return false;
     }
     
@@ -131,7 +221,7 @@ bool DatabaseManager::executeQuery(const QString &query)
 bool DatabaseManager::beginTransaction()
 {
     if (!getDatabase().transaction()) {
-        lastError = "开始事务失败: " + getDatabase().lastError().text();
+        lastError() = "开始事务失败: " + getDatabase().lastError().text();
         return false;
     }
     return true;
@@ -140,7 +230,7 @@ bool DatabaseManager::beginTransaction()
 bool DatabaseManager::commitTransaction()
 {
     if (!getDatabase().commit()) {
-        lastError = "提交事务失败: " + getDatabase().lastError().text();
+        lastError() = "提交事务失败: " + getDatabase().lastError().text();
         return false;
     }
     return true;
@@ -149,7 +239,7 @@ bool DatabaseManager::commitTransaction()
 bool DatabaseManager::rollbackTransaction()
 {
     if (!getDatabase().rollback()) {
-        lastError = "回滚事务失败: " + getDatabase().lastError().text();
+        lastError() = "回滚事务失败: " + getDatabase().lastError().text();
         return false;
     }
     return true;
@@ -168,6 +258,35 @@ bool DatabaseManager::tableExists(const QString &tableName)
     return false;
 }
 
+// 掘进参数表结构：excavation_time、created_at 为毫秒时间戳（建库与时间戳迁移共用）
+static QString excavationParametersTableStatement(const QString &tableName)
+{
+    return QString(R"(
+        CREATE TABLE IF NOT EXISTS %1 (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            project_id INTEGER NOT NULL,
+            excavation_time INTEGER NOT NULL,
+            stake_mark VARCHAR(50),
+            mileage REAL,
+            excavation_mode VARCHAR(50),
+            chamber_pressure REAL,
+            thrust_force REAL,
+            cutter_speed REAL,
+            cutter_torque REAL,
+            excavation_speed REAL,
+            grouting_pressure REAL,
+            grouting_volume REAL,
+            segment_number VARCHAR(50),
+            excavation_duration INTEGER,
+            idle_duration INTEGER,
+            fault_duration INTEGER,
+            excavation_distance REAL,
+            created_at INTEGER DEFAULT (%2),
+            FOREIGN KEY (project_id) REFERENCES projects(project_id)
+        )
+    )").arg(tableName, EpochTime::sqlNowMs());
+}
+
 bool DatabaseManager::createTables()
 {
     QSqlQuery query(database);
@@ -186,8 +305,8 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createUsersTable)) {
-        lastError = "创建users表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建users表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -221,8 +340,8 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createProjectsTable)) {
-        lastError = "创建projects表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建projects表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -247,8 +366,8 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createWarningsTable)) {
-        lastError = "创建warnings表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建warnings表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -266,8 +385,8 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createNewsTable)) {
-        lastError = "创建news表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建news表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -289,8 +408,8 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createBoreholesTable)) {
-        lastError = "创建boreholes表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建boreholes表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -315,8 +434,8 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createBoreholLayersTable)) {
-        lastError = "创建borehole_layers表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建borehole_layers表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -347,8 +466,8 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createTunnelProfilesTable)) {
-        lastError = "创建tunnel_profiles表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建tunnel_profiles表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -371,8 +490,8 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createMileagePointsTable)) {
-        lastError = "创建mileage_points表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建mileage_points表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -406,42 +525,19 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createShieldPositionTable)) {
-        lastError = "创建shield_position表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建shield_position表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
     qDebug() << "shield_position表创建成功";
     
     // 创建掘进参数表
-    QString createExcavationParametersTable = R"(
-        CREATE TABLE IF NOT EXISTS excavation_parameters (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            project_id INTEGER NOT NULL,
-            excavation_time DATETIME NOT NULL,
-            stake_mark VARCHAR(50),
-            mileage REAL,
-            excavation_mode VARCHAR(50),
-            chamber_pressure REAL,
-            thrust_force REAL,
-            cutter_speed REAL,
-            cutter_torque REAL,
-            excavation_speed REAL,
-            grouting_pressure REAL,
-            grouting_volume REAL,
-            segment_number VARCHAR(50),
-            excavation_duration INTEGER,
-            idle_duration INTEGER,
-            fault_duration INTEGER,
-            excavation_distance REAL,
-            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-            FOREIGN KEY (project_id) REFERENCES projects(project_id)
-        )
-    )";
+    QString createExcavationParametersTable = excavationParametersTableStatement("excavation_parameters");
     
     if (!query.exec(createExcavationParametersTable)) {
-        lastError = "创建excavation_parameters表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建excavation_parameters表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -477,8 +573,8 @@ bool DatabaseManager::createTables()
     )";
     
     if (!query.exec(createProspectingDataTable)) {
-        lastError = "创建prospecting_data表失败: " + query.lastError().text();
-        qCritical() << lastError;
+        lastError() = "创建prospecting_data表失败: " + query.lastError().text();
+        qCritical() << lastError();
         return false;
     }
     
@@ -487,6 +583,636 @@ bool DatabaseManager::createTables()
     return true;
 }
 
+bool DatabaseManager::migrateExcavationTimestamps()
+{
+    QSqlQuery query(database);
+    
+    if (!query.exec("SELECT type FROM pragma_table_info('excavation_parameters') WHERE name = 'excavation_time'")) {
+        lastError() = "读取excavation_parameters表结构失败: " + query.lastError().text();
+        return false;
+    }
+    
+    bool needsMigration = query.next() && query.value(0).toString().toUpper() != "INTEGER";
+    query.finish();
+    
+    if (needsMigration) {
+        qDebug() << "开始迁移掘进参数时间戳为毫秒整数...";
+        
+        // 保留自增序号，避免已归档记录的ID被重新分配
+        qint64 sequence = 0;
+        if (query.exec("SELECT seq FROM sqlite_sequence WHERE name = 'excavation_parameters'") && query.next()) {
+            sequence = query.value(0).toLongLong();
+        }
+        query.finish();
+        
+        const QString columns = "id, project_id, excavation_time, stake_mark, mileage, excavation_mode, "
+                                "chamber_pressure, thrust_force, cutter_speed, cutter_torque, "
+                                "excavation_speed, grouting_pressure, grouting_volume, segment_number, "
+                                "excavation_duration, idle_duration, fault_duration, excavation_distance, created_at";
+        
+        // created_at 来自 CURRENT_TIMESTAMP，本身就是UTC时间
+        const QString createdAtMs = "CASE WHEN typeof(created_at) = 'text' "
+                                    "THEN CAST(ROUND((julianday(created_at) - 2440587.5) * 86400000) AS INTEGER) "
+                                    "ELSE created_at END";
+        
+        QStringList statements = {
+            "DROP VIEW IF EXISTS excavation_parameters_view",
+            "DROP TABLE IF EXISTS excavation_parameters_new",
+            excavationParametersTableStatement("excavation_parameters_new"),
+            QString("INSERT INTO excavation_parameters_new (%1) "
+                    "SELECT id, project_id, %2, stake_mark, mileage, excavation_mode, "
+                    "chamber_pressure, thrust_force, cutter_speed, cutter_torque, "
+                    "excavation_speed, grouting_pressure, grouting_volume, segment_number, "
+                    "excavation_duration, idle_duration, fault_duration, excavation_distance, %3 "
+                    "FROM excavation_parameters")
+                .arg(columns, EpochTime::sqlTextToMs("excavation_time"), createdAtMs),
+            // 旧表的索引与触发器随表删除，之后由 createIndexes / createSummaryTables / createRollupTables 重建
+            "DROP TABLE excavation_parameters",
+            "ALTER TABLE excavation_parameters_new RENAME TO excavation_parameters",
+            QString("UPDATE sqlite_sequence SET seq = MAX(seq, %1) WHERE name = 'excavation_parameters'").arg(sequence)
+        };
+        
+        // 依赖掘进时间的汇总与聚合中的时间一并换算
+        if (tableExists("project_data_summary")) {
+            statements << QString("UPDATE project_data_summary SET min_time = %1, max_time = %2 "
+                                  "WHERE data_type = 'excavation'")
+                              .arg(EpochTime::sqlTextToMs("min_time"), EpochTime::sqlTextToMs("max_time"));
+        }
+        if (tableExists("excavation_rollups")) {
+            statements << QString("UPDATE excavation_rollups SET first_time = %1, last_time = %2")
+                              .arg(EpochTime::sqlTextToMs("first_time"), EpochTime::sqlTextToMs("last_time"));
+        }
+        
+        if (!database.transaction()) {
+            lastError() = "开始事务失败: " + database.lastError().text();
+            return false;
+        }
+        
+        for (const QString &statement : statements) {
+            if (!query.exec(statement)) {
+                lastError() = "迁移掘进参数时间戳失败: " + query.lastError().text();
+                database.rollback();
+                return false;
+            }
+        }
+        
+        if (!database.commit()) {
+            lastError() = "提交事务失败: " + database.lastError().text();
+            database.rollback();
+            return false;
+        }
+        
+        qDebug() << "掘进参数时间戳迁移完成";
+    }
+    
+    // 兼容视图：按原来的日期文本格式提供时间列，供外部工具与手工查询使用
+    QString createView =
+        "CREATE VIEW IF NOT EXISTS excavation_parameters_view AS "
+        "SELECT id, project_id, "
+        + EpochTime::sqlLocalFormat("%Y-%m-%dT%H:%M:%f", "excavation_time") + " AS excavation_time, "
+        "stake_mark, mileage, excavation_mode, chamber_pressure, thrust_force, cutter_speed, cutter_torque, "
+        "excavation_speed, grouting_pressure, grouting_volume, segment_number, "
+        "excavation_duration, idle_duration, fault_duration, excavation_distance, "
+        "strftime('%Y-%m-%d %H:%M:%S', created_at / 1000.0, 'unixepoch') AS created_at "
+        "FROM excavation_parameters";
+    
+    if (!query.exec(createView)) {
+        lastError() = "创建excavation_parameters_view视图失败: " + query.lastError().text();
+        return false;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::createIndexes()
+{
+    QSqlQuery query(database);
+    
+    // 游标分页按 (项目, 排序键, 主键) 定位，复合索引使任意页只需一次索引查找
+    const QStringList indexStatements = {
+        "CREATE INDEX IF NOT EXISTS idx_excavation_project_time "
+        "ON excavation_parameters(project_id, excavation_time, id)",
+        "CREATE INDEX IF NOT EXISTS idx_excavation_project_mileage "
+        "ON excavation_parameters(project_id, mileage, id)",
+        // 聚合触发器按环重新计算时按 (项目, 管片编号) 读取明细
+        "CREATE INDEX IF NOT EXISTS idx_excavation_project_segment "
+        "ON excavation_parameters(project_id, segment_number)",
+        "CREATE INDEX IF NOT EXISTS idx_prospecting_project_time "
+        "ON prospecting_data(project_id, excavation_time, prospecting_id)",
+        "CREATE INDEX IF NOT EXISTS idx_prospecting_project_mileage "
+        "ON prospecting_data(project_id, mileage, prospecting_id)",
+        "CREATE INDEX IF NOT EXISTS idx_warnings_project_time "
+        "ON warnings(project_id, warning_time, warning_id)",
+        // 管理表格不限项目时按时间跨项目滚动加载
+        "CREATE INDEX IF NOT EXISTS idx_excavation_time "
+        "ON excavation_parameters(excavation_time, id)",
+        "CREATE INDEX IF NOT EXISTS idx_prospecting_time "
+        "ON prospecting_data(excavation_time, prospecting_id)",
+        // 预警导出按时间跨项目分批读取
+        "CREATE INDEX IF NOT EXISTS idx_warnings_time "
+        "ON warnings(warning_time, warning_id)"
+    };
+    
+    for (const QString &statement : indexStatements) {
+        if (!query.exec(statement)) {
+            lastError() = "创建索引失败: " + query.lastError().text();
+            qCritical() << lastError();
+            return false;
+        }
+    }
+    
+    qDebug() << "数据库索引检查完成";
+    return true;
+}
+
+/**
+ * @brief 汇总表维护触发器的SQL
+ *
+ * 插入时按新行增量更新计数、最新记录与时间/里程范围；
+ * 删除或修改时仅在受影响的值恰为边界时才回查明细表，
+ * 回查走 (project_id, 排序键, 主键) 索引，代价为 O(log n)。
+ * mileageColumn 为空表示该表没有里程字段。
+ */
+static QStringList summaryTriggerStatements(const QString &dataType,
+                                            const QString &table,
+                                            const QString &idColumn,
+                                            const QString &timeColumn,
+                                            const QString &mileageColumn)
+{
+    const QString where = QString("WHERE project_id = %1 AND data_type = '%2'");
+    
+    // 某项目当前最新记录与范围的回查子查询，%1 为项目ID表达式
+    const QString latestSub = QString("(SELECT %1 FROM %2 WHERE project_id = %4 "
+                                      "ORDER BY %3 DESC, %1 DESC LIMIT 1)")
+                                  .arg(idColumn, table, timeColumn);
+    const QString aggSub = QString("(SELECT %1(%2) FROM %3 WHERE project_id = %4)");
+    
+    QString insertSql = QString(
+        "CREATE TRIGGER IF NOT EXISTS trg_%1_summary_insert AFTER INSERT ON %2 "
+        "BEGIN "
+        "INSERT OR IGNORE INTO project_data_summary (project_id, data_type) VALUES (NEW.project_id, '%1'); "
+        "UPDATE project_data_summary SET "
+        "row_count = row_count + 1, "
+        "latest_id = CASE WHEN max_time IS NULL OR NEW.%4 >= max_time THEN NEW.%3 ELSE latest_id END, "
+        "min_time = CASE WHEN min_time IS NULL OR NEW.%4 < min_time THEN NEW.%4 ELSE min_time END, "
+        "max_time = CASE WHEN max_time IS NULL OR NEW.%4 > max_time THEN NEW.%4 ELSE max_time END")
+        .arg(dataType, table, idColumn, timeColumn);
+    if (!mileageColumn.isEmpty()) {
+        insertSql += QString(", "
+            "min_mileage = CASE WHEN min_mileage IS NULL OR NEW.%1 < min_mileage THEN NEW.%1 ELSE min_mileage END, "
+            "max_mileage = CASE WHEN max_mileage IS NULL OR NEW.%1 > max_mileage THEN NEW.%1 ELSE max_mileage END")
+            .arg(mileageColumn);
+    }
+    insertSql += " " + where.arg("NEW.project_id", dataType) + "; END";
+    
+    QString deleteSql = QString(
+        "CREATE TRIGGER IF NOT EXISTS trg_%1_summary_delete AFTER DELETE ON %2 "
+        "BEGIN "
+        "UPDATE project_data_summary SET "
+        "row_count = row_count - 1, "
+        "latest_id = CASE WHEN OLD.%3 = latest_id THEN %5 ELSE latest_id END, "
+        "min_time = CASE WHEN OLD.%4 <= min_time THEN %6 ELSE min_time END, "
+        "max_time = CASE WHEN OLD.%4 >= max_time THEN %7 ELSE max_time END")
+        .arg(dataType, table, idColumn, timeColumn,
+             latestSub.arg("OLD.project_id"),
+             aggSub.arg("MIN", timeColumn, table, "OLD.project_id"),
+             aggSub.arg("MAX", timeColumn, table, "OLD.project_id"));
+    if (!mileageColumn.isEmpty()) {
+        deleteSql += QString(", "
+            "min_mileage = CASE WHEN OLD.%1 <= min_mileage THEN %2 ELSE min_mileage END, "
+            "max_mileage = CASE WHEN OLD.%1 >= max_mileage THEN %3 ELSE max_mileage END")
+            .arg(mileageColumn,
+                 aggSub.arg("MIN", mileageColumn, table, "OLD.project_id"),
+                 aggSub.arg("MAX", mileageColumn, table, "OLD.project_id"));
+    }
+    deleteSql += " " + where.arg("OLD.project_id", dataType) + "; END";
+    
+    // 修改排序相关字段时，对新旧两个项目重新回查边界并调整计数
+    const QString summaryProject = "project_data_summary.project_id";
+    QString updateColumns = "project_id, " + timeColumn;
+    if (!mileageColumn.isEmpty()) {
+        updateColumns += ", " + mileageColumn;
+    }
+    QString updateSql = QString(
+        "CREATE TRIGGER IF NOT EXISTS trg_%1_summary_update AFTER UPDATE OF %3 ON %2 "
+        "BEGIN "
+        "INSERT OR IGNORE INTO project_data_summary (project_id, data_type) VALUES (NEW.project_id, '%1'); "
+        "UPDATE project_data_summary SET "
+        "row_count = row_count "
+        "+ (CASE WHEN project_id = NEW.project_id THEN 1 ELSE 0 END) "
+        "- (CASE WHEN project_id = OLD.project_id THEN 1 ELSE 0 END), "
+        "latest_id = %4, min_time = %5, max_time = %6")
+        .arg(dataType, table, updateColumns,
+             latestSub.arg(summaryProject),
+             aggSub.arg("MIN", timeColumn, table, summaryProject),
+             aggSub.arg("MAX", timeColumn, table, summaryProject));
+    if (!mileageColumn.isEmpty()) {
+        updateSql += QString(", min_mileage = %1, max_mileage = %2")
+            .arg(aggSub.arg("MIN", mileageColumn, table, summaryProject),
+                 aggSub.arg("MAX", mileageColumn, table, summaryProject));
+    }
+    updateSql += QString(" WHERE data_type = '%1' AND project_id IN (OLD.project_id, NEW.project_id); END")
+                     .arg(dataType);
+    
+    return {insertSql, deleteSql, updateSql};
+}
+
+bool DatabaseManager::createSummaryTables()
+{
+    QSqlQuery query(database);
+    
+    bool isNewSummary = !tableExists("project_data_summary");
+    
+    // 每个项目每类明细数据一行：记录数、最新记录ID、时间与里程范围
+    QString createSummaryTable = R"(
+        CREATE TABLE IF NOT EXISTS project_data_summary (
+            project_id INTEGER NOT NULL,
+            data_type VARCHAR(20) NOT NULL,
+            row_count INTEGER NOT NULL DEFAULT 0,
+            latest_id INTEGER,
+            min_time DATETIME,
+            max_time DATETIME,
+            min_mileage REAL,
+            max_mileage REAL,
+            PRIMARY KEY (project_id, data_type)
+        )
+    )";
+    
+    if (!query.exec(createSummaryTable)) {
+        lastError() = "创建project_data_summary表失败: " + query.lastError().text();
+        qCritical() << lastError();
+        return false;
+    }
+    
+    QStringList triggerStatements;
+    triggerStatements << summaryTriggerStatements("excavation", "excavation_parameters",
+                                                  "id", "excavation_time", "mileage");
+    triggerStatements << summaryTriggerStatements("prospecting", "prospecting_data",
+                                                  "prospecting_id", "excavation_time", "mileage");
+    triggerStatements << summaryTriggerStatements("warning", "warnings",
+                                                  "warning_id", "warning_time", QString());
+    
+    for (const QString &statement : triggerStatements) {
+        if (!query.exec(statement)) {
+            lastError() = "创建汇总触发器失败: " + query.lastError().text();
+            qCritical() << lastError() << "\nSQL:" << statement;
+            return false;
+        }
+    }
+    
+    // 首次创建汇总表时按已有明细数据回填
+    if (isNewSummary) {
+        qDebug() << "首次创建汇总表，开始回填已有数据...";
+        if (!rebuildDataSummary()) {
+            return false;
+        }
+    }
+    
+    bool isNewStatistics = !tableExists("excavation_statistics");
+    
+    // 掘进累计统计：按项目保存掘进/闲置/故障时长与掘进距离的累计值
+    QString createStatisticsTable = R"(
+        CREATE TABLE IF NOT EXISTS excavation_statistics (
+            project_id INTEGER PRIMARY KEY,
+            record_count INTEGER NOT NULL DEFAULT 0,
+            total_excavation_minutes INTEGER NOT NULL DEFAULT 0,
+            total_idle_minutes INTEGER NOT NULL DEFAULT 0,
+            total_fault_minutes INTEGER NOT NULL DEFAULT 0,
+            total_distance REAL NOT NULL DEFAULT 0,
+            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+    
+    if (!query.exec(createStatisticsTable)) {
+        lastError() = "创建excavation_statistics表失败: " + query.lastError().text();
+        qCritical() << lastError();
+        return false;
+    }
+    
+    // 累计值随明细记录的插入、删除、修改增量调整，不回查明细表
+    const QStringList statisticsTriggers = {
+        R"(
+        CREATE TRIGGER IF NOT EXISTS trg_excavation_statistics_insert
+        AFTER INSERT ON excavation_parameters
+        BEGIN
+            INSERT OR IGNORE INTO excavation_statistics (project_id) VALUES (NEW.project_id);
+            UPDATE excavation_statistics SET
+                record_count = record_count + 1,
+                total_excavation_minutes = total_excavation_minutes + COALESCE(NEW.excavation_duration, 0),
+                total_idle_minutes = total_idle_minutes + COALESCE(NEW.idle_duration, 0),
+                total_fault_minutes = total_fault_minutes + COALESCE(NEW.fault_duration, 0),
+                total_distance = total_distance + COALESCE(NEW.excavation_distance, 0),
+                updated_at = CURRENT_TIMESTAMP
+            WHERE project_id = NEW.project_id;
+        END
+        )",
+        R"(
+        CREATE TRIGGER IF NOT EXISTS trg_excavation_statistics_delete
+        AFTER DELETE ON excavation_parameters
+        BEGIN
+            UPDATE excavation_statistics SET
+                record_count = record_count - 1,
+                total_excavation_minutes = total_excavation_minutes - COALESCE(OLD.excavation_duration, 0),
+                total_idle_minutes = total_idle_minutes - COALESCE(OLD.idle_duration, 0),
+                total_fault_minutes = total_fault_minutes - COALESCE(OLD.fault_duration, 0),
+                total_distance = total_distance - COALESCE(OLD.excavation_distance, 0),
+                updated_at = CURRENT_TIMESTAMP
+            WHERE project_id = OLD.project_id;
+        END
+        )",
+        R"(
+        CREATE TRIGGER IF NOT EXISTS trg_excavation_statistics_update
+        AFTER UPDATE OF project_id, excavation_duration, idle_duration, fault_duration, excavation_distance
+        ON excavation_parameters
+        BEGIN
+            UPDATE excavation_statistics SET
+                record_count = record_count - 1,
+                total_excavation_minutes = total_excavation_minutes - COALESCE(OLD.excavation_duration, 0),
+                total_idle_minutes = total_idle_minutes - COALESCE(OLD.idle_duration, 0),
+                total_fault_minutes = total_fault_minutes - COALESCE(OLD.fault_duration, 0),
+                total_distance = total_distance - COALESCE(OLD.excavation_distance, 0),
+                updated_at = CURRENT_TIMESTAMP
+            WHERE project_id = OLD.project_id;
+            INSERT OR IGNORE INTO excavation_statistics (project_id) VALUES (NEW.project_id);
+            UPDATE excavation_statistics SET
+                record_count = record_count + 1,
+                total_excavation_minutes = total_excavation_minutes + COALESCE(NEW.excavation_duration, 0),
+                total_idle_minutes = total_idle_minutes + COALESCE(NEW.idle_duration, 0),
+                total_fault_minutes = total_fault_minutes + COALESCE(NEW.fault_duration, 0),
+                total_distance = total_distance + COALESCE(NEW.excavation_distance, 0),
+                updated_at = CURRENT_TIMESTAMP
+            WHERE project_id = NEW.project_id;
+        END
+        )"
+    };
+    
+    for (const QString &statement : statisticsTriggers) {
+        if (!query.exec(statement)) {
+            lastError() = "创建掘进统计触发器失败: " + query.lastError().text();
+            qCritical() << lastError();
+            return false;
+        }
+    }
+    
+    if (isNewStatistics) {
+        qDebug() << "首次创建掘进累计统计表，开始回填已有数据...";
+        if (!rebuildExcavationStatistics()) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::createRetentionTables()
+{
+    QSqlQuery query(database);
+    
+    // 项目明细数据保留天数，未配置的项目永久保留
+    QString createPoliciesTable = R"(
+        CREATE TABLE IF NOT EXISTS data_retention_policies (
+            project_id INTEGER PRIMARY KEY,
+            retention_days INTEGER NOT NULL,
+            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+    
+    if (!query.exec(createPoliciesTable)) {
+        lastError() = "创建data_retention_policies表失败: " + query.lastError().text();
+        qCritical() << lastError();
+        return false;
+    }
+    
+    // 已归档明细的行数与累计量，重新统计掘进累计值时需要计入
+    QString createArchiveStateTable = R"(
+        CREATE TABLE IF NOT EXISTS data_archive_state (
+            project_id INTEGER NOT NULL,
+            data_type VARCHAR(20) NOT NULL,
+            archive_file TEXT,
+            archived_rows INTEGER NOT NULL DEFAULT 0,
+            archived_excavation_minutes INTEGER NOT NULL DEFAULT 0,
+            archived_idle_minutes INTEGER NOT NULL DEFAULT 0,
+            archived_fault_minutes INTEGER NOT NULL DEFAULT 0,
+            archived_distance REAL NOT NULL DEFAULT 0,
+            archived_until DATETIME,
+            last_archived_at DATETIME,
+            PRIMARY KEY (project_id, data_type)
+        )
+    )";
+    
+    if (!query.exec(createArchiveStateTable)) {
+        lastError() = "创建data_archive_state表失败: " + query.lastError().text();
+        qCritical() << lastError();
+        return false;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::createRollupTables()
+{
+    QSqlQuery query(database);
+    
+    bool isNewRollups = !tableExists("excavation_rollups");
+    
+    for (const QString &statement : ExcavationRollupDAO::schemaStatements()) {
+        if (!query.exec(statement)) {
+            lastError() = "创建掘进聚合表失败: " + query.lastError().text();
+            qCritical() << lastError();
+            return false;
+        }
+    }
+    
+    if (isNewRollups) {
+        qDebug() << "首次创建掘进聚合表，开始回填已有数据...";
+        if (!rebuildExcavationRollups()) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::createSegmentTables()
+{
+    QSqlQuery query(database);
+    
+    // 高频时序段文件登记：数据在段文件中，库内只保存定位与范围信息
+    QString createSegmentsTable = R"(
+        CREATE TABLE IF NOT EXISTS excavation_segments (
+            project_id INTEGER NOT NULL,
+            segment_day VARCHAR(8) NOT NULL,
+            file_path TEXT NOT NULL,
+            record_count INTEGER NOT NULL DEFAULT 0,
+            min_time_ms INTEGER,
+            max_time_ms INTEGER,
+            min_mileage REAL,
+            max_mileage REAL,
+            sealed INTEGER NOT NULL DEFAULT 0,
+            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            PRIMARY KEY (project_id, segment_day)
+        )
+    )";
+    
+    if (!query.exec(createSegmentsTable)) {
+        lastError() = "创建excavation_segments表失败: " + query.lastError().text();
+        qCritical() << lastError();
+        return false;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::rebuildDataSummary()
+{
+    QSqlQuery query(database);
+    
+    const QStringList rebuildStatements = {
+        "DELETE FROM project_data_summary",
+        
+        "INSERT INTO project_data_summary "
+        "(project_id, data_type, row_count, latest_id, min_time, max_time, min_mileage, max_mileage) "
+        "SELECT project_id, 'excavation', COUNT(*), "
+        "(SELECT e2.id FROM excavation_parameters e2 WHERE e2.project_id = e.project_id "
+        "ORDER BY e2.excavation_time DESC, e2.id DESC LIMIT 1), "
+        "MIN(excavation_time), MAX(excavation_time), MIN(mileage), MAX(mileage) "
+        "FROM excavation_parameters e GROUP BY project_id",
+        
+        "INSERT INTO project_data_summary "
+        "(project_id, data_type, row_count, latest_id, min_time, max_time, min_mileage, max_mileage) "
+        "SELECT project_id, 'prospecting', COUNT(*), "
+        "(SELECT p2.prospecting_id FROM prospecting_data p2 WHERE p2.project_id = p.project_id "
+        "ORDER BY p2.excavation_time DESC, p2.prospecting_id DESC LIMIT 1), "
+        "MIN(excavation_time), MAX(excavation_time), MIN(mileage), MAX(mileage) "
+        "FROM prospecting_data p GROUP BY project_id",
+        
+        "INSERT INTO project_data_summary "
+        "(project_id, data_type, row_count, latest_id, min_time, max_time) "
+        "SELECT project_id, 'warning', COUNT(*), "
+        "(SELECT w2.warning_id FROM warnings w2 WHERE w2.project_id = w.project_id "
+        "ORDER BY w2.warning_time DESC, w2.warning_id DESC LIMIT 1), "
+        "MIN(warning_time), MAX(warning_time) "
+        "FROM warnings w GROUP BY project_id"
+    };
+    
+    if (!database.transaction()) {
+        lastError() = "开始事务失败: " + database.lastError().text();
+        qCritical() << lastError();
+        return false;
+    }
+    
+    for (const QString &statement : rebuildStatements) {
+        if (!query.exec(statement)) {
+            lastError() = "重建汇总表失败: " + query.lastError().text();
+            qCritical() << lastError();
+            database.rollback();
+            return false;
+        }
+    }
+    
+    if (!database.commit()) {
+        lastError() = "提交事务失败: " + database.lastError().text();
+        qCritical() << lastError();
+        database.rollback();
+        return false;
+    }
+    
+    qDebug() << "汇总表重建完成";
+    return true;
+}
+
+bool DatabaseManager::rebuildExcavationStatistics(int projectId)
+{
+    QSqlQuery query(database);
+    
+    QString projectFilter = (projectId > 0) ? "WHERE project_id = :projectId" : "";
+    
+    if (!database.transaction()) {
+        lastError() = "开始事务失败: " + database.lastError().text();
+        qCritical() << lastError();
+        return false;
+    }
+    
+    query.prepare(QString("DELETE FROM excavation_statistics %1").arg(projectFilter));
+    if (projectId > 0) {
+        query.bindValue(":projectId", projectId);
+    }
+    
+    if (!query.exec()) {
+        lastError() = "清除掘进累计统计失败: " + query.lastError().text();
+        qCritical() << lastError();
+        database.rollback();
+        return false;
+    }
+    
+    // 已归档的明细不在表中，其累计量从归档状态表计入
+    query.prepare(QString(
+        "INSERT INTO excavation_statistics "
+        "(project_id, record_count, total_excavation_minutes, total_idle_minutes, "
+        "total_fault_minutes, total_distance) "
+        "SELECT project_id, SUM(record_count), SUM(excavation_minutes), SUM(idle_minutes), "
+        "SUM(fault_minutes), SUM(distance) FROM ("
+        "SELECT project_id, COUNT(*) AS record_count, "
+        "COALESCE(SUM(excavation_duration), 0) AS excavation_minutes, COALESCE(SUM(idle_duration), 0) AS idle_minutes, "
+        "COALESCE(SUM(fault_duration), 0) AS fault_minutes, COALESCE(SUM(excavation_distance), 0) AS distance "
+        "FROM excavation_parameters %1 GROUP BY project_id "
+        "UNION ALL "
+        "SELECT project_id, archived_rows, archived_excavation_minutes, archived_idle_minutes, "
+        "archived_fault_minutes, archived_distance "
+        "FROM data_archive_state WHERE data_type = 'excavation' %2"
+        ") GROUP BY project_id")
+        .arg(projectFilter, projectId > 0 ? "AND project_id = :archiveProjectId" : ""));
+    if (projectId > 0) {
+        query.bindValue(":projectId", projectId);
+        query.bindValue(":archiveProjectId", projectId);
+    }
+    
+    if (!query.exec()) {
+        lastError() = "重建掘进累计统计失败: " + query.lastError().text();
+        qCritical() << lastError();
+        database.rollback();
+        return false;
+    }
+    
+    if (!database.commit()) {
+        lastError() = "提交事务失败: " + database.lastError().text();
+        qCritical() << lastError();
+        database.rollback();
+        return false;
+    }
+    
+    qDebug() << "掘进累计统计重建完成" << (projectId > 0 ? QString("项目ID: %1").arg(projectId) : QString("全部项目"));
+    return true;
+}
+
+bool DatabaseManager::rebuildExcavationRollups(int projectId)
+{
+    QSqlQuery query(database);
+    
+    if (!database.transaction()) {
+        lastError() = "开始事务失败: " + database.lastError().text();
+        qCritical() << lastError();
+        return false;
+    }
+    
+    if (!query.exec(ExcavationRollupDAO::backfillStatement(projectId))) {
+        lastError() = "重建掘进聚合数据失败: " + query.lastError().text();
+        qCritical() << lastError();
+        database.rollback();
+        return false;
+    }
+    
+    if (!database.commit()) {
+        lastError() = "提交事务失败: " + database.lastError().text();
+        qCritical() << lastError();
+        database.rollback();
+        return false;
+    }
+    
+    qDebug() << "掘进聚合数据重建完成" << (projectId > 0 ? QString("项目ID: %1").arg(projectId) : QString("全部项目"));
+    return true;
+}
+
 bool DatabaseManager::insertDefaultData()
 {
     QSqlQuery query(database);
@@ -782,7 +1508,7 @@ bool DatabaseManager::insertDefaultData()
         QString stakeMark = QString("K%1+%2").arg(km).arg(m, 0, 'f', 2);
         
         query.bindValue(":pid", projectId);
-        query.bindValue(":time", baseTime.addSecs(i * 300)); // 每5分钟一条记录
+        query.bindValue(":time", EpochTime::toMs(baseTime.addSecs(i * 300))); // 每5分钟一条记录
         query.bindValue(":stake", stakeMark);
         query.bindValue(":mileage", currentMileage);
         query.bindValue(":mode", "土压平衡");
@@ -5,6 +5,8 @@
 #include <QString>
 #include <QMutex>
 
+class QThread;
+
 /**
  * @brief 数据库管理类（单例模式）
  * 
@@ -20,7 +22,11 @@ public:
     // 初始化数据库
     bool initDatabase();
     
-    // 获取数据库连接
+    /**
+     * @brief 获取数据库连接
+     * 在初始化数据库的线程（主线程）返回主连接；在其他线程返回该线程专用的连接，
+     * 首次调用时打开，线程结束时自动关闭。QSqlDatabase 连接不能跨线程使用。
+     */
     QSqlDatabase getDatabase();
     
     // 检查数据库是否已连接
@@ -29,8 +35,8 @@ public:
     // 关闭数据库连接
     void closeDatabase();
     
-    // 获取最后的错误信息
-    QString getLastError() const { return lastError; }
+    // 获取当前线程最后的错误信息
+    QString getLastError() const;
     
     // 执行SQL语句
     bool executeQuery(const QString &query);
@@ -43,6 +49,15 @@ public:
     
     // 回滚事务
     bool rollbackTransaction();
+    
+    // 按明细表重新统计汇总表（对账用，正常情况下由触发器维护）
+    bool rebuildDataSummary();
+    
+    // 按明细表与归档状态重新统计掘进累计数据，projectId为0时重建所有项目
+    bool rebuildExcavationStatistics(int projectId = 0);
+    
+    // 按明细表重新计算掘进多分辨率聚合（只覆盖明细仍存在的桶），projectId为0时处理所有项目
+    bool rebuildExcavationRollups(int projectId = 0);
 
 private:
     DatabaseManager();
@@ -55,22 +70,49 @@ private:
     // 创建数据库表
     bool createTables();
     
+    // 把旧库掘进参数的 DATETIME 文本时间迁移为毫秒时间戳，并创建兼容视图（可重复调用）
+    bool migrateExcavationTimestamps();
+    
+    // 创建索引（对已有数据库同样执行，可重复调用）
+    bool createIndexes();
+    
+    // 创建数据保留策略与归档状态表（对已有数据库同样执行，可重复调用）
+    bool createRetentionTables();
+    
+    // 创建汇总表及其维护触发器（对已有数据库同样执行，可重复调用）
+    bool createSummaryTables();
+    
+    // 创建掘进多分辨率聚合表及其触发器（对已有数据库同样执行，可重复调用）
+    bool createRollupTables();
+    
+    // 创建高频时序段文件登记表（对已有数据库同样执行，可重复调用）
+    bool createSegmentTables();
+    
     // 插入默认数据
     bool insertDefaultData();
     
     // 检查表是否存在
     bool tableExists(const QString &tableName);
+    
+    // 获取（必要时打开）当前工作线程的专用连接
+    QSqlDatabase threadDatabase();
 
 private:
     QSqlDatabase database;
     QString databasePath;
-    QString lastError;
     QMutex mutex;
     bool initialized;
+    QThread *ownerThread;   // 主连接所属线程
+    
+    // 当前线程的错误信息，可直接赋值
+    static QString &lastError();
     
     static const QString DB_CONNECTION_NAME;
     static const QString DB_DRIVER;
     static const QString DB_FILE_NAME;
+    
+    // 写锁被占用时的等待时间（毫秒）
+    static const int BUSY_TIMEOUT_MS = 5000;
 };
 
 #endif // DATABASEMANAGER_H
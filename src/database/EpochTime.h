@@ -0,0 +1,72 @@
+#ifndef EPOCHTIME_H
+#define EPOCHTIME_H
+
+#include <QDateTime>
+#include <QVariant>
+#include <QString>
+
+/**
+ * @brief 毫秒时间戳与 QDateTime 之间的转换
+ *
+ * excavation_parameters 的 excavation_time、created_at 以 INTEGER 毫秒时间戳存储，
+ * 范围比较直接按整数进行，读取时也无需解析日期字符串。
+ * 只在 DAO 绑定参数与读取结果时转换，其余代码仍使用 QDateTime。
+ */
+class EpochTime
+{
+public:
+    // QDateTime 转毫秒时间戳，无效时间为0
+    static qint64 toMs(const QDateTime &dateTime)
+    {
+        return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : 0;
+    }
+
+    // 读取时间列：整数按毫秒时间戳解析，文本（迁移前的数据或其他表）按日期字符串解析
+    static QDateTime toDateTime(const QVariant &value)
+    {
+        if (value.isNull()) {
+            return QDateTime();
+        }
+        if (value.typeId() == QMetaType::LongLong || value.typeId() == QMetaType::Int) {
+            return QDateTime::fromMSecsSinceEpoch(value.toLongLong());
+        }
+        return value.toDateTime();
+    }
+
+    // 读取时间列为毫秒时间戳，整数列直接返回
+    static qint64 toMs(const QVariant &value)
+    {
+        if (value.typeId() == QMetaType::LongLong || value.typeId() == QMetaType::Int) {
+            return value.toLongLong();
+        }
+        return toMs(toDateTime(value));
+    }
+
+    /**
+     * @brief 把 DATETIME 文本列换算为毫秒时间戳的SQL表达式（用于迁移）
+     * 带时区后缀（Z 或 ±hh:mm）的文本按其时区换算，无后缀的按本地时间换算
+     */
+    static QString sqlTextToMs(const QString &column)
+    {
+        return QString("CASE WHEN %1 IS NULL THEN NULL "
+                       "WHEN typeof(%1) = 'integer' THEN %1 "
+                       "WHEN %1 GLOB '*[Zz]' OR %1 GLOB '*[+-][0-9][0-9]:[0-9][0-9]' "
+                       "THEN CAST(ROUND((julianday(%1) - 2440587.5) * 86400000) AS INTEGER) "
+                       "ELSE CAST(ROUND((julianday(%1, 'utc') - 2440587.5) * 86400000) AS INTEGER) END")
+            .arg(column);
+    }
+
+    // 当前时间的毫秒时间戳SQL表达式（用于列默认值与触发器）
+    static QString sqlNowMs()
+    {
+        return "CAST(ROUND((julianday('now') - 2440587.5) * 86400000) AS INTEGER)";
+    }
+
+    // 毫秒时间戳列按本地时间格式化的SQL表达式
+    static QString sqlLocalFormat(const QString &format, const QString &column)
+    {
+        return QString("strftime('%1', %2 / 1000.0, 'unixepoch', 'localtime')").arg(format, column);
+    }
+};
+
+#endif // EPOCHTIME_H
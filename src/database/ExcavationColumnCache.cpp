@@ -0,0 +1,362 @@
+#include "ExcavationColumnCache.h"
+#include "DatabaseManager.h"
+#include "DataSummaryDAO.h"
+#include "EpochTime.h"
+#include "../models/ExcavationParameter.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const size_t DEFAULT_MEMORY_LIMIT = 256 * 1024 * 1024;
+
+// 分4路累加，各路之间无依赖，编译器可直接向量化
+template <typename T>
+ExcavationColumnCache::ColumnStats aggregateRange(const T *data, size_t count)
+{
+    ExcavationColumnCache::ColumnStats stats;
+    if (count == 0) {
+        return stats;
+    }
+
+    double sums[4] = {0.0, 0.0, 0.0, 0.0};
+    double mins[4];
+    double maxs[4];
+    for (int k = 0; k < 4; ++k) {
+        mins[k] = static_cast<double>(data[0]);
+        maxs[k] = static_cast<double>(data[0]);
+    }
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            double v = static_cast<double>(data[i + k]);
+            sums[k] += v;
+            mins[k] = v < mins[k] ? v : mins[k];
+            maxs[k] = v > maxs[k] ? v : maxs[k];
+        }
+    }
+    for (; i < count; ++i) {
+        double v = static_cast<double>(data[i]);
+        sums[0] += v;
+        mins[0] = v < mins[0] ? v : mins[0];
+        maxs[0] = v > maxs[0] ? v : maxs[0];
+    }
+
+    stats.count = count;
+    stats.sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    stats.min = std::min(std::min(mins[0], mins[1]), std::min(mins[2], mins[3]));
+    stats.max = std::max(std::max(maxs[0], maxs[1]), std::max(maxs[2], maxs[3]));
+    return stats;
+}
+
+template <typename T>
+size_t vectorBytes(const std::vector<T> &column)
+{
+    return column.capacity() * sizeof(T);
+}
+
+}
+
+quint32 ExcavationColumnCache::StringDictionary::encode(const QString &value)
+{
+    auto it = codes.constFind(value);
+    if (it != codes.constEnd()) {
+        return it.value();
+    }
+
+    quint32 code = static_cast<quint32>(values.size());
+    values.append(value);
+    codes.insert(value, code);
+    // 每个字符串在列表和哈希中各有一份引用，估算为字符数据加固定开销
+    bytes += static_cast<size_t>(value.size()) * sizeof(QChar) + 64;
+    return code;
+}
+
+size_t ExcavationColumnCache::ProjectColumns::memoryUsage() const
+{
+    size_t bytes = vectorBytes(ids) + vectorBytes(timeMs)
+                   + vectorBytes(stakeMarks) + vectorBytes(excavationModes) + vectorBytes(segmentNumbers);
+    for (const auto &column : values) {
+        bytes += vectorBytes(column);
+    }
+    for (const auto &column : integers) {
+        bytes += vectorBytes(column);
+    }
+    return bytes + dictionary.bytes;
+}
+
+ExcavationColumnCache::ExcavationColumnCache()
+    : memoryLimit(DEFAULT_MEMORY_LIMIT)
+    , usedBytes(0)
+{
+}
+
+ExcavationColumnCache& ExcavationColumnCache::instance()
+{
+    static ExcavationColumnCache cache;
+    return cache;
+}
+
+std::shared_ptr<const ExcavationColumnCache::ProjectColumns> ExcavationColumnCache::getProject(int projectId)
+{
+    auto it = projects.constFind(projectId);
+    if (it != projects.constEnd()) {
+        touch(projectId);
+        return it.value();
+    }
+
+    auto columns = std::make_shared<ProjectColumns>();
+    columns->projectId = projectId;
+    if (!loadProject(projectId, *columns)) {
+        return nullptr;
+    }
+
+    projects.insert(projectId, columns);
+    usedBytes += columns->memoryUsage();
+    touch(projectId);
+    evict(projectId);
+    return columns;
+}
+
+bool ExcavationColumnCache::loadProject(int projectId, ProjectColumns &columns)
+{
+    // 用汇总表的行数预分配，避免加载过程中数组反复扩容
+    DataSummaryDAO summaryDao;
+    size_t expected = static_cast<size_t>(
+        summaryDao.getSummary(projectId, DataSummaryDAO::TYPE_EXCAVATION).rowCount);
+
+    columns.ids.reserve(expected);
+    columns.timeMs.reserve(expected);
+    for (auto &column : columns.values) {
+        column.reserve(expected);
+    }
+    for (auto &column : columns.integers) {
+        column.reserve(expected);
+    }
+    columns.stakeMarks.reserve(expected);
+    columns.excavationModes.reserve(expected);
+    columns.segmentNumbers.reserve(expected);
+
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.setForwardOnly(true);
+    query.prepare("SELECT id, excavation_time, mileage, chamber_pressure, thrust_force, cutter_speed, "
+                  "cutter_torque, excavation_speed, grouting_pressure, grouting_volume, excavation_distance, "
+                  "excavation_duration, idle_duration, fault_duration, "
+                  "stake_mark, excavation_mode, segment_number "
+                  "FROM excavation_parameters WHERE project_id = :projectId "
+                  "ORDER BY excavation_time, id");
+    query.bindValue(":projectId", projectId);
+
+    if (!query.exec()) {
+        lastError = "加载掘进参数列缓存失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return false;
+    }
+
+    // 按列序号读取，列顺序与 Field / IntegerField 枚举一致
+    while (query.next()) {
+        columns.ids.push_back(query.value(0).toInt());
+        columns.timeMs.push_back(EpochTime::toMs(query.value(1)));
+        for (int f = 0; f < FieldCount; ++f) {
+            columns.values[f].push_back(query.value(2 + f).toDouble());
+        }
+        for (int f = 0; f < IntegerFieldCount; ++f) {
+            columns.integers[f].push_back(query.value(2 + FieldCount + f).toLongLong());
+        }
+        int stringBase = 2 + FieldCount + IntegerFieldCount;
+        columns.stakeMarks.push_back(columns.dictionary.encode(query.value(stringBase).toString()));
+        columns.excavationModes.push_back(columns.dictionary.encode(query.value(stringBase + 1).toString()));
+        columns.segmentNumbers.push_back(columns.dictionary.encode(query.value(stringBase + 2).toString()));
+    }
+
+    qDebug() << "掘进参数列缓存已加载，项目ID:" << projectId << "行数:" << columns.size();
+    return true;
+}
+
+void ExcavationColumnCache::append(const ExcavationParameter &param)
+{
+    Row row;
+    row.id = param.getId();
+    row.timeMs = param.getExcavationTime().toMSecsSinceEpoch();
+    row.values[Mileage] = param.getMileage();
+    row.values[ChamberPressure] = param.getChamberPressure();
+    row.values[ThrustForce] = param.getThrustForce();
+    row.values[CutterSpeed] = param.getCutterSpeed();
+    row.values[CutterTorque] = param.getCutterTorque();
+    row.values[ExcavationSpeed] = param.getExcavationSpeed();
+    row.values[GroutingPressure] = param.getGroutingPressure();
+    row.values[GroutingVolume] = param.getGroutingVolume();
+    row.values[ExcavationDistance] = param.getExcavationDistance();
+    row.integers[ExcavationDuration] = param.getExcavationDuration();
+    row.integers[IdleDuration] = param.getIdleDuration();
+    row.integers[FaultDuration] = param.getFaultDuration();
+    row.stakeMark = param.getStakeMark();
+    row.excavationMode = param.getExcavationMode();
+    row.segmentNumber = param.getSegmentNumber();
+
+    appendRow(param.getProjectId(), row);
+}
+
+void ExcavationColumnCache::appendFromJson(int projectId, const QJsonObject &data)
+{
+    Row row;
+    row.timeMs = QDateTime::fromString(data["excavation_time"].toString(), Qt::ISODate).toMSecsSinceEpoch();
+    row.values[Mileage] = data["mileage"].toDouble();
+    row.values[ChamberPressure] = data["chamber_pressure"].toDouble();
+    row.values[ThrustForce] = data["thrust_force"].toDouble();
+    row.values[CutterSpeed] = data["cutter_speed"].toDouble();
+    row.values[CutterTorque] = data["cutter_torque"].toDouble();
+    row.values[ExcavationSpeed] = data["excavation_speed"].toDouble();
+    row.values[GroutingPressure] = data["grouting_pressure"].toDouble();
+    row.values[GroutingVolume] = data["grouting_volume"].toDouble();
+    row.values[ExcavationDistance] = data["excavation_distance"].toDouble();
+    row.integers[ExcavationDuration] = data["excavation_duration"].toInt();
+    row.integers[IdleDuration] = data["idle_duration"].toInt();
+    row.integers[FaultDuration] = data["fault_duration"].toInt();
+    row.stakeMark = data["stake_mark"].toString();
+    row.excavationMode = data["excavation_mode"].toString();
+    row.segmentNumber = data["segment_number"].toString();
+
+    appendRow(projectId, row);
+}
+
+void ExcavationColumnCache::appendRow(int projectId, const Row &row)
+{
+    auto it = projects.find(projectId);
+    if (it == projects.end()) {
+        return;
+    }
+
+    // 快照仍被调用方持有时先复制，已交出的数据保持不变
+    if (it.value().use_count() > 1) {
+        it.value() = std::make_shared<ProjectColumns>(*it.value());
+    }
+
+    ProjectColumns &columns = *it.value();
+    size_t bytesBefore = columns.memoryUsage();
+
+    // 实时数据通常按时间顺序到达，直接追加；乱序时插入到对应位置保持有序
+    size_t pos = columns.size();
+    if (pos > 0 && row.timeMs < columns.timeMs.back()) {
+        pos = std::upper_bound(columns.timeMs.begin(), columns.timeMs.end(), row.timeMs)
+              - columns.timeMs.begin();
+    }
+
+    auto insertAt = [pos](auto &column, auto value) {
+        column.insert(column.begin() + static_cast<std::ptrdiff_t>(pos), value);
+    };
+
+    insertAt(columns.ids, row.id);
+    insertAt(columns.timeMs, row.timeMs);
+    for (int f = 0; f < FieldCount; ++f) {
+        insertAt(columns.values[f], row.values[f]);
+    }
+    for (int f = 0; f < IntegerFieldCount; ++f) {
+        insertAt(columns.integers[f], row.integers[f]);
+    }
+    insertAt(columns.stakeMarks, columns.dictionary.encode(row.stakeMark));
+    insertAt(columns.excavationModes, columns.dictionary.encode(row.excavationMode));
+    insertAt(columns.segmentNumbers, columns.dictionary.encode(row.segmentNumber));
+
+    // 复制出的新快照容量等于行数，占用可能比原来小
+    usedBytes = usedBytes - bytesBefore + columns.memoryUsage();
+    evict(projectId);
+}
+
+void ExcavationColumnCache::invalidate(int projectId)
+{
+    auto it = projects.find(projectId);
+    if (it == projects.end()) {
+        return;
+    }
+
+    usedBytes -= it.value()->memoryUsage();
+    projects.erase(it);
+    lruOrder.removeAll(projectId);
+}
+
+void ExcavationColumnCache::clear()
+{
+    projects.clear();
+    lruOrder.clear();
+    usedBytes = 0;
+}
+
+void ExcavationColumnCache::setMemoryLimit(size_t bytes)
+{
+    memoryLimit = bytes;
+    evict(lruOrder.isEmpty() ? 0 : lruOrder.first());
+}
+
+size_t ExcavationColumnCache::memoryUsage() const
+{
+    return usedBytes;
+}
+
+void ExcavationColumnCache::touch(int projectId)
+{
+    lruOrder.removeAll(projectId);
+    lruOrder.prepend(projectId);
+}
+
+void ExcavationColumnCache::evict(int keepProjectId)
+{
+    // 从最久未使用的项目开始淘汰，正在使用的项目即使超限也保留
+    for (int i = lruOrder.size() - 1; i >= 0 && usedBytes > memoryLimit; --i) {
+        int projectId = lruOrder.at(i);
+        if (projectId == keepProjectId) {
+            continue;
+        }
+        usedBytes -= projects.value(projectId)->memoryUsage();
+        qDebug() << "掘进参数列缓存超出内存上限，淘汰项目:" << projectId;
+        projects.remove(projectId);
+        lruOrder.removeAt(i);
+    }
+}
+
+std::pair<size_t, size_t> ExcavationColumnCache::timeRange(const ProjectColumns &columns,
+                                                            const QDateTime &startTime,
+                                                            const QDateTime &endTime)
+{
+    auto first = std::lower_bound(columns.timeMs.begin(), columns.timeMs.end(), startTime.toMSecsSinceEpoch());
+    auto last = std::upper_bound(first, columns.timeMs.end(), endTime.toMSecsSinceEpoch());
+    return {static_cast<size_t>(first - columns.timeMs.begin()),
+            static_cast<size_t>(last - columns.timeMs.begin())};
+}
+
+ExcavationColumnCache::ColumnStats ExcavationColumnCache::aggregate(const ProjectColumns &columns,
+                                                                    Field field, size_t first, size_t last)
+{
+    last = std::min(last, columns.size());
+    if (first >= last) {
+        return ColumnStats();
+    }
+    return aggregateRange(columns.values[field].data() + first, last - first);
+}
+
+ExcavationColumnCache::ColumnStats ExcavationColumnCache::aggregate(const ProjectColumns &columns,
+                                                                    IntegerField field, size_t first, size_t last)
+{
+    last = std::min(last, columns.size());
+    if (first >= last) {
+        return ColumnStats();
+    }
+    return aggregateRange(columns.integers[field].data() + first, last - first);
+}
+
+ExcavationColumnCache::ColumnStats ExcavationColumnCache::aggregate(int projectId, Field field,
+                                                                    const QDateTime &startTime,
+                                                                    const QDateTime &endTime)
+{
+    std::shared_ptr<const ProjectColumns> columns = getProject(projectId);
+    if (!columns) {
+        return ColumnStats();
+    }
+
+    std::pair<size_t, size_t> range = timeRange(*columns, startTime, endTime);
+    return aggregate(*columns, field, range.first, range.second);
+}
@@ -0,0 +1,168 @@
+#ifndef EXCAVATIONCOLUMNCACHE_H
+#define EXCAVATIONCOLUMNCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+#include <QDateTime>
+#include <QJsonObject>
+#include <vector>
+#include <memory>
+#include <utility>
+
+class ExcavationParameter;
+
+/**
+ * @brief 项目掘进参数列式内存缓存
+ *
+ * 每个项目的掘进参数按列存放在连续数组中：时间为毫秒时间戳（qint64），
+ * 数值字段为 double/qint64 数组，桩号、掘进模式、管片编号做字典编码。
+ * 分析与统计直接在数组上做区间查找和聚合，不再逐行构造 ExcavationParameter。
+ *
+ * 项目首次访问时从数据库整体加载，之后由数据接收信号追加（未缓存的项目不追加，
+ * 下次访问时从数据库加载即包含新记录）；总内存超过上限时按最近最少使用淘汰其他项目。
+ * getProject() 返回的快照不会被修改：追加时若快照仍被持有，先复制再写入（写时复制）。
+ * 内存占用随加载、追加和淘汰增量维护。
+ * 仅在主线程使用。
+ */
+class ExcavationColumnCache
+{
+public:
+    // 浮点数值列
+    enum Field {
+        Mileage,
+        ChamberPressure,
+        ThrustForce,
+        CutterSpeed,
+        CutterTorque,
+        ExcavationSpeed,
+        GroutingPressure,
+        GroutingVolume,
+        ExcavationDistance,
+        FieldCount
+    };
+
+    // 整数数值列（分钟）
+    enum IntegerField {
+        ExcavationDuration,
+        IdleDuration,
+        FaultDuration,
+        IntegerFieldCount
+    };
+
+    /**
+     * @brief 字符串字典：每个不同的字符串只保存一份，列中存放编号
+     */
+    struct StringDictionary {
+        QStringList values;
+        QHash<QString, quint32> codes;
+        size_t bytes = 0;           // 估算的内存占用，随 encode() 增量累计
+
+        quint32 encode(const QString &value);
+        const QString &decode(quint32 code) const { return values.at(static_cast<int>(code)); }
+    };
+
+    /**
+     * @brief 一个项目的列数据，所有列按 (时间, id) 升序对齐
+     */
+    struct ProjectColumns {
+        int projectId = 0;
+        std::vector<int> ids;                           // 记录ID，信号追加的行为0
+        std::vector<qint64> timeMs;                     // 掘进时间（毫秒时间戳）
+        std::vector<double> values[FieldCount];
+        std::vector<qint64> integers[IntegerFieldCount];
+        std::vector<quint32> stakeMarks;
+        std::vector<quint32> excavationModes;
+        std::vector<quint32> segmentNumbers;
+        StringDictionary dictionary;                    // 三个字符串列共用
+
+        size_t size() const { return timeMs.size(); }
+        size_t memoryUsage() const;
+    };
+
+    /**
+     * @brief 列区间聚合结果
+     */
+    struct ColumnStats {
+        size_t count = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double sum = 0.0;
+
+        double mean() const { return count > 0 ? sum / count : 0.0; }
+    };
+
+    static ExcavationColumnCache& instance();
+
+    /**
+     * @brief 获取项目的列数据，未缓存时从数据库加载
+     * @return 加载失败返回空指针；返回的是只读快照，之后的追加和淘汰都不影响它
+     */
+    std::shared_ptr<const ProjectColumns> getProject(int projectId);
+
+    // 项目是否已缓存
+    bool contains(int projectId) const { return projects.contains(projectId); }
+
+    // 追加一条记录（项目未缓存时忽略，下次访问从数据库加载）
+    void append(const ExcavationParameter &param);
+
+    // 追加一条接口/模拟器上报的JSON记录，字段同 ApiServer 接收格式
+    void appendFromJson(int projectId, const QJsonObject &data);
+
+    // 丢弃项目缓存（明细被删除或归档后调用）
+    void invalidate(int projectId);
+
+    // 清空所有缓存
+    void clear();
+
+    // 内存上限（字节），默认256MB
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const { return memoryLimit; }
+    size_t memoryUsage() const;
+
+    // 时间区间 [start, end] 对应的行下标区间 [first, last)
+    static std::pair<size_t, size_t> timeRange(const ProjectColumns &columns,
+                                                const QDateTime &startTime,
+                                                const QDateTime &endTime);
+
+    // 对行区间 [first, last) 的某列求计数/最小/最大/和
+    static ColumnStats aggregate(const ProjectColumns &columns, Field field, size_t first, size_t last);
+    static ColumnStats aggregate(const ProjectColumns &columns, IntegerField field, size_t first, size_t last);
+
+    // 按时间区间聚合项目某列
+    ColumnStats aggregate(int projectId, Field field, const QDateTime &startTime, const QDateTime &endTime);
+
+    // 获取最后的错误信息
+    QString getLastError() const { return lastError; }
+
+private:
+    ExcavationColumnCache();
+    ExcavationColumnCache(const ExcavationColumnCache&) = delete;
+    ExcavationColumnCache& operator=(const ExcavationColumnCache&) = delete;
+
+    // 一行待写入的数据
+    struct Row {
+        int id = 0;
+        qint64 timeMs = 0;
+        double values[FieldCount] = {};
+        qint64 integers[IntegerFieldCount] = {};
+        QString stakeMark;
+        QString excavationMode;
+        QString segmentNumber;
+    };
+
+    bool loadProject(int projectId, ProjectColumns &columns);
+    void appendRow(int projectId, const Row &row);
+    void touch(int projectId);
+    void evict(int keepProjectId);
+
+private:
+    QHash<int, std::shared_ptr<ProjectColumns>> projects;
+    QList<int> lruOrder;        // 队首为最近使用
+    size_t memoryLimit;
+    size_t usedBytes;           // 所有缓存项目的内存占用
+    QString lastError;
+};
+
+#endif // EXCAVATIONCOLUMNCACHE_H
@@ -1,9 +1,16 @@
 #include "ExcavationParameterDAO.h"
 #include "DatabaseManager.h"
+#include "EpochTime.h"
+#include "ExcavationRollupDAO.h"
+#include "RetentionPolicyDAO.h"
+#include "DataSummaryDAO.h"
+#include "ExcavationColumnCache.h"
+#include "SqlQueryBuilder.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
 #include <QDebug>
+#include <algorithm>
 
 ExcavationParameterDAO::ExcavationParameterDAO()
 {
@@ -24,7 +31,7 @@ bool ExcavationParameterDAO::insertExcavationParameter(const ExcavationParameter
                   ":excavationDuration, :idleDuration, :faultDuration, :excavationDistance)");
     
     query.bindValue(":projectId", param.getProjectId());
-    query.bindValue(":excavationTime", param.getExcavationTime());
+    query.bindValue(":excavationTime", EpochTime::toMs(param.getExcavationTime()));
     query.bindValue(":stakeMark", param.getStakeMark());
     query.bindValue(":mileage", param.getMileage());
     query.bindValue(":excavationMode", param.getExcavationMode());
@@ -76,6 +83,14 @@ bool ExcavationParameterDAO::batchInsertExcavationParameters(const QList<Excavat
         return false;
     }
     
+    // 批量导入可能是乱序的历史数据，直接丢弃列缓存，下次访问重新加载
+    ExcavationColumnCache &cache = ExcavationColumnCache::instance();
+    for (const ExcavationParameter &param : params) {
+        if (cache.contains(param.getProjectId())) {
+            cache.invalidate(param.getProjectId());
+        }
+    }
+    
     return true;
 }
 
@@ -102,7 +117,7 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByProj
         ExcavationParameter param;
         param.setId(query.value("id").toInt());
         param.setProjectId(query.value("project_id").toInt());
-        param.setExcavationTime(query.value("excavation_time").toDateTime());
+        param.setExcavationTime(EpochTime::toDateTime(query.value("excavation_time")));
         param.setStakeMark(query.value("stake_mark").toString());
         param.setMileage(query.value("mileage").toDouble());
         param.setExcavationMode(query.value("excavation_mode").toString());
@@ -118,7 +133,7 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByProj
         param.setIdleDuration(query.value("idle_duration").toInt());
         param.setFaultDuration(query.value("fault_duration").toInt());
         param.setExcavationDistance(query.value("excavation_distance").toDouble());
-        param.setCreatedAt(query.value("created_at").toDateTime());
+        param.setCreatedAt(EpochTime::toDateTime(query.value("created_at")));
         
         params.append(param);
     }
@@ -142,8 +157,8 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByTime
                   "WHERE project_id = :projectId AND excavation_time BETWEEN :startTime AND :endTime "
                   "ORDER BY excavation_time DESC");
     query.bindValue(":projectId", projectId);
-    query.bindValue(":startTime", startTime);
-    query.bindValue(":endTime", endTime);
+    query.bindValue(":startTime", EpochTime::toMs(startTime));
+    query.bindValue(":endTime", EpochTime::toMs(endTime));
     
     if (!query.exec()) {
         lastError = "按时间范围查询掘进参数记录失败: " + query.lastError().text();
@@ -155,7 +170,7 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByTime
         ExcavationParameter param;
         param.setId(query.value("id").toInt());
         param.setProjectId(query.value("project_id").toInt());
-        param.setExcavationTime(query.value("excavation_time").toDateTime());
+        param.setExcavationTime(EpochTime::toDateTime(query.value("excavation_time")));
         param.setStakeMark(query.value("stake_mark").toString());
         param.setMileage(query.value("mileage").toDouble());
         param.setExcavationMode(query.value("excavation_mode").toString());
@@ -171,7 +186,7 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByTime
         param.setIdleDuration(query.value("idle_duration").toInt());
         param.setFaultDuration(query.value("fault_duration").toInt());
         param.setExcavationDistance(query.value("excavation_distance").toDouble());
-        param.setCreatedAt(query.value("created_at").toDateTime());
+        param.setCreatedAt(EpochTime::toDateTime(query.value("created_at")));
         
         params.append(param);
     }
@@ -208,7 +223,7 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByMile
         ExcavationParameter param;
         param.setId(query.value("id").toInt());
         param.setProjectId(query.value("project_id").toInt());
-        param.setExcavationTime(query.value("excavation_time").toDateTime());
+        param.setExcavationTime(EpochTime::toDateTime(query.value("excavation_time")));
         param.setStakeMark(query.value("stake_mark").toString());
         param.setMileage(query.value("mileage").toDouble());
         param.setExcavationMode(query.value("excavation_mode").toString());
@@ -224,7 +239,7 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByMile
         param.setIdleDuration(query.value("idle_duration").toInt());
         param.setFaultDuration(query.value("fault_duration").toInt());
         param.setExcavationDistance(query.value("excavation_distance").toDouble());
-        param.setCreatedAt(query.value("created_at").toDateTime());
+        param.setCreatedAt(EpochTime::toDateTime(query.value("created_at")));
         
         params.append(param);
     }
@@ -241,8 +256,8 @@ bool ExcavationParameterDAO::getLatestExcavationParameter(int projectId, Excavat
                   "excavation_speed, grouting_pressure, grouting_volume, segment_number, "
                   "excavation_duration, idle_duration, fault_duration, excavation_distance, created_at "
                   "FROM excavation_parameters "
-                  "WHERE project_id = :projectId "
-                  "ORDER BY excavation_time DESC LIMIT 1");
+                  "WHERE id = (SELECT latest_id FROM project_data_summary "
+                  "WHERE project_id = :projectId AND data_type = 'excavation')");
     query.bindValue(":projectId", projectId);
     
     if (!query.exec()) {
@@ -254,7 +269,7 @@ bool ExcavationParameterDAO::getLatestExcavationParameter(int projectId, Excavat
     if (query.next()) {
         param.setId(query.value("id").toInt());
         param.setProjectId(query.value("project_id").toInt());
-        param.setExcavationTime(query.value("excavation_time").toDateTime());
+        param.setExcavationTime(EpochTime::toDateTime(query.value("excavation_time")));
         param.setStakeMark(query.value("stake_mark").toString());
         param.setMileage(query.value("mileage").toDouble());
         param.setExcavationMode(query.value("excavation_mode").toString());
@@ -270,7 +285,7 @@ bool ExcavationParameterDAO::getLatestExcavationParameter(int projectId, Excavat
         param.setIdleDuration(query.value("idle_duration").toInt());
         param.setFaultDuration(query.value("fault_duration").toInt());
         param.setExcavationDistance(query.value("excavation_distance").toDouble());
-        param.setCreatedAt(query.value("created_at").toDateTime());
+        param.setCreatedAt(EpochTime::toDateTime(query.value("created_at")));
         return true;
     }
     
@@ -310,7 +325,7 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByPage
         ExcavationParameter param;
         param.setId(query.value("id").toInt());
         param.setProjectId(query.value("project_id").toInt());
-        param.setExcavationTime(query.value("excavation_time").toDateTime());
+        param.setExcavationTime(EpochTime::toDateTime(query.value("excavation_time")));
         param.setStakeMark(query.value("stake_mark").toString());
         param.setMileage(query.value("mileage").toDouble());
         param.setExcavationMode(query.value("excavation_mode").toString());
@@ -326,7 +341,7 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByPage
         param.setIdleDuration(query.value("idle_duration").toInt());
         param.setFaultDuration(query.value("fault_duration").toInt());
         param.setExcavationDistance(query.value("excavation_distance").toDouble());
-        param.setCreatedAt(query.value("created_at").toDateTime());
+        param.setCreatedAt(EpochTime::toDateTime(query.value("created_at")));
         
         params.append(param);
     }
@@ -334,11 +349,189 @@ QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByPage
     return params;
 }
 
+QList<ExcavationParameter> ExcavationParameterDAO::getExcavationParametersByCursor(
+    int projectId,
+    const PageCursor &cursor,
+    int pageSize,
+    PageDirection direction,
+    PageOrder order)
+{
+    QList<ExcavationParameter> params;
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    
+    // 时间按降序（最新在前），里程按升序；向后翻页时反转扫描方向
+    QString keyColumn = (order == PageOrder::ByMileage) ? "mileage" : "excavation_time";
+    bool descending = (order == PageOrder::ByTime);
+    if (direction == PageDirection::Backward) {
+        descending = !descending;
+    }
+    
+    QString sql = "SELECT id, project_id, excavation_time, stake_mark, mileage, excavation_mode, "
+                  "chamber_pressure, thrust_force, cutter_speed, cutter_torque, "
+                  "excavation_speed, grouting_pressure, grouting_volume, segment_number, "
+                  "excavation_duration, idle_duration, fault_duration, excavation_distance, created_at "
+                  "FROM excavation_parameters "
+                  "WHERE project_id = :projectId ";
+    if (cursor.isValid()) {
+        // 行值比较可直接利用 (project_id, 排序键, id) 复合索引定位
+        sql += QString("AND (%1, id) %2 (:cursorKey, :cursorId) ")
+                   .arg(keyColumn, descending ? "<" : ">");
+    }
+    sql += QString("ORDER BY %1 %2, id %2 LIMIT :limit")
+               .arg(keyColumn, descending ? "DESC" : "ASC");
+    
+    query.prepare(sql);
+    query.bindValue(":projectId", projectId);
+    if (cursor.isValid()) {
+        query.bindValue(":cursorKey", cursor.sortKey);
+        query.bindValue(":cursorId", cursor.id);
+    }
+    query.bindValue(":limit", pageSize);
+    
+    if (!query.exec()) {
+        lastError = "游标分页查询掘进参数记录失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return params;
+    }
+    
+    while (query.next()) {
+        params.append(readParameter(query));
+    }
+    
+    // 向后翻页按反向扫描，恢复为正常显示顺序
+    if (direction == PageDirection::Backward) {
+        std::reverse(params.begin(), params.end());
+    }
+    
+    return params;
+}
+
+QList<ExcavationParameterDAO::ExcavationRow> ExcavationParameterDAO::queryExcavationRows(const ExcavationQuery &filter)
+{
+    QList<ExcavationRow> rows;
+    
+    SqlQueryBuilder builder = filteredQuery(filter);
+    builder.select({"e.*", "p.project_name"});
+    QString keyColumn = (filter.order == PageOrder::ByMileage) ? "e.mileage" : "e.excavation_time";
+    
+    // 向后翻页时反转扫描方向，取游标之前最近的一批
+    bool backward = (filter.direction == PageDirection::Backward);
+    Qt::SortOrder scanOrder = filter.sortOrder;
+    if (backward) {
+        scanOrder = (scanOrder == Qt::DescendingOrder) ? Qt::AscendingOrder : Qt::DescendingOrder;
+    }
+    if (filter.after.isValid()) {
+        builder.where(QString("(%1, e.id) %2 (%3, %4)")
+                          .arg(keyColumn, scanOrder == Qt::DescendingOrder ? "<" : ">", "%1", "%2"),
+                      {filter.after.sortKey, filter.after.id});
+    }
+    builder.orderBy(keyColumn, scanOrder)
+        .orderBy("e.id", scanOrder)
+        .limit(filter.limit);
+    
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.setForwardOnly(true);
+    if (!builder.prepare(query) || !query.exec()) {
+        lastError = "按条件查询掘进参数记录失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return rows;
+    }
+    
+    while (query.next()) {
+        ExcavationRow row;
+        row.projectName = query.value("project_name").toString();
+        row.param = readParameter(query);
+        rows.append(row);
+    }
+    
+    // 恢复为正常显示顺序
+    if (backward) {
+        std::reverse(rows.begin(), rows.end());
+    }
+    
+    return rows;
+}
+
+QList<ExcavationParameterDAO::ExcavationGroupSummary> ExcavationParameterDAO::summarizeExcavationByProject(
+    const ExcavationQuery &filter)
+{
+    QList<ExcavationGroupSummary> summaries;
+    
+    SqlQueryBuilder builder = filteredQuery(filter);
+    builder.select({"e.project_id", "p.project_name", "COUNT(*) AS record_count",
+                    "MIN(e.excavation_time) AS first_time", "MAX(e.excavation_time) AS last_time",
+                    "MIN(e.mileage) AS min_mileage", "MAX(e.mileage) AS max_mileage",
+                    "AVG(e.chamber_pressure) AS avg_chamber_pressure", "AVG(e.thrust_force) AS avg_thrust_force",
+                    "AVG(e.cutter_speed) AS avg_cutter_speed", "AVG(e.cutter_torque) AS avg_cutter_torque"})
+        .groupBy({"e.project_id"})
+        .orderBy("e.project_id");
+    
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.setForwardOnly(true);
+    if (!builder.prepare(query) || !query.exec()) {
+        lastError = "统计掘进参数失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return summaries;
+    }
+    
+    while (query.next()) {
+        ExcavationGroupSummary summary;
+        summary.projectId = query.value("project_id").toInt();
+        summary.projectName = query.value("project_name").toString();
+        summary.recordCount = query.value("record_count").toInt();
+        summary.firstTime = EpochTime::toDateTime(query.value("first_time"));
+        summary.lastTime = EpochTime::toDateTime(query.value("last_time"));
+        summary.minMileage = query.value("min_mileage").toDouble();
+        summary.maxMileage = query.value("max_mileage").toDouble();
+        summary.avgChamberPressure = query.value("avg_chamber_pressure").toDouble();
+        summary.avgThrustForce = query.value("avg_thrust_force").toDouble();
+        summary.avgCutterSpeed = query.value("avg_cutter_speed").toDouble();
+        summary.avgCutterTorque = query.value("avg_cutter_torque").toDouble();
+        summaries.append(summary);
+    }
+    
+    return summaries;
+}
+
+SqlQueryBuilder ExcavationParameterDAO::filteredQuery(const ExcavationQuery &filter)
+{
+    SqlQueryBuilder builder("excavation_parameters e JOIN projects p ON p.project_id = e.project_id");
+    
+    if (!filter.projectIds.isEmpty()) {
+        QVariantList ids;
+        for (int projectId : filter.projectIds) {
+            ids << projectId;
+        }
+        builder.whereIn("e.project_id", ids);
+    }
+    
+    builder.whereBetween("e.excavation_time",
+                         filter.startTime.isValid() ? QVariant(EpochTime::toMs(filter.startTime)) : QVariant(),
+                         filter.endTime.isValid() ? QVariant(EpochTime::toMs(filter.endTime)) : QVariant());
+    builder.whereContains({"p.project_name", "e.stake_mark", "e.excavation_mode", "e.segment_number"},
+                          filter.keyword);
+    return builder;
+}
+
+PageCursor ExcavationParameterDAO::cursorFor(const ExcavationParameter &param, PageOrder order)
+{
+    PageCursor cursor;
+    cursor.id = param.getId();
+    if (order == PageOrder::ByMileage) {
+        cursor.sortKey = param.getMileage();
+    } else {
+        cursor.sortKey = EpochTime::toMs(param.getExcavationTime());
+    }
+    return cursor;
+}
+
 int ExcavationParameterDAO::getExcavationParametersCount(int projectId)
 {
     QSqlQuery query(DatabaseManager::instance().getDatabase());
     
-    query.prepare("SELECT COUNT(*) FROM excavation_parameters WHERE project_id = :projectId");
+    // 记录数由触发器维护在汇总表中，无需扫描明细表
+    query.prepare("SELECT row_count FROM project_data_summary "
+                  "WHERE project_id = :projectId AND data_type = 'excavation'");
     query.bindValue(":projectId", projectId);
     
     if (!query.exec()) {
@@ -354,18 +547,146 @@ int ExcavationParameterDAO::getExcavationParametersCount(int projectId)
     return 0;
 }
 
-bool ExcavationParameterDAO::deleteExcavationParametersByProjectId(int projectId)
+bool ExcavationParameterDAO::getExcavationStatistics(int projectId, ExcavationStatistics &stats)
 {
+    stats = ExcavationStatistics();
+    stats.projectId = projectId;
+    
     QSqlQuery query(DatabaseManager::instance().getDatabase());
     
-    query.prepare("DELETE FROM excavation_parameters WHERE project_id = :projectId");
+    query.prepare("SELECT record_count, total_excavation_minutes, total_idle_minutes, "
+                  "total_fault_minutes, total_distance "
+                  "FROM excavation_statistics WHERE project_id = :projectId");
     query.bindValue(":projectId", projectId);
     
     if (!query.exec()) {
-        lastError = "删除掘进参数记录失败: " + query.lastError().text();
+        lastError = "查询掘进累计统计失败: " + query.lastError().text();
         qWarning() << lastError;
         return false;
     }
     
+    if (query.next()) {
+        stats.recordCount = query.value("record_count").toInt();
+        stats.excavationMinutes = query.value("total_excavation_minutes").toLongLong();
+        stats.idleMinutes = query.value("total_idle_minutes").toLongLong();
+        stats.faultMinutes = query.value("total_fault_minutes").toLongLong();
+        stats.distance = query.value("total_distance").toDouble();
+    }
+    
     return true;
 }
+
+bool ExcavationParameterDAO::reconcileExcavationStatistics(int projectId)
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+    
+    if (!dbManager.rebuildExcavationStatistics(projectId)) {
+        lastError = "重新统计掘进累计数据失败: " + dbManager.getLastError();
+        return false;
+    }
+    
+    return true;
+}
+
+bool ExcavationParameterDAO::appendHighFrequencySample(const ExcavationParameter &param)
+{
+    ExcavationSegmentStore &store = ExcavationSegmentStore::instance();
+    
+    if (!store.append(param)) {
+        lastError = "追加高频采样失败: " + store.getLastError();
+        return false;
+    }
+    
+    return true;
+}
+
+QVector<ExcavationSegmentStore::RecordSpan> ExcavationParameterDAO::getHighFrequencySamplesByTimeRange(
+    int projectId,
+    const QDateTime &startTime,
+    const QDateTime &endTime)
+{
+    return ExcavationSegmentStore::instance().readTimeRange(projectId, startTime, endTime);
+}
+
+bool ExcavationParameterDAO::deleteExcavationParametersByProjectId(int projectId)
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+    QSqlQuery query(dbManager.getDatabase());
+    
+    // 整个项目的聚合随后一并清除，删除时不必逐行重新计算：与归档相同，用标记行豁免删除触发器
+    if (!dbManager.beginTransaction()) {
+        lastError = dbManager.getLastError();
+        return false;
+    }
+    
+    query.prepare(ExcavationRollupDAO::holdStatement());
+    query.addBindValue(projectId);
+    bool ok = query.exec();
+    
+    if (ok) {
+        query.prepare("DELETE FROM excavation_parameters WHERE project_id = :projectId");
+        query.bindValue(":projectId", projectId);
+        ok = query.exec();
+    }
+    
+    if (ok) {
+        query.prepare(ExcavationRollupDAO::releaseStatement());
+        query.addBindValue(projectId);
+        ok = query.exec();
+    }
+    
+    if (!ok) {
+        lastError = "删除掘进参数记录失败: " + query.lastError().text();
+        qWarning() << lastError;
+        dbManager.rollbackTransaction();
+        return false;
+    }
+    
+    if (!dbManager.commitTransaction()) {
+        lastError = dbManager.getLastError();
+        return false;
+    }
+    
+    // 删除项目数据时清除全部聚合（包括已归档明细对应的部分）
+    ExcavationRollupDAO rollupDao;
+    if (!rollupDao.deleteRollupsByProjectId(projectId)) {
+        lastError = rollupDao.getLastError();
+        return false;
+    }
+    
+    ExcavationColumnCache::instance().invalidate(projectId);
+    
+    // 已归档部分仍计入累计统计，删除项目数据时同时清除归档状态并重新统计（归档文件保留）
+    RetentionPolicyDAO retentionDao;
+    if (!retentionDao.clearArchiveState(projectId, DataSummaryDAO::TYPE_EXCAVATION)) {
+        lastError = retentionDao.getLastError();
+        return false;
+    }
+    
+    return reconcileExcavationStatistics(projectId);
+}
+
+ExcavationParameter ExcavationParameterDAO::readParameter(const QSqlQuery &query)
+{
+    ExcavationParameter param;
+    param.setId(query.value("id").toInt());
+    param.setProjectId(query.value("project_id").toInt());
+    param.setExcavationTime(EpochTime::toDateTime(query.value("excavation_time")));
+    param.setStakeMark(query.value("stake_mark").toString());
+    param.setMileage(query.value("mileage").toDouble());
+    param.setExcavationMode(query.value("excavation_mode").toString());
+    param.setChamberPressure(query.value("chamber_pressure").toDouble());
+    param.setThrustForce(query.value("thrust_force").toDouble());
+    param.setCutterSpeed(query.value("cutter_speed").toDouble());
+    param.setCutterTorque(query.value("cutter_torque").toDouble());
+    param.setExcavationSpeed(query.value("excavation_speed").toDouble());
+    param.setGroutingPressure(query.value("grouting_pressure").toDouble());
+    param.setGroutingVolume(query.value("grouting_volume").toDouble());
+    param.setSegmentNumber(query.value("segment_number").toString());
+    param.setExcavationDuration(query.value("excavation_duration").toInt());
+    param.setIdleDuration(query.value("idle_duration").toInt());
+    param.setFaultDuration(query.value("fault_duration").toInt());
+    param.setExcavationDistance(query.value("excavation_distance").toDouble());
+    param.setCreatedAt(EpochTime::toDateTime(query.value("created_at")));
+    return param;
+}
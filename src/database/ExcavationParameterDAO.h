@@ -2,9 +2,14 @@
 #define EXCAVATIONPARAMETERDAO_H
 
 #include "../models/ExcavationParameter.h"
+#include "PageCursor.h"
+#include "ExcavationSegmentStore.h"
 #include <QList>
 #include <QString>
 
+class QSqlQuery;
+class SqlQueryBuilder;
+
 /**
  * @brief 掘进参数数据访问对象
  * 
@@ -13,6 +18,66 @@
 class ExcavationParameterDAO
 {
 public:
+    /**
+     * @brief 项目掘进累计统计
+     *
+     * 由触发器在记录写入/删除时增量维护，持久化在 excavation_statistics 表中
+     */
+    struct ExcavationStatistics {
+        int projectId = 0;
+        int recordCount = 0;             // 记录数
+        qint64 excavationMinutes = 0;    // 累计掘进时长（分钟）
+        qint64 idleMinutes = 0;          // 累计闲置时长（分钟）
+        qint64 faultMinutes = 0;         // 累计故障时长（分钟）
+        double distance = 0.0;           // 累计掘进距离（米）
+        
+        // 故障时间占总时长的比例（%）
+        double faultRatio() const {
+            qint64 total = excavationMinutes + idleMinutes + faultMinutes;
+            return total > 0 ? static_cast<double>(faultMinutes) / total * 100.0 : 0.0;
+        }
+    };
+
+    /**
+     * @brief 管理表格的掘进参数查询条件（各条件之间为与关系）
+     */
+    struct ExcavationQuery {
+        QList<int> projectIds;                          // 为空表示全部项目
+        QDateTime startTime;                            // 无效表示不限
+        QDateTime endTime;                              // 无效表示不限
+        QString keyword;                                // 匹配项目名称、桩号、掘进模式、管片号
+        PageOrder order = PageOrder::ByTime;
+        Qt::SortOrder sortOrder = Qt::DescendingOrder;
+        int limit = 0;                                  // 0 表示不限制
+        PageCursor after;                               // 有效时只返回排序在该游标之后（Backward 时为之前）的记录
+        PageDirection direction = PageDirection::Forward; // Backward 时取游标之前最近的 limit 条，结果仍按排序方向排列
+    };
+
+    /**
+     * @brief 带项目名称的掘进参数记录
+     */
+    struct ExcavationRow {
+        QString projectName;
+        ExcavationParameter param;
+    };
+
+    /**
+     * @brief 按项目分组的掘进参数聚合
+     */
+    struct ExcavationGroupSummary {
+        int projectId = 0;
+        QString projectName;
+        int recordCount = 0;
+        QDateTime firstTime;
+        QDateTime lastTime;
+        double minMileage = 0.0;
+        double maxMileage = 0.0;
+        double avgChamberPressure = 0.0;
+        double avgThrustForce = 0.0;
+        double avgCutterSpeed = 0.0;
+        double avgCutterTorque = 0.0;
+    };
+
     ExcavationParameterDAO();
     ~ExcavationParameterDAO() = default;
 
@@ -63,6 +128,9 @@ public:
 
     /**
      * @brief 获取项目最新的掘进参数记录
+     *
+     * 通过汇总表中触发器维护的最新记录ID按主键读取
+     *
      * @param projectId 项目ID
      * @param param 输出参数
      * @return 是否查询成功
@@ -71,6 +139,10 @@ public:
 
     /**
      * @brief 分页查询掘进参数记录
+     *
+     * 基于OFFSET，页码越大代价越高；大数据量翻页请使用
+     * getExcavationParametersByCursor()
+     *
      * @param projectId 项目ID
      * @param page 页码（从1开始）
      * @param pageSize 每页记录数
@@ -81,6 +153,49 @@ public:
         int page, 
         int pageSize);
 
+    /**
+     * @brief 游标分页查询掘进参数记录
+     *
+     * 按 (excavation_time, id) 或 (mileage, id) 定位，任意页的代价与首页相同。
+     * 返回结果始终按排序方式的正序排列（时间降序 / 里程升序），
+     * 向后翻页时同样如此。
+     *
+     * @param projectId 项目ID
+     * @param cursor 当前页首行（Backward）或末行（Forward）的游标，无效游标表示从头/尾开始
+     * @param pageSize 每页记录数
+     * @param direction 翻页方向
+     * @param order 排序方式
+     * @return 掘进参数列表
+     */
+    QList<ExcavationParameter> getExcavationParametersByCursor(
+        int projectId,
+        const PageCursor &cursor,
+        int pageSize,
+        PageDirection direction = PageDirection::Forward,
+        PageOrder order = PageOrder::ByTime);
+
+    /**
+     * @brief 按条件查询多个项目的掘进参数（一次查询，附带项目名称）
+     * @param filter 查询条件
+     * @return 记录列表，按条件中的排序方式排列
+     */
+    QList<ExcavationRow> queryExcavationRows(const ExcavationQuery &filter);
+
+    /**
+     * @brief 按条件统计各项目的记录数、时间/里程范围与主要参数均值
+     * @param filter 查询条件（排序与 limit 不参与统计）
+     * @return 每个有记录的项目一项，按项目ID排列
+     */
+    QList<ExcavationGroupSummary> summarizeExcavationByProject(const ExcavationQuery &filter);
+
+    /**
+     * @brief 根据记录生成游标
+     * @param param 掘进参数记录（通常为一页的首行或末行）
+     * @param order 排序方式
+     * @return 游标
+     */
+    static PageCursor cursorFor(const ExcavationParameter &param, PageOrder order = PageOrder::ByTime);
+
     /**
      * @brief 获取项目掘进参数记录总数
      * @param projectId 项目ID
@@ -88,6 +203,40 @@ public:
      */
     int getExcavationParametersCount(int projectId);
 
+    /**
+     * @brief 获取项目掘进累计统计
+     * @param projectId 项目ID
+     * @param stats 输出参数，项目无记录时为全零
+     * @return 是否查询成功
+     */
+    bool getExcavationStatistics(int projectId, ExcavationStatistics &stats);
+
+    /**
+     * @brief 按明细记录重新统计项目的掘进累计数据（对账）
+     * @param projectId 项目ID
+     * @return 是否成功
+     */
+    bool reconcileExcavationStatistics(int projectId);
+
+    /**
+     * @brief 追加一条高频采样到段文件存储（不写入 excavation_parameters 表）
+     * @param param 掘进参数对象，只保存时间与数值字段
+     * @return 是否追加成功
+     */
+    bool appendHighFrequencySample(const ExcavationParameter &param);
+
+    /**
+     * @brief 按时间范围读取高频采样
+     * @param projectId 项目ID
+     * @param startTime 开始时间
+     * @param endTime 结束时间
+     * @return 指向段文件映射内存的记录区间（不拷贝），按时间升序
+     */
+    QVector<ExcavationSegmentStore::RecordSpan> getHighFrequencySamplesByTimeRange(
+        int projectId,
+        const QDateTime &startTime,
+        const QDateTime &endTime);
+
     /**
      * @brief 删除项目的所有掘进参数记录
      * @param projectId 项目ID
@@ -103,6 +252,12 @@ public:
 
 private:
     QString lastError;
+
+    // 从查询结果当前行读取掘进参数记录
+    static ExcavationParameter readParameter(const QSqlQuery &query);
+
+    // 按查询条件生成关联 projects 表的查询（e 为掘进参数表，p 为项目表）
+    static SqlQueryBuilder filteredQuery(const ExcavationQuery &filter);
 };
 
 #endif // EXCAVATIONPARAMETERDAO_H
@@ -0,0 +1,469 @@
+#include "ExcavationRollupDAO.h"
+#include "DatabaseManager.h"
+#include "EpochTime.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+// SQLite中由毫秒时间戳计算本地时间桶的表达式，与 bucketFormat() 的Qt格式一一对应
+QString sqliteBucketExpression(ExcavationRollupDAO::Resolution resolution, const QString &timeExpr)
+{
+    if (resolution == ExcavationRollupDAO::Resolution::Hour) {
+        return EpochTime::sqlLocalFormat("%Y-%m-%d %H:00", timeExpr);
+    }
+    return EpochTime::sqlLocalFormat("%Y-%m-%d %H:%M", timeExpr);
+}
+
+}
+
+double ExcavationRollupDAO::RollupPoint::variance() const
+{
+    if (count <= 0) {
+        return 0.0;
+    }
+    double m = mean();
+    return std::max(0.0, sumSquares / count - m * m);
+}
+
+ExcavationRollupDAO::ExcavationRollupDAO()
+{
+}
+
+const QStringList &ExcavationRollupDAO::numericFields()
+{
+    static const QStringList fields = {
+        "mileage", "chamber_pressure", "thrust_force", "cutter_speed", "cutter_torque",
+        "excavation_speed", "grouting_pressure", "grouting_volume",
+        "excavation_duration", "idle_duration", "fault_duration", "excavation_distance"
+    };
+    return fields;
+}
+
+QString ExcavationRollupDAO::resolutionName(Resolution resolution)
+{
+    switch (resolution) {
+    case Resolution::Minute: return "minute";
+    case Resolution::Hour:   return "hour";
+    case Resolution::Ring:   return "ring";
+    default:                 return "raw";
+    }
+}
+
+QString ExcavationRollupDAO::bucketFormat(Resolution resolution)
+{
+    return resolution == Resolution::Hour ? "yyyy-MM-dd HH:00" : "yyyy-MM-dd HH:mm";
+}
+
+QStringList ExcavationRollupDAO::schemaStatements()
+{
+    QStringList statements;
+
+    // 每个数值字段四列：最小、最大、和、平方和
+    QString fieldColumns;
+    for (const QString &field : numericFields()) {
+        fieldColumns += QString("            %1_min REAL,\n"
+                                "            %1_max REAL,\n"
+                                "            %1_sum REAL NOT NULL DEFAULT 0,\n"
+                                "            %1_sumsq REAL NOT NULL DEFAULT 0,\n").arg(field);
+    }
+
+    statements << QString(R"(
+        CREATE TABLE IF NOT EXISTS excavation_rollups (
+            project_id INTEGER NOT NULL,
+            resolution VARCHAR(10) NOT NULL,
+            bucket VARCHAR(50) NOT NULL,
+            sample_count INTEGER NOT NULL DEFAULT 0,
+            first_time INTEGER,
+            last_time INTEGER,
+%1            PRIMARY KEY (project_id, resolution, bucket)
+        )
+    )").arg(fieldColumns);
+
+    // 新记录写入时按三种粒度增量累加
+    QString fieldUpdates;
+    for (const QString &field : numericFields()) {
+        fieldUpdates += QString(
+            ", %1_min = CASE WHEN NEW.%1 IS NULL THEN %1_min "
+            "WHEN %1_min IS NULL OR NEW.%1 < %1_min THEN NEW.%1 ELSE %1_min END"
+            ", %1_max = CASE WHEN NEW.%1 IS NULL THEN %1_max "
+            "WHEN %1_max IS NULL OR NEW.%1 > %1_max THEN NEW.%1 ELSE %1_max END"
+            ", %1_sum = %1_sum + COALESCE(NEW.%1, 0)"
+            ", %1_sumsq = %1_sumsq + COALESCE(NEW.%1 * NEW.%1, 0)").arg(field);
+    }
+
+    const QString commonUpdate =
+        "UPDATE excavation_rollups SET sample_count = sample_count + 1"
+        ", first_time = CASE WHEN first_time IS NULL OR NEW.excavation_time < first_time "
+        "THEN NEW.excavation_time ELSE first_time END"
+        ", last_time = CASE WHEN last_time IS NULL OR NEW.excavation_time > last_time "
+        "THEN NEW.excavation_time ELSE last_time END" + fieldUpdates;
+
+    QString triggerBody;
+    for (Resolution resolution : {Resolution::Minute, Resolution::Hour}) {
+        QString bucket = sqliteBucketExpression(resolution, "NEW.excavation_time");
+        triggerBody += QString(
+            "INSERT OR IGNORE INTO excavation_rollups (project_id, resolution, bucket) "
+            "VALUES (NEW.project_id, '%1', %2); ").arg(resolutionName(resolution), bucket);
+        triggerBody += commonUpdate + QString(
+            " WHERE project_id = NEW.project_id AND resolution = '%1' AND bucket = %2; ")
+            .arg(resolutionName(resolution), bucket);
+    }
+    // 没有管片编号的记录不参与按环聚合
+    triggerBody +=
+        "INSERT OR IGNORE INTO excavation_rollups (project_id, resolution, bucket) "
+        "SELECT NEW.project_id, 'ring', NEW.segment_number "
+        "WHERE COALESCE(NEW.segment_number, '') <> ''; ";
+    triggerBody += commonUpdate +
+        " WHERE project_id = NEW.project_id AND resolution = 'ring' AND bucket = NEW.segment_number; ";
+
+    statements << "CREATE TRIGGER IF NOT EXISTS trg_excavation_rollup_insert "
+                  "AFTER INSERT ON excavation_parameters BEGIN " + triggerBody + "END";
+
+    // 明细修改时无法从最值中撤销旧值，按修改前后所在的桶从明细重新计算
+    QStringList updatedColumns = numericFields();
+    updatedColumns << "project_id" << "excavation_time" << "segment_number";
+    statements << "CREATE TRIGGER IF NOT EXISTS trg_excavation_rollup_update "
+                  "AFTER UPDATE OF " + updatedColumns.join(", ") + " ON excavation_parameters BEGIN "
+                  + recomputeStatements("OLD") + recomputeStatements("NEW") + "END";
+
+    // 明细删除时按被删记录所在的桶重新计算；归档删除由标记行豁免，聚合保持不变
+    statements << "CREATE TABLE IF NOT EXISTS excavation_rollup_holds ("
+                  "project_id INTEGER PRIMARY KEY)";
+    statements << "CREATE TRIGGER IF NOT EXISTS trg_excavation_rollup_delete "
+                  "AFTER DELETE ON excavation_parameters "
+                  "WHEN NOT EXISTS (SELECT 1 FROM excavation_rollup_holds WHERE project_id = OLD.project_id) "
+                  "BEGIN " + recomputeStatements("OLD") + "END";
+
+    // 项目本身删除时清除其聚合
+    statements << "CREATE TRIGGER IF NOT EXISTS trg_excavation_rollup_project_delete "
+                  "AFTER DELETE ON projects BEGIN "
+                  "DELETE FROM excavation_rollups WHERE project_id = OLD.project_id; END";
+
+    return statements;
+}
+
+QString ExcavationRollupDAO::holdStatement()
+{
+    return "INSERT OR IGNORE INTO excavation_rollup_holds (project_id) VALUES (?)";
+}
+
+QString ExcavationRollupDAO::releaseStatement()
+{
+    return "DELETE FROM excavation_rollup_holds WHERE project_id = ?";
+}
+
+QStringList ExcavationRollupDAO::rollupColumns()
+{
+    QStringList columns = {"project_id", "resolution", "bucket", "sample_count", "first_time", "last_time"};
+    for (const QString &field : numericFields()) {
+        columns << field + "_min" << field + "_max" << field + "_sum" << field + "_sumsq";
+    }
+    return columns;
+}
+
+QString ExcavationRollupDAO::rollupSelect(Resolution resolution, const QString &condition)
+{
+    QString aggregates;
+    for (const QString &field : numericFields()) {
+        aggregates += QString(", MIN(%1), MAX(%1), TOTAL(%1), TOTAL(%1 * %1)").arg(field);
+    }
+
+    QString bucket = (resolution == Resolution::Ring)
+                         ? QString("segment_number")
+                         : sqliteBucketExpression(resolution, "excavation_time");
+    return QString("SELECT project_id, '%1', %2, COUNT(*), MIN(excavation_time), MAX(excavation_time)")
+               .arg(resolutionName(resolution), bucket)
+           + aggregates
+           + QString(" FROM excavation_parameters WHERE excavation_time IS NOT NULL %1").arg(condition)
+           + (resolution == Resolution::Ring ? "AND COALESCE(segment_number, '') <> '' " : "")
+           + QString("GROUP BY project_id, %1").arg(bucket);
+}
+
+QString ExcavationRollupDAO::backfillStatement(int projectId)
+{
+    QString projectFilter = projectId > 0 ? QString("AND project_id = %1 ").arg(projectId) : QString();
+
+    QStringList selects;
+    for (Resolution resolution : {Resolution::Minute, Resolution::Hour, Resolution::Ring}) {
+        selects << rollupSelect(resolution, projectFilter);
+    }
+
+    // INSERT OR REPLACE：只覆盖明细仍存在的桶，已归档明细对应的聚合保留
+    return QString("INSERT OR REPLACE INTO excavation_rollups (%1) ").arg(rollupColumns().join(", "))
+           + selects.join(" UNION ALL ");
+}
+
+QString ExcavationRollupDAO::recomputeStatements(const QString &row)
+{
+    // 按 row（OLD 或 NEW）所在的桶从明细重新计算：先删除再按剩余明细插入，
+    // 记录移出某个桶后该桶不会残留旧值。时间条件限定在前后一小时内以利用索引。
+    const QString timeExpr = row + ".excavation_time";
+    const QString columns = rollupColumns().join(", ");
+
+    QString statements;
+    for (Resolution resolution : {Resolution::Minute, Resolution::Hour}) {
+        QString bucket = sqliteBucketExpression(resolution, timeExpr);
+        statements += QString(
+            "DELETE FROM excavation_rollups WHERE project_id = %1.project_id "
+            "AND resolution = '%2' AND bucket = %3; ").arg(row, resolutionName(resolution), bucket);
+        statements += QString("INSERT INTO excavation_rollups (%1) ").arg(columns)
+            + rollupSelect(resolution,
+                           QString("AND project_id = %1.project_id "
+                                   "AND excavation_time BETWEEN %2 - 3600000 AND %2 + 3600000 "
+                                   "AND %3 = %4 ")
+                               .arg(row, timeExpr, sqliteBucketExpression(resolution, "excavation_time"), bucket))
+            + "; ";
+    }
+    statements += QString(
+        "DELETE FROM excavation_rollups WHERE project_id = %1.project_id "
+        "AND resolution = 'ring' AND bucket = %1.segment_number; ").arg(row);
+    statements += QString("INSERT INTO excavation_rollups (%1) ").arg(columns)
+        + rollupSelect(Resolution::Ring,
+                       QString("AND project_id = %1.project_id AND segment_number = %1.segment_number ").arg(row))
+        + "; ";
+    return statements;
+}
+
+QVector<ExcavationRollupDAO::RollupPoint> ExcavationRollupDAO::downsample(const QVector<RollupPoint> &points,
+                                                                          int maxPoints)
+{
+    if (maxPoints <= 0 || points.size() <= maxPoints) {
+        return points;
+    }
+
+    // 相邻桶按固定个数合并，计数、和、平方和相加，最值取极值
+    const int group = (points.size() + maxPoints - 1) / maxPoints;
+    QVector<RollupPoint> merged;
+    merged.reserve((points.size() + group - 1) / group);
+    for (int i = 0; i < points.size(); i += group) {
+        RollupPoint point = points.at(i);
+        for (int j = i + 1; j < std::min(i + group, static_cast<int>(points.size())); ++j) {
+            const RollupPoint &next = points.at(j);
+            if (next.count <= 0) {
+                continue;
+            }
+            if (point.count <= 0) {
+                point.min = next.min;
+                point.max = next.max;
+            } else {
+                point.min = std::min(point.min, next.min);
+                point.max = std::max(point.max, next.max);
+            }
+            point.firstTime = std::min(point.firstTime, next.firstTime);
+            point.lastTime = std::max(point.lastTime, next.lastTime);
+            point.count += next.count;
+            point.sum += next.sum;
+            point.sumSquares += next.sumSquares;
+        }
+        merged.append(point);
+    }
+    return merged;
+}
+
+QVector<ExcavationRollupDAO::RollupPoint> ExcavationRollupDAO::queryTimeSeries(
+    int projectId,
+    const QString &field,
+    const QDateTime &startTime,
+    const QDateTime &endTime,
+    int maxPoints,
+    Resolution *usedResolution)
+{
+    QVector<RollupPoint> points;
+
+    if (!numericFields().contains(field)) {
+        lastError = "不支持的聚合字段: " + field;
+        qWarning() << lastError;
+        return points;
+    }
+
+    // 用小时聚合估算范围内原始记录数，代价只与小时数相关
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare("SELECT COALESCE(SUM(sample_count), 0) FROM excavation_rollups "
+                  "WHERE project_id = :projectId AND resolution = 'hour' "
+                  "AND bucket BETWEEN :startBucket AND :endBucket");
+    query.bindValue(":projectId", projectId);
+    query.bindValue(":startBucket", startTime.toString(bucketFormat(Resolution::Hour)));
+    query.bindValue(":endBucket", endTime.toString(bucketFormat(Resolution::Hour)));
+
+    if (!query.exec()) {
+        lastError = "估算趋势数据量失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return points;
+    }
+
+    qint64 rawCount = query.next() ? query.value(0).toLongLong() : 0;
+    qint64 minuteCount = std::min(rawCount, startTime.secsTo(endTime) / 60 + 1);
+
+    Resolution resolution = Resolution::Hour;
+    if (rawCount <= maxPoints) {
+        resolution = Resolution::Raw;
+    } else if (minuteCount <= maxPoints) {
+        resolution = Resolution::Minute;
+    }
+
+    if (usedResolution) {
+        *usedResolution = resolution;
+    }
+
+    if (resolution != Resolution::Raw) {
+        // 小时桶仍超出预算时再合并相邻桶
+        return downsample(queryRollups(projectId, field, resolution, startTime, endTime), maxPoints);
+    }
+
+    // 原始记录量在预算内，直接返回每条记录
+    query.prepare(QString("SELECT excavation_time, %1 FROM excavation_parameters "
+                          "WHERE project_id = :projectId "
+                          "AND excavation_time BETWEEN :startTime AND :endTime "
+                          "ORDER BY excavation_time, id").arg(field));
+    query.bindValue(":projectId", projectId);
+    query.bindValue(":startTime", EpochTime::toMs(startTime));
+    query.bindValue(":endTime", EpochTime::toMs(endTime));
+
+    if (!query.exec()) {
+        lastError = "查询原始趋势数据失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return points;
+    }
+
+    while (query.next()) {
+        RollupPoint point;
+        point.firstTime = EpochTime::toDateTime(query.value(0));
+        point.lastTime = point.firstTime;
+        point.bucket = point.firstTime.toString(bucketFormat(Resolution::Minute));
+        double value = query.value(1).toDouble();
+        point.count = 1;
+        point.min = value;
+        point.max = value;
+        point.sum = value;
+        point.sumSquares = value * value;
+        points.append(point);
+    }
+
+    return points;
+}
+
+QVector<ExcavationRollupDAO::RollupPoint> ExcavationRollupDAO::queryRollups(
+    int projectId,
+    const QString &field,
+    Resolution resolution,
+    const QDateTime &startTime,
+    const QDateTime &endTime)
+{
+    QVector<RollupPoint> points;
+
+    if (!numericFields().contains(field)) {
+        lastError = "不支持的聚合字段: " + field;
+        qWarning() << lastError;
+        return points;
+    }
+
+    if (resolution != Resolution::Minute && resolution != Resolution::Hour) {
+        lastError = "时间聚合只支持分钟或小时粒度";
+        qWarning() << lastError;
+        return points;
+    }
+
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare(QString("SELECT bucket, first_time, last_time, sample_count, "
+                          "%1_min, %1_max, %1_sum, %1_sumsq FROM excavation_rollups "
+                          "WHERE project_id = :projectId AND resolution = :resolution "
+                          "AND bucket BETWEEN :startBucket AND :endBucket "
+                          "ORDER BY bucket").arg(field));
+    query.bindValue(":projectId", projectId);
+    query.bindValue(":resolution", resolutionName(resolution));
+    query.bindValue(":startBucket", startTime.toString(bucketFormat(resolution)));
+    query.bindValue(":endBucket", endTime.toString(bucketFormat(resolution)));
+
+    if (!query.exec()) {
+        lastError = "查询聚合趋势数据失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return points;
+    }
+
+    while (query.next()) {
+        RollupPoint point;
+        point.bucket = query.value(0).toString();
+        point.firstTime = EpochTime::toDateTime(query.value(1));
+        point.lastTime = EpochTime::toDateTime(query.value(2));
+        point.count = query.value(3).toInt();
+        point.min = query.value(4).toDouble();
+        point.max = query.value(5).toDouble();
+        point.sum = query.value(6).toDouble();
+        point.sumSquares = query.value(7).toDouble();
+        points.append(point);
+    }
+
+    return points;
+}
+
+QVector<ExcavationRollupDAO::RollupPoint> ExcavationRollupDAO::queryByRing(int projectId, const QString &field,
+                                                                           int maxPoints)
+{
+    QVector<RollupPoint> points;
+
+    if (!numericFields().contains(field)) {
+        lastError = "不支持的聚合字段: " + field;
+        qWarning() << lastError;
+        return points;
+    }
+
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare(QString("SELECT bucket, first_time, last_time, sample_count, "
+                          "%1_min, %1_max, %1_sum, %1_sumsq FROM excavation_rollups "
+                          "WHERE project_id = :projectId AND resolution = 'ring' "
+                          "ORDER BY first_time, bucket").arg(field));
+    query.bindValue(":projectId", projectId);
+
+    if (!query.exec()) {
+        lastError = "查询按环聚合数据失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return points;
+    }
+
+    while (query.next()) {
+        RollupPoint point;
+        point.bucket = query.value(0).toString();
+        point.firstTime = EpochTime::toDateTime(query.value(1));
+        point.lastTime = EpochTime::toDateTime(query.value(2));
+        point.count = query.value(3).toInt();
+        point.min = query.value(4).toDouble();
+        point.max = query.value(5).toDouble();
+        point.sum = query.value(6).toDouble();
+        point.sumSquares = query.value(7).toDouble();
+        points.append(point);
+    }
+
+    return downsample(points, maxPoints);
+}
+
+bool ExcavationRollupDAO::deleteRollupsByProjectId(int projectId)
+{
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+
+    query.prepare("DELETE FROM excavation_rollups WHERE project_id = :projectId");
+    query.bindValue(":projectId", projectId);
+
+    if (!query.exec()) {
+        lastError = "删除聚合数据失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return false;
+    }
+
+    return true;
+}
+
+bool ExcavationRollupDAO::rebuildRollups(int projectId)
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    if (!dbManager.rebuildExcavationRollups(projectId)) {
+        lastError = "重建聚合数据失败: " + dbManager.getLastError();
+        return false;
+    }
+
+    return true;
+}
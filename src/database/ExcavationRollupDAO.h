@@ -0,0 +1,135 @@
+#ifndef EXCAVATIONROLLUPDAO_H
+#define EXCAVATIONROLLUPDAO_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QDateTime>
+
+/**
+ * @brief 掘进参数多分辨率聚合访问对象
+ *
+ * excavation_rollups 表按分钟、小时和管片环号（segment_number）三种粒度
+ * 保存 excavation_parameters 每个数值字段的 计数/最小/最大/和/平方和。
+ * 新记录写入时由触发器增量更新，明细修改或删除时由触发器按所在的桶从明细重新计算，
+ * 历史数据在建表时回填。归档删除明细前在 excavation_rollup_holds 中为项目写入标记行
+ * （见 holdStatement()），删除触发器跳过该项目，聚合保持不变，长期趋势始终可查。
+ *
+ * 趋势查询按点数预算自动选择满足预算的最细粒度：原始记录 → 分钟 → 小时，
+ * 小时桶仍超出预算时合并相邻桶，返回的点数不超过预算。
+ */
+class ExcavationRollupDAO
+{
+public:
+    /**
+     * @brief 聚合粒度
+     */
+    enum class Resolution {
+        Raw,        // 原始记录
+        Minute,     // 每分钟
+        Hour,       // 每小时
+        Ring        // 每环（管片编号）
+    };
+
+    /**
+     * @brief 一个聚合桶中某字段的统计值
+     */
+    struct RollupPoint {
+        QString bucket;          // 桶标识：时间桶为 "yyyy-MM-dd HH:mm"，环为管片编号
+        QDateTime firstTime;     // 桶内最早记录时间
+        QDateTime lastTime;      // 桶内最晚记录时间
+        int count = 0;           // 记录数
+        double min = 0.0;
+        double max = 0.0;
+        double sum = 0.0;
+        double sumSquares = 0.0;
+
+        double mean() const { return count > 0 ? sum / count : 0.0; }
+        double variance() const;
+    };
+
+    ExcavationRollupDAO();
+
+    /**
+     * @brief 按时间范围查询某字段的趋势
+     *
+     * 根据点数预算选择分辨率：原始记录数不超过预算时直接返回原始值
+     * （每点 count 为1），否则依次尝试分钟、小时聚合；小时桶超出预算时合并相邻桶。
+     *
+     * @param projectId 项目ID
+     * @param field 数值字段名，见 numericFields()
+     * @param startTime 开始时间
+     * @param endTime 结束时间
+     * @param maxPoints 点数预算
+     * @param usedResolution 输出实际使用的分辨率，可为空
+     * @return 按时间升序的统计点
+     */
+    QVector<RollupPoint> queryTimeSeries(int projectId,
+                                         const QString &field,
+                                         const QDateTime &startTime,
+                                         const QDateTime &endTime,
+                                         int maxPoints,
+                                         Resolution *usedResolution = nullptr);
+
+    /**
+     * @brief 查询指定分辨率的时间聚合
+     * @param resolution Minute 或 Hour
+     * @return 按时间升序的统计点
+     */
+    QVector<RollupPoint> queryRollups(int projectId,
+                                      const QString &field,
+                                      Resolution resolution,
+                                      const QDateTime &startTime,
+                                      const QDateTime &endTime);
+
+    /**
+     * @brief 查询按环聚合的统计（按环内最早时间排序）
+     * @param projectId 项目ID
+     * @param field 数值字段名
+     * @param maxPoints 点数预算，环数超出时合并相邻环，0 表示不限
+     * @return 每环（或每组相邻环）一个统计点
+     */
+    QVector<RollupPoint> queryByRing(int projectId, const QString &field, int maxPoints = 0);
+
+    // 合并相邻统计点，使点数不超过 maxPoints（桶标识取每组第一个）
+    static QVector<RollupPoint> downsample(const QVector<RollupPoint> &points, int maxPoints);
+
+    /**
+     * @brief 删除项目的所有聚合数据
+     */
+    bool deleteRollupsByProjectId(int projectId);
+
+    /**
+     * @brief 按现有明细记录重新计算项目的聚合（覆盖明细仍存在的桶）
+     */
+    bool rebuildRollups(int projectId);
+
+    // 参与聚合的数值字段
+    static const QStringList &numericFields();
+
+    // 建表、触发器与回填SQL，供 DatabaseManager 建库/升级时使用
+    static QStringList schemaStatements();
+    static QString backfillStatement(int projectId = 0);
+
+    // 写入/清除项目的删除豁免标记（绑定一个参数：项目ID）；须与删除明细在同一事务中，
+    // 其他连接看不到标记，只有本次删除不重新计算聚合
+    static QString holdStatement();
+    static QString releaseStatement();
+
+    QString getLastError() const { return lastError; }
+
+private:
+    QString lastError;
+
+    static QString resolutionName(Resolution resolution);
+    static QString bucketFormat(Resolution resolution);
+
+    // 聚合表的写入列，与 rollupSelect() 的结果列一一对应
+    static QStringList rollupColumns();
+    // 某粒度从明细计算聚合的SELECT，condition 为附加的 AND 条件
+    static QString rollupSelect(Resolution resolution, const QString &condition);
+    // 触发器中按 OLD/NEW 记录所在的桶重新计算聚合的语句
+    static QString recomputeStatements(const QString &row);
+};
+
+#endif // EXCAVATIONROLLUPDAO_H
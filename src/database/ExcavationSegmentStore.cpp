@@ -0,0 +1,747 @@
+#include "ExcavationSegmentStore.h"
+#include "DatabaseManager.h"
+#include "../models/ExcavationParameter.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+const quint32 SEGMENT_MAGIC = 0x53564553;          // "SVES"
+const quint32 SEGMENT_FOOTER_MAGIC = 0x53564546;   // "SVEF"
+const quint32 SEGMENT_VERSION = 1;
+
+// 新建段的初始容量与单次最大扩容（记录数）
+const qint64 INITIAL_CAPACITY = 64 * 1024;
+const qint64 MAX_GROWTH = 1024 * 1024;
+
+struct SegmentHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 recordSize;
+    qint32 projectId;
+    qint64 dayStartMs;
+    qint64 recordCount;     // 已完整写入的记录数
+    quint8 reserved[32];
+};
+
+struct IndexEntry {
+    qint64 minTime;
+    qint64 maxTime;
+    double minMileage;
+    double maxMileage;
+    quint32 firstRecord;
+    quint32 recordCount;
+};
+
+struct SegmentFooter {
+    quint32 magic;
+    quint32 indexCount;
+    qint64 recordCount;
+    qint64 indexOffset;
+    quint32 checksum;       // 覆盖索引区与页脚前24字节
+    quint32 reserved;
+};
+
+static_assert(sizeof(ExcavationSegmentStore::SegmentRecord) == 96, "段记录必须为定长96字节");
+static_assert(sizeof(SegmentHeader) == 64, "段文件头必须为64字节");
+static_assert(sizeof(SegmentFooter) == 32, "段文件页脚必须为32字节");
+
+quint32 footerChecksum(const QByteArray &indexBytes, const SegmentFooter &footer)
+{
+    QByteArray payload = indexBytes;
+    payload.append(reinterpret_cast<const char *>(&footer), offsetof(SegmentFooter, checksum));
+    return qChecksum(QByteArrayView(payload));
+}
+
+double recordMileage(const ExcavationSegmentStore::SegmentRecord &record)
+{
+    return record.values[ExcavationColumnCache::Mileage];
+}
+
+// 容量为 capacity 条记录的段文件大小：记录区之后预留索引与页脚的空间，封存时不必改变文件大小
+qint64 fileSizeFor(qint64 capacity, int blockSize)
+{
+    qint64 indexEntries = (capacity + blockSize - 1) / blockSize;
+    return static_cast<qint64>(sizeof(SegmentHeader)) + capacity * static_cast<qint64>(sizeof(ExcavationSegmentStore::SegmentRecord))
+           + indexEntries * static_cast<qint64>(sizeof(IndexEntry)) + static_cast<qint64>(sizeof(SegmentFooter));
+}
+
+// 给定文件大小能容纳的最大记录数
+qint64 capacityForSize(qint64 size, int blockSize)
+{
+    qint64 perRecord = sizeof(ExcavationSegmentStore::SegmentRecord);
+    qint64 capacity = std::max<qint64>(0, (size - static_cast<qint64>(sizeof(SegmentHeader) + sizeof(SegmentFooter))) / perRecord);
+    while (capacity > 0 && fileSizeFor(capacity, blockSize) > size) {
+        --capacity;
+    }
+    return capacity;
+}
+
+}
+
+/**
+ * @brief 单个段文件的映射与索引
+ *
+ * 读取方通过 acquireView() 持有映射视图，视图存在期间映射地址不变。
+ * 改变文件大小前必须先解除映射（Windows 不允许截断或扩展仍被映射的文件），
+ * 因此只在没有视图时扩容；有视图时新记录暂存在内存中，视图释放后再写入。
+ * 文件末尾预留了索引与页脚的空间，封存与重新追加都不需要改变文件大小。
+ */
+class ExcavationSegmentStore::Segment
+{
+public:
+    ~Segment()
+    {
+        // 最后一个视图释放时段对象才会销毁，此时可以写入暂存的记录
+        QString error;
+        if (!pending.isEmpty() && !flushPending(error)) {
+            qWarning() << "写入暂存的段记录失败:" << error;
+        }
+        unmap();
+    }
+
+    const SegmentRecord *records() const
+    {
+        return reinterpret_cast<const SegmentRecord *>(mapping + sizeof(SegmentHeader));
+    }
+
+    bool create(const QString &path, int project, const QDate &segmentDay, QString &error)
+    {
+        file.setFileName(path);
+        if (!file.open(QIODevice::ReadWrite)) {
+            error = "创建段文件失败: " + file.errorString();
+            return false;
+        }
+
+        projectId = project;
+        day = segmentDay;
+
+        if (!resizeFile(fileSizeFor(INITIAL_CAPACITY, INDEX_BLOCK_SIZE), error)) {
+            return false;
+        }
+        capacity = INITIAL_CAPACITY;
+
+        SegmentHeader *header = this->header();
+        std::memset(header, 0, sizeof(SegmentHeader));
+        header->magic = SEGMENT_MAGIC;
+        header->version = SEGMENT_VERSION;
+        header->recordSize = sizeof(SegmentRecord);
+        header->projectId = projectId;
+        header->dayStartMs = day.startOfDay().toMSecsSinceEpoch();
+        header->recordCount = 0;
+        return true;
+    }
+
+    bool open(const QString &path, QString &error)
+    {
+        file.setFileName(path);
+        if (!file.open(QIODevice::ReadWrite)) {
+            error = "打开段文件失败: " + file.errorString();
+            return false;
+        }
+
+        if (file.size() < static_cast<qint64>(sizeof(SegmentHeader)) || !map(error)) {
+            error = "段文件损坏: " + path;
+            return false;
+        }
+
+        const SegmentHeader *header = this->header();
+        if (header->magic != SEGMENT_MAGIC || header->version != SEGMENT_VERSION
+            || header->recordSize != sizeof(SegmentRecord)) {
+            error = "段文件格式不匹配: " + path;
+            return false;
+        }
+
+        projectId = header->projectId;
+        day = QDateTime::fromMSecsSinceEpoch(header->dayStartMs).date();
+
+        if (!loadFooter()) {
+            recover();
+        }
+        return true;
+    }
+
+    bool append(const SegmentRecord &record, QString &error)
+    {
+        if (sealed && !unseal(error)) {
+            return false;
+        }
+
+        qint64 lastTime = !pending.isEmpty() ? pending.last().timeMs
+                          : (recordCount > 0 ? records()[recordCount - 1].timeMs : record.timeMs);
+        if (record.timeMs < lastTime) {
+            error = "记录时间早于段内最后一条记录";
+            return false;
+        }
+
+        // 视图释放后先写入暂存的记录，保持时间顺序
+        if (!pending.isEmpty() && !hasViews() && !flushPending(error)) {
+            return false;
+        }
+
+        if (!pending.isEmpty() || (recordCount >= capacity && hasViews())) {
+            if (pending.isEmpty()) {
+                qWarning() << "段文件已满且仍有读取中的视图，新记录暂存在内存中:" << filePath();
+            }
+            pending.append(record);
+            return true;
+        }
+
+        return write(record, error);
+    }
+
+    bool seal(QString &error)
+    {
+        if (sealed) {
+            return true;
+        }
+
+        if (!pending.isEmpty() && (hasViews() || !flushPending(error))) {
+            if (error.isEmpty()) {
+                error = "段文件仍有读取中的视图，暂不能封存: " + filePath();
+            }
+            return false;
+        }
+
+        qint64 indexOffset = sizeof(SegmentHeader) + recordCount * sizeof(SegmentRecord);
+        qint64 indexSize = static_cast<qint64>(index.size()) * static_cast<qint64>(sizeof(IndexEntry));
+        qint64 sealedSize = indexOffset + indexSize + static_cast<qint64>(sizeof(SegmentFooter));
+        header()->recordCount = recordCount;
+
+        // 没有视图时截掉预分配的空闲容量；否则保留文件大小，页脚写在文件末尾
+        if (!hasViews() && file.size() != sealedSize) {
+            if (!resizeFile(sealedSize, error)) {
+                return false;
+            }
+        } else if (sealedSize > file.size()) {
+            error = "段文件预留空间不足且仍有读取中的视图，暂不能封存: " + filePath();
+            return false;
+        }
+
+        QByteArray indexBytes(reinterpret_cast<const char *>(index.constData()), static_cast<int>(indexSize));
+
+        SegmentFooter footer;
+        std::memset(&footer, 0, sizeof(footer));
+        footer.magic = SEGMENT_FOOTER_MAGIC;
+        footer.indexCount = static_cast<quint32>(index.size());
+        footer.recordCount = recordCount;
+        footer.indexOffset = indexOffset;
+        footer.checksum = footerChecksum(indexBytes, footer);
+
+        // 与记录一样经映射写入，先写索引再写页脚
+        std::memcpy(mapping + indexOffset, indexBytes.constData(), static_cast<size_t>(indexBytes.size()));
+        std::memcpy(mapping + file.size() - sizeof(SegmentFooter), &footer, sizeof(footer));
+
+        sealed = true;
+        return true;
+    }
+
+    // 时间区间对应的记录下标 [first, last)
+    std::pair<qint64, qint64> timeRange(qint64 startMs, qint64 endMs) const
+    {
+        // 先用索引定位块，再在块内二分
+        auto firstBlock = std::lower_bound(index.begin(), index.end(), startMs,
+                                           [](const IndexEntry &entry, qint64 t) { return entry.maxTime < t; });
+        auto lastBlock = std::upper_bound(firstBlock, index.end(), endMs,
+                                          [](qint64 t, const IndexEntry &entry) { return t < entry.minTime; });
+        if (firstBlock == lastBlock) {
+            return {0, 0};
+        }
+
+        const SegmentRecord *begin = records() + firstBlock->firstRecord;
+        const SegmentRecord *end = records() + (lastBlock - 1)->firstRecord + (lastBlock - 1)->recordCount;
+
+        const SegmentRecord *first = std::lower_bound(begin, end, startMs,
+            [](const SegmentRecord &record, qint64 t) { return record.timeMs < t; });
+        const SegmentRecord *last = std::upper_bound(first, end, endMs,
+            [](qint64 t, const SegmentRecord &record) { return t < record.timeMs; });
+        return {first - records(), last - records()};
+    }
+
+    /**
+     * @brief 获取映射视图
+     * 视图持有段对象，段对象只保存视图的弱引用；视图全部释放后才允许改变文件大小
+     */
+    std::shared_ptr<const void> acquireView(const std::shared_ptr<Segment> &self)
+    {
+        std::shared_ptr<const void> view = currentView.lock();
+        if (!view) {
+            view = std::make_shared<std::shared_ptr<Segment>>(self);
+            currentView = view;
+        }
+        return view;
+    }
+
+    bool hasViews() const { return !currentView.expired(); }
+
+    QString filePath() const { return file.fileName(); }
+
+    int projectId = 0;
+    QDate day;
+    qint64 recordCount = 0;
+    bool sealed = false;
+    QVector<IndexEntry> index;
+
+private:
+    SegmentHeader *header() const { return reinterpret_cast<SegmentHeader *>(mapping); }
+
+    bool map(QString &error)
+    {
+        mapping = file.map(0, file.size());
+        if (!mapping) {
+            error = "映射段文件失败: " + file.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    void unmap()
+    {
+        if (mapping) {
+            file.unmap(mapping);
+            mapping = nullptr;
+        }
+    }
+
+    // 解除映射后改变文件大小再重新映射，调用前须确认没有视图
+    bool resizeFile(qint64 size, QString &error)
+    {
+        unmap();
+        if (!file.resize(size)) {
+            error = "调整段文件大小失败: " + file.errorString();
+            map(error);
+            return false;
+        }
+        return map(error);
+    }
+
+    bool write(const SegmentRecord &record, QString &error)
+    {
+        if (recordCount >= capacity && !grow(error)) {
+            return false;
+        }
+
+        SegmentRecord *target = reinterpret_cast<SegmentRecord *>(mapping + sizeof(SegmentHeader)) + recordCount;
+        std::memcpy(target, &record, sizeof(SegmentRecord));
+
+        // 记录写完后再更新记录数，崩溃时最后一条不完整的记录不会被计入
+        ++recordCount;
+        header()->recordCount = recordCount;
+
+        updateIndex(recordCount - 1, record);
+        return true;
+    }
+
+    bool flushPending(QString &error)
+    {
+        while (!pending.isEmpty()) {
+            if (!write(pending.first(), error)) {
+                return false;
+            }
+            pending.removeFirst();
+        }
+        return true;
+    }
+
+    bool grow(QString &error)
+    {
+        qint64 newCapacity = capacity + std::clamp(capacity, INITIAL_CAPACITY, MAX_GROWTH);
+        if (!resizeFile(fileSizeFor(newCapacity, INDEX_BLOCK_SIZE), error)) {
+            error = "扩展段文件失败: " + error;
+            return false;
+        }
+        capacity = newCapacity;
+        return true;
+    }
+
+    // 校验页脚，通过则加载索引并视为已封存
+    bool loadFooter()
+    {
+        qint64 size = file.size();
+        if (size < static_cast<qint64>(sizeof(SegmentHeader) + sizeof(SegmentFooter))) {
+            return false;
+        }
+
+        SegmentFooter footer;
+        std::memcpy(&footer, mapping + size - sizeof(SegmentFooter), sizeof(footer));
+
+        // 索引紧接记录区，页脚在文件末尾，二者之间可以有未截断的预留空间
+        qint64 indexBytesSize = static_cast<qint64>(footer.indexCount) * sizeof(IndexEntry);
+        if (footer.magic != SEGMENT_FOOTER_MAGIC
+            || footer.indexOffset != static_cast<qint64>(sizeof(SegmentHeader) + footer.recordCount * sizeof(SegmentRecord))
+            || footer.indexOffset + indexBytesSize + static_cast<qint64>(sizeof(SegmentFooter)) > size) {
+            return false;
+        }
+
+        QByteArray indexBytes(reinterpret_cast<const char *>(mapping + footer.indexOffset),
+                              static_cast<int>(indexBytesSize));
+        if (footerChecksum(indexBytes, footer) != footer.checksum) {
+            return false;
+        }
+
+        recordCount = footer.recordCount;
+        capacity = std::max(recordCount, capacityForSize(size, INDEX_BLOCK_SIZE));
+        index.resize(static_cast<int>(footer.indexCount));
+        std::memcpy(index.data(), indexBytes.constData(), indexBytes.size());
+        sealed = true;
+        return true;
+    }
+
+    // 未封存（写入中或崩溃）的段：按文件头记录数恢复并重建索引
+    void recover()
+    {
+        qint64 available = (file.size() - static_cast<qint64>(sizeof(SegmentHeader))) / sizeof(SegmentRecord);
+        recordCount = std::clamp(header()->recordCount, qint64(0), available);
+        header()->recordCount = recordCount;
+        capacity = std::max(recordCount, capacityForSize(file.size(), INDEX_BLOCK_SIZE));
+        sealed = false;
+
+        index.clear();
+        for (qint64 i = 0; i < recordCount; ++i) {
+            updateIndex(i, records()[i]);
+        }
+    }
+
+    // 已封存的段重新追加：作废页脚回到写入状态，索引区与页脚所在空间之后会被记录覆盖
+    bool unseal(QString &error)
+    {
+        Q_UNUSED(error);
+        std::memset(mapping + file.size() - sizeof(SegmentFooter), 0, sizeof(SegmentFooter));
+        sealed = false;
+        capacity = std::max(recordCount, capacityForSize(file.size(), INDEX_BLOCK_SIZE));
+        return true;
+    }
+
+    void updateIndex(qint64 recordIndex, const SegmentRecord &record)
+    {
+        double mileage = recordMileage(record);
+        if (recordIndex % INDEX_BLOCK_SIZE == 0) {
+            IndexEntry entry;
+            entry.minTime = record.timeMs;
+            entry.maxTime = record.timeMs;
+            entry.minMileage = mileage;
+            entry.maxMileage = mileage;
+            entry.firstRecord = static_cast<quint32>(recordIndex);
+            entry.recordCount = 1;
+            index.append(entry);
+            return;
+        }
+
+        IndexEntry &entry = index.last();
+        entry.maxTime = record.timeMs;
+        entry.minMileage = std::min(entry.minMileage, mileage);
+        entry.maxMileage = std::max(entry.maxMileage, mileage);
+        ++entry.recordCount;
+    }
+
+    QFile file;
+    uchar *mapping = nullptr;
+    qint64 capacity = 0;
+    QVector<SegmentRecord> pending;         // 有视图时无法扩容，暂存的新记录
+    std::weak_ptr<const void> currentView;
+};
+
+ExcavationSegmentStore::ExcavationSegmentStore()
+{
+}
+
+ExcavationSegmentStore& ExcavationSegmentStore::instance()
+{
+    static ExcavationSegmentStore store;
+    return store;
+}
+
+QString ExcavationSegmentStore::segmentDirectory(int projectId)
+{
+    return QString("%1/data/segments/project_%2").arg(QCoreApplication::applicationDirPath()).arg(projectId);
+}
+
+ExcavationSegmentStore::SegmentRecord ExcavationSegmentStore::toRecord(const ExcavationParameter &param)
+{
+    SegmentRecord record;
+    record.timeMs = param.getExcavationTime().toMSecsSinceEpoch();
+    record.values[ExcavationColumnCache::Mileage] = param.getMileage();
+    record.values[ExcavationColumnCache::ChamberPressure] = param.getChamberPressure();
+    record.values[ExcavationColumnCache::ThrustForce] = param.getThrustForce();
+    record.values[ExcavationColumnCache::CutterSpeed] = param.getCutterSpeed();
+    record.values[ExcavationColumnCache::CutterTorque] = param.getCutterTorque();
+    record.values[ExcavationColumnCache::ExcavationSpeed] = param.getExcavationSpeed();
+    record.values[ExcavationColumnCache::GroutingPressure] = param.getGroutingPressure();
+    record.values[ExcavationColumnCache::GroutingVolume] = param.getGroutingVolume();
+    record.values[ExcavationColumnCache::ExcavationDistance] = param.getExcavationDistance();
+    record.integers[ExcavationColumnCache::ExcavationDuration] = param.getExcavationDuration();
+    record.integers[ExcavationColumnCache::IdleDuration] = param.getIdleDuration();
+    record.integers[ExcavationColumnCache::FaultDuration] = param.getFaultDuration();
+    return record;
+}
+
+bool ExcavationSegmentStore::append(const ExcavationParameter &param)
+{
+    return append(param.getProjectId(), toRecord(param));
+}
+
+bool ExcavationSegmentStore::append(int projectId, const SegmentRecord &record)
+{
+    QDate day = QDateTime::fromMSecsSinceEpoch(record.timeMs).date();
+
+    std::shared_ptr<Segment> segment = activeSegments.value(projectId);
+    if (segment && segment->day != day) {
+        if (day < segment->day) {
+            lastError = "记录日期早于当前写入的段文件";
+            qWarning() << lastError;
+            return false;
+        }
+
+        // 跨天：封存前一天的段，之后只读；仍有视图而无法封存时在下次读取时封存
+        if (segment->seal(lastError)) {
+            saveSegmentInfo(*segment);
+        } else {
+            qWarning() << lastError;
+        }
+        activeSegments.remove(projectId);
+        segment.reset();
+    }
+
+    if (!segment) {
+        segment = writableSegment(projectId, day);
+        if (!segment) {
+            return false;
+        }
+    }
+
+    if (!segment->append(record, lastError)) {
+        qWarning() << "追加段记录失败:" << lastError;
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<ExcavationSegmentStore::Segment> ExcavationSegmentStore::writableSegment(int projectId, const QDate &day)
+{
+    QString dirPath = segmentDirectory(projectId);
+    if (!QDir().mkpath(dirPath)) {
+        lastError = "创建段文件目录失败: " + dirPath;
+        qWarning() << lastError;
+        return nullptr;
+    }
+
+    QString path = QString("%1/%2.seg").arg(dirPath, day.toString("yyyyMMdd"));
+
+    // 当天的段已存在（如程序重启）时恢复后继续追加
+    std::shared_ptr<Segment> segment = openSegments.value(path);
+    if (!segment) {
+        segment = std::make_shared<Segment>();
+        bool ok = QFile::exists(path) ? segment->open(path, lastError)
+                                      : segment->create(path, projectId, day, lastError);
+        if (!ok) {
+            qWarning() << lastError;
+            return nullptr;
+        }
+        openSegments.insert(path, segment);
+        openOrder.append(path);
+    }
+
+    activeSegments.insert(projectId, segment);
+    evictOpenSegments();
+    saveSegmentInfo(*segment);
+    return segment;
+}
+
+std::shared_ptr<ExcavationSegmentStore::Segment> ExcavationSegmentStore::readableSegment(const QString &filePath)
+{
+    std::shared_ptr<Segment> segment = openSegments.value(filePath);
+    if (!segment) {
+        segment = std::make_shared<Segment>();
+        if (!segment->open(filePath, lastError)) {
+            qWarning() << lastError;
+            return nullptr;
+        }
+
+        openSegments.insert(filePath, segment);
+        openOrder.append(filePath);
+        evictOpenSegments();
+    }
+
+    // 往日未封存的段：上次写入时程序异常退出，或跨天时仍有视图未能封存
+    if (!segment->sealed && segment->day < QDate::currentDate()
+        && activeSegments.value(segment->projectId) != segment) {
+        if (segment->seal(lastError)) {
+            qInfo() << "已封存段文件:" << filePath << "记录数:" << segment->recordCount;
+            saveSegmentInfo(*segment);
+        } else {
+            qWarning() << lastError;
+        }
+    }
+
+    return segment;
+}
+
+void ExcavationSegmentStore::evictOpenSegments()
+{
+    // 从最早打开的段开始释放，写入中的段跳过；已返回的区间仍由调用方的视图持有
+    for (int i = 0; i < openOrder.size() && openOrder.size() > MAX_OPEN_SEGMENTS;) {
+        std::shared_ptr<Segment> segment = openSegments.value(openOrder.at(i));
+        if (segment && activeSegments.value(segment->projectId) == segment) {
+            ++i;
+            continue;
+        }
+        openSegments.remove(openOrder.takeAt(i));
+    }
+}
+
+QList<std::shared_ptr<ExcavationSegmentStore::Segment>> ExcavationSegmentStore::candidateSegments(
+    int projectId, const QString &condition, const QVariant &low, const QVariant &high)
+{
+    QList<std::shared_ptr<Segment>> segments;
+
+    // 未封存的段登记信息可能滞后，总是纳入
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare(QString("SELECT file_path FROM excavation_segments "
+                          "WHERE project_id = :projectId AND (sealed = 0 OR (%1)) "
+                          "ORDER BY segment_day").arg(condition));
+    query.bindValue(":projectId", projectId);
+    query.bindValue(":low", low);
+    query.bindValue(":high", high);
+
+    if (!query.exec()) {
+        lastError = "查询段文件登记失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return segments;
+    }
+
+    QStringList paths;
+    while (query.next()) {
+        paths << query.value(0).toString();
+    }
+
+    for (const QString &path : paths) {
+        std::shared_ptr<Segment> segment = readableSegment(path);
+        if (segment) {
+            segments.append(segment);
+        }
+    }
+
+    return segments;
+}
+
+QVector<ExcavationSegmentStore::RecordSpan> ExcavationSegmentStore::readTimeRange(
+    int projectId, const QDateTime &startTime, const QDateTime &endTime)
+{
+    QVector<RecordSpan> spans;
+    qint64 startMs = startTime.toMSecsSinceEpoch();
+    qint64 endMs = endTime.toMSecsSinceEpoch();
+
+    const auto segments = candidateSegments(projectId, "max_time_ms >= :low AND min_time_ms <= :high",
+                                            startMs, endMs);
+    for (const std::shared_ptr<Segment> &segment : segments) {
+        std::pair<qint64, qint64> range = segment->timeRange(startMs, endMs);
+        if (range.second > range.first) {
+            RecordSpan span;
+            span.records = segment->records() + range.first;
+            span.count = static_cast<size_t>(range.second - range.first);
+            span.owner = segment->acquireView(segment);
+            spans.append(span);
+        }
+    }
+
+    return spans;
+}
+
+bool ExcavationSegmentStore::sealAll()
+{
+    bool ok = true;
+    for (const std::shared_ptr<Segment> &segment : std::as_const(activeSegments)) {
+        if (segment->seal(lastError)) {
+            saveSegmentInfo(*segment);
+        } else {
+            qWarning() << lastError;
+            ok = false;
+        }
+    }
+    activeSegments.clear();
+    return ok;
+}
+
+bool ExcavationSegmentStore::saveSegmentInfo(const Segment &segment)
+{
+    qint64 minTime = 0;
+    qint64 maxTime = 0;
+    double minMileage = 0.0;
+    double maxMileage = 0.0;
+    if (!segment.index.isEmpty()) {
+        minTime = segment.index.first().minTime;
+        maxTime = segment.index.last().maxTime;
+        minMileage = segment.index.first().minMileage;
+        maxMileage = segment.index.first().maxMileage;
+        for (const IndexEntry &entry : segment.index) {
+            minMileage = std::min(minMileage, entry.minMileage);
+            maxMileage = std::max(maxMileage, entry.maxMileage);
+        }
+    }
+
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare("INSERT OR REPLACE INTO excavation_segments "
+                  "(project_id, segment_day, file_path, record_count, min_time_ms, max_time_ms, "
+                  "min_mileage, max_mileage, sealed, updated_at) "
+                  "VALUES (:projectId, :segmentDay, :filePath, :recordCount, :minTime, :maxTime, "
+                  ":minMileage, :maxMileage, :sealed, CURRENT_TIMESTAMP)");
+    query.bindValue(":projectId", segment.projectId);
+    query.bindValue(":segmentDay", segment.day.toString("yyyyMMdd"));
+    query.bindValue(":filePath", segment.filePath());
+    query.bindValue(":recordCount", segment.recordCount);
+    query.bindValue(":minTime", minTime);
+    query.bindValue(":maxTime", maxTime);
+    query.bindValue(":minMileage", minMileage);
+    query.bindValue(":maxMileage", maxMileage);
+    query.bindValue(":sealed", segment.sealed ? 1 : 0);
+
+    if (!query.exec()) {
+        lastError = "登记段文件失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return false;
+    }
+
+    return true;
+}
+
+QList<ExcavationSegmentStore::SegmentInfo> ExcavationSegmentStore::getSegments(int projectId)
+{
+    QList<SegmentInfo> segments;
+
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare("SELECT project_id, segment_day, file_path, record_count, min_time_ms, max_time_ms, "
+                  "min_mileage, max_mileage, sealed FROM excavation_segments "
+                  "WHERE project_id = :projectId ORDER BY segment_day");
+    query.bindValue(":projectId", projectId);
+
+    if (!query.exec()) {
+        lastError = "查询段文件登记失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return segments;
+    }
+
+    while (query.next()) {
+        SegmentInfo info;
+        info.projectId = query.value("project_id").toInt();
+        info.day = QDate::fromString(query.value("segment_day").toString(), "yyyyMMdd");
+        info.filePath = query.value("file_path").toString();
+        info.recordCount = query.value("record_count").toLongLong();
+        info.minTime = QDateTime::fromMSecsSinceEpoch(query.value("min_time_ms").toLongLong());
+        info.maxTime = QDateTime::fromMSecsSinceEpoch(query.value("max_time_ms").toLongLong());
+        info.minMileage = query.value("min_mileage").toDouble();
+        info.maxMileage = query.value("max_mileage").toDouble();
+        info.sealed = query.value("sealed").toBool();
+        segments.append(info);
+    }
+
+    return segments;
+}
@@ -0,0 +1,137 @@
+#ifndef EXCAVATIONSEGMENTSTORE_H
+#define EXCAVATIONSEGMENTSTORE_H
+
+#include "ExcavationColumnCache.h"
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QVector>
+#include <QDate>
+#include <QDateTime>
+#include <QVariant>
+#include <memory>
+
+class ExcavationParameter;
+
+/**
+ * @brief 高频掘进时序的段文件存储
+ *
+ * 面向 100Hz 级别的数值通道，SQLite 逐行存储开销过大。每个项目每天一个
+ * 只追加的段文件（data/segments/project_<id>/yyyyMMdd.seg），记录为定长结构，
+ * 通过内存映射直接写入与读取，读取结果是指向映射内存的记录区间，不做拷贝。
+ * 由 ApiServer 的 /api/excavation/samples 接口写入，趋势图的高频模式读取，程序退出时封存。
+ *
+ * 段文件布局：
+ *   [文件头][记录 × N][空闲容量][索引与页脚预留]        写入中
+ *   [文件头][记录 × N][稀疏索引]([预留])[页脚]            已封存
+ * 稀疏索引每 INDEX_BLOCK_SIZE 条记录一项，保存该块的时间与里程范围，
+ * 段的里程范围登记在库中用于筛选段文件。
+ * 返回的区间持有段的映射视图，视图存在期间不改变文件大小（Windows 不允许调整仍被映射的文件）：
+ * 段已满时新记录暂存在内存中，视图释放后写入；封存只写入预留空间，没有视图时才截掉空闲容量。
+ * 写入中的段在每条记录写完后才更新文件头中的记录数，进程崩溃后按记录数恢复并重建索引；
+ * 页脚带校验和，只有校验通过才视为已封存。跨天或调用 sealAll() 时封存。
+ *
+ * 段文件的项目、日期、记录数与时间/里程范围登记在 SQLite 的 excavation_segments 表中，
+ * 查询时先按该表筛选段文件。同一段内记录时间必须非递减。仅在主线程使用。
+ */
+class ExcavationSegmentStore
+{
+public:
+    /**
+     * @brief 定长记录（96字节），数值列顺序与 ExcavationColumnCache 的枚举一致
+     */
+    struct SegmentRecord {
+        qint64 timeMs = 0;
+        double values[ExcavationColumnCache::FieldCount] = {};
+        qint32 integers[ExcavationColumnCache::IntegerFieldCount] = {};
+        qint32 reserved = 0;
+    };
+
+    /**
+     * @brief 指向段文件映射内存的连续记录区间
+     * owner 持有段文件的映射视图，区间在 owner 存活期间有效；应尽快释放，
+     * 持有期间写入中的段无法扩容
+     */
+    struct RecordSpan {
+        const SegmentRecord *records = nullptr;
+        size_t count = 0;
+        std::shared_ptr<const void> owner;
+    };
+
+    /**
+     * @brief SQLite 中登记的段文件信息
+     */
+    struct SegmentInfo {
+        int projectId = 0;
+        QDate day;
+        QString filePath;
+        qint64 recordCount = 0;
+        QDateTime minTime;
+        QDateTime maxTime;
+        double minMileage = 0.0;
+        double maxMileage = 0.0;
+        bool sealed = false;
+    };
+
+    static ExcavationSegmentStore& instance();
+
+    // 追加一条记录到项目当天的段文件
+    bool append(int projectId, const SegmentRecord &record);
+    bool append(const ExcavationParameter &param);
+
+    // 按掘进参数构造定长记录
+    static SegmentRecord toRecord(const ExcavationParameter &param);
+
+    // 读取时间区间 [startTime, endTime] 内的记录，按时间升序，每个段文件至多一个区间；
+    // 段满时暂存在内存中的记录在写入段文件后才可读到
+    QVector<RecordSpan> readTimeRange(int projectId, const QDateTime &startTime, const QDateTime &endTime);
+
+    // 封存所有写入中的段文件
+    bool sealAll();
+
+    // 查询项目已登记的段文件
+    QList<SegmentInfo> getSegments(int projectId);
+
+    // 项目段文件目录
+    static QString segmentDirectory(int projectId);
+
+    // 获取最后的错误信息
+    QString getLastError() const { return lastError; }
+
+private:
+    ExcavationSegmentStore();
+    ExcavationSegmentStore(const ExcavationSegmentStore&) = delete;
+    ExcavationSegmentStore& operator=(const ExcavationSegmentStore&) = delete;
+
+    class Segment;
+
+    // 获取（必要时创建或恢复）项目指定日期的可写段
+    std::shared_ptr<Segment> writableSegment(int projectId, const QDate &day);
+
+    // 打开段文件用于读取，未封存的往日段会先恢复并封存
+    std::shared_ptr<Segment> readableSegment(const QString &filePath);
+
+    // 按登记信息筛选项目可能相关的段文件
+    QList<std::shared_ptr<Segment>> candidateSegments(int projectId, const QString &condition,
+                                                      const QVariant &low, const QVariant &high);
+
+    // 读缓存超出上限时释放最早打开且不在写入中的段
+    void evictOpenSegments();
+
+    // 登记段文件信息
+    bool saveSegmentInfo(const Segment &segment);
+
+private:
+    // 每个稀疏索引项覆盖的记录数
+    static const int INDEX_BLOCK_SIZE = 4096;
+
+    // 读缓存中最多同时映射的段文件数
+    static const int MAX_OPEN_SEGMENTS = 64;
+
+    QHash<int, std::shared_ptr<Segment>> activeSegments;        // 项目 -> 写入中的段
+    QHash<QString, std::shared_ptr<Segment>> openSegments;      // 文件路径 -> 已映射的段
+    QList<QString> openOrder;                                   // 读缓存的打开顺序
+    QString lastError;
+};
+
+#endif // EXCAVATIONSEGMENTSTORE_H
@@ -1,11 +1,10 @@
 #include "MileageDAO.h"
 #include "DatabaseManager.h"
 #include "../utils/CoordinateConverter.h"
+#include "../utils/CsvImportPipeline.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
-#include <QFile>
-#include <QTextStream>
 #include <QRegularExpression>
 #include <QtMath>
 
@@ -22,7 +21,7 @@ double MileageDAO::stakeMarkToMileage(const QString &stakeMark)
 {
     // 解析桩号格式，如 "K1+190.00" -> 1190.00
     // 格式: K{千米}+{米}
-    QRegularExpression re("K(\\d+)\\+(\\d+(?:\\.\\d+)?)");
+    static const QRegularExpression re("K(\\d+)\\+(\\d+(?:\\.\\d+)?)");
     QRegularExpressionMatch match = re.match(stakeMark);
     
     if (match.hasMatch()) {
@@ -254,73 +253,61 @@ bool MileageDAO::deleteMileagePointsByProject(int projectId)
 
 bool MileageDAO::importFromCSV(int projectId, const QString &csvFilePath)
 {
-    QFile file(csvFilePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qCritical() << "无法打开CSV文件:" << csvFilePath;
+    // 格式: 序号,附近钻孔,左上x,左上y,左上z,,左下x,左下y,左下z,,右上x,右上y,右上z,,右下x,右下y,右下z,
+    CsvImportPipeline pipeline;
+    CsvImportPipeline::Options options;
+    options.minFields = 17;
+    options.singleTransaction = true;   // 出错时不留下只导入了一部分的里程点
+    pipeline.setOptions(options);
+    
+    pipeline.setHandlers<MileagePoint>(
+        [this, projectId](const CsvTokenizer::Row &row, MileagePoint &point) {
+            point.id = 0;
+            point.projectId = projectId;
+            point.nearBorehole = row[1].toString();
+            
+            // 使用左上角的坐标作为代表点
+            double x = row[2].toDouble();  // 投影坐标 X
+            double y = row[3].toDouble();  // 投影坐标 Y
+            double z = row[4].toDouble();  // 高程
+            
+            // 使用高斯-克吕格投影转WGS84经纬度
+            // 青岛地区使用3度带第41带（中央子午线123°）
+            double lat, lon;
+            CoordinateConverter::gaussKrugerToWGS84(x, y, 41, lat, lon);
+            point.latitude = lat;
+            point.longitude = lon;
+            point.elevation = z;
+            
+            // 根据序号计算里程（假设每个断面间隔一定距离）
+            int sequence = row[0].toInt();
+            point.mileage = sequence * 10.0;  // 假设每10米一个断面
+            point.stakeMark = mileageToStakeMark(point.mileage);
+            return true;
+        },
+        [this](const QVector<MileagePoint> &points, QString &error) {
+            for (const auto &point : points) {
+                if (!addMileagePoint(point)) {
+                    error = QString("添加里程点失败: %1").arg(point.stakeMark);
+                    return false;
+                }
+            }
+            return true;
+        });
+    
+    CsvImportPipeline::Result result = pipeline.run(csvFilePath);
+    if (!result.success) {
+        qCritical() << "导入里程数据失败:" << csvFilePath << result.errorMessage;
         return false;
     }
-    
-    QTextStream in(&file);
-    // Qt 6默认使用UTF-8编码，无需设置
-    
-    // 跳过表头
-    QString header = in.readLine();
-    
-    QList<MileagePoint> points;
-    int lineNumber = 1;
-    
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        lineNumber++;
-        
-        // 跳过空行
-        if (line.trimmed().isEmpty()) {
-            continue;
-        }
-        
-        QStringList fields = line.split(',');
-        
-        // 检查字段数量
-        if (fields.size() < 17) {
-            qWarning() << "CSV第" << lineNumber << "行字段不足，跳过";
-            continue;
-        }
-        
-        // 解析数据
-        // 格式: 序号,附近钻孔,左上x,左上y,左上z,,左下x,左下y,左下z,,右上x,右上y,右上z,,右下x,右下y,右下z,
-        MileagePoint point;
-        point.projectId = projectId;
-        point.nearBorehole = fields[1].trimmed();
-        
-        // 使用左上角的坐标作为代表点
-        double x = fields[2].trimmed().toDouble();  // 投影坐标 X
-        double y = fields[3].trimmed().toDouble();  // 投影坐标 Y
-        double z = fields[4].trimmed().toDouble();  // 高程
-        
-        // 使用高斯-克吕格投影转WGS84经纬度
-        // 青岛地区使用3度带第41带（中央子午线123°）
-        double lat, lon;
-        CoordinateConverter::gaussKrugerToWGS84(x, y, 41, lat, lon);
-        point.latitude = lat;
-        point.longitude = lon;
-        point.elevation = z;
-        
-        // 根据序号计算里程（假设每个断面间隔一定距离）
-        int sequence = fields[0].trimmed().toInt();
-        point.mileage = sequence * 10.0;  // 假设每10米一个断面
-        point.stakeMark = mileageToStakeMark(point.mileage);
-        
-        points.append(point);
+    if (result.rejectedCount > 0) {
+        qWarning() << "CSV中有" << result.rejectedCount << "行字段不足，已跳过";
     }
-    
-    file.close();
-    
-    if (points.isEmpty()) {
+    if (result.recordCount == 0) {
         qWarning() << "CSV文件中没有有效数据";
         return false;
     }
     
-    // 批量插入数据
-    return batchAddMileagePoints(points);
+    return true;
 }
 
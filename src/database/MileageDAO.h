@@ -48,17 +48,17 @@ public:
     // 删除项目的所有里程数据
     bool deleteMileagePointsByProject(int projectId);
     
-    // 从CSV导入里程数据
+    // 从CSV或XLSX（第一个工作表）导入里程数据，整个文件一个事务，失败时不写入任何记录
     bool importFromCSV(int projectId, const QString &csvFilePath);
     
 private:
     QSqlDatabase getDatabase();
     
-    // 将字符串桩号转换为数值里程（如 "K1+190.00" -> 1190.00）
-    double stakeMarkToMileage(const QString &stakeMark);
+    // 将字符串桩号转换为数值里程（如 "K1+190.00" -> 1190.00），不访问数据库
+    static double stakeMarkToMileage(const QString &stakeMark);
     
     // 将数值里程转换为桩号字符串（如 1190.00 -> "K1+190.00"）
-    QString mileageToStakeMark(double mileage);
+    static QString mileageToStakeMark(double mileage);
 };
 
 #endif // MILEAGEDAO_H
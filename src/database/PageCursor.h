@@ -0,0 +1,62 @@
+#ifndef PAGECURSOR_H
+#define PAGECURSOR_H
+
+#include <QVariant>
+
+/**
+ * @brief 游标分页（keyset）排序方式
+ *
+ * ByTime    按采集时间降序（最新在前），键为 (excavation_time, id)
+ * ByMileage 按里程升序，键为 (mileage, id)
+ */
+enum class PageOrder {
+    ByTime,
+    ByMileage
+};
+
+/**
+ * @brief 游标分页翻页方向
+ *
+ * Forward 取游标之后的一页（沿排序方向），Backward 取游标之前的一页
+ */
+enum class PageDirection {
+    Forward,
+    Backward
+};
+
+/**
+ * @brief 游标分页位置
+ *
+ * 记录一页首行或末行的排序键与主键。按游标取页时SQL使用
+ * (排序键, id) 的行值比较配合复合索引定位，代价与页码无关，
+ * 避免 LIMIT/OFFSET 在深分页时逐行跳过。
+ * 无效游标表示从头（Forward）或从尾（Backward）开始。
+ */
+struct PageCursor {
+    QVariant sortKey;   // 排序键（掘进时间或里程，掘进参数的时间为毫秒时间戳）
+    int id = 0;         // 记录主键，用于同键记录之间的次序
+
+    bool isValid() const { return id > 0 && sortKey.isValid(); }
+};
+
+/**
+ * @brief 一页的首尾游标
+ *
+ * 向后翻页必须从本页首行的游标开始查询，向前翻页从末行开始；
+ * 只保存一个游标并在换向时互相赋值，会重复或跳过边界上的一行。
+ * 取到空页时应保留原来的首尾游标。
+ */
+struct PageRange {
+    PageCursor first;   // 页首行
+    PageCursor last;    // 页末行
+
+    bool isValid() const { return first.isValid() && last.isValid(); }
+
+    // 按 direction 翻到相邻页时查询所用的游标
+    const PageCursor &seekFrom(PageDirection direction) const
+    {
+        return direction == PageDirection::Backward ? first : last;
+    }
+};
+
+#endif // PAGECURSOR_H
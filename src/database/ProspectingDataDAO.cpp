@@ -1,9 +1,11 @@
 #include "ProspectingDataDAO.h"
 #include "DatabaseManager.h"
+#include "SqlQueryBuilder.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 #include <QVariant>
+#include <algorithm>
 
 ProspectingDataDAO::ProspectingDataDAO()
 {
@@ -370,12 +372,76 @@ QVector<ProspectingData> ProspectingDataDAO::selectByProjectIdWithPagination(int
     return dataList;
 }
 
+QVector<ProspectingData> ProspectingDataDAO::selectByProjectIdWithCursor(int projectId,
+                                                                     const PageCursor &cursor,
+                                                                     int limit,
+                                                                     PageDirection direction,
+                                                                     PageOrder order)
+{
+    QVector<ProspectingData> dataList;
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    QSqlQuery query(db);
+    
+    // 时间按降序（最新在前），里程按升序；向后翻页时反转扫描方向
+    QString keyColumn = (order == PageOrder::ByMileage) ? "mileage" : "excavation_time";
+    bool descending = (order == PageOrder::ByTime);
+    if (direction == PageDirection::Backward) {
+        descending = !descending;
+    }
+    
+    QString sql = "SELECT * FROM prospecting_data WHERE project_id = :projectId ";
+    if (cursor.isValid()) {
+        sql += QString("AND (%1, prospecting_id) %2 (:cursorKey, :cursorId) ")
+                   .arg(keyColumn, descending ? "<" : ">");
+    }
+    sql += QString("ORDER BY %1 %2, prospecting_id %2 LIMIT :limit")
+               .arg(keyColumn, descending ? "DESC" : "ASC");
+    
+    query.prepare(sql);
+    query.bindValue(":projectId", projectId);
+    if (cursor.isValid()) {
+        query.bindValue(":cursorKey", cursor.sortKey);
+        query.bindValue(":cursorId", cursor.id);
+    }
+    query.bindValue(":limit", limit);
+    
+    if (!query.exec()) {
+        lastError = "游标分页查询补勘数据失败: " + query.lastError().text();
+        qCritical() << lastError;
+        return dataList;
+    }
+    
+    while (query.next()) {
+        dataList.append(readData(query));
+    }
+    
+    if (direction == PageDirection::Backward) {
+        std::reverse(dataList.begin(), dataList.end());
+    }
+    
+    return dataList;
+}
+
+PageCursor ProspectingDataDAO::cursorFor(const ProspectingData &data, PageOrder order)
+{
+    PageCursor cursor;
+    cursor.id = data.getId();
+    if (order == PageOrder::ByMileage) {
+        cursor.sortKey = data.getMileage();
+    } else {
+        cursor.sortKey = data.getExcavationTime();
+    }
+    return cursor;
+}
+
 int ProspectingDataDAO::countByProjectId(int projectId)
 {
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
     QSqlQuery query(db);
     
-    query.prepare("SELECT COUNT(*) FROM prospecting_data WHERE project_id = :projectId");
+    // 记录数由触发器维护在汇总表中，无需扫描明细表
+    query.prepare("SELECT row_count FROM project_data_summary "
+                  "WHERE project_id = :projectId AND data_type = 'prospecting'");
     query.bindValue(":projectId", projectId);
     
     if (!query.exec()) {
@@ -554,3 +620,107 @@ QList<ProspectingData> ProspectingDataDAO::getAllProspectingData()
     
     return dataList;
 }
+
+QList<ProspectingDataDAO::ProspectingRow> ProspectingDataDAO::queryRows(const ProspectingQuery &filter)
+{
+    QList<ProspectingRow> rows;
+    
+    SqlQueryBuilder builder = filteredQuery(filter);
+    builder.select({"d.*", "p.project_name"});
+    
+    // 向后翻页时按时间升序扫描，取游标之后最近的一批
+    bool backward = (filter.direction == PageDirection::Backward);
+    Qt::SortOrder scanOrder = backward ? Qt::AscendingOrder : Qt::DescendingOrder;
+    if (filter.after.isValid()) {
+        builder.where(QString("(d.excavation_time, d.prospecting_id) %1 (%2, %3)").arg(backward ? ">" : "<", "%1", "%2"),
+                      {filter.after.sortKey, filter.after.id});
+    }
+    builder.orderBy("d.excavation_time", scanOrder)
+        .orderBy("d.prospecting_id", scanOrder)
+        .limit(filter.limit);
+    
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.setForwardOnly(true);
+    if (!builder.prepare(query) || !query.exec()) {
+        lastError = "按条件查询补勘数据失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return rows;
+    }
+    
+    while (query.next()) {
+        ProspectingRow row;
+        row.projectName = query.value("project_name").toString();
+        row.data = readData(query);
+        rows.append(row);
+    }
+    
+    // 恢复为时间降序
+    if (backward) {
+        std::reverse(rows.begin(), rows.end());
+    }
+    
+    return rows;
+}
+
+int ProspectingDataDAO::countRows(const ProspectingQuery &filter)
+{
+    SqlQueryBuilder builder = filteredQuery(filter);
+    builder.select({"COUNT(*)"});
+    
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    if (!builder.prepare(query) || !query.exec() || !query.next()) {
+        lastError = "统计补勘数据记录数失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return -1;
+    }
+    
+    return query.value(0).toInt();
+}
+
+SqlQueryBuilder ProspectingDataDAO::filteredQuery(const ProspectingQuery &filter)
+{
+    SqlQueryBuilder builder("prospecting_data d JOIN projects p ON p.project_id = d.project_id");
+    
+    if (!filter.projectIds.isEmpty()) {
+        QVariantList ids;
+        for (int projectId : filter.projectIds) {
+            ids << projectId;
+        }
+        builder.whereIn("d.project_id", ids);
+    }
+    if (!filter.dangerLevel.isEmpty()) {
+        builder.whereEquals("d.rock_danger_level", filter.dangerLevel);
+    }
+    builder.whereContains({"p.project_name"}, filter.projectName)
+        .whereContains({"p.project_name", "d.stake_mark", "d.rock_properties", "d.rock_type", "d.rock_danger_level"},
+                       filter.keyword);
+    return builder;
+}
+
+ProspectingData ProspectingDataDAO::readData(const QSqlQuery &query)
+{
+    ProspectingData data;
+    data.setId(query.value("prospecting_id").toInt());
+    data.setProjectId(query.value("project_id").toInt());
+    data.setExcavationTime(query.value("excavation_time").toDateTime());
+    data.setStakeMark(query.value("stake_mark").toString());
+    data.setMileage(query.value("mileage").toDouble());
+    data.setCutterForce(query.value("cutter_force").toDouble());
+    data.setCutterPenetrationResistance(query.value("cutter_penetration_resistance").toDouble());
+    data.setFaceFrictionTorque(query.value("face_friction_torque").toDouble());
+    data.setPWaveVelocity(query.value("p_wave_velocity").toDouble());
+    data.setSWaveVelocity(query.value("s_wave_velocity").toDouble());
+    data.setWaveReflectionCoeff(query.value("wave_reflection_coeff").toDouble());
+    data.setApparentResistivity(query.value("apparent_resistivity").toDouble());
+    data.setStressGradient(query.value("stress_gradient").toDouble());
+    data.setWaterProbability(query.value("water_probability").toDouble());
+    data.setRockProperties(query.value("rock_properties").toString());
+    data.setRockDangerLevel(query.value("rock_danger_level").toString());
+    data.setYoungsModulus(query.value("youngs_modulus").toDouble());
+    data.setPoissonRatio(query.value("poisson_ratio").toDouble());
+    data.setWaveVelocityRatio(query.value("wave_velocity_ratio").toDouble());
+    data.setRockType(query.value("rock_type").toString());
+    data.setDistributionPattern(query.value("distribution_pattern").toString());
+    data.setCreatedAt(query.value("created_at").toDateTime());
+    return data;
+}
@@ -2,9 +2,13 @@
 #define PROSPECTINGDATADAO_H
 
 #include "../models/ProspectingData.h"
+#include "PageCursor.h"
 #include <QVector>
 #include <QString>
 
+class QSqlQuery;
+class SqlQueryBuilder;
+
 /**
  * @brief 补勘数据访问对象类
  * 
@@ -13,6 +17,27 @@
 class ProspectingDataDAO
 {
 public:
+    /**
+     * @brief 管理表格的补勘数据查询条件（各条件之间为与关系）
+     */
+    struct ProspectingQuery {
+        QList<int> projectIds;          // 为空表示全部项目
+        QString projectName;            // 项目名称包含该文本，为空表示不限
+        QString dangerLevel;            // 围岩危险等级，为空表示不限
+        QString keyword;                // 匹配项目名称、桩号、围岩性质、岩性、危险等级
+        int limit = 0;                  // 0 表示不限制
+        PageCursor after;               // 有效时只返回 (掘进时间, ID) 在该游标之前（Backward 时为之后）的记录
+        PageDirection direction = PageDirection::Forward;   // Backward 时取游标之后最近的 limit 条，结果仍按时间降序
+    };
+
+    /**
+     * @brief 带项目名称的补勘数据记录
+     */
+    struct ProspectingRow {
+        QString projectName;
+        ProspectingData data;
+    };
+
     ProspectingDataDAO();
     ~ProspectingDataDAO() = default;
 
@@ -67,6 +92,9 @@ public:
 
     /**
      * @brief 分页查询项目的补勘数据
+     *
+     * 基于OFFSET，偏移越大代价越高；大数据量翻页请使用 selectByProjectIdWithCursor()
+     *
      * @param projectId 项目ID
      * @param offset 偏移量
      * @param limit 限制数量
@@ -74,6 +102,33 @@ public:
      */
     QVector<ProspectingData> selectByProjectIdWithPagination(int projectId, int offset, int limit);
 
+    /**
+     * @brief 游标分页查询项目的补勘数据
+     *
+     * 按 (excavation_time, prospecting_id) 或 (mileage, prospecting_id) 定位，
+     * 任意页的代价与首页相同。结果始终按排序方式的正序排列。
+     *
+     * @param projectId 项目ID
+     * @param cursor 当前页首行（Backward）或末行（Forward）的游标，无效游标表示从头/尾开始
+     * @param limit 每页记录数
+     * @param direction 翻页方向
+     * @param order 排序方式
+     * @return 数据对象列表
+     */
+    QVector<ProspectingData> selectByProjectIdWithCursor(int projectId,
+                                                         const PageCursor &cursor,
+                                                         int limit,
+                                                         PageDirection direction = PageDirection::Forward,
+                                                         PageOrder order = PageOrder::ByTime);
+
+    /**
+     * @brief 根据记录生成游标
+     * @param data 补勘数据（通常为一页的首行或末行）
+     * @param order 排序方式
+     * @return 游标
+     */
+    static PageCursor cursorFor(const ProspectingData &data, PageOrder order = PageOrder::ByTime);
+
     /**
      * @brief 查询项目的补勘数据记录总数
      * @param projectId 项目ID
@@ -111,6 +166,20 @@ public:
      */
     QList<ProspectingData> getAllProspectingData();
 
+    /**
+     * @brief 按条件查询多个项目的补勘数据（一次查询，附带项目名称）
+     * @param filter 查询条件
+     * @return 记录列表，按掘进时间降序
+     */
+    QList<ProspectingRow> queryRows(const ProspectingQuery &filter);
+
+    /**
+     * @brief 统计符合条件的补勘数据记录数
+     * @param filter 查询条件（limit 与 after 不参与统计）
+     * @return 记录数，失败返回-1
+     */
+    int countRows(const ProspectingQuery &filter);
+
     /**
      * @brief 获取最后的错误信息
      * @return 错误信息字符串
@@ -119,6 +188,12 @@ public:
 
 private:
     QString lastError;
+
+    // 从查询结果当前行读取补勘数据
+    static ProspectingData readData(const QSqlQuery &query);
+
+    // 按查询条件生成关联 projects 表的查询（d 为补勘数据表，p 为项目表）
+    static SqlQueryBuilder filteredQuery(const ProspectingQuery &filter);
 };
 
 #endif // PROSPECTINGDATADAO_H
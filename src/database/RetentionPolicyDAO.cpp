@@ -0,0 +1,120 @@
+#include "RetentionPolicyDAO.h"
+#include "DatabaseManager.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+#include <QVariant>
+
+RetentionPolicyDAO::RetentionPolicyDAO()
+{
+}
+
+bool RetentionPolicyDAO::setRetentionDays(int projectId, int days)
+{
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+
+    if (days <= 0) {
+        query.prepare("DELETE FROM data_retention_policies WHERE project_id = :projectId");
+        query.bindValue(":projectId", projectId);
+    } else {
+        query.prepare("INSERT OR REPLACE INTO data_retention_policies (project_id, retention_days, updated_at) "
+                      "VALUES (:projectId, :days, CURRENT_TIMESTAMP)");
+        query.bindValue(":projectId", projectId);
+        query.bindValue(":days", days);
+    }
+
+    if (!query.exec()) {
+        lastError = "保存数据保留策略失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return false;
+    }
+
+    return true;
+}
+
+int RetentionPolicyDAO::getRetentionDays(int projectId)
+{
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare("SELECT retention_days FROM data_retention_policies WHERE project_id = :projectId");
+    query.bindValue(":projectId", projectId);
+
+    if (!query.exec()) {
+        lastError = "查询数据保留策略失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return 0;
+    }
+
+    if (query.next()) {
+        return query.value("retention_days").toInt();
+    }
+
+    return 0;
+}
+
+QList<RetentionPolicyDAO::RetentionPolicy> RetentionPolicyDAO::getAllPolicies()
+{
+    QList<RetentionPolicy> policies;
+
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    if (!query.exec("SELECT project_id, retention_days, updated_at FROM data_retention_policies "
+                    "WHERE retention_days > 0 ORDER BY project_id")) {
+        lastError = "查询数据保留策略失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return policies;
+    }
+
+    while (query.next()) {
+        RetentionPolicy policy;
+        policy.projectId = query.value("project_id").toInt();
+        policy.retentionDays = query.value("retention_days").toInt();
+        policy.updatedAt = query.value("updated_at").toDateTime();
+        policies.append(policy);
+    }
+
+    return policies;
+}
+
+QList<RetentionPolicyDAO::ArchiveState> RetentionPolicyDAO::getArchiveStates(int projectId)
+{
+    QList<ArchiveState> states;
+
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare("SELECT project_id, data_type, archive_file, archived_rows, archived_until, last_archived_at "
+                  "FROM data_archive_state WHERE project_id = :projectId ORDER BY data_type");
+    query.bindValue(":projectId", projectId);
+
+    if (!query.exec()) {
+        lastError = "查询归档状态失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return states;
+    }
+
+    while (query.next()) {
+        ArchiveState state;
+        state.projectId = query.value("project_id").toInt();
+        state.dataType = query.value("data_type").toString();
+        state.archiveFile = query.value("archive_file").toString();
+        state.archivedRows = query.value("archived_rows").toLongLong();
+        state.archivedUntil = query.value("archived_until").toDateTime();
+        state.lastArchivedAt = query.value("last_archived_at").toDateTime();
+        states.append(state);
+    }
+
+    return states;
+}
+
+bool RetentionPolicyDAO::clearArchiveState(int projectId, const QString &dataType)
+{
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.prepare("DELETE FROM data_archive_state WHERE project_id = :projectId AND data_type = :dataType");
+    query.bindValue(":projectId", projectId);
+    query.bindValue(":dataType", dataType);
+
+    if (!query.exec()) {
+        lastError = "清除归档状态失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef RETENTIONPOLICYDAO_H
+#define RETENTIONPOLICYDAO_H
+
+#include <QString>
+#include <QList>
+#include <QDateTime>
+
+/**
+ * @brief 明细数据保留策略与归档状态访问对象
+ *
+ * data_retention_policies 保存每个项目明细数据在库内的保留天数，
+ * 未配置的项目永久保留。data_archive_state 记录每个项目每类数据
+ * 已归档的行数、累计量与归档文件位置，由 DataArchiver 维护。
+ */
+class RetentionPolicyDAO
+{
+public:
+    struct RetentionPolicy {
+        int projectId = 0;
+        int retentionDays = 0;      // 明细保留天数
+        QDateTime updatedAt;
+    };
+
+    struct ArchiveState {
+        int projectId = 0;
+        QString dataType;           // 数据类型，见 DataSummaryDAO::TYPE_*
+        QString archiveFile;        // 归档文件路径
+        qint64 archivedRows = 0;    // 已归档行数
+        QDateTime archivedUntil;    // 已归档的最晚记录时间
+        QDateTime lastArchivedAt;   // 最近一次归档时间
+    };
+
+    RetentionPolicyDAO();
+
+    // 设置项目的保留天数，days <= 0 表示永久保留（删除策略）
+    bool setRetentionDays(int projectId, int days);
+
+    // 获取项目的保留天数，未配置时返回0
+    int getRetentionDays(int projectId);
+
+    // 获取所有已配置的保留策略
+    QList<RetentionPolicy> getAllPolicies();
+
+    // 获取项目各类数据的归档状态
+    QList<ArchiveState> getArchiveStates(int projectId);
+
+    // 清除项目某类数据的归档状态（归档文件保留）
+    bool clearArchiveState(int projectId, const QString &dataType);
+
+    // 获取最后的错误信息
+    QString getLastError() const { return lastError; }
+
+private:
+    QString lastError;
+};
+
+#endif // RETENTIONPOLICYDAO_H
@@ -0,0 +1,142 @@
+#include "SqlQueryBuilder.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+SqlQueryBuilder::SqlQueryBuilder(const QString &from)
+    : fromClause(from)
+    , limitCount(0)
+    , limitOffset(0)
+{
+}
+
+SqlQueryBuilder& SqlQueryBuilder::select(const QStringList &columns)
+{
+    selectColumns = columns;
+    return *this;
+}
+
+SqlQueryBuilder& SqlQueryBuilder::where(const QString &condition, const QVariantList &values)
+{
+    QString expanded = condition;
+    for (const QVariant &value : values) {
+        expanded = expanded.arg(addValue(value));
+    }
+    conditions << "(" + expanded + ")";
+    return *this;
+}
+
+SqlQueryBuilder& SqlQueryBuilder::whereEquals(const QString &column, const QVariant &value)
+{
+    conditions << QString("%1 = %2").arg(column, addValue(value));
+    return *this;
+}
+
+SqlQueryBuilder& SqlQueryBuilder::whereIn(const QString &column, const QVariantList &values)
+{
+    if (values.isEmpty()) {
+        conditions << "0";
+        return *this;
+    }
+
+    QStringList placeholders;
+    for (const QVariant &value : values) {
+        placeholders << addValue(value);
+    }
+    conditions << QString("%1 IN (%2)").arg(column, placeholders.join(", "));
+    return *this;
+}
+
+SqlQueryBuilder& SqlQueryBuilder::whereBetween(const QString &column, const QVariant &low, const QVariant &high)
+{
+    if (!low.isNull() && !high.isNull()) {
+        QString lowPlaceholder = addValue(low);
+        conditions << QString("%1 BETWEEN %2 AND %3").arg(column, lowPlaceholder, addValue(high));
+    } else if (!low.isNull()) {
+        conditions << QString("%1 >= %2").arg(column, addValue(low));
+    } else if (!high.isNull()) {
+        conditions << QString("%1 <= %2").arg(column, addValue(high));
+    }
+    return *this;
+}
+
+SqlQueryBuilder& SqlQueryBuilder::whereContains(const QStringList &columns, const QString &keyword)
+{
+    if (keyword.isEmpty() || columns.isEmpty()) {
+        return *this;
+    }
+
+    // 转义 LIKE 通配符，关键字中的 % 与 _ 按字面匹配
+    QString escaped = keyword;
+    escaped.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+
+    // 同一值在多列上比较时每列各用一个占位符
+    QStringList terms;
+    for (const QString &column : columns) {
+        terms << QString("%1 LIKE %2 ESCAPE '\\'").arg(column, addValue("%" + escaped + "%"));
+    }
+    conditions << "(" + terms.join(" OR ") + ")";
+    return *this;
+}
+
+SqlQueryBuilder& SqlQueryBuilder::groupBy(const QStringList &columns)
+{
+    groupColumns = columns;
+    return *this;
+}
+
+SqlQueryBuilder& SqlQueryBuilder::orderBy(const QString &column, Qt::SortOrder order)
+{
+    orderTerms << column + (order == Qt::DescendingOrder ? " DESC" : " ASC");
+    return *this;
+}
+
+SqlQueryBuilder& SqlQueryBuilder::limit(int count, int offset)
+{
+    limitCount = count;
+    limitOffset = offset;
+    return *this;
+}
+
+QString SqlQueryBuilder::sql() const
+{
+    QString statement = QString("SELECT %1 FROM %2")
+        .arg(selectColumns.isEmpty() ? QString("*") : selectColumns.join(", "), fromClause);
+
+    if (!conditions.isEmpty()) {
+        statement += " WHERE " + conditions.join(" AND ");
+    }
+    if (!groupColumns.isEmpty()) {
+        statement += " GROUP BY " + groupColumns.join(", ");
+    }
+    if (!orderTerms.isEmpty()) {
+        statement += " ORDER BY " + orderTerms.join(", ");
+    }
+    if (limitCount > 0) {
+        statement += QString(" LIMIT %1").arg(limitCount);
+        if (limitOffset > 0) {
+            statement += QString(" OFFSET %1").arg(limitOffset);
+        }
+    }
+    return statement;
+}
+
+bool SqlQueryBuilder::prepare(QSqlQuery &query) const
+{
+    if (!query.prepare(sql())) {
+        qWarning() << "准备查询语句失败:" << query.lastError().text() << sql();
+        return false;
+    }
+
+    for (const auto &value : values) {
+        query.bindValue(value.first, value.second);
+    }
+    return true;
+}
+
+QString SqlQueryBuilder::addValue(const QVariant &value)
+{
+    QString placeholder = QString(":p%1").arg(values.size());
+    values.append(qMakePair(placeholder, value));
+    return placeholder;
+}
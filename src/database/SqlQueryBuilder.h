@@ -0,0 +1,78 @@
+#ifndef SQLQUERYBUILDER_H
+#define SQLQUERYBUILDER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QList>
+#include <QPair>
+
+class QSqlQuery;
+
+/**
+ * @brief 参数化 SELECT 语句构造器
+ *
+ * 供 DAO 按筛选条件拼接查询：条件之间为 AND，取值一律通过命名参数绑定。
+ * 表名、列名与表达式直接拼入SQL，只能使用 DAO 中的常量，不能来自用户输入。
+ *
+ * 用法：
+ *   SqlQueryBuilder builder("excavation_parameters e");
+ *   builder.select({"e.*"}).whereIn("e.project_id", ids).orderBy("e.excavation_time", Qt::DescendingOrder).limit(100);
+ *   QSqlQuery query(db);
+ *   if (builder.prepare(query) && query.exec()) { ... }
+ */
+class SqlQueryBuilder
+{
+public:
+    explicit SqlQueryBuilder(const QString &from);
+
+    // 选择列（可为聚合表达式），默认为 *
+    SqlQueryBuilder& select(const QStringList &columns);
+
+    /**
+     * @brief 任意条件，condition 中的 %1、%2… 依次替换为 values 的占位符
+     * 如 where("(e.excavation_time, e.id) < (%1, %2)", {timeMs, id})
+     */
+    SqlQueryBuilder& where(const QString &condition, const QVariantList &values);
+
+    // column = value
+    SqlQueryBuilder& whereEquals(const QString &column, const QVariant &value);
+
+    // column IN (values)，values 为空时不匹配任何行
+    SqlQueryBuilder& whereIn(const QString &column, const QVariantList &values);
+
+    // column BETWEEN low AND high，low/high 为空值时只限制另一端
+    SqlQueryBuilder& whereBetween(const QString &column, const QVariant &low, const QVariant &high);
+
+    // 任一列包含关键字（LIKE，不区分大小写，通配符按字面匹配），keyword 为空时忽略
+    SqlQueryBuilder& whereContains(const QStringList &columns, const QString &keyword);
+
+    SqlQueryBuilder& groupBy(const QStringList &columns);
+
+    // 可多次调用，按调用顺序排序
+    SqlQueryBuilder& orderBy(const QString &column, Qt::SortOrder order = Qt::AscendingOrder);
+
+    // count <= 0 表示不限制
+    SqlQueryBuilder& limit(int count, int offset = 0);
+
+    // 生成的SQL语句
+    QString sql() const;
+
+    // 准备语句并绑定全部参数
+    bool prepare(QSqlQuery &query) const;
+
+private:
+    // 登记一个参数值，返回其占位符
+    QString addValue(const QVariant &value);
+
+    QString fromClause;
+    QStringList selectColumns;
+    QStringList conditions;
+    QStringList groupColumns;
+    QStringList orderTerms;
+    int limitCount;
+    int limitOffset;
+    QList<QPair<QString, QVariant>> values;
+};
+
+#endif // SQLQUERYBUILDER_H
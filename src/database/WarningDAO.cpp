@@ -1,9 +1,11 @@
 #include "WarningDAO.h"
 #include "DatabaseManager.h"
+#include "SqlQueryBuilder.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 #include <QVariant>
+#include <algorithm>
 
 WarningDAO::WarningDAO()
 {
@@ -251,7 +253,9 @@ int WarningDAO::getWarningCountByProject(int projectId)
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
     
     QSqlQuery query(db);
-    query.prepare("SELECT COUNT(*) as count FROM warnings WHERE project_id = :projectId");
+    // 预警数量由触发器维护在汇总表中
+    query.prepare("SELECT row_count as count FROM project_data_summary "
+                  "WHERE project_id = :projectId AND data_type = 'warning'");
     query.bindValue(":projectId", projectId);
     
     if (!query.exec()) {
@@ -272,7 +276,8 @@ int WarningDAO::getTotalWarningCount()
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
     
     QSqlQuery query(db);
-    if (!query.exec("SELECT COUNT(*) as count FROM warnings")) {
+    if (!query.exec("SELECT COALESCE(SUM(row_count), 0) as count FROM project_data_summary "
+                    "WHERE data_type = 'warning'")) {
         lastError = "查询预警总数失败: " + query.lastError().text();
         qWarning() << lastError;
         return 0;
@@ -284,3 +289,105 @@ int WarningDAO::getTotalWarningCount()
     
     return 0;
 }
+
+QList<WarningDAO::WarningRow> WarningDAO::queryRows(const WarningQuery &filter)
+{
+    QList<WarningRow> rows;
+    
+    SqlQueryBuilder builder = filteredQuery(filter);
+    builder.select({"w.*", "p.project_name"});
+    
+    // 向后翻页时按时间升序扫描，取游标之后最近的一批
+    bool backward = (filter.direction == PageDirection::Backward);
+    Qt::SortOrder scanOrder = backward ? Qt::AscendingOrder : Qt::DescendingOrder;
+    if (filter.after.isValid()) {
+        builder.where(QString("(w.warning_time, w.warning_id) %1 (%2, %3)").arg(backward ? ">" : "<", "%1", "%2"),
+                      {filter.after.sortKey, filter.after.id});
+    }
+    builder.orderBy("w.warning_time", scanOrder)
+        .orderBy("w.warning_id", scanOrder)
+        .limit(filter.limit);
+    
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.setForwardOnly(true);
+    if (!builder.prepare(query) || !query.exec()) {
+        lastError = "按条件查询预警失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return rows;
+    }
+    
+    while (query.next()) {
+        WarningRow row;
+        row.projectName = query.value("project_name").toString();
+        row.warning = readWarning(query);
+        row.cursor.sortKey = query.value("warning_time");
+        row.cursor.id = row.warning.getWarningId();
+        rows.append(row);
+    }
+    
+    // 恢复为时间降序
+    if (backward) {
+        std::reverse(rows.begin(), rows.end());
+    }
+    
+    return rows;
+}
+
+int WarningDAO::countRows(const WarningQuery &filter)
+{
+    SqlQueryBuilder builder = filteredQuery(filter);
+    builder.select({"COUNT(*)"});
+    
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    if (!builder.prepare(query) || !query.exec() || !query.next()) {
+        lastError = "统计预警数量失败: " + query.lastError().text();
+        qWarning() << lastError;
+        return -1;
+    }
+    
+    return query.value(0).toInt();
+}
+
+Warning WarningDAO::readWarning(const QSqlQuery &query)
+{
+    Warning warning;
+    warning.setWarningId(query.value("warning_id").toInt());
+    warning.setProjectId(query.value("project_id").toInt());
+    warning.setWarningNumber(query.value("warning_number").toInt());
+    warning.setWarningLevel(query.value("warning_level").toString());
+    warning.setWarningType(query.value("warning_type").toString());
+    warning.setLatitude(query.value("latitude").toDouble());
+    warning.setLongitude(query.value("longitude").toDouble());
+    warning.setDepth(query.value("depth").toDouble());
+    warning.setThresholdValue(query.value("threshold_value").toInt());
+    warning.setDistance(query.value("distance").toDouble());
+    warning.setWarningTime(query.value("warning_time").toDateTime());
+    return warning;
+}
+
+SqlQueryBuilder WarningDAO::filteredQuery(const WarningQuery &filter)
+{
+    SqlQueryBuilder builder("warnings w JOIN projects p ON p.project_id = w.project_id");
+    
+    if (!filter.projectIds.isEmpty()) {
+        QVariantList ids;
+        for (int projectId : filter.projectIds) {
+            ids << projectId;
+        }
+        builder.whereIn("w.project_id", ids);
+    }
+    if (!filter.warningLevel.isEmpty()) {
+        builder.whereEquals("w.warning_level", filter.warningLevel);
+    }
+    if (!filter.warningType.isEmpty()) {
+        builder.whereEquals("w.warning_type", filter.warningType);
+    }
+    // 预警时间为 DATETIME 文本，可能带 T 分隔符或毫秒，统一格式后再比较
+    const QString timeFormat = "yyyy-MM-dd HH:mm:ss";
+    builder.whereBetween("datetime(w.warning_time)",
+                         filter.startTime.isValid() ? QVariant(filter.startTime.toString(timeFormat)) : QVariant(),
+                         filter.endTime.isValid() ? QVariant(filter.endTime.toString(timeFormat)) : QVariant());
+    builder.whereContains({"p.project_name", "CAST(w.warning_id AS TEXT)", "w.warning_level", "w.warning_type"},
+                          filter.keyword);
+    return builder;
+}
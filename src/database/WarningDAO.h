@@ -2,9 +2,13 @@
 #define WARNINGDAO_H
 
 #include "../models/Warning.h"
+#include "PageCursor.h"
 #include <QList>
 #include <QString>
 
+class QSqlQuery;
+class SqlQueryBuilder;
+
 /**
  * @brief 预警数据访问对象类
  * 
@@ -13,6 +17,30 @@
 class WarningDAO
 {
 public:
+    /**
+     * @brief 预警查询条件（各条件之间为与关系）
+     */
+    struct WarningQuery {
+        QList<int> projectIds;          // 为空表示全部项目
+        QString warningLevel;           // 预警级别，为空表示不限
+        QString warningType;            // 预警类别，为空表示不限
+        QDateTime startTime;            // 无效表示不限
+        QDateTime endTime;              // 无效表示不限
+        QString keyword;                // 匹配项目名称、预警编号、级别、类别
+        int limit = 0;                  // 0 表示不限制
+        PageCursor after;               // 有效时只返回 (预警时间, ID) 在该游标之前（Backward 时为之后）的记录
+        PageDirection direction = PageDirection::Forward;   // Backward 时取游标之后最近的 limit 条，结果仍按时间降序
+    };
+
+    /**
+     * @brief 带项目名称的预警记录
+     */
+    struct WarningRow {
+        QString projectName;
+        Warning warning;
+        PageCursor cursor;              // 以数据库中的原始时间值为键，可直接作为下一批的 after
+    };
+
     WarningDAO();
     ~WarningDAO();
     
@@ -43,11 +71,23 @@ public:
     // 获取总预警数量
     int getTotalWarningCount();
     
+    // 按条件查询预警（一次查询，附带项目名称），按预警时间降序
+    QList<WarningRow> queryRows(const WarningQuery &filter);
+    
+    // 统计符合条件的预警数（limit、after 与 direction 不参与统计），失败返回-1
+    int countRows(const WarningQuery &filter);
+    
     // 获取最后的错误信息
     QString getLastError() const { return lastError; }
 
 private:
     QString lastError;
+    
+    // 从查询结果当前行读取预警
+    static Warning readWarning(const QSqlQuery &query);
+    
+    // 按查询条件生成关联 projects 表的查询（w 为预警表，p 为项目表）
+    static SqlQueryBuilder filteredQuery(const WarningQuery &filter);
 };
 
 #endif // WARNINGDAO_H
@@ -0,0 +1,125 @@
+#include "actionbuttondelegate.h"
+#include <QAbstractItemView>
+#include <QPainter>
+#include <QMouseEvent>
+#include <QCursor>
+
+namespace {
+
+// 与项目总览表操作按钮一致的尺寸（像素）
+const int BUTTON_WIDTH = 70;
+const int BUTTON_HEIGHT = 32;
+const int BUTTON_SPACING = 12;
+const int BUTTON_RADIUS = 4;
+const int CELL_MARGIN = 10;
+
+} // namespace
+
+ActionButtonDelegate::ActionButtonDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void ActionButtonDelegate::addButton(const QString &text, const QColor &color, const QColor &hoverColor)
+{
+    buttons.append(Button{ text, color, hoverColor });
+}
+
+QRect ActionButtonDelegate::buttonRect(const QRect &cell, int button) const
+{
+    const int totalWidth = buttons.size() * BUTTON_WIDTH + (buttons.size() - 1) * BUTTON_SPACING;
+    const int left = cell.left() + (cell.width() - totalWidth) / 2;
+    const int top = cell.top() + (cell.height() - BUTTON_HEIGHT) / 2;
+    return QRect(left + button * (BUTTON_WIDTH + BUTTON_SPACING), top, BUTTON_WIDTH, BUTTON_HEIGHT);
+}
+
+int ActionButtonDelegate::buttonAt(const QRect &cell, const QPoint &pos) const
+{
+    for (int i = 0; i < buttons.size(); i++) {
+        if (buttonRect(cell, i).contains(pos)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ActionButtonDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                                 const QModelIndex &index) const
+{
+    // 先绘制背景（选中、交替行色），单元格本身没有文本
+    QStyledItemDelegate::paint(painter, option, index);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // 悬停的按钮按光标当前位置判断，光标离开单元格时视图会重绘它
+    int hoveredButton = -1;
+    const QAbstractItemView *view = qobject_cast<const QAbstractItemView *>(option.widget);
+    if (view && (option.state & QStyle::State_MouseOver)) {
+        hoveredButton = buttonAt(option.rect, view->viewport()->mapFromGlobal(QCursor::pos()));
+    }
+
+    QFont font = option.font;
+    font.setPixelSize(13);
+    font.setBold(true);
+    painter->setFont(font);
+
+    for (int i = 0; i < buttons.size(); i++) {
+        const Button &button = buttons[i];
+        const QRect rect = buttonRect(option.rect, i);
+        const bool hovered = (hoveredButton == i);
+
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(hovered ? button.hoverColor : button.color);
+        painter->drawRoundedRect(rect, BUTTON_RADIUS, BUTTON_RADIUS);
+
+        painter->setPen(Qt::white);
+        painter->drawText(rect, Qt::AlignCenter, button.text);
+    }
+
+    painter->restore();
+}
+
+QSize ActionButtonDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    Q_UNUSED(index);
+    const int width = buttons.size() * BUTTON_WIDTH + (buttons.size() - 1) * BUTTON_SPACING;
+    return QSize(width + 2 * CELL_MARGIN, BUTTON_HEIGHT + CELL_MARGIN);
+}
+
+bool ActionButtonDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                       const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+    Q_UNUSED(model);
+
+    switch (event->type()) {
+    case QEvent::MouseMove: {
+        // 在单元格内移动时按钮之间的悬停状态会变化，重绘该单元格
+        if (const QAbstractItemView *view = qobject_cast<const QAbstractItemView *>(option.widget)) {
+            view->viewport()->update(option.rect);
+        }
+        return false;
+    }
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonDblClick: {
+        // 按下在按钮上时吞掉事件，避免触发行选择或编辑
+        const QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+        return buttonAt(option.rect, mouseEvent->position().toPoint()) >= 0;
+    }
+    case QEvent::MouseButtonRelease: {
+        const QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+        if (mouseEvent->button() != Qt::LeftButton) {
+            return false;
+        }
+        const int button = buttonAt(option.rect, mouseEvent->position().toPoint());
+        if (button < 0) {
+            return false;
+        }
+        emit buttonClicked(index, button);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
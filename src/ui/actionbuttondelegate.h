@@ -0,0 +1,58 @@
+#ifndef ACTIONBUTTONDELEGATE_H
+#define ACTIONBUTTONDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QColor>
+#include <QList>
+
+/**
+ * @brief 表格操作列按钮委托
+ *
+ * 在单元格内绘制一排按钮（与项目总览表的“修改”“删除”按钮外观相同），
+ * 不为每行创建 QPushButton 控件，行数再多也只有绘制开销，适用于按需加载的模型视图。
+ * 点击按钮时发出 buttonClicked()；视图需开启 setMouseTracking(true) 才有悬停效果。
+ *
+ * 用法：
+ *   ActionButtonDelegate *delegate = new ActionButtonDelegate(view);
+ *   delegate->addButton("删除", QColor("#E74C3C"), QColor("#C0392B"));
+ *   view->setItemDelegateForColumn(column, delegate);
+ *   connect(delegate, &ActionButtonDelegate::buttonClicked, this, ...);
+ */
+class ActionButtonDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit ActionButtonDelegate(QObject *parent = nullptr);
+
+    // 追加一个按钮，按添加顺序从左到右排列
+    void addButton(const QString &text, const QColor &color, const QColor &hoverColor);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+signals:
+    // button 为按钮序号
+    void buttonClicked(const QModelIndex &index, int button);
+
+protected:
+    bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                     const QModelIndex &index) override;
+
+private:
+    struct Button {
+        QString text;
+        QColor color;
+        QColor hoverColor;
+    };
+
+    // 第 button 个按钮在单元格中的位置（整排居中）
+    QRect buttonRect(const QRect &cell, int button) const;
+
+    // 单元格内位于 pos 的按钮序号，没有时返回-1
+    int buttonAt(const QRect &cell, const QPoint &pos) const;
+
+    QList<Button> buttons;
+};
+
+#endif // ACTIONBUTTONDELEGATE_H
@@ -4,6 +4,7 @@
 #include "../utils/stylehelper.h"
 #include "../database/ProjectDAO.h"
 #include "../database/WarningDAO.h"
+#include "../database/AsyncDAO.h"
 #include "../models/Project.h"
 #include <QApplication>
 #include <QScreen>
@@ -501,11 +502,29 @@ void DashboardWindow::onProjectListItemDoubleClicked(QListWidgetItem *item)
 
 void DashboardWindow::showAllProjects()
 {
-    ProjectDAO projectDAO;
-    WarningDAO warningDAO;
+    // 在数据库线程查询，完成后回到界面线程刷新；窗口关闭时查询被取消
+    int request = ++overviewRequest;
     
-    // 从数据库获取所有活动项目
-    QList<Project> projects = projectDAO.getProjectsByStatus("active");
+    AsyncDAO::run(this, [] {
+        ProjectDAO projectDAO;
+        WarningDAO warningDAO;
+        
+        ProjectOverview overview;
+        overview.projects = projectDAO.getProjectsByStatus("active");
+        overview.projectCount = projectDAO.getProjectCount();
+        overview.avgProgress = projectDAO.getAverageProgress();
+        overview.warningCount = warningDAO.getTotalWarningCount();
+        return overview;
+    }).then(this, [this, request](const ProjectOverview &overview) {
+        if (request == overviewRequest) {
+            populateAllProjects(overview);
+        }
+    });
+}
+
+void DashboardWindow::populateAllProjects(const ProjectOverview &overview)
+{
+    const QList<Project> &projects = overview.projects;
     
     // 清除并重新加载地图标记
     mapWidget->clearMarkers();
@@ -584,17 +603,13 @@ void DashboardWindow::showAllProjects()
     }
 
     // 更新统计信息
-    int projectCount = projectDAO.getProjectCount();
-    double avgProgress = projectDAO.getAverageProgress();
-    int warningCount = warningDAO.getTotalWarningCount();
-    
     statisticsLabel->setText(QString("在建项目统计\n\n"
                                     "项目总数: %1\n"
                                     "平均进度: %2%\n"
                                     "预警数量: %3")
-                            .arg(projectCount)
-                            .arg(QString::number(avgProgress, 'f', 1))
-                            .arg(warningCount));
+                            .arg(overview.projectCount)
+                            .arg(QString::number(overview.avgProgress, 'f', 1))
+                            .arg(overview.warningCount));
     
     // 清除旧的进度条
     QLayoutItem *item;
@@ -647,6 +662,9 @@ void DashboardWindow::showAllProjects()
 
 void DashboardWindow::showSingleProject(const QString &projectName)
 {
+    // 丢弃尚未返回的总览查询结果
+    ++overviewRequest;
+    
     ProjectDAO projectDAO;
     WarningDAO warningDAO;
     
@@ -13,6 +13,7 @@
 #include <QListWidgetItem>
 #include <QFrame>
 #include "mapwidget.h"
+#include "../models/Project.h"
 
 class DashboardWindow : public QMainWindow
 {
@@ -45,6 +46,15 @@ private:
     void showAllProjects();
     void showSingleProject(const QString &projectName);
     
+    // 全部项目总览数据（在数据库线程查询）
+    struct ProjectOverview {
+        QList<Project> projects;
+        int projectCount = 0;
+        double avgProgress = 0.0;
+        int warningCount = 0;
+    };
+    void populateAllProjects(const ProjectOverview &overview);
+    
     // UI组件
     QWidget *centralWidget;
     QPushButton *workbenchButton;
@@ -81,6 +91,9 @@ private:
     
     // 当前选中的项目
     QString selectedProject;
+    
+    // 总览查询序号，切换显示后到达的旧结果被丢弃
+    int overviewRequest = 0;
 };
 
 #endif // DASHBOARDWINDOW_H
@@ -0,0 +1,139 @@
+#include "excavationtablemodel.h"
+#include <QDateTime>
+
+ExcavationTableModel::ExcavationTableModel(QObject *parent)
+    : PagedTableModel(parent)
+{
+}
+
+void ExcavationTableModel::setQuery(const ExcavationParameterDAO::ExcavationQuery &query)
+{
+    currentQuery = query;
+    reload();
+}
+
+int ExcavationTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ExcavationTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    int offset = 0;
+    const RowPage *page = static_cast<const RowPage *>(pageAt(index.row(), offset));
+    if (!page) {
+        return QVariant();
+    }
+
+    const Row &row = page->rows[static_cast<size_t>(offset)];
+    const ExcavationColumnCache::StringDictionary &dictionary = page->dictionary;
+    switch (index.column()) {
+    case ProjectColumn:
+        return dictionary.decode(row.projectName);
+    case TimeColumn:
+        return QDateTime::fromMSecsSinceEpoch(row.timeMs).toString("yyyy-MM-dd HH:mm:ss");
+    case StakeMarkColumn:
+        return dictionary.decode(row.stakeMark);
+    case ModeColumn:
+        return dictionary.decode(row.excavationMode);
+    case ChamberPressureColumn:
+        return QString::number(row.chamberPressure, 'f', 2);
+    case ThrustForceColumn:
+        return QString::number(row.thrustForce, 'f', 0);
+    case CutterSpeedColumn:
+        return QString::number(row.cutterSpeed, 'f', 1);
+    case CutterTorqueColumn:
+        return QString::number(row.cutterTorque, 'f', 0);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant ExcavationTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    static const QStringList headers = {
+        "项目名称", "掘进时间", "掘进坐标/桩号", "掘进模式",
+        "土仓土压力", "千斤顶推力", "刀盘转速", "刀盘扭矩"
+    };
+    return headers.value(section);
+}
+
+PagedTableModel::Fetcher ExcavationTableModel::pageFetcher(const PageCursor &after, PageDirection direction,
+                                                           int limit) const
+{
+    ExcavationParameterDAO::ExcavationQuery batchQuery = currentQuery;
+    batchQuery.after = after;
+    batchQuery.direction = direction;
+    batchQuery.limit = limit;
+    return [batchQuery] {
+        return fetchPage(batchQuery);
+    };
+}
+
+PagedTableModel::FetchResult ExcavationTableModel::fetchPage(const ExcavationParameterDAO::ExcavationQuery &query)
+{
+    FetchResult result;
+
+    ExcavationParameterDAO dao;
+    QList<ExcavationParameterDAO::ExcavationRow> batch = dao.queryExcavationRows(query);
+    if (!dao.getLastError().isEmpty()) {
+        result.error = dao.getLastError();
+        return result;
+    }
+
+    result.rowCount = batch.size();
+    if (batch.isEmpty()) {
+        return result;
+    }
+
+    auto page = std::make_shared<RowPage>();
+    page->rowCount = batch.size();
+    page->rows.reserve(static_cast<size_t>(batch.size()));
+    for (const auto &entry : batch) {
+        const ExcavationParameter &param = entry.param;
+        Row row;
+        row.timeMs = param.getExcavationTime().toMSecsSinceEpoch();
+        row.chamberPressure = static_cast<float>(param.getChamberPressure());
+        row.thrustForce = static_cast<float>(param.getThrustForce());
+        row.cutterSpeed = static_cast<float>(param.getCutterSpeed());
+        row.cutterTorque = static_cast<float>(param.getCutterTorque());
+        row.projectName = page->dictionary.encode(entry.projectName);
+        row.stakeMark = page->dictionary.encode(param.getStakeMark());
+        row.excavationMode = page->dictionary.encode(param.getExcavationMode());
+        page->rows.push_back(row);
+    }
+
+    // 首尾游标都保留，向后翻页从首行、向前翻页从末行开始查询
+    page->range.first = ExcavationParameterDAO::cursorFor(batch.first().param, query.order);
+    page->range.last = ExcavationParameterDAO::cursorFor(batch.last().param, query.order);
+    result.page = page;
+    return result;
+}
+
+void ExcavationTableModel::sort(int column, Qt::SortOrder order)
+{
+    PageOrder pageOrder;
+    if (column == TimeColumn) {
+        pageOrder = PageOrder::ByTime;
+    } else if (column == StakeMarkColumn) {
+        pageOrder = PageOrder::ByMileage;
+    } else {
+        return;
+    }
+
+    if (pageOrder == currentQuery.order && order == currentQuery.sortOrder) {
+        return;
+    }
+
+    currentQuery.order = pageOrder;
+    currentQuery.sortOrder = order;
+    reload();
+}
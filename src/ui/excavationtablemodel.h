@@ -0,0 +1,73 @@
+#ifndef EXCAVATIONTABLEMODEL_H
+#define EXCAVATIONTABLEMODEL_H
+
+#include <vector>
+#include "pagedtablemodel.h"
+#include "../database/ExcavationParameterDAO.h"
+#include "../database/ExcavationColumnCache.h"
+
+/**
+ * @brief 掘进信息表格模型
+ *
+ * 按查询条件通过游标分批读取掘进参数，只保留最近几批组成的滑动窗口（见 PagedTableModel）。
+ * 每批的紧凑行与字符串字典在数据库线程中生成，每行只保存显示所需的紧凑字段
+ * （字符串按批字典编码），单元格文本在 data() 中按需生成。
+ * 过滤与排序都在SQL中完成，支持按掘进时间与桩号（里程）排序。
+ */
+class ExcavationTableModel : public PagedTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        ProjectColumn,
+        TimeColumn,
+        StakeMarkColumn,
+        ModeColumn,
+        ChamberPressureColumn,
+        ThrustForceColumn,
+        CutterSpeedColumn,
+        CutterTorqueColumn,
+        ColumnCount
+    };
+
+    explicit ExcavationTableModel(QObject *parent = nullptr);
+
+    // 设置查询条件并从头加载（limit、after 与 direction 由模型管理）
+    void setQuery(const ExcavationParameterDAO::ExcavationQuery &query);
+    const ExcavationParameterDAO::ExcavationQuery &query() const { return currentQuery; }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // 只支持掘进时间与桩号（按里程）列，其余列忽略
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+protected:
+    Fetcher pageFetcher(const PageCursor &after, PageDirection direction, int limit) const override;
+
+private:
+    // 一行的紧凑存储
+    struct Row {
+        qint64 timeMs = 0;
+        float chamberPressure = 0.0f;
+        float thrustForce = 0.0f;
+        float cutterSpeed = 0.0f;
+        float cutterTorque = 0.0f;
+        quint32 projectName = 0;        // 以下为字典编号
+        quint32 stakeMark = 0;
+        quint32 excavationMode = 0;
+    };
+
+    struct RowPage : Page {
+        std::vector<Row> rows;
+        ExcavationColumnCache::StringDictionary dictionary;
+    };
+
+    static FetchResult fetchPage(const ExcavationParameterDAO::ExcavationQuery &query);
+
+    ExcavationParameterDAO::ExcavationQuery currentQuery;
+};
+
+#endif // EXCAVATIONTABLEMODEL_H
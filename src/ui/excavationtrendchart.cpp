@@ -0,0 +1,250 @@
+#include "excavationtrendchart.h"
+#include "../database/AsyncDAO.h"
+#include "../database/ExcavationParameterDAO.h"
+#include "../utils/stylehelper.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QPaintEvent>
+#include <QHash>
+#include <algorithm>
+
+namespace {
+
+// 绘图区边距（像素）：左侧留给纵轴刻度，底部留给横轴标签
+const int MARGIN_LEFT = 64;
+const int MARGIN_RIGHT = 16;
+const int MARGIN_TOP = 12;
+const int MARGIN_BOTTOM = 28;
+
+const int Y_TICKS = 5;
+const int MIN_POINT_BUDGET = 50;
+
+// 聚合字段名与段记录数值列的对应
+int segmentFieldIndex(const QString &field)
+{
+    static const QHash<QString, int> fields = {
+        {"mileage", ExcavationColumnCache::Mileage},
+        {"chamber_pressure", ExcavationColumnCache::ChamberPressure},
+        {"thrust_force", ExcavationColumnCache::ThrustForce},
+        {"cutter_speed", ExcavationColumnCache::CutterSpeed},
+        {"cutter_torque", ExcavationColumnCache::CutterTorque},
+        {"excavation_speed", ExcavationColumnCache::ExcavationSpeed},
+        {"grouting_pressure", ExcavationColumnCache::GroutingPressure},
+        {"grouting_volume", ExcavationColumnCache::GroutingVolume},
+        {"excavation_distance", ExcavationColumnCache::ExcavationDistance}
+    };
+    return fields.value(field, -1);
+}
+
+}
+
+ExcavationTrendChart::ExcavationTrendChart(QWidget *parent)
+    : QWidget(parent)
+    , loading(false)
+    , requestSerial(0)
+{
+    setMinimumHeight(220);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+int ExcavationTrendChart::pointBudget() const
+{
+    return std::max(MIN_POINT_BUDGET, width() - MARGIN_LEFT - MARGIN_RIGHT);
+}
+
+void ExcavationTrendChart::showTimeSeries(int projectId, const QString &field,
+                                          const QDateTime &startTime, const QDateTime &endTime)
+{
+    int request = ++requestSerial;
+    int maxPoints = pointBudget();
+    loading = true;
+    update();
+
+    AsyncDAO::run(this, [projectId, field, startTime, endTime, maxPoints] {
+        Series result;
+        result.points = ExcavationRollupDAO().queryTimeSeries(projectId, field, startTime, endTime,
+                                                              maxPoints, &result.resolution);
+        return result;
+    }).then(this, [this, request](const Series &result) {
+        applySeries(request, result);
+    });
+}
+
+void ExcavationTrendChart::showRings(int projectId, const QString &field)
+{
+    int request = ++requestSerial;
+    int maxPoints = pointBudget();
+    loading = true;
+    update();
+
+    AsyncDAO::run(this, [projectId, field, maxPoints] {
+        Series result;
+        result.points = ExcavationRollupDAO().queryByRing(projectId, field, maxPoints);
+        result.resolution = ExcavationRollupDAO::Resolution::Ring;
+        return result;
+    }).then(this, [this, request](const Series &result) {
+        applySeries(request, result);
+    });
+}
+
+void ExcavationTrendChart::showHighFrequency(int projectId, const QString &field,
+                                             const QDateTime &startTime, const QDateTime &endTime)
+{
+    int request = ++requestSerial;
+    Series result;
+    result.resolution = ExcavationRollupDAO::Resolution::Raw;
+
+    int column = segmentFieldIndex(field);
+    if (column < 0) {
+        applySeries(request, result);
+        return;
+    }
+
+    // 段文件存储只能在主线程访问；记录区间直接指向映射内存，聚合完即释放
+    QVector<ExcavationSegmentStore::RecordSpan> spans =
+        ExcavationParameterDAO().getHighFrequencySamplesByTimeRange(projectId, startTime, endTime);
+
+    size_t total = 0;
+    for (const auto &span : spans) {
+        total += span.count;
+    }
+
+    const int maxPoints = pointBudget();
+    const qint64 startMs = startTime.toMSecsSinceEpoch();
+    const qint64 bucketMs = std::max<qint64>(1, (endTime.toMSecsSinceEpoch() - startMs) / maxPoints + 1);
+    const bool perSample = total <= static_cast<size_t>(maxPoints);
+
+    qint64 currentBucket = -1;
+    for (const auto &span : spans) {
+        for (size_t i = 0; i < span.count; ++i) {
+            const ExcavationSegmentStore::SegmentRecord &record = span.records[i];
+            const double value = record.values[column];
+            const qint64 bucket = perSample ? static_cast<qint64>(result.points.size())
+                                            : (record.timeMs - startMs) / bucketMs;
+            if (bucket != currentBucket) {
+                ExcavationRollupDAO::RollupPoint point;
+                point.firstTime = QDateTime::fromMSecsSinceEpoch(record.timeMs);
+                point.bucket = point.firstTime.toString("yyyy-MM-dd HH:mm:ss");
+                point.min = value;
+                point.max = value;
+                result.points.append(point);
+                currentBucket = bucket;
+            }
+
+            ExcavationRollupDAO::RollupPoint &point = result.points.last();
+            point.lastTime = QDateTime::fromMSecsSinceEpoch(record.timeMs);
+            point.count += 1;
+            point.min = std::min(point.min, value);
+            point.max = std::max(point.max, value);
+            point.sum += value;
+            point.sumSquares += value * value;
+        }
+    }
+
+    applySeries(request, result);
+}
+
+void ExcavationTrendChart::applySeries(int request, const Series &result)
+{
+    if (request != requestSerial) {
+        return;
+    }
+
+    series = result;
+    loading = false;
+    update();
+    emit loaded(series.resolution, series.points.size());
+}
+
+void ExcavationTrendChart::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QRectF plot(MARGIN_LEFT, MARGIN_TOP,
+                width() - MARGIN_LEFT - MARGIN_RIGHT, height() - MARGIN_TOP - MARGIN_BOTTOM);
+    painter.setPen(QColor(StyleHelper::COLOR_BORDER));
+    painter.drawRect(plot);
+
+    const QVector<ExcavationRollupDAO::RollupPoint> &points = series.points;
+    if (loading || points.isEmpty()) {
+        painter.setPen(QColor(StyleHelper::COLOR_TEXT_DARK));
+        painter.drawText(plot, Qt::AlignCenter, loading ? "加载中..." : "暂无数据");
+        return;
+    }
+
+    // 纵轴范围取所有点的最小/最大值
+    double low = points.first().min;
+    double high = points.first().max;
+    for (const auto &point : points) {
+        low = std::min(low, point.min);
+        high = std::max(high, point.max);
+    }
+    if (high - low < 1e-9) {
+        low -= 1.0;
+        high += 1.0;
+    }
+
+    // 横轴：按环显示时按序号均匀排列，时间序列按桶内最早时间
+    const bool byRing = (series.resolution == ExcavationRollupDAO::Resolution::Ring);
+    const qint64 firstMs = points.first().firstTime.toMSecsSinceEpoch();
+    const qint64 lastMs = points.last().firstTime.toMSecsSinceEpoch();
+    auto xAt = [&](int i) {
+        double t;
+        if (byRing || lastMs <= firstMs) {
+            t = points.size() > 1 ? static_cast<double>(i) / (points.size() - 1) : 0.5;
+        } else {
+            t = static_cast<double>(points.at(i).firstTime.toMSecsSinceEpoch() - firstMs) / (lastMs - firstMs);
+        }
+        return plot.left() + t * plot.width();
+    };
+    auto yAt = [&](double value) {
+        return plot.bottom() - (value - low) / (high - low) * plot.height();
+    };
+
+    // 纵轴刻度与网格
+    painter.setPen(QColor(StyleHelper::COLOR_TEXT_DARK));
+    for (int i = 0; i <= Y_TICKS; ++i) {
+        double value = low + (high - low) * i / Y_TICKS;
+        double y = yAt(value);
+        painter.setPen(QColor(235, 235, 235));
+        painter.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+        painter.setPen(QColor(StyleHelper::COLOR_TEXT_DARK));
+        painter.drawText(QRectF(0, y - 10, MARGIN_LEFT - 6, 20), Qt::AlignRight | Qt::AlignVCenter,
+                         QString::number(value, 'g', 5));
+    }
+
+    // 最小/最大值带：上沿为最大值，下沿为最小值
+    QPainterPath band;
+    band.moveTo(xAt(0), yAt(points.first().max));
+    for (int i = 1; i < points.size(); ++i) {
+        band.lineTo(xAt(i), yAt(points.at(i).max));
+    }
+    for (int i = points.size() - 1; i >= 0; --i) {
+        band.lineTo(xAt(i), yAt(points.at(i).min));
+    }
+    band.closeSubpath();
+    QColor bandColor(StyleHelper::COLOR_ACCENT);
+    bandColor.setAlpha(70);
+    painter.fillPath(band, bandColor);
+
+    // 均值折线
+    QPainterPath meanLine;
+    meanLine.moveTo(xAt(0), yAt(points.first().mean()));
+    for (int i = 1; i < points.size(); ++i) {
+        meanLine.lineTo(xAt(i), yAt(points.at(i).mean()));
+    }
+    painter.setPen(QPen(QColor(StyleHelper::COLOR_SECONDARY), 1.5));
+    painter.drawPath(meanLine);
+
+    // 横轴只标注首尾
+    painter.setPen(QColor(StyleHelper::COLOR_TEXT_DARK));
+    QRectF labelRect(plot.left(), plot.bottom() + 4, plot.width(), MARGIN_BOTTOM - 4);
+    QString firstLabel = byRing ? "环 " + points.first().bucket : points.first().bucket;
+    QString lastLabel = byRing ? "环 " + points.last().bucket : points.last().bucket;
+    painter.drawText(labelRect, Qt::AlignLeft | Qt::AlignTop, firstLabel);
+    painter.drawText(labelRect, Qt::AlignRight | Qt::AlignTop, lastLabel);
+}
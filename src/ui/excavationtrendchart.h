@@ -0,0 +1,59 @@
+#ifndef EXCAVATIONTRENDCHART_H
+#define EXCAVATIONTRENDCHART_H
+
+#include <QWidget>
+#include <QVector>
+#include <QString>
+#include "../database/ExcavationRollupDAO.h"
+
+/**
+ * @brief 掘进参数趋势图
+ *
+ * 从 excavation_rollups 多分辨率聚合读取某字段的趋势，绘制均值折线和最小/最大值带。
+ * 点数预算取绘图区宽度（像素），数据量再大每像素也只有一个点；
+ * 查询在数据库线程执行，界面线程只负责绘制。
+ * 高频模式直接读取段文件存储的映射记录，在界面线程按像素分桶聚合。
+ *
+ * 用法：
+ *   ExcavationTrendChart *chart = new ExcavationTrendChart(this);
+ *   chart->showTimeSeries(projectId, "chamber_pressure", start, end);
+ *   chart->showRings(projectId, "thrust_force");
+ */
+class ExcavationTrendChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ExcavationTrendChart(QWidget *parent = nullptr);
+
+    // 按时间范围显示，分辨率由点数预算自动选择
+    void showTimeSeries(int projectId, const QString &field, const QDateTime &startTime, const QDateTime &endTime);
+
+    // 按管片环显示（按环内最早时间排序）
+    void showRings(int projectId, const QString &field);
+
+    // 显示段文件存储中的高频采样，超出点数预算时按时间等分聚合
+    void showHighFrequency(int projectId, const QString &field, const QDateTime &startTime, const QDateTime &endTime);
+
+signals:
+    // 数据加载完成，resolution 为实际使用的分辨率
+    void loaded(ExcavationRollupDAO::Resolution resolution, int pointCount);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    struct Series {
+        QVector<ExcavationRollupDAO::RollupPoint> points;
+        ExcavationRollupDAO::Resolution resolution = ExcavationRollupDAO::Resolution::Raw;
+    };
+
+    int pointBudget() const;
+    void applySeries(int request, const Series &series);
+
+    Series series;
+    bool loading;
+    int requestSerial;      // 只采用最后一次请求的结果
+};
+
+#endif // EXCAVATIONTRENDCHART_H
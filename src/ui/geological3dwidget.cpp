@@ -1,5 +1,11 @@
 #include "geological3dwidget.h"
 #include "../utils/stylehelper.h"
+#include "instancedmarkermaterial.h"
+#include "../database/AsyncDAO.h"
+#include "../database/MileageDAO.h"
+#include "../api/ApiManager.h"
+#include "../api/ApiServer.h"
+#include "../api/DataSimulator.h"
 #include <Qt3DExtras/QPhongMaterial>
 #include <Qt3DExtras/QCylinderMesh>
 #include <Qt3DExtras/QSphereMesh>
@@ -8,6 +14,7 @@
 #include <Qt3DExtras/QPlaneMesh>
 #include <Qt3DExtras/QForwardRenderer>
 #include <Qt3DRender/QMesh>
+#include <Qt3DRender/QRenderSettings>
 #include <Qt3DCore/QTransform>
 #include <Qt3DRender/QGeometryRenderer>
 #include <Qt3DCore/QGeometry>
@@ -20,9 +27,50 @@
 #include <QTimer>
 #include <QDebug>
 #include <QMessageBox>
+#include <QScreen>
+#include <QQuaternion>
+#include <QMouseEvent>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
 #include <cmath>
 #include <cfloat>
 
+namespace {
+
+// 相机视点停止移动多久后调整分块（毫秒）
+const int CHUNK_UPDATE_DELAY_MS = 300;
+
+// 同时在后台生成的分块数上限，每个分块的插值内部已并行
+const int MAX_CHUNK_BUILDS = 2;
+
+// 实时里程两次更新之间的最短间隔（毫秒），屏幕刷新率更高时也不超过此频率
+const int MIN_FRAME_INTERVAL_MS = 8;
+
+// 盾构机尺寸（米）：盾体长度、刀盘厚度
+const float SHIELD_LENGTH = 9.0f;
+const float CUTTERHEAD_THICKNESS = 0.8f;
+
+// 已掘进段：衬砌环宽（米）、截面相对设计断面的放大比例（避免与设计隧道重叠闪烁）、截面环顶点数
+const double LINING_RING_WIDTH = 1.5;
+const double EXCAVATED_SCALE = 1.03;
+const int EXCAVATED_RING_SEGMENTS = 24;
+
+// 每次更新最多追加的衬砌环数，里程跳变较大时分多帧补齐，避免单帧生成和上传过多网格
+const int MAX_RINGS_PER_UPDATE = 200;
+
+// 按下与松开之间移动不超过此距离（像素）视为点击
+const int CLICK_TOLERANCE_PX = 4;
+
+// 钻孔标记尺寸（米）：圆柱半径、顶部球体半径，拾取包围盒与之一致
+const float BOREHOLE_COLUMN_RADIUS = 1.2f;
+const float BOREHOLE_SPHERE_RADIUS = 2.5f;
+
+// 拾取结果面板宽度（像素）
+const int PICK_PANEL_WIDTH = 280;
+
+} // namespace
+
 // 根据岩性名称返回对应的颜色
 QColor getColorForRockType(const QString &rockName) 
 {
@@ -93,6 +141,17 @@ QColor getColorForRockType(const QString &rockName)
 }
 
 Geological3DWidget::Geological3DWidget(int projectId, QWidget *parent)
+    : Geological3DWidget(projectId, true, parent)
+{
+}
+
+Geological3DWidget::Geological3DWidget(const GeologyScene &scene, QWidget *parent)
+    : Geological3DWidget(scene.projectId, false, parent)
+{
+    applyScene(scene);
+}
+
+Geological3DWidget::Geological3DWidget(int projectId, bool loadFromDatabase, QWidget *parent)
     : QWidget(parent)
     , projectId(projectId)
     , view3D(nullptr)
@@ -105,6 +164,16 @@ Geological3DWidget::Geological3DWidget(int projectId, QWidget *parent)
     , axesEntity(nullptr)
     , camera(nullptr)
     , cameraController(nullptr)
+    , boreholeMarkerMaterial(nullptr)
+    , chunkGeneration(0)
+    , runningChunkBuilds(0)
+    , chunkUpdateTimer(nullptr)
+    , hasShieldMileage(false)
+    , shieldMileage(0.0)
+    , tunnelMaterial(nullptr)
+    , shieldEntity(nullptr)
+    , shieldTransform(nullptr)
+    , shieldUpdateTimer(nullptr)
     , sceneMin(0, 0, 0)
     , sceneMax(0, 0, 0)
     , sceneCenter(0, 0, 0)
@@ -120,11 +189,10 @@ Geological3DWidget::Geological3DWidget(int projectId, QWidget *parent)
         setupUI();
         qDebug() << "setupUI完成";
         
-        loadData();
-        qDebug() << "loadData完成";
-        
-        renderScene();
-        qDebug() << "renderScene完成";
+        // 数据读取与网格生成在后台进行，完成后再渲染场景
+        if (loadFromDatabase) {
+            loadData();
+        }
     }
     catch (const std::exception& e) {
         qCritical() << "Geological3DWidget初始化异常:" << e.what();
@@ -163,8 +231,9 @@ void Geological3DWidget::setupUI()
     toggleBoreholeButton->setStyleSheet(StyleHelper::getButtonStyle());
     connect(toggleBoreholeButton, &QPushButton::clicked, [this]() {
         boreholesVisible = !boreholesVisible;
-        if (boreholeEntity) {
-            boreholeEntity->setEnabled(boreholesVisible);
+        // 所有钻孔标记共用一个材质，禁用材质即隐藏全部标记
+        if (boreholeMarkerMaterial) {
+            boreholeMarkerMaterial->setEnabled(boreholesVisible);
         }
         toggleBoreholeButton->setText(boreholesVisible ? "隐藏钻孔" : "显示钻孔");
     });
@@ -179,6 +248,34 @@ void Geological3DWidget::setupUI()
         toggleSurfaceButton->setText(surfaceVisible ? "隐藏地表" : "显示地表");
     });
     
+    // 性能统计：逻辑帧间隔、绘制调用、实体数与缓冲大小，同时输出到日志
+    sceneStatistics = new SceneStatistics(this);
+    toggleStatisticsButton = new QPushButton("性能统计", this);
+    toggleStatisticsButton->setStyleSheet(StyleHelper::getButtonStyle());
+    toggleStatisticsButton->setCheckable(true);
+    connect(toggleStatisticsButton, &QPushButton::toggled, [this](bool checked) {
+        sceneStatistics->setEnabled(checked);
+        statisticsLabel->setVisible(checked);
+        statisticsLabel->setText(checked ? "正在统计..." : "");
+    });
+    
+    statisticsLabel = new QLabel("", this);
+    statisticsLabel->setStyleSheet(QString("color: %1; padding: 2px 10px;").arg(StyleHelper::COLOR_TEXT_DARK));
+    statisticsLabel->setVisible(false);
+    connect(sceneStatistics, &SceneStatistics::updated, this, [this](const SceneStatistics::Snapshot &snapshot) {
+        statisticsLabel->setText(snapshot.toString());
+    });
+    
+    // 拾取结果面板，位于三维视图右侧，点击空白处隐藏
+    pickInfoLabel = new QLabel("", this);
+    pickInfoLabel->setStyleSheet(QString("background-color: white; border: 1px solid %1; color: %2; padding: 8px;")
+                                     .arg(StyleHelper::COLOR_BORDER, StyleHelper::COLOR_TEXT_DARK));
+    pickInfoLabel->setFixedWidth(PICK_PANEL_WIDTH);
+    pickInfoLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
+    pickInfoLabel->setWordWrap(true);
+    pickInfoLabel->setTextFormat(Qt::RichText);
+    pickInfoLabel->setVisible(false);
+    
     infoLabel = new QLabel("", this);
     infoLabel->setStyleSheet(QString("color: %1;").arg(StyleHelper::COLOR_TEXT_DARK));
     
@@ -188,8 +285,10 @@ void Geological3DWidget::setupUI()
     controlLayout->addWidget(resetViewButton);
     controlLayout->addWidget(toggleBoreholeButton);
     controlLayout->addWidget(toggleSurfaceButton);
+    controlLayout->addWidget(toggleStatisticsButton);
     
     mainLayout->addWidget(controlBar);
+    mainLayout->addWidget(statisticsLabel);
     
     // 创建3D视图
     view3D = new Qt3DExtras::Qt3DWindow();
@@ -200,47 +299,126 @@ void Geological3DWidget::setupUI()
     
     qDebug() << "Qt3DWindow创建成功";
     view3D->defaultFrameGraph()->setClearColor(QColor("#e8f4f8"));  // 浅蓝色背景
+    // 按需渲染：只在相机或场景变化时绘制，静止时不占用CPU/GPU
+    view3D->renderSettings()->setRenderPolicy(Qt3DRender::QRenderSettings::OnDemand);
     container = QWidget::createWindowContainer(view3D, this);
     container->setMinimumSize(800, 600);
     
-    mainLayout->addWidget(container, 1);
+    view3D->installEventFilter(this);
+    
+    QHBoxLayout *viewLayout = new QHBoxLayout();
+    viewLayout->setSpacing(10);
+    viewLayout->addWidget(container, 1);
+    viewLayout->addWidget(pickInfoLabel);
+    mainLayout->addLayout(viewLayout, 1);
+    
+    // 相机视点停止移动后再按新的焦点调整分块，拖动过程中不反复生成
+    chunkUpdateTimer = new QTimer(this);
+    chunkUpdateTimer->setSingleShot(true);
+    chunkUpdateTimer->setInterval(CHUNK_UPDATE_DELAY_MS);
+    connect(chunkUpdateTimer, &QTimer::timeout, this, &Geological3DWidget::updateChunks);
+    connect(view3D->camera(), &Qt3DRender::QCamera::viewCenterChanged,
+            chunkUpdateTimer, qOverload<>(&QTimer::start));
+    
+    // 实时里程：同一显示帧内到达的多条数据只取最新一条更新盾构机
+    shieldUpdateTimer = new QTimer(this);
+    shieldUpdateTimer->setSingleShot(true);
+    connect(shieldUpdateTimer, &QTimer::timeout, this, &Geological3DWidget::applyShieldMileage);
+    
+    ApiManager *apiManager = ApiManager::instance();
+    if (apiManager->apiServer()) {
+        connect(apiManager->apiServer(), &ApiServer::excavationDataReceived,
+                this, &Geological3DWidget::onExcavationData);
+    }
+    if (apiManager->dataSimulator()) {
+        connect(apiManager->dataSimulator(), &DataSimulator::excavationDataGenerated,
+                this, &Geological3DWidget::onExcavationData);
+    }
 }
 
 void Geological3DWidget::loadData()
 {
-    tunnelSegments.clear();
-    boreholes.clear();
-    
-    // 加载隧道轮廓数据
-    TunnelProfileDAO tunnelDAO;
-    QVector<TunnelProfileData> profiles = tunnelDAO.getProfilesByProjectId(projectId);
-    
-    qDebug() << "加载的隧道断面数量:" << profiles.size();
+    if (infoLabel) {
+        infoLabel->setText("正在加载三维模型...");
+    }
     
-    for (const auto &profile : profiles) {
-        TunnelSegment segment;
-        segment.topLeft = QVector3D(profile.topLeftX, profile.topLeftY, profile.topLeftZ);
-        segment.topRight = QVector3D(profile.topRightX, profile.topRightY, profile.topRightZ);
-        segment.bottomLeft = QVector3D(profile.bottomLeftX, profile.bottomLeftY, profile.bottomLeftZ);
-        segment.bottomRight = QVector3D(profile.bottomRightX, profile.bottomRightY, profile.bottomRightZ);
-        tunnelSegments.append(segment);
+    // 数据库读取在数据库线程池中进行；地层与隧道网格按里程分块，场景建好后
+    // 由 updateChunks() 按需在全局线程池中生成；窗口关闭后未完成的加载自动取消
+    const int id = projectId;
+    AsyncDAO::run(this, [id] { return GeologySceneBuilder::read(id); })
+        .then(this, [this](const GeologyScene &scene) {
+            applyScene(scene);
+        });
+}
+
+void Geological3DWidget::applyScene(const GeologyScene &scene)
+{
+    if (!scene.error.isEmpty()) {
+        qWarning() << "读取三维场景数据失败:" << scene.error;
     }
     
-    // 加载钻孔数据
-    BoreholeDAO boreholeDAO;
-    boreholes = boreholeDAO.getBoreholesByProjectId(projectId);
+    boreholes = scene.boreholes;
+    tunnelProfiles = scene.tunnelProfiles;
+    hasShieldMileage = scene.hasShieldPosition;
+    shieldMileage = scene.shieldMileage;
+    
+    // 实时里程是桩号里程，隧道轴线使用与分块相同的桩号里程轴
+    chunkPlanner.plan(boreholes, tunnelProfiles);
+    tunnelAlignment.setProfiles(chunkPlanner.chainageAxis().toChainage(tunnelProfiles));
+    
+    // 旧场景的分块随旧根实体一起释放，仍在生成的结果到达后丢弃
+    chunkGeneration++;
+    chunkStates.clear();
+    layerMaterials.clear();
+    if (pickInfoLabel) {
+        pickInfoLabel->setVisible(false);
+    }
     
+    qDebug() << "加载的隧道断面数量:" << tunnelProfiles.size();
     qDebug() << "加载的钻孔数量:" << boreholes.size();
-    
-    // 按照里程排序钻孔
-    std::sort(boreholes.begin(), boreholes.end(), [](const BoreholeData &a, const BoreholeData &b) {
-        return a.mileage < b.mileage;
-    });
-    
+    qDebug() << "三维场景分块数量:" << chunkPlanner.chunks().size();
+    
+    updateInfoLabel();
+    
+    // 重新加载时先建好新场景再释放旧场景
+    Qt3DCore::QEntity *oldRootEntity = rootEntity;
+    rootEntity = nullptr;
+    tunnelEntity = nullptr;
+    boreholeEntity = nullptr;
+    geologicalLayersEntity = nullptr;
+    surfaceEntity = nullptr;
+    axesEntity = nullptr;
+    cameraController = nullptr;
+    boreholeMarkerMaterial = nullptr;
+    tunnelMaterial = nullptr;
+    shieldEntity = nullptr;
+    shieldTransform = nullptr;
+    excavated = ExcavatedSection();
+    
+    renderScene();
+    delete oldRootEntity;
+}
+
+SceneStatistics::Snapshot Geological3DWidget::sceneSnapshot() const
+{
+    return SceneStatistics::collect(rootEntity);
+}
+
+void Geological3DWidget::updateInfoLabel()
+{
     // 输出信息
-    QString info = QString("钻孔: %1个 | 隧道断面: %2个")
+    int loadedChunks = 0;
+    for (const ChunkState &state : chunkStates) {
+        if (state.level >= 0) {
+            loadedChunks++;
+        }
+    }
+    
+    QString info = QString("钻孔: %1个 | 隧道断面: %2个 | 已加载分块: %3/%4")
         .arg(boreholes.size())
-        .arg(tunnelSegments.size());
+        .arg(tunnelProfiles.size())
+        .arg(loadedChunks)
+        .arg(chunkPlanner.chunks().size());
     if (infoLabel) {
         infoLabel->setText(info);
     }
@@ -261,11 +439,20 @@ void Geological3DWidget::renderScene()
     createGroundSurface();       // 地表
     createGeologicalVolume();    // 地质体 - 改进版
     createTunnelMesh();          // 隧道 - 改进版
+    createShieldMachine();       // 盾构机
+    createExcavatedSection();    // 已掘进段
     
     // 设置场景
     view3D->setRootEntity(rootEntity);
+    sceneStatistics->setRootEntity(rootEntity);
     setup3DView();
     
+    // 地层与隧道网格按焦点里程分块加载
+    updateChunks();
+    
+    // 按已知里程摆放盾构机、生成已掘进段
+    applyShieldMileage();
+    
     qDebug() << "✓ 场景渲染完成";
 }
 
@@ -276,131 +463,674 @@ void Geological3DWidget::createTunnelMesh()
         return;
     }
     
-    if (tunnelSegments.isEmpty()) {
+    if (tunnelProfiles.isEmpty()) {
         qWarning() << "没有隧道数据";
         return;
     }
     
     tunnelEntity = new Qt3DCore::QEntity(rootEntity);
     
-    qDebug() << "开始创建改进的隧道模型，断面数:" << tunnelSegments.size();
+    // 各断面的截面沿里程连成连续网格，按里程分块生成（只含钻孔范围内的隧道段），
+    // 由 updateChunks() 加载到 tunnelEntity 下，各分块共用一个材质
+    tunnelMaterial = new Qt3DExtras::QPhongMaterial(tunnelEntity);
+    tunnelMaterial->setDiffuse(QColor(70, 130, 220, 200));  // 蓝色，半透明
+    tunnelMaterial->setAmbient(QColor(40, 80, 150));
+    tunnelMaterial->setSpecular(QColor(120, 170, 255, 100));
+    tunnelMaterial->setShininess(60.0f);
+    
+    qDebug() << "✓ 创建了隧道实体，断面数:" << tunnelProfiles.size() << "，网格按里程分块加载";
+}
+
+void Geological3DWidget::createTunnelChunk(const TunnelMeshBuilder &builder, Qt3DCore::QEntity *parent)
+{
+    Qt3DCore::QEntity *chunkEntity = new Qt3DCore::QEntity(parent);
     
-    // 计算隧道中心线的所有点
-    QVector<QVector3D> centerPoints;
-    float totalRadius = 0.0f;
+    // 交错顶点缓冲：位置、法线
+    Qt3DCore::QBuffer *vertexBuffer = new Qt3DCore::QBuffer();
+    vertexBuffer->setData(builder.vertexBytes());
     
-    for (int i = 0; i < tunnelSegments.size(); i++) {
-        const TunnelSegment &seg = tunnelSegments[i];
-        
-        // 计算断面中心点（4个角点的平均）
-        QVector3D center = (seg.topLeft + seg.topRight + seg.bottomLeft + seg.bottomRight) / 4.0f;
-        centerPoints.append(center);
-        
-        // 计算隧道半径（宽度和高度的平均值的一半）
-        float width = seg.topLeft.distanceToPoint(seg.topRight);
-        float height = seg.topLeft.distanceToPoint(seg.bottomLeft);
-        totalRadius += (width + height) / 4.0f;
+    Qt3DCore::QAttribute *positionAttribute = new Qt3DCore::QAttribute();
+    positionAttribute->setName(Qt3DCore::QAttribute::defaultPositionAttributeName());
+    positionAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
+    positionAttribute->setVertexSize(3);
+    positionAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
+    positionAttribute->setBuffer(vertexBuffer);
+    positionAttribute->setByteOffset(TunnelMeshBuilder::POSITION_OFFSET);
+    positionAttribute->setByteStride(TunnelMeshBuilder::VERTEX_STRIDE);
+    positionAttribute->setCount(builder.vertices().size());
+    
+    Qt3DCore::QAttribute *normalAttribute = new Qt3DCore::QAttribute();
+    normalAttribute->setName(Qt3DCore::QAttribute::defaultNormalAttributeName());
+    normalAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
+    normalAttribute->setVertexSize(3);
+    normalAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
+    normalAttribute->setBuffer(vertexBuffer);
+    normalAttribute->setByteOffset(TunnelMeshBuilder::NORMAL_OFFSET);
+    normalAttribute->setByteStride(TunnelMeshBuilder::VERTEX_STRIDE);
+    normalAttribute->setCount(builder.vertices().size());
+    
+    // 索引缓冲
+    Qt3DCore::QBuffer *indexBuffer = new Qt3DCore::QBuffer();
+    indexBuffer->setData(builder.indexBytes());
+    
+    Qt3DCore::QAttribute *indexAttribute = new Qt3DCore::QAttribute();
+    indexAttribute->setVertexBaseType(Qt3DCore::QAttribute::UnsignedInt);
+    indexAttribute->setAttributeType(Qt3DCore::QAttribute::IndexAttribute);
+    indexAttribute->setBuffer(indexBuffer);
+    indexAttribute->setCount(builder.indices().size());
+    
+    Qt3DCore::QGeometry *geometry = new Qt3DCore::QGeometry();
+    geometry->addAttribute(positionAttribute);
+    geometry->addAttribute(normalAttribute);
+    geometry->addAttribute(indexAttribute);
+    
+    Qt3DRender::QGeometryRenderer *geometryRenderer = new Qt3DRender::QGeometryRenderer();
+    geometryRenderer->setGeometry(geometry);
+    geometryRenderer->setPrimitiveType(Qt3DRender::QGeometryRenderer::Triangles);
+    
+    chunkEntity->addComponent(geometryRenderer);
+    chunkEntity->addComponent(tunnelMaterial);
+}
+
+QVector<double> Geological3DWidget::focusMileages() const
+{
+    QVector<double> mileages;
+    if (hasShieldMileage) {
+        mileages.append(shieldMileage);
+    }
+    if (camera && rootEntity) {
+        const QVector3D center = camera->viewCenter();
+        mileages.append(chunkPlanner.mileageAt(center.x(), center.y()));
+    }
+    return mileages;
+}
+
+void Geological3DWidget::updateChunks()
+{
+    if (!rootEntity) {
+        return;
     }
     
-    float avgRadius = totalRadius / centerPoints.size();
+    const QMap<int, GeologyChunk> &chunks = chunkPlanner.chunks();
+    const QVector<double> focus = focusMileages();
     
-    qDebug() << "隧道中心点数量:" << centerPoints.size();
-    qDebug() << "平均隧道半径:" << avgRadius;
+    // 重新划分后已不存在的分块直接释放
+    for (auto it = chunkStates.begin(); it != chunkStates.end(); ) {
+        if (!chunks.contains(it.key())) {
+            releaseChunk(it.value());
+            it = chunkStates.erase(it);
+        } else {
+            ++it;
+        }
+    }
     
-    // 【修改】根据钻孔范围限制隧道渲染 - 彻底修复无限延伸问题
-    float minBoreholeX = FLT_MAX, maxBoreholeX = -FLT_MAX;
-    float minBoreholeY = FLT_MAX, maxBoreholeY = -FLT_MAX;
+    // 需要生成的分块：细节级别或内容与已加载的不同，且没有正在生成（完成后会再次检查）
+    struct Request {
+        double distance;
+        int index;
+        int level;
+    };
+    QVector<Request> requests;
+    
+    for (const GeologyChunk &chunk : chunks) {
+        ChunkState &state = chunkStates[chunk.index];
+        const int level = chunkPlanner.levelFor(chunk, focus);
+    
+        if (level < 0) {
+            // 超出最远距离，卸载
+            if (state.level >= 0) {
+                releaseChunk(state);
+            }
+            continue;
+        }
+        if (state.pendingLevel >= 0 || (state.level == level && state.contentHash == chunk.contentHash)) {
+            continue;
+        }
     
-    for (const auto &bh : boreholes) {
-        minBoreholeX = qMin(minBoreholeX, static_cast<float>(bh.x));
-        maxBoreholeX = qMax(maxBoreholeX, static_cast<float>(bh.x));
-        minBoreholeY = qMin(minBoreholeY, static_cast<float>(bh.y));
-        maxBoreholeY = qMax(maxBoreholeY, static_cast<float>(bh.y));
-    }
-    
-    // 扩展钻孔范围20%作为隧道渲染边界
-    float rangeX = maxBoreholeX - minBoreholeX;
-    float rangeY = maxBoreholeY - minBoreholeY;
-    float extendRatio = 0.2f;
-    minBoreholeX -= rangeX * extendRatio;
-    maxBoreholeX += rangeX * extendRatio;
-    minBoreholeY -= rangeY * extendRatio;
-    maxBoreholeY += rangeY * extendRatio;
-    
-    qDebug() << "钻孔范围: X[" << minBoreholeX << "," << maxBoreholeX 
-             << "] Y[" << minBoreholeY << "," << maxBoreholeY << "]";
-    
-    int renderedSegments = 0;
-    for (int i = 0; i < centerPoints.size() - 1; i++) {
-        QVector3D p1 = centerPoints[i];
-        QVector3D p2 = centerPoints[i + 1];
-        
-        // 【关键】检查隧道段是否在钻孔范围内，跳过范围外的段
-        QVector3D midPoint = (p1 + p2) / 2.0f;
-        if (midPoint.x() < minBoreholeX || midPoint.x() > maxBoreholeX ||
-            midPoint.y() < minBoreholeY || midPoint.y() > maxBoreholeY) {
-            continue;  // 跳过范围外的隧道段
+        double distance = DBL_MAX;
+        for (double mileage : focus) {
+            distance = qMin(distance, std::abs((chunk.startMileage + chunk.endMileage) / 2.0 - mileage));
         }
-        
-        // 计算两点间距离和方向
-        QVector3D direction = p2 - p1;
-        float length = direction.length();
-        
-        if (length < 0.01f) continue;  // 跳过太短的段
-        
-        direction.normalize();
-        
-        // 创建圆柱体实体
-        Qt3DCore::QEntity *tunnelSegEntity = new Qt3DCore::QEntity(tunnelEntity);
-        
-        // 创建圆柱体网格
-        Qt3DExtras::QCylinderMesh *cylinder = new Qt3DExtras::QCylinderMesh();
-        cylinder->setRadius(avgRadius);
-        cylinder->setLength(length);
-        cylinder->setRings(8);
-        cylinder->setSlices(32);
-        
-        // 计算变换矩阵
-        Qt3DCore::QTransform *transform = new Qt3DCore::QTransform();
-        
-        // 圆柱体中心位置（使用之前计算的midPoint）
-        transform->setTranslation(midPoint);
-        
-        // 计算旋转：将圆柱体的Y轴（默认方向）对齐到direction
-        QVector3D defaultDir(0, 1, 0);  // Qt3D圆柱体默认沿Y轴
-        QVector3D rotationAxis = QVector3D::crossProduct(defaultDir, direction);
-        
-        if (rotationAxis.length() > 0.0001f) {
-            rotationAxis.normalize();
-            float dotProduct = QVector3D::dotProduct(defaultDir, direction);
-            // 限制dotProduct在[-1, 1]范围内
-            dotProduct = qBound(-1.0f, dotProduct, 1.0f);
-            float angle = std::acos(dotProduct);
-            transform->setRotation(QQuaternion::fromAxisAndAngle(rotationAxis, qRadiansToDegrees(angle)));
-        } else {
-            // 如果方向几乎平行或反平行，使用简单旋转
-            if (QVector3D::dotProduct(defaultDir, direction) < 0) {
-                transform->setRotation(QQuaternion::fromAxisAndAngle(QVector3D(1, 0, 0), 180));
+        requests.append(Request{ distance, chunk.index, level });
+    }
+    
+    // 离焦点近的分块优先，同时生成的分块数有上限，其余等前面的完成后再安排
+    std::sort(requests.begin(), requests.end(), [](const Request &a, const Request &b) {
+        return a.distance < b.distance;
+    });
+    for (const Request &request : requests) {
+        if (runningChunkBuilds >= MAX_CHUNK_BUILDS) {
+            break;
+        }
+        startChunkBuild(chunks.value(request.index), request.level);
+    }
+    
+    updateInfoLabel();
+}
+
+void Geological3DWidget::startChunkBuild(const GeologyChunk &chunk, int level)
+{
+    chunkStates[chunk.index].pendingLevel = level;
+    runningChunkBuilds++;
+    
+    // 网格生成（或读取缓存）在全局线程池中进行，界面线程只创建实体并上传缓冲
+    const GeologyModelBuilder::Options model = chunkPlanner.modelOptions(chunk, level);
+    const TunnelMeshBuilder::Options tunnel = chunkPlanner.tunnelOptions(level);
+    const int generation = chunkGeneration;
+    
+    QtConcurrent::run([chunk, level, model, tunnel] {
+        return GeologySceneBuilder::buildChunk(chunk, level, model, tunnel);
+    }).then(this, [this, generation](const GeologyChunkMeshes &meshes) {
+        runningChunkBuilds--;
+        if (generation == chunkGeneration) {
+            applyChunk(meshes);
+        }
+        updateChunks();
+        if (runningChunkBuilds == 0) {
+            emit chunksLoaded();
+        }
+    });
+}
+
+void Geological3DWidget::applyChunk(const GeologyChunkMeshes &meshes)
+{
+    auto it = chunkStates.find(meshes.index);
+    if (it == chunkStates.end() || !rootEntity) {
+        return;
+    }
+    ChunkState &state = it.value();
+    state.pendingLevel = -1;
+    
+    // 生成期间分块内容已变化或已移出加载范围时丢弃；细节级别已变化时先显示，随后由 updateChunks() 重新生成
+    const GeologyChunk chunk = chunkPlanner.chunks().value(meshes.index);
+    if (chunk.contentHash != meshes.contentHash || chunkPlanner.levelFor(chunk, focusMileages()) < 0) {
+        return;
+    }
+    
+    // 先建新实体再释放旧实体，切换细节级别时不出现空洞
+    Qt3DCore::QEntity *layerEntity = nullptr;
+    if (geologicalLayersEntity && !meshes.layerBatches.isEmpty()) {
+        layerEntity = new Qt3DCore::QEntity(geologicalLayersEntity);
+        for (const GeologyMeshLayout::Batch &batch : meshes.layerBatches) {
+            createLayerBatch(batch, layerEntity);
+        }
+    }
+    
+    Qt3DCore::QEntity *chunkTunnelEntity = nullptr;
+    if (tunnelEntity && !meshes.tunnel.indices().isEmpty()) {
+        chunkTunnelEntity = new Qt3DCore::QEntity(tunnelEntity);
+        createTunnelChunk(meshes.tunnel, chunkTunnelEntity);
+    }
+    
+    releaseChunk(state);
+    state.layerEntity = layerEntity;
+    state.tunnelEntity = chunkTunnelEntity;
+    state.level = meshes.level;
+    state.contentHash = meshes.contentHash;
+    state.pickIndex = meshes.pickIndex;
+    for (const GeologyMeshLayout::Batch &batch : meshes.layerBatches) {
+        state.layerRockNames.append(batch.rockName);
+    }
+    
+    qDebug() << "✓ 分块" << meshes.index << "加载为细节级别" << meshes.level
+             << (meshes.fromCache ? "（缓存）" : "") << "：地层单元" << meshes.layerCellCount
+             << "，隧道管段" << meshes.tunnel.segmentCount();
+}
+
+void Geological3DWidget::releaseChunk(ChunkState &state)
+{
+    // 缓冲与几何体都是实体的子对象，随实体一起释放；材质为各分块共用，不释放
+    delete state.layerEntity;
+    delete state.tunnelEntity;
+    state.layerEntity = nullptr;
+    state.tunnelEntity = nullptr;
+    state.level = -1;
+    state.contentHash.clear();
+    state.pickIndex.clear();
+    state.layerRockNames.clear();
+}
+
+void Geological3DWidget::setShieldMileage(double mileage)
+{
+    hasShieldMileage = true;
+    shieldMileage = mileage;
+    pendingStakeMark.clear();
+    scheduleShieldUpdate();
+}
+
+void Geological3DWidget::setShieldStakeMark(const QString &stakeMark)
+{
+    hasShieldMileage = true;
+    pendingStakeMark = stakeMark;
+    scheduleShieldUpdate();
+}
+
+void Geological3DWidget::scheduleShieldUpdate()
+{
+    // 高频的实时里程只记录最新值，每个显示帧最多更新一次
+    if (shieldUpdateTimer && !shieldUpdateTimer->isActive()) {
+        const qreal refreshRate = (view3D && view3D->screen()) ? view3D->screen()->refreshRate() : 60.0;
+        shieldUpdateTimer->start(qMax(MIN_FRAME_INTERVAL_MS, qRound(1000.0 / qMax(refreshRate, 1.0))));
+    }
+}
+
+void Geological3DWidget::onExcavationData(int dataProjectId, const QJsonObject &data)
+{
+    if (dataProjectId != projectId) {
+        return;
+    }
+    
+    if (data.contains("mileage")) {
+        setShieldMileage(data.value("mileage").toDouble());
+    } else if (data.contains("stake_mark")) {
+        setShieldStakeMark(data.value("stake_mark").toString());
+    }
+}
+
+void Geological3DWidget::createShieldMachine()
+{
+    if (!rootEntity || tunnelAlignment.isEmpty()) {
+        return;
+    }
+    
+    const double mileage = hasShieldMileage ? shieldMileage : tunnelAlignment.startMileage();
+    const float radius = qMax(tunnelAlignment.radiusAt(mileage), 1.0f);
+    
+    // 盾构机整体一个变换，实时里程只更新这个变换；位置确定前不显示
+    shieldEntity = new Qt3DCore::QEntity(rootEntity);
+    shieldTransform = new Qt3DCore::QTransform();
+    shieldEntity->addComponent(shieldTransform);
+    shieldEntity->setEnabled(hasShieldMileage);
+    
+    // 盾体：沿局部Y轴的圆柱，略大于已掘进段以免被衬砌遮住
+    Qt3DCore::QEntity *body = new Qt3DCore::QEntity(shieldEntity);
+    Qt3DExtras::QCylinderMesh *bodyMesh = new Qt3DExtras::QCylinderMesh();
+    bodyMesh->setRadius(radius * 1.06f);
+    bodyMesh->setLength(SHIELD_LENGTH);
+    bodyMesh->setRings(2);
+    bodyMesh->setSlices(32);
+    
+    Qt3DExtras::QPhongMaterial *bodyMaterial = new Qt3DExtras::QPhongMaterial();
+    bodyMaterial->setDiffuse(QColor(255, 170, 0));  // 橙黄色
+    bodyMaterial->setAmbient(QColor(150, 100, 0));
+    bodyMaterial->setSpecular(QColor(255, 230, 180));
+    bodyMaterial->setShininess(60.0f);
+    
+    body->addComponent(bodyMesh);
+    body->addComponent(bodyMaterial);
+    
+    // 刀盘：盾体前端的圆盘
+    Qt3DCore::QEntity *cutterhead = new Qt3DCore::QEntity(shieldEntity);
+    Qt3DExtras::QCylinderMesh *cutterheadMesh = new Qt3DExtras::QCylinderMesh();
+    cutterheadMesh->setRadius(radius * 1.1f);
+    cutterheadMesh->setLength(CUTTERHEAD_THICKNESS);
+    cutterheadMesh->setRings(2);
+    cutterheadMesh->setSlices(32);
+    
+    Qt3DCore::QTransform *cutterheadTransform = new Qt3DCore::QTransform();
+    cutterheadTransform->setTranslation(QVector3D(0, (SHIELD_LENGTH + CUTTERHEAD_THICKNESS) / 2.0f, 0));
+    
+    Qt3DExtras::QPhongMaterial *cutterheadMaterial = new Qt3DExtras::QPhongMaterial();
+    cutterheadMaterial->setDiffuse(QColor(90, 90, 90));  // 深灰色
+    cutterheadMaterial->setAmbient(QColor(50, 50, 50));
+    cutterheadMaterial->setSpecular(QColor(200, 200, 200));
+    cutterheadMaterial->setShininess(80.0f);
+    
+    cutterhead->addComponent(cutterheadMesh);
+    cutterhead->addComponent(cutterheadTransform);
+    cutterhead->addComponent(cutterheadMaterial);
+    
+    qDebug() << "✓ 创建了盾构机，半径" << radius;
+}
+
+void Geological3DWidget::createExcavatedSection()
+{
+    if (!rootEntity || tunnelAlignment.isEmpty()) {
+        return;
+    }
+    
+    // 已掘进段从隧道起点开始，按衬砌环宽追加截面，裁剪范围与设计隧道一致
+    TunnelMeshBuilder::Options options;
+    options.ringSegments = EXCAVATED_RING_SEGMENTS;
+    options.clipRect = GeologySceneBuilder::tunnelClipRect(boreholes);
+    excavated = ExcavatedSection();
+    excavated.builder = TunnelMeshBuilder(options);
+    excavated.nextRingMileage = tunnelAlignment.startMileage();
+    
+    Qt3DCore::QEntity *sectionEntity = new Qt3DCore::QEntity(rootEntity);
+    
+    // 交错顶点缓冲：位置、法线
+    excavated.vertexBuffer = new Qt3DCore::QBuffer();
+    
+    excavated.positionAttribute = new Qt3DCore::QAttribute();
+    excavated.positionAttribute->setName(Qt3DCore::QAttribute::defaultPositionAttributeName());
+    excavated.positionAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
+    excavated.positionAttribute->setVertexSize(3);
+    excavated.positionAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
+    excavated.positionAttribute->setBuffer(excavated.vertexBuffer);
+    excavated.positionAttribute->setByteOffset(TunnelMeshBuilder::POSITION_OFFSET);
+    excavated.positionAttribute->setByteStride(TunnelMeshBuilder::VERTEX_STRIDE);
+    
+    excavated.normalAttribute = new Qt3DCore::QAttribute();
+    excavated.normalAttribute->setName(Qt3DCore::QAttribute::defaultNormalAttributeName());
+    excavated.normalAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
+    excavated.normalAttribute->setVertexSize(3);
+    excavated.normalAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
+    excavated.normalAttribute->setBuffer(excavated.vertexBuffer);
+    excavated.normalAttribute->setByteOffset(TunnelMeshBuilder::NORMAL_OFFSET);
+    excavated.normalAttribute->setByteStride(TunnelMeshBuilder::VERTEX_STRIDE);
+    
+    // 索引缓冲
+    excavated.indexBuffer = new Qt3DCore::QBuffer();
+    
+    excavated.indexAttribute = new Qt3DCore::QAttribute();
+    excavated.indexAttribute->setVertexBaseType(Qt3DCore::QAttribute::UnsignedInt);
+    excavated.indexAttribute->setAttributeType(Qt3DCore::QAttribute::IndexAttribute);
+    excavated.indexAttribute->setBuffer(excavated.indexBuffer);
+    
+    uploadExcavatedSection(0, 0);
+    
+    Qt3DCore::QGeometry *geometry = new Qt3DCore::QGeometry();
+    geometry->addAttribute(excavated.positionAttribute);
+    geometry->addAttribute(excavated.normalAttribute);
+    geometry->addAttribute(excavated.indexAttribute);
+    
+    Qt3DRender::QGeometryRenderer *geometryRenderer = new Qt3DRender::QGeometryRenderer();
+    geometryRenderer->setGeometry(geometry);
+    geometryRenderer->setPrimitiveType(Qt3DRender::QGeometryRenderer::Triangles);
+    
+    // 管片衬砌：不透明的混凝土灰
+    Qt3DExtras::QPhongMaterial *material = new Qt3DExtras::QPhongMaterial();
+    material->setDiffuse(QColor(175, 175, 170));
+    material->setAmbient(QColor(110, 110, 105));
+    material->setSpecular(QColor(60, 60, 60));
+    material->setShininess(20.0f);
+    
+    sectionEntity->addComponent(geometryRenderer);
+    sectionEntity->addComponent(material);
+}
+
+void Geological3DWidget::applyShieldMileage()
+{
+    if (!pendingStakeMark.isEmpty()) {
+        shieldMileage = MileageDAO::stakeMarkToMileage(pendingStakeMark);
+        pendingStakeMark.clear();
+    }
+    
+    if (!hasShieldMileage || !rootEntity || tunnelAlignment.isEmpty()) {
+        return;
+    }
+    
+    // 不在隧道范围内的里程（桩号错误或不属于本项目）不摆放盾构机，也不追加衬砌
+    if (shieldMileage < tunnelAlignment.startMileage() || shieldMileage > tunnelAlignment.endMileage() + SHIELD_LENGTH) {
+        if (shieldEntity && shieldEntity->isEnabled()) {
+            qWarning() << "盾构机里程超出隧道范围:" << shieldMileage
+                       << "范围" << tunnelAlignment.startMileage() << "-" << tunnelAlignment.endMileage();
+            shieldEntity->setEnabled(false);
+        }
+        return;
+    }
+    
+    if (shieldEntity) {
+        // 盾体中心在前盾里程之后半个盾体处，圆柱轴线（局部Y轴）转到隧道前进方向
+        const double center = shieldMileage - SHIELD_LENGTH / 2.0;
+        shieldTransform->setTranslation(tunnelAlignment.centerAt(center));
+        shieldTransform->setRotation(QQuaternion::rotationTo(QVector3D(0, 1, 0), tunnelAlignment.directionAt(center)));
+        shieldEntity->setEnabled(true);
+    }
+    
+    // 盾尾之后为已拼装的衬砌
+    appendExcavatedRings(shieldMileage - SHIELD_LENGTH);
+    
+    // 焦点移动后调整分块；实时数据连续到达时防抖会一直推迟，这里只在计时器空闲时启动
+    if (chunkUpdateTimer && !chunkUpdateTimer->isActive()) {
+        chunkUpdateTimer->start();
+    }
+}
+
+void Geological3DWidget::appendExcavatedRings(double tailMileage)
+{
+    // 衬砌不超出隧道终点；盾构机后退（里程修正）时已掘进段保持不变
+    const double tail = qMin(tailMileage, tunnelAlignment.endMileage());
+    if (!excavated.vertexBuffer || excavated.nextRingMileage > tail) {
+        return;
+    }
+    
+    QVector<TunnelProfileData> rings;
+    while (excavated.nextRingMileage <= tail && rings.size() < MAX_RINGS_PER_UPDATE) {
+        rings.append(tunnelAlignment.profileAt(excavated.nextRingMileage, EXCAVATED_SCALE));
+        excavated.nextRingMileage += LINING_RING_WIDTH;
+    }
+    
+    // 未追加完的在下一个显示帧继续
+    if (excavated.nextRingMileage <= tail && shieldUpdateTimer && !shieldUpdateTimer->isActive()) {
+        shieldUpdateTimer->start(MIN_FRAME_INTERVAL_MS);
+    }
+    
+    const int firstVertex = excavated.builder.vertices().size();
+    const int firstIndex = excavated.builder.indices().size();
+    excavated.builder.appendProfiles(rings);
+    uploadExcavatedSection(firstVertex, firstIndex);
+}
+
+void Geological3DWidget::uploadExcavatedSection(int firstVertex, int firstIndex)
+{
+    const TunnelMeshBuilder &builder = excavated.builder;
+    const int vertexCount = builder.vertices().size();
+    const int indexCount = builder.indices().size();
+    
+    // 新增数据放得下时只上传新增部分，否则重新分配并预留一半余量供后续追加
+    if (firstVertex > 0 && vertexCount <= excavated.vertexCapacity) {
+        if (vertexCount > firstVertex) {
+            excavated.vertexBuffer->updateData(firstVertex * TunnelMeshBuilder::VERTEX_STRIDE,
+                                               builder.vertexBytes(firstVertex));
+        }
+    } else {
+        excavated.vertexCapacity = vertexCount + vertexCount / 2;
+        QByteArray bytes = builder.vertexBytes();
+        bytes.append(QByteArray((excavated.vertexCapacity - vertexCount) * TunnelMeshBuilder::VERTEX_STRIDE, '\0'));
+        excavated.vertexBuffer->setData(bytes);
+    }
+    
+    if (firstIndex > 0 && indexCount <= excavated.indexCapacity) {
+        if (indexCount > firstIndex) {
+            excavated.indexBuffer->updateData(firstIndex * static_cast<int>(sizeof(quint32)),
+                                              builder.indexBytes(firstIndex));
+        }
+    } else {
+        excavated.indexCapacity = indexCount + indexCount / 2;
+        QByteArray bytes = builder.indexBytes();
+        bytes.append(QByteArray((excavated.indexCapacity - indexCount) * static_cast<int>(sizeof(quint32)), '\0'));
+        excavated.indexBuffer->setData(bytes);
+    }
+    
+    // 只绘制已生成的部分，余量不参与渲染
+    excavated.positionAttribute->setCount(vertexCount);
+    excavated.normalAttribute->setCount(vertexCount);
+    excavated.indexAttribute->setCount(indexCount);
+}
+
+void Geological3DWidget::reloadTunnelProfiles()
+{
+    const int id = projectId;
+    AsyncDAO::run(this, [id] { return TunnelProfileDAO().getProfilesByProjectId(id); })
+        .then(this, [this](const QVector<TunnelProfileData> &profiles) {
+            applyTunnelProfiles(profiles);
+        });
+}
+
+void Geological3DWidget::applyTunnelProfiles(const QVector<TunnelProfileData> &profiles)
+{
+    tunnelProfiles = profiles;
+    tunnelAlignment.setProfiles(ChainageAxis(boreholes, tunnelProfiles).toChainage(tunnelProfiles));
+    
+    if (!rootEntity) {
+        updateInfoLabel();
+        return;
+    }
+    
+    // 重新划分后只有内容变化的分块（新增断面时通常只是末端一两块）重新生成，
+    // 新网格就绪前旧网格保持显示
+    chunkPlanner.plan(boreholes, tunnelProfiles);
+    if (!tunnelEntity) {
+        createTunnelMesh();
+    }
+    if (!shieldEntity) {
+        createShieldMachine();
+        createExcavatedSection();
+    }
+    updateChunks();
+    applyShieldMileage();
+}
+
+bool Geological3DWidget::eventFilter(QObject *watched, QEvent *event)
+{
+    // 左键按下后几乎没有移动就松开视为点击（拖动用于旋转视角）
+    if (watched == view3D && (event->type() == QEvent::MouseButtonPress || event->type() == QEvent::MouseButtonRelease)) {
+        QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+        if (mouseEvent->button() == Qt::LeftButton) {
+            const QPoint position = mouseEvent->position().toPoint();
+            if (event->type() == QEvent::MouseButtonPress) {
+                pressPosition = position;
+            } else if ((position - pressPosition).manhattanLength() <= CLICK_TOLERANCE_PX) {
+                pickAt(position);
             }
         }
-        
-        // 创建材质
-        Qt3DExtras::QPhongMaterial *material = new Qt3DExtras::QPhongMaterial();
-        material->setDiffuse(QColor(70, 130, 220, 200));  // 蓝色，半透明
-        material->setAmbient(QColor(40, 80, 150));
-        material->setSpecular(QColor(120, 170, 255, 100));
-        material->setShininess(60.0f);
-        
-        // 添加组件
-        tunnelSegEntity->addComponent(cylinder);
-        tunnelSegEntity->addComponent(transform);
-        tunnelSegEntity->addComponent(material);
-        
-        renderedSegments++;  // 计数实际渲染的段数
     }
+    return QWidget::eventFilter(watched, event);
+}
+
+void Geological3DWidget::pickAt(const QPoint &position)
+{
+    if (!rootEntity || !camera || !view3D) {
+        return;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    // 从相机位置穿过鼠标所在像素的射线（窗口坐标原点在左下角）
+    const QRect viewport(0, 0, view3D->width(), view3D->height());
+    const QVector3D farPoint = QVector3D(position.x(), viewport.height() - position.y(), 1.0f)
+        .unproject(camera->viewMatrix(), camera->projectionMatrix(), viewport);
+    const QVector3D origin = camera->position();
+    const QVector3D direction = (farPoint - origin).normalized();
+    
+    // 各包围体层次依次求交，后面的只检测比已有交点更近的部分
+    PickingBvh::Hit hit;
+    int hitChunk = -1;
+    if (boreholesVisible) {
+        hit = boreholePickIndex.intersect(origin, direction);
+    }
+    for (auto it = chunkStates.constBegin(); it != chunkStates.constEnd(); ++it) {
+        if (it.value().level < 0) {
+            continue;
+        }
+        const PickingBvh::Hit chunkHit = it.value().pickIndex.intersect(origin, direction, hit.distance);
+        if (chunkHit.kind != PickingBvh::Kind::None) {
+            hit = chunkHit;
+            hitChunk = it.key();
+        }
+    }
+    
+    showPickResult(hit, hitChunk, timer.nsecsElapsed() / 1000.0);
+}
+
+void Geological3DWidget::showPickResult(const PickingBvh::Hit &hit, int chunkIndex, double elapsedUs)
+{
+    if (!pickInfoLabel) {
+        return;
+    }
+    if (hit.kind == PickingBvh::Kind::None) {
+        pickInfoLabel->setVisible(false);
+        return;
+    }
+    
+    QString html;
+    if (hit.kind == PickingBvh::Kind::Borehole && hit.objectId >= 0 && hit.objectId < boreholes.size()) {
+        const BoreholeData &bh = boreholes[hit.objectId];
+        html = QString("<b>钻孔 %1</b><br>里程: %2 m<br>坐标: %3, %4<br>地面标高: %5 m<br>孔深: %6 m<br>")
+            .arg(bh.boreholeCode)
+            .arg(bh.mileage, 0, 'f', 2)
+            .arg(bh.x, 0, 'f', 2)
+            .arg(bh.y, 0, 'f', 2)
+            .arg(bh.surfaceElevation, 0, 'f', 2)
+            .arg(bh.layers.isEmpty() ? 0.0 : bh.layers.last().bottomDepth, 0, 'f', 2);
+        for (const BoreholeLayerData &layer : bh.layers) {
+            html += QString("%1 %2：厚 %3 m，层底深 %4 m<br>")
+                .arg(layer.layerCode)
+                .arg(layer.rockName)
+                .arg(layer.thickness, 0, 'f', 2)
+                .arg(layer.bottomDepth, 0, 'f', 2);
+        }
+    } else if (hit.kind == PickingBvh::Kind::Layer) {
+        const ChunkState state = chunkStates.value(chunkIndex);
+        const QString rockName = state.layerRockNames.value(hit.objectId);
+    
+        // 地层属性取最近的含该地层的钻孔
+        const BoreholeData *nearest = nullptr;
+        const BoreholeLayerData *nearestLayer = nullptr;
+        double nearestDistance = DBL_MAX;
+        for (const BoreholeData &bh : boreholes) {
+            const double dx = bh.x - hit.point.x();
+            const double dy = bh.y - hit.point.y();
+            const double distance = std::sqrt(dx * dx + dy * dy);
+            if (distance >= nearestDistance) {
+                continue;
+            }
+            for (const BoreholeLayerData &layer : bh.layers) {
+                if (layer.rockName == rockName) {
+                    nearest = &bh;
+                    nearestLayer = &layer;
+                    nearestDistance = distance;
+                    break;
+                }
+            }
+        }
+    
+        html = QString("<b>地层 %1</b><br>拾取点标高: %2 m<br>").arg(rockName).arg(hit.point.z(), 0, 'f', 2);
+        if (nearestLayer) {
+            html += QString("参考钻孔: %1（距 %2 m）<br>层号: %3<br>地层代号: %4<br>时代成因: %5<br>"
+                            "厚度: %6 m<br>层底深度: %7 m<br>层底标高: %8 m<br>%9")
+                .arg(nearest->boreholeCode)
+                .arg(nearestDistance, 0, 'f', 1)
+                .arg(nearestLayer->layerNumber)
+                .arg(nearestLayer->layerCode)
+                .arg(nearestLayer->eraGenesis)
+                .arg(nearestLayer->thickness, 0, 'f', 2)
+                .arg(nearestLayer->bottomDepth, 0, 'f', 2)
+                .arg(nearestLayer->bottomElevation, 0, 'f', 2)
+                .arg(nearestLayer->characteristics.toHtmlEscaped());
+        }
+    } else if (hit.kind == PickingBvh::Kind::Tunnel) {
+        // 命中管段两端中离拾取点最近的断面
+        const GeologyChunk chunk = chunkPlanner.chunks().value(hit.objectId);
+        const TunnelProfileData *nearest = nullptr;
+        float nearestDistance = FLT_MAX;
+        for (const TunnelProfileData &profile : chunk.tunnelProfiles) {
+            const QVector3D center(
+                (profile.topLeftX + profile.topRightX + profile.bottomLeftX + profile.bottomRightX) / 4.0,
+                (profile.topLeftY + profile.topRightY + profile.bottomLeftY + profile.bottomRightY) / 4.0,
+                (profile.topLeftZ + profile.topRightZ + profile.bottomLeftZ + profile.bottomRightZ) / 4.0);
+            const float distance = (center - hit.point).length();
+            if (distance < nearestDistance) {
+                nearest = &profile;
+                nearestDistance = distance;
+            }
+        }
     
-    qDebug() << "✓ 创建了" << renderedSegments << "段隧道（共" << (centerPoints.size() - 1) 
-             << "段数据，只渲染钻孔范围内的）";
+        html = QString("<b>隧道</b><br>拾取点标高: %1 m<br>").arg(hit.point.z(), 0, 'f', 2);
+        if (nearest) {
+            html += QString("最近断面: #%1<br>里程: %2 m<br>附近钻孔: %3<br>")
+                .arg(nearest->profileId)
+                .arg(nearest->mileage, 0, 'f', 2)
+                .arg(nearest->nearBorehole);
+        }
+    }
+    
+    html += QString("<br><span style='color: gray;'>拾取耗时 %1 μs</span>").arg(elapsedUs, 0, 'f', 1);
+    pickInfoLabel->setText(html);
+    pickInfoLabel->setVisible(true);
 }
 
 void Geological3DWidget::createGeologicalVolume()
@@ -449,161 +1179,25 @@ void Geological3DWidget::createGeologicalVolume()
     
     qDebug() << "地质体范围: X[" << minX << "," << maxX << "] Y[" << minY << "," << maxY << "] Z[" << minZ << "," << maxZ << "]";
     
-    // === 创建规则的地质层结构 ===
-    // 方法：在相邻钻孔之间创建规则的层状结构
-    for (int i = 0; i < boreholes.size() - 1; i++) {
-        const BoreholeData &bh1 = boreholes[i];
-        const BoreholeData &bh2 = boreholes[i + 1];
-        
-        // 为每对钻孔创建地层连接
-        createLayersBetweenBoreholes(bh1, bh2);
-        
-        // 创建钻孔位置标记
-        createBoreholeMarker(bh1);
-        if (i == boreholes.size() - 2) {
-            createBoreholeMarker(bh2);
-        }
-    }
-    
-    qDebug() << "✓ 创建了规则的地质层结构";
-}
-
-void Geological3DWidget::createLayersBetweenBoreholes(const BoreholeData &bh1, const BoreholeData &bh2)
-{
-    // 获取两个钻孔的所有地层，按深度组织
-    QMap<QString, QPair<float, float>> layers1, layers2;  // 岩性名称 -> (顶部标高, 底部标高)
-    
-    float currentTop1 = bh1.surfaceElevation;
-    for (const auto &layer : bh1.layers) {
-        float bottomZ = bh1.surfaceElevation - layer.bottomDepth;
-        layers1[layer.rockName] = qMakePair(currentTop1, bottomZ);
-        currentTop1 = bottomZ;
-    }
+    // === 地质层结构 ===
+    // 由全部钻孔插值出各地层分界面，按里程分块生成，由 updateChunks() 加载到 geologicalLayersEntity 下
     
-    float currentTop2 = bh2.surfaceElevation;
-    for (const auto &layer : bh2.layers) {
-        float bottomZ = bh2.surfaceElevation - layer.bottomDepth;
-        layers2[layer.rockName] = qMakePair(currentTop2, bottomZ);
-        currentTop2 = bottomZ;
+    // 创建钻孔位置标记
+    if (boreholes.size() > 1) {
+        createBoreholeMarkers();
     }
     
-    // 找到共同的地层并创建连接体
-    for (auto it1 = layers1.constBegin(); it1 != layers1.constEnd(); ++it1) {
-        QString rockName = it1.key();
-        
-        // 如果第二个钻孔也有这个岩性
-        if (layers2.contains(rockName)) {
-            auto pair1 = it1.value();
-            auto pair2 = layers2[rockName];
-            
-            float top1 = pair1.first;
-            float bottom1 = pair1.second;
-            float top2 = pair2.first;
-            float bottom2 = pair2.second;
-            
-            // 创建六面体连接这两个钻孔的对应地层
-            createLayerPrism(bh1.x, bh1.y, top1, bottom1,
-                           bh2.x, bh2.y, top2, bottom2,
-                           rockName);
-        }
-    }
+    qDebug() << "✓ 创建了钻孔标记，地层网格按里程分块加载";
 }
 
-void Geological3DWidget::createLayerPrism(float x1, float y1, float top1, float bottom1,
-                                         float x2, float y2, float top2, float bottom2,
-                                         const QString &rockName)
+void Geological3DWidget::createLayerBatch(const GeologyMeshLayout::Batch &batch, Qt3DCore::QEntity *parent)
 {
-    // 【修改】创建六面体几何体 - 使用geologicalLayersEntity而不是boreholeEntity
-    Qt3DCore::QEntity *prismEntity = new Qt3DCore::QEntity(geologicalLayersEntity);
-    
-    // 计算地层宽度（垂直于隧道方向）
-    float dx = x2 - x1;
-    float dy = y2 - y1;
-    float distance = std::sqrt(dx*dx + dy*dy);
-    
-    // 增大地层宽度以形成可见的地质体
-    float width = qMax(distance * 0.8f, 30.0f);  // 宽度至少30米，或钻孔间距的80%
+    // 分块内同一岩性共用一个实体和一组缓冲，只产生一次绘制
+    Qt3DCore::QEntity *layerEntity = new Qt3DCore::QEntity(parent);
     
-    // 计算垂直于连线的方向
-    QVector3D forward(dx, dy, 0);
-    if (forward.length() > 0.001f) {
-        forward.normalize();
-    } else {
-        forward = QVector3D(1, 0, 0);
-    }
-    QVector3D up(0, 0, 1);
-    QVector3D right = QVector3D::crossProduct(forward, up).normalized();
-    
-    // 定义8个顶点（扩展地层宽度）
-    // 钻孔1位置的4个点
-    QVector3D offset1 = right * (width / 2.0f);
-    QVector3D v0 = QVector3D(x1, y1, top1) - offset1;     // 左上
-    QVector3D v1 = QVector3D(x1, y1, top1) + offset1;     // 右上
-    QVector3D v2 = QVector3D(x1, y1, bottom1) + offset1;  // 右下
-    QVector3D v3 = QVector3D(x1, y1, bottom1) - offset1;  // 左下
-    
-    // 钻孔2位置的4个点
-    QVector3D offset2 = right * (width / 2.0f);
-    QVector3D v4 = QVector3D(x2, y2, top2) - offset2;     // 左上
-    QVector3D v5 = QVector3D(x2, y2, top2) + offset2;     // 右上
-    QVector3D v6 = QVector3D(x2, y2, bottom2) + offset2;  // 右下
-    QVector3D v7 = QVector3D(x2, y2, bottom2) - offset2;  // 左下
-    
-    // 创建六面体的12个三角形（每面2个三角形）
-    QVector<QVector3D> vertices;
-    QVector<QVector3D> normals;
-    
-    // 顶面
-    vertices << v0 << v1 << v5 << v0 << v5 << v4;
-    for(int i = 0; i < 6; i++) normals << QVector3D(0, 0, 1);
-    
-    // 底面
-    vertices << v3 << v7 << v6 << v3 << v6 << v2;
-    for(int i = 0; i < 6; i++) normals << QVector3D(0, 0, -1);
-    
-    // 前面（远离观察者）
-    vertices << v0 << v4 << v7 << v0 << v7 << v3;
-    QVector3D normal1 = -right;
-    for(int i = 0; i < 6; i++) normals << normal1;
-    
-    // 后面（靠近观察者）
-    vertices << v1 << v2 << v6 << v1 << v6 << v5;
-    QVector3D normal2 = right;
-    for(int i = 0; i < 6; i++) normals << normal2;
-    
-    // 左侧面
-    vertices << v0 << v3 << v2 << v0 << v2 << v1;
-    QVector3D normal3 = -forward;
-    for(int i = 0; i < 6; i++) normals << normal3;
-    
-    // 右侧面
-    vertices << v4 << v5 << v6 << v4 << v6 << v7;
-    QVector3D normal4 = forward;
-    for(int i = 0; i < 6; i++) normals << normal4;
-    
-    // 创建顶点数据缓冲
-    QByteArray vertexData;
-    vertexData.resize(vertices.size() * 3 * sizeof(float));
-    float *vertexPtr = reinterpret_cast<float*>(vertexData.data());
-    for (const auto &v : vertices) {
-        *vertexPtr++ = v.x();
-        *vertexPtr++ = v.y();
-        *vertexPtr++ = v.z();
-    }
-    
-    // 创建法线数据缓冲
-    QByteArray normalData;
-    normalData.resize(normals.size() * 3 * sizeof(float));
-    float *normalPtr = reinterpret_cast<float*>(normalData.data());
-    for (const auto &n : normals) {
-        *normalPtr++ = n.x();
-        *normalPtr++ = n.y();
-        *normalPtr++ = n.z();
-    }
-    
-    // 顶点缓冲
+    // 交错顶点缓冲：位置、法线、岩性序号
     Qt3DCore::QBuffer *vertexBuffer = new Qt3DCore::QBuffer();
-    vertexBuffer->setData(vertexData);
+    vertexBuffer->setData(batch.vertexBytes());
     
     Qt3DCore::QAttribute *positionAttribute = new Qt3DCore::QAttribute();
     positionAttribute->setName(Qt3DCore::QAttribute::defaultPositionAttributeName());
@@ -611,128 +1205,139 @@ void Geological3DWidget::createLayerPrism(float x1, float y1, float top1, float
     positionAttribute->setVertexSize(3);
     positionAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
     positionAttribute->setBuffer(vertexBuffer);
-    positionAttribute->setCount(vertices.size());
-    
-    // 法线缓冲
-    Qt3DCore::QBuffer *normalBuffer = new Qt3DCore::QBuffer();
-    normalBuffer->setData(normalData);
+    positionAttribute->setByteOffset(GeologyMeshLayout::POSITION_OFFSET);
+    positionAttribute->setByteStride(GeologyMeshLayout::VERTEX_STRIDE);
+    positionAttribute->setCount(batch.vertices.size());
     
     Qt3DCore::QAttribute *normalAttribute = new Qt3DCore::QAttribute();
     normalAttribute->setName(Qt3DCore::QAttribute::defaultNormalAttributeName());
     normalAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
     normalAttribute->setVertexSize(3);
     normalAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
-    normalAttribute->setBuffer(normalBuffer);
-    normalAttribute->setCount(normals.size());
+    normalAttribute->setBuffer(vertexBuffer);
+    normalAttribute->setByteOffset(GeologyMeshLayout::NORMAL_OFFSET);
+    normalAttribute->setByteStride(GeologyMeshLayout::VERTEX_STRIDE);
+    normalAttribute->setCount(batch.vertices.size());
+    
+    // 岩性序号，用于拾取
+    Qt3DCore::QAttribute *rockIdAttribute = new Qt3DCore::QAttribute();
+    rockIdAttribute->setName("vertexRockId");
+    rockIdAttribute->setVertexBaseType(Qt3DCore::QAttribute::UnsignedInt);
+    rockIdAttribute->setVertexSize(1);
+    rockIdAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
+    rockIdAttribute->setBuffer(vertexBuffer);
+    rockIdAttribute->setByteOffset(GeologyMeshLayout::ROCK_ID_OFFSET);
+    rockIdAttribute->setByteStride(GeologyMeshLayout::VERTEX_STRIDE);
+    rockIdAttribute->setCount(batch.vertices.size());
+    
+    // 索引缓冲
+    Qt3DCore::QBuffer *indexBuffer = new Qt3DCore::QBuffer();
+    indexBuffer->setData(batch.indexBytes());
+    
+    Qt3DCore::QAttribute *indexAttribute = new Qt3DCore::QAttribute();
+    indexAttribute->setVertexBaseType(Qt3DCore::QAttribute::UnsignedInt);
+    indexAttribute->setAttributeType(Qt3DCore::QAttribute::IndexAttribute);
+    indexAttribute->setBuffer(indexBuffer);
+    indexAttribute->setCount(batch.indices.size());
     
     // 创建几何体
     Qt3DCore::QGeometry *geometry = new Qt3DCore::QGeometry();
     geometry->addAttribute(positionAttribute);
     geometry->addAttribute(normalAttribute);
+    geometry->addAttribute(rockIdAttribute);
+    geometry->addAttribute(indexAttribute);
     
     Qt3DRender::QGeometryRenderer *geometryRenderer = new Qt3DRender::QGeometryRenderer();
     geometryRenderer->setGeometry(geometry);
     geometryRenderer->setPrimitiveType(Qt3DRender::QGeometryRenderer::Triangles);
     
-    // 材质
-    Qt3DExtras::QPhongMaterial *material = new Qt3DExtras::QPhongMaterial();
+    layerEntity->addComponent(geometryRenderer);
+    layerEntity->addComponent(layerMaterial(batch.rockName));
+}
+
+Qt3DExtras::QPhongMaterial *Geological3DWidget::layerMaterial(const QString &rockName)
+{
+    Qt3DExtras::QPhongMaterial *material = layerMaterials.value(rockName);
+    if (material) {
+        return material;
+    }
+    
+    // 材质挂在地质层实体下，分块卸载时不随之释放
+    material = new Qt3DExtras::QPhongMaterial(geologicalLayersEntity);
     QColor layerColor = getColorForRockType(rockName);
     material->setDiffuse(layerColor);
     material->setAmbient(layerColor.darker(130));
     material->setSpecular(QColor(255, 255, 255, 50));
     material->setShininess(40.0f);
-    
-    prismEntity->addComponent(geometryRenderer);
-    prismEntity->addComponent(material);
+    layerMaterials.insert(rockName, material);
+    return material;
 }
 
-void Geological3DWidget::createBoreholeMarker(const BoreholeData &bh)
+void Geological3DWidget::createBoreholeMarkers()
 {
-    // 在钻孔位置创建一个垂直的圆柱标记
-    Qt3DCore::QEntity *marker = new Qt3DCore::QEntity(boreholeEntity);
-    
-    // 计算钻孔深度
-    float depth = 0;
-    if (!bh.layers.isEmpty()) {
-        depth = bh.layers.last().bottomDepth;
+    // 所有钻孔的圆柱标记与顶部球体各用一个网格实例化绘制，共用一个材质
+    QVector<InstancedMarkerMaterial::Instance> columnInstances;
+    QVector<InstancedMarkerMaterial::Instance> sphereInstances;
+    columnInstances.reserve(boreholes.size());
+    sphereInstances.reserve(boreholes.size());
+    
+    boreholePickIndex.clear();
+    
+    for (int i = 0; i < boreholes.size(); i++) {
+        const BoreholeData &bh = boreholes[i];
+        // 计算钻孔深度
+        float depth = 0;
+        if (!bh.layers.isEmpty()) {
+            depth = bh.layers.last().bottomDepth;
+        }
+        
+        float topZ = bh.surfaceElevation;
+        float bottomZ = topZ - depth;
+        
+        // 垂直圆柱：单位长度的网格按钻孔深度拉伸，明亮的红色
+        columnInstances.append(InstancedMarkerMaterial::makeInstance(
+            QVector3D(bh.x, bh.y, (topZ + bottomZ) / 2.0f), depth, QColor(255, 60, 60)));
+        
+        // 顶部球体稍微抬高，橙红色
+        sphereInstances.append(InstancedMarkerMaterial::makeInstance(
+            QVector3D(bh.x, bh.y, topZ + 1.0f), 1.0f, QColor(255, 100, 0)));
+        
+        // 拾取用包围盒：圆柱与顶部球体
+        boreholePickIndex.addBox(QVector3D(bh.x - BOREHOLE_COLUMN_RADIUS, bh.y - BOREHOLE_COLUMN_RADIUS, bottomZ),
+                                 QVector3D(bh.x + BOREHOLE_COLUMN_RADIUS, bh.y + BOREHOLE_COLUMN_RADIUS, topZ),
+                                 PickingBvh::Kind::Borehole, i);
+        boreholePickIndex.addBox(QVector3D(bh.x, bh.y, topZ + 1.0f) - QVector3D(1, 1, 1) * BOREHOLE_SPHERE_RADIUS,
+                                 QVector3D(bh.x, bh.y, topZ + 1.0f) + QVector3D(1, 1, 1) * BOREHOLE_SPHERE_RADIUS,
+                                 PickingBvh::Kind::Borehole, i);
     }
+    boreholePickIndex.build();
     
-    float topZ = bh.surfaceElevation;
-    float bottomZ = topZ - depth;
+    boreholeMarkerMaterial = new InstancedMarkerMaterial(boreholeEntity);
+    boreholeMarkerMaterial->setShininess(60.0f);
+    boreholeMarkerMaterial->setEnabled(boreholesVisible);
     
-    // 创建较粗的圆柱以便更明显
+    // 较粗的圆柱以便更明显
+    Qt3DCore::QEntity *columns = new Qt3DCore::QEntity(boreholeEntity);
     Qt3DExtras::QCylinderMesh *cylinder = new Qt3DExtras::QCylinderMesh();
-    cylinder->setRadius(1.2f);  // 增大半径
-    cylinder->setLength(depth);
+    cylinder->setRadius(BOREHOLE_COLUMN_RADIUS);
+    cylinder->setLength(1.0f);
     cylinder->setRings(8);
     cylinder->setSlices(16);
+    InstancedMarkerMaterial::addInstances(cylinder, columnInstances);
     
-    Qt3DCore::QTransform *transform = new Qt3DCore::QTransform();
-    transform->setTranslation(QVector3D(bh.x, bh.y, (topZ + bottomZ) / 2.0f));
-    
-    Qt3DExtras::QPhongMaterial *material = new Qt3DExtras::QPhongMaterial();
-    material->setDiffuse(QColor(255, 60, 60));  // 明亮的红色
-    material->setAmbient(QColor(180, 30, 30));
-    material->setSpecular(QColor(255, 150, 150));
-    material->setShininess(60.0f);
-    
-    marker->addComponent(cylinder);
-    marker->addComponent(transform);
-    marker->addComponent(material);
+    columns->addComponent(cylinder);
+    columns->addComponent(boreholeMarkerMaterial);
     
-    // 在顶部添加一个更大的球体标记
-    Qt3DCore::QEntity *sphere = new Qt3DCore::QEntity(boreholeEntity);
+    // 顶部更大的球体标记
+    Qt3DCore::QEntity *spheres = new Qt3DCore::QEntity(boreholeEntity);
     Qt3DExtras::QSphereMesh *sphereMesh = new Qt3DExtras::QSphereMesh();
-    sphereMesh->setRadius(2.5f);  // 增大球体
+    sphereMesh->setRadius(BOREHOLE_SPHERE_RADIUS);
     sphereMesh->setRings(16);
     sphereMesh->setSlices(16);
+    InstancedMarkerMaterial::addInstances(sphereMesh, sphereInstances);
     
-    Qt3DCore::QTransform *sphereTransform = new Qt3DCore::QTransform();
-    sphereTransform->setTranslation(QVector3D(bh.x, bh.y, topZ + 1.0f));  // 稍微抬高
-    
-    Qt3DExtras::QPhongMaterial *sphereMaterial = new Qt3DExtras::QPhongMaterial();
-    sphereMaterial->setDiffuse(QColor(255, 100, 0));  // 橙红色
-    sphereMaterial->setAmbient(QColor(200, 80, 0));
-    sphereMaterial->setSpecular(QColor(255, 200, 100));
-    sphereMaterial->setShininess(80.0f);
-    
-    sphere->addComponent(sphereMesh);
-    sphere->addComponent(sphereTransform);
-    sphere->addComponent(sphereMaterial);
-}
-
-void Geological3DWidget::createBoreholeMarkers()
-{
-    // 已在createGeologicalVolume中创建
-}
-
-void Geological3DWidget::createGeologicalColumns()
-{
-    // 此函数已被createGeologicalVolume替代
-}
-
-void Geological3DWidget::createLayerVolume(const BoreholeData &bh1, const BoreholeLayerData &layer1,
-                                          const BoreholeData &bh2, const BoreholeLayerData &layer2,
-                                          Qt3DCore::QEntity *parent)
-{
-    // 此函数已被createLayerPrism替代
-    Q_UNUSED(bh1);
-    Q_UNUSED(layer1);
-    Q_UNUSED(bh2);
-    Q_UNUSED(layer2);
-    Q_UNUSED(parent);
-}
-
-void Geological3DWidget::createLayerSurface(const BoreholeData &bh1, const BoreholeLayerData &layer1,
-                                           const BoreholeData &bh2, const BoreholeLayerData &layer2,
-                                           Qt3DCore::QEntity *parent)
-{
-    // 此函数已被createLayerPrism替代
-    Q_UNUSED(bh1);
-    Q_UNUSED(layer1);
-    Q_UNUSED(bh2);
-    Q_UNUSED(layer2);
-    Q_UNUSED(parent);
+    spheres->addComponent(sphereMesh);
+    spheres->addComponent(boreholeMarkerMaterial);
 }
 
 void Geological3DWidget::createGroundSurface()
@@ -742,7 +1347,7 @@ void Geological3DWidget::createGroundSurface()
         return;
     }
     
-    if (boreholes.isEmpty() && tunnelSegments.isEmpty()) {
+    if (boreholes.isEmpty() && tunnelProfiles.isEmpty()) {
         qWarning() << "没有数据";
         return;
     }
@@ -877,6 +1482,11 @@ void Geological3DWidget::setup3DView()
         return;
     }
     
+    // 场景尚未加载完成
+    if (!rootEntity) {
+        return;
+    }
+    
     if (!camera) {
         camera = view3D->camera();
         if (!camera) {
@@ -8,12 +8,32 @@
 #include <Qt3DExtras/QOrbitCameraController>
 #include <Qt3DCore/QTransform>
 #include <QVector>
+#include <QMap>
+#include <QHash>
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QLabel>
 #include <QTimer>
+#include <QJsonObject>
 #include "../database/TunnelProfileDAO.h"
 #include "../database/BoreholeDAO.h"
+#include "../utils/GeologyMeshLayout.h"
+#include "../utils/TunnelMeshBuilder.h"
+#include "../utils/GeologySceneBuilder.h"
+#include "../utils/GeologyChunkPlanner.h"
+#include "../utils/TunnelAlignment.h"
+#include "scenestatistics.h"
+
+namespace Qt3DCore {
+class QBuffer;
+class QAttribute;
+}
+
+namespace Qt3DExtras {
+class QPhongMaterial;
+}
+
+class InstancedMarkerMaterial;
 
 class Geological3DWidget : public QWidget
 {
@@ -21,44 +41,99 @@ class Geological3DWidget : public QWidget
 
 public:
     explicit Geological3DWidget(int projectId, QWidget *parent = nullptr);
+    // 直接显示给定的场景数据，不读取数据库（用于基准测试）
+    explicit Geological3DWidget(const GeologyScene &scene, QWidget *parent = nullptr);
     ~Geological3DWidget();
 
+    // 在后台读取数据并生成（或从缓存读取）网格，完成后渲染场景
     void loadData();
     void renderScene();
 
+    // 重新读取隧道断面，只重建内容有变化的分块
+    void reloadTunnelProfiles();
+
+    // 更新盾构机里程：移动盾构机、延长已掘进段，其附近的分块提高细节级别；
+    // 可高频调用，每个显示帧最多更新一次
+    void setShieldMileage(double mileage);
+
+    // 按桩号更新盾构机里程；只记录最新的桩号，在显示帧更新时换算
+    void setShieldStakeMark(const QString &stakeMark);
+
+    Qt3DExtras::Qt3DWindow *window3D() const { return view3D; }
+    int pendingChunkBuilds() const { return runningChunkBuilds; }  // 正在后台生成的分块数
+    SceneStatistics::Snapshot sceneSnapshot() const;                // 当前场景规模（不含逻辑帧间隔）
+
+signals:
+    // 按当前焦点需要加载的分块都已生成完毕
+    void chunksLoaded();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;  // 三维窗口中的鼠标点击用于拾取
+
 private:
+    Geological3DWidget(int projectId, bool loadFromDatabase, QWidget *parent);
     void setupUI();
+    void applyScene(const GeologyScene &scene);  // 界面线程：接收后台生成的场景并创建实体
+    void applyTunnelProfiles(const QVector<TunnelProfileData> &profiles);
     void setup3DView();
     void createTunnelMesh();
-    void createBoreholeMarkers();
+    void updateInfoLabel();
+    void createBoreholeMarkers();  // 实例化绘制所有钻孔的标记
     
     // 【新增】地质可视化核心函数
-    void createGeologicalColumns();  // 创建地质柱状图
     void createGeologicalVolume();  // 创建3D地质体积
-    void createLayerVolume(const BoreholeData &bh1, const BoreholeLayerData &layer1,
-                          const BoreholeData &bh2, const BoreholeLayerData &layer2,
-                          Qt3DCore::QEntity *parent);  // 创建地层体积块
-    void createLayerSurface(const BoreholeData &bh1, const BoreholeLayerData &layer1,
-                           const BoreholeData &bh2, const BoreholeLayerData &layer2,
-                           Qt3DCore::QEntity *parent);  // 创建两个钻孔之间的地层连接面
     
     // 【新增】改进版地质可视化函数
-    void createLayersBetweenBoreholes(const BoreholeData &bh1, const BoreholeData &bh2);  // 在相邻钻孔间创建地层
-    void createLayerPrism(float x1, float y1, float top1, float bottom1,
-                         float x2, float y2, float top2, float bottom2,
-                         const QString &rockName);  // 创建地层六面体
-    void createBoreholeMarker(const BoreholeData &bh);  // 创建钻孔标记
+    void createLayerBatch(const GeologyMeshLayout::Batch &batch, Qt3DCore::QEntity *parent);  // 创建一种岩性的合并地层网格
+    Qt3DExtras::QPhongMaterial *layerMaterial(const QString &rockName);  // 同一岩性的各分块共用材质
     
     void createGroundSurface();
     void createCoordinateAxes();
     
-    // 数据结构
-    struct TunnelSegment {
-        QVector3D topLeft;
-        QVector3D topRight;
-        QVector3D bottomLeft;
-        QVector3D bottomRight;
+    void createTunnelChunk(const TunnelMeshBuilder &builder, Qt3DCore::QEntity *parent);
+    
+    // 里程分块的加载状态：地层与隧道各一个实体，新网格生成后才替换旧实体
+    struct ChunkState {
+        QByteArray contentHash;                     // 已加载网格对应的分块内容
+        int level = -1;                             // 已加载的细节级别，-1 未加载
+        int pendingLevel = -1;                      // 正在后台生成的级别，-1 无
+        Qt3DCore::QEntity *layerEntity = nullptr;
+        Qt3DCore::QEntity *tunnelEntity = nullptr;
+        PickingBvh pickIndex;                       // 已加载网格的拾取索引
+        QVector<QString> layerRockNames;            // 拾取索引中地层序号对应的岩性
     };
+    
+    QVector<double> focusMileages() const;          // 盾构机里程与相机视点所在里程
+    void updateChunks();                            // 按焦点调整各分块的细节级别，启动后台生成
+    void startChunkBuild(const GeologyChunk &chunk, int level);
+    void applyChunk(const GeologyChunkMeshes &meshes);  // 界面线程：用新网格替换分块的实体
+    void releaseChunk(ChunkState &state);
+    
+    // 已掘进段：按衬砌环追加截面的隧道网格，缓冲预留余量，追加时只上传新增部分
+    struct ExcavatedSection {
+        TunnelMeshBuilder builder;
+        Qt3DCore::QBuffer *vertexBuffer = nullptr;
+        Qt3DCore::QBuffer *indexBuffer = nullptr;
+        Qt3DCore::QAttribute *positionAttribute = nullptr;
+        Qt3DCore::QAttribute *normalAttribute = nullptr;
+        Qt3DCore::QAttribute *indexAttribute = nullptr;
+        int vertexCapacity = 0;     // 顶点缓冲已分配的顶点数
+        int indexCapacity = 0;      // 索引缓冲已分配的索引数
+        double nextRingMileage = 0.0;
+    };
+    
+    // 盾构机与已掘进段：实时里程只改变换、向缓冲追加数据，不重建场景
+    void createShieldMachine();
+    void createExcavatedSection();
+    void applyShieldMileage();                      // 合并后的里程更新
+    void scheduleShieldUpdate();
+    void appendExcavatedRings(double tailMileage);  // 追加到盾尾里程为止的衬砌环
+    void uploadExcavatedSection(int firstVertex, int firstIndex);
+    void onExcavationData(int dataProjectId, const QJsonObject &data);
+    
+    // 拾取：鼠标射线与钻孔、各分块的包围体层次求交，结果显示在信息面板中
+    void pickAt(const QPoint &position);
+    void showPickResult(const PickingBvh::Hit &hit, int chunkIndex, double elapsedUs);
 
     int projectId;
     Qt3DExtras::Qt3DWindow *view3D;
@@ -72,9 +147,33 @@ private:
     Qt3DRender::QCamera *camera;
     Qt3DExtras::QOrbitCameraController *cameraController;
     
-    QVector<TunnelSegment> tunnelSegments;
+    QVector<TunnelProfileData> tunnelProfiles;
+    InstancedMarkerMaterial *boreholeMarkerMaterial;  // 所有钻孔标记共用，用于切换显示
     QVector<BoreholeData> boreholes;
     
+    // 里程分块流式加载
+    GeologyChunkPlanner chunkPlanner;
+    QMap<int, ChunkState> chunkStates;          // 按块序号
+    int chunkGeneration;                        // 每次重建场景时递增，旧场景的生成结果直接丢弃
+    int runningChunkBuilds;                     // 正在后台生成的分块数
+    QTimer *chunkUpdateTimer;                   // 相机停止移动后再调整分块
+    bool hasShieldMileage;
+    double shieldMileage;
+    QString pendingStakeMark;                   // 尚未换算为里程的最新桩号
+    Qt3DExtras::QPhongMaterial *tunnelMaterial;
+    QHash<QString, Qt3DExtras::QPhongMaterial *> layerMaterials;
+    
+    // 盾构机与已掘进段
+    TunnelAlignment tunnelAlignment;
+    Qt3DCore::QEntity *shieldEntity;
+    Qt3DCore::QTransform *shieldTransform;
+    ExcavatedSection excavated;
+    QTimer *shieldUpdateTimer;                  // 实时里程合并到显示刷新周期
+    
+    // 拾取
+    PickingBvh boreholePickIndex;               // 钻孔标记的包围盒
+    QPoint pressPosition;
+    
     // 场景边界（用于限制相机移动）
     QVector3D sceneMin;
     QVector3D sceneMax;
@@ -89,7 +188,11 @@ private:
     QPushButton *resetViewButton;
     QPushButton *toggleBoreholeButton;
     QPushButton *toggleSurfaceButton;
+    QPushButton *toggleStatisticsButton;
     QLabel *infoLabel;
+    QLabel *statisticsLabel;                    // 性能统计，开启统计时显示
+    QLabel *pickInfoLabel;                      // 拾取结果，点击对象时显示
+    SceneStatistics *sceneStatistics;
     
     bool boreholesVisible;
     bool surfaceVisible;
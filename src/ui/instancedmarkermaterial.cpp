@@ -0,0 +1,105 @@
+#include "instancedmarkermaterial.h"
+#include <Qt3DRender/QTechnique>
+#include <Qt3DRender/QRenderPass>
+#include <Qt3DRender/QShaderProgram>
+#include <Qt3DRender/QFilterKey>
+#include <Qt3DCore/QGeometry>
+#include <Qt3DCore/QAttribute>
+#include <Qt3DCore/QBuffer>
+#include <QUrl>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+const float DEFAULT_SHININESS = 60.0f;
+
+} // namespace
+
+InstancedMarkerMaterial::Instance InstancedMarkerMaterial::makeInstance(const QVector3D &position, float height,
+                                                                       const QColor &color)
+{
+    return Instance{ { position.x(), position.y(), position.z() }, height,
+                     { color.redF(), color.greenF(), color.blueF(), color.alphaF() } };
+}
+
+void InstancedMarkerMaterial::addInstances(Qt3DRender::QGeometryRenderer *mesh, const QVector<Instance> &instances)
+{
+    Qt3DCore::QGeometry *geometry = mesh->geometry();
+    if (!geometry) {
+        qWarning() << "网格没有几何体，无法添加实例";
+        return;
+    }
+
+    QByteArray bytes;
+    bytes.resize(instances.size() * INSTANCE_STRIDE);
+    std::memcpy(bytes.data(), instances.constData(), bytes.size());
+
+    Qt3DCore::QBuffer *instanceBuffer = new Qt3DCore::QBuffer(geometry);
+    instanceBuffer->setData(bytes);
+
+    // 每个实例前进一次（divisor = 1），而不是每个顶点
+    auto addAttribute = [&](const QString &name, uint size, uint offset) {
+        Qt3DCore::QAttribute *attribute = new Qt3DCore::QAttribute(geometry);
+        attribute->setName(name);
+        attribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
+        attribute->setVertexSize(size);
+        attribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
+        attribute->setBuffer(instanceBuffer);
+        attribute->setByteOffset(offset);
+        attribute->setByteStride(INSTANCE_STRIDE);
+        attribute->setCount(instances.size());
+        attribute->setDivisor(1);
+        geometry->addAttribute(attribute);
+    };
+    addAttribute("instancePosition", 3, POSITION_OFFSET);
+    addAttribute("instanceHeight", 1, HEIGHT_OFFSET);
+    addAttribute("instanceColor", 4, COLOR_OFFSET);
+
+    mesh->setInstanceCount(instances.size());
+}
+
+InstancedMarkerMaterial::InstancedMarkerMaterial(Qt3DCore::QNode *parent)
+    : Qt3DRender::QMaterial(parent)
+    , shininessParameter(new Qt3DRender::QParameter("shininess", DEFAULT_SHININESS, this))
+{
+    Qt3DRender::QEffect *effect = new Qt3DRender::QEffect(this);
+    addTechnique(effect, Qt3DRender::QGraphicsApiFilter::OpenGL, 3, 2, "instancedmarker");
+    addTechnique(effect, Qt3DRender::QGraphicsApiFilter::RHI, 1, 0, "instancedmarker_rhi");
+
+    addParameter(shininessParameter);
+    setEffect(effect);
+}
+
+void InstancedMarkerMaterial::setShininess(float shininess)
+{
+    shininessParameter->setValue(shininess);
+}
+
+void InstancedMarkerMaterial::addTechnique(Qt3DRender::QEffect *effect, Qt3DRender::QGraphicsApiFilter::Api api,
+                                           int majorVersion, int minorVersion, const QString &shaderName)
+{
+    Qt3DRender::QTechnique *technique = new Qt3DRender::QTechnique(effect);
+    technique->graphicsApiFilter()->setApi(api);
+    technique->graphicsApiFilter()->setMajorVersion(majorVersion);
+    technique->graphicsApiFilter()->setMinorVersion(minorVersion);
+    if (api == Qt3DRender::QGraphicsApiFilter::OpenGL) {
+        technique->graphicsApiFilter()->setProfile(Qt3DRender::QGraphicsApiFilter::CoreProfile);
+    }
+
+    // Qt3DWindow 默认的前向渲染帧图只选择带此过滤键的技术
+    Qt3DRender::QFilterKey *filterKey = new Qt3DRender::QFilterKey(technique);
+    filterKey->setName("renderingStyle");
+    filterKey->setValue("forward");
+    technique->addFilterKey(filterKey);
+
+    Qt3DRender::QShaderProgram *shader = new Qt3DRender::QShaderProgram(technique);
+    shader->setVertexShaderCode(Qt3DRender::QShaderProgram::loadSource(QUrl("qrc:/shaders/" + shaderName + ".vert")));
+    shader->setFragmentShaderCode(Qt3DRender::QShaderProgram::loadSource(QUrl("qrc:/shaders/" + shaderName + ".frag")));
+
+    Qt3DRender::QRenderPass *renderPass = new Qt3DRender::QRenderPass(technique);
+    renderPass->setShaderProgram(shader);
+    technique->addRenderPass(renderPass);
+
+    effect->addTechnique(technique);
+}
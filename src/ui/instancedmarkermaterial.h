@@ -0,0 +1,67 @@
+#ifndef INSTANCEDMARKERMATERIAL_H
+#define INSTANCEDMARKERMATERIAL_H
+
+#include <Qt3DRender/QMaterial>
+#include <Qt3DRender/QParameter>
+#include <Qt3DRender/QEffect>
+#include <Qt3DRender/QGraphicsApiFilter>
+#include <Qt3DRender/QGeometryRenderer>
+#include <QVector>
+#include <QVector3D>
+#include <QColor>
+#include <QByteArray>
+
+/**
+ * @brief 钻孔标记的实例化材质
+ *
+ * 同一个网格（圆柱或球体）按实例缓冲中的位置、高度与颜色绘制多次，
+ * 所有钻孔的标记只需一个实体、一次绘制。网格沿Y轴建模，着色器将其转为Z轴向上，
+ * 并沿Z轴按实例高度拉伸（球体高度取1保持原形）。
+ *
+ * 光照为以相机为光源的简化 Phong 模型，同时提供 OpenGL 3.2 与 RHI 两套着色器。
+ *
+ * 用法：
+ *   QVector<InstancedMarkerMaterial::Instance> instances = ...;
+ *   Qt3DExtras::QCylinderMesh *mesh = new Qt3DExtras::QCylinderMesh();
+ *   mesh->setLength(1.0f);
+ *   InstancedMarkerMaterial::addInstances(mesh, instances);
+ *   entity->addComponent(mesh);
+ *   entity->addComponent(material);
+ */
+class InstancedMarkerMaterial : public Qt3DRender::QMaterial
+{
+    Q_OBJECT
+
+public:
+    // 实例数据：底部中心（球体为球心）、沿Z轴的高度、颜色
+    struct Instance {
+        float position[3];
+        float height;
+        float color[4];
+    };
+
+    static const int POSITION_OFFSET = 0;
+    static const int HEIGHT_OFFSET = 3 * sizeof(float);
+    static const int COLOR_OFFSET = 4 * sizeof(float);
+    static const int INSTANCE_STRIDE = sizeof(Instance);
+
+    static Instance makeInstance(const QVector3D &position, float height, const QColor &color);
+
+    /**
+     * @brief 为网格添加实例缓冲与实例属性，并设置实例数量
+     * @param mesh 网格（如 QCylinderMesh、QSphereMesh），其几何体须已创建
+     */
+    static void addInstances(Qt3DRender::QGeometryRenderer *mesh, const QVector<Instance> &instances);
+
+    explicit InstancedMarkerMaterial(Qt3DCore::QNode *parent = nullptr);
+
+    void setShininess(float shininess);
+
+private:
+    void addTechnique(Qt3DRender::QEffect *effect, Qt3DRender::QGraphicsApiFilter::Api api,
+                      int majorVersion, int minorVersion, const QString &shaderName);
+
+    Qt3DRender::QParameter *shininessParameter;
+};
+
+#endif // INSTANCEDMARKERMATERIAL_H
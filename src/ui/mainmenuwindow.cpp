@@ -4,6 +4,7 @@
 #include "../utils/stylehelper.h"
 #include "../api/ApiManager.h"
 #include "../database/DatabaseManager.h"
+#include "../database/DataArchiver.h"
 #include <QApplication>
 #include <QScreen>
 #include <QMessageBox>
@@ -39,6 +40,11 @@ MainMenuWindow::MainMenuWindow(QWidget *parent)
     } else {
         qDebug() << "API服务器已在运行，无需重复启动";
     }
+    
+    // 启动明细数据归档任务（按项目保留策略分批转存过期记录）
+    if (!DataArchiver::instance()->isRunning()) {
+        DataArchiver::instance()->start();
+    }
 }
 
 MainMenuWindow::~MainMenuWindow()
@@ -0,0 +1,164 @@
+#include "pagedtablemodel.h"
+#include "../database/AsyncDAO.h"
+
+PagedTableModel::PagedTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , totalRows(0)
+    , atStart(true)
+    , exhausted(true)
+    , fetching(false)
+    , requestSerial(0)
+{
+}
+
+void PagedTableModel::reload()
+{
+    beginResetModel();
+    pages.clear();
+    totalRows = 0;
+    atStart = true;
+    exhausted = false;
+    fetching = false;
+    ++requestSerial;
+    lastError.clear();
+    endResetModel();
+
+    // 先取第一批，视图随后按需 fetchMore
+    fetchMore(QModelIndex());
+}
+
+int PagedTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : totalRows;
+}
+
+const PagedTableModel::Page *PagedTableModel::pageAt(int row, int &offset) const
+{
+    // 窗口内批数很少，逐批定位
+    offset = row;
+    for (const auto &page : pages) {
+        if (offset < page->rowCount) {
+            return page.get();
+        }
+        offset -= page->rowCount;
+    }
+    return nullptr;
+}
+
+bool PagedTableModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !exhausted && !fetching;
+}
+
+void PagedTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid() || exhausted || fetching) {
+        return;
+    }
+
+    requestPage(PageDirection::Forward);
+}
+
+bool PagedTableModel::canFetchPrevious() const
+{
+    return !atStart && !fetching && !pages.empty();
+}
+
+void PagedTableModel::fetchPrevious()
+{
+    if (!canFetchPrevious()) {
+        return;
+    }
+
+    requestPage(PageDirection::Backward);
+}
+
+void PagedTableModel::requestPage(PageDirection direction)
+{
+    // 首尾游标都保留，向后翻页从首批首行、向前翻页从末批末行开始查询
+    PageCursor after;
+    if (direction == PageDirection::Forward) {
+        after = pages.empty() ? PageCursor() : pages.back()->range.seekFrom(PageDirection::Forward);
+    } else {
+        after = pages.front()->range.seekFrom(PageDirection::Backward);
+    }
+
+    fetching = true;
+    int request = requestSerial;
+    AsyncDAO::run(this, pageFetcher(after, direction, FETCH_SIZE))
+        .then(this, [this, request, direction](const FetchResult &result) {
+            applyPage(request, direction, result);
+        });
+}
+
+void PagedTableModel::applyPage(int request, PageDirection direction, const FetchResult &result)
+{
+    if (request != requestSerial) {
+        return;
+    }
+    fetching = false;
+
+    if (!result.error.isEmpty()) {
+        // 出错时停止加载，避免视图反复请求
+        lastError = result.error;
+        exhausted = true;
+        atStart = true;
+        emit loadedRowsChanged(rowCount(), false);
+        return;
+    }
+
+    const bool complete = result.rowCount == FETCH_SIZE;
+    const int count = result.page ? result.page->rowCount : 0;
+
+    if (direction == PageDirection::Forward) {
+        exhausted = !complete;
+        if (count > 0) {
+            beginInsertRows(QModelIndex(), totalRows, totalRows + count - 1);
+            pages.push_back(result.page);
+            totalRows += count;
+            endInsertRows();
+
+            if (pages.size() > static_cast<size_t>(MAX_PAGES)) {
+                dropFirstPage();
+            }
+        }
+    } else {
+        atStart = !complete;
+        if (count > 0) {
+            beginInsertRows(QModelIndex(), 0, count - 1);
+            pages.push_front(result.page);
+            totalRows += count;
+            endInsertRows();
+            emit windowShifted(count);
+
+            if (pages.size() > static_cast<size_t>(MAX_PAGES)) {
+                dropLastPage();
+            }
+        }
+    }
+
+    emit loadedRowsChanged(rowCount(), !exhausted);
+}
+
+void PagedTableModel::dropFirstPage()
+{
+    const int count = pages.front()->rowCount;
+    beginRemoveRows(QModelIndex(), 0, count - 1);
+    pages.pop_front();
+    totalRows -= count;
+    endRemoveRows();
+
+    atStart = false;
+    emit windowShifted(-count);
+}
+
+void PagedTableModel::dropLastPage()
+{
+    const int count = pages.back()->rowCount;
+    beginRemoveRows(QModelIndex(), totalRows - count, totalRows - 1);
+    pages.pop_back();
+    totalRows -= count;
+    endRemoveRows();
+
+    exhausted = false;
+}
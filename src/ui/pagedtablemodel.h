@@ -0,0 +1,99 @@
+#ifndef PAGEDTABLEMODEL_H
+#define PAGEDTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <deque>
+#include <functional>
+#include <memory>
+#include "../database/PageCursor.h"
+
+/**
+ * @brief 按游标分批读取的表格模型基类
+ *
+ * 视图滚动到底部时 fetchMore() 从末批末行的 (排序键, id) 之后再取一批，任意位置的代价与首批相同。
+ * 模型只保留 MAX_PAGES 批组成的滑动窗口：向下加载超出时丢弃最上面一批，
+ * 滚回顶部时 fetchPrevious() 从首批首行向前重新读取一批并丢弃最下面一批，
+ * 内存占用与结果集大小无关。窗口移动时发出 windowShifted()，视图据此保持可见行不动。
+ *
+ * 查询在数据库线程执行。派生类在 pageFetcher() 中返回读取一批并转换为紧凑行的函数
+ * （在数据库线程中调用，只能使用按值捕获的查询条件），在 data() 中通过 pageAt() 定位行。
+ */
+class PagedTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit PagedTableModel(QObject *parent = nullptr);
+
+    // 按当前条件从头重新加载
+    void reload();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    // 窗口首批之前是否还有已丢弃的记录
+    bool canFetchPrevious() const;
+    void fetchPrevious();
+
+    // 获取最后的错误信息
+    QString getLastError() const { return lastError; }
+
+signals:
+    // 已加载行数变化
+    void loadedRowsChanged(int rowCount, bool hasMore);
+
+    // 窗口首部增加（正数）或丢弃（负数）了若干行
+    void windowShifted(int rowDelta);
+
+protected:
+    // 一批记录，派生类在其中保存紧凑行与字符串字典，随批一起释放
+    struct Page {
+        virtual ~Page() = default;
+        PageRange range;                // 本批首尾游标
+        int rowCount = 0;
+    };
+
+    // 数据库线程中的一次读取结果
+    struct FetchResult {
+        std::shared_ptr<const Page> page;   // 没有记录时为空
+        int rowCount = 0;                   // 查询返回的行数，少于一批表示已到结果集一端
+        QString error;
+    };
+
+    using Fetcher = std::function<FetchResult()>;
+
+    /**
+     * @brief 读取一批的函数
+     * @param after 本批之前（Forward）或之后（Backward）的游标，无效时从头开始
+     * @param direction 翻页方向，结果仍按排序方向排列
+     * @param limit 每批行数
+     */
+    virtual Fetcher pageFetcher(const PageCursor &after, PageDirection direction, int limit) const = 0;
+
+    // 行所在的批，offset 输出批内行号；超出范围时返回 nullptr
+    const Page *pageAt(int row, int &offset) const;
+
+    // 每批读取行数
+    static const int FETCH_SIZE = 500;
+
+    // 窗口内最多保留的批数
+    static const int MAX_PAGES = 6;
+
+private:
+    void requestPage(PageDirection direction);
+    void applyPage(int request, PageDirection direction, const FetchResult &result);
+    void dropFirstPage();
+    void dropLastPage();
+
+    std::deque<std::shared_ptr<const Page>> pages;  // 窗口内各批，按排序方向排列
+    int totalRows;
+    bool atStart;                   // 首批即结果集开头
+    bool exhausted;                 // 末批即结果集末尾
+    bool fetching;
+    int requestSerial;              // 重新加载后丢弃之前请求的结果
+    QString lastError;
+};
+
+#endif // PAGEDTABLEMODEL_H
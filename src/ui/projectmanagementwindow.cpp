@@ -7,6 +7,12 @@
 #include "../database/NewsDAO.h"
 #include "../database/ExcavationParameterDAO.h"
 #include "../database/ProspectingDataDAO.h"
+#include "../database/RetentionPolicyDAO.h"
+#include "../database/DataArchiver.h"
+#include "excavationtablemodel.h"
+#include "prospectingtablemodel.h"
+#include "warningtablemodel.h"
+#include "actionbuttondelegate.h"
 #include "../models/Project.h"
 #include "../models/Warning.h"
 #include "../models/News.h"
@@ -29,12 +35,14 @@
 #include <QSqlError>
 #include <QCheckBox>
 #include <QTextEdit>
-#include <QTextStream>
-#include <QStringConverter>
+#include <QProgressDialog>
+#include <QScrollBar>
+#include <algorithm>
 
 ProjectManagementWindow::ProjectManagementWindow(QWidget *parent)
     : QMainWindow(parent)
 {
+    dataExporter = new DataExporter(this);
     setupUI();
     loadProjectData();
 
@@ -372,15 +380,36 @@ void ProjectManagementWindow::createWarningInfoTab()
     topLayout->addWidget(refreshBtn);
     topLayout->addWidget(filterBtn);
     topLayout->addWidget(exportBtn);
+    
+    warningStatusLabel = new QLabel(topWidget);
     topLayout->addStretch();
+    topLayout->addWidget(warningStatusLabel);
 
-    // 预警信息表格
-    warningTable = new QTableWidget(0, 8, tab);
-    warningTable->setHorizontalHeaderLabels({"项目名称", "编号", "预警级别", "预警类别", "预警坐标", "预警深度", "预警阈值", "预警时间"});
+    // 预警信息表格：项目名称由查询关联返回，滚动到底部时由模型按游标加载下一批，
+    // 模型只保留最近几批，滚回顶部时重新读取已丢弃的记录
+    warningModel = new WarningTableModel(this);
+    connect(warningModel, &WarningTableModel::loadedRowsChanged, this, [this](int rowCount, bool hasMore) {
+        warningStatusLabel->setText(QString("当前显示 %1 条%2").arg(rowCount).arg(hasMore ? "，滚动加载更多" : ""));
+    });
+    
+    warningTable = new QTableView(tab);
+    warningTable->setModel(warningModel);
+    followPagedWindow(warningTable, warningModel);
+    warningTable->verticalHeader()->setDefaultSectionSize(42);
     warningTable->setStyleSheet(StyleHelper::getTableStyle());
     warningTable->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     warningTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     warningTable->setAlternatingRowColors(true);
+    warningTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    
+    // 操作列按钮由委托绘制，不为每行创建控件
+    ActionButtonDelegate *actionDelegate = new ActionButtonDelegate(warningTable);
+    actionDelegate->addButton("删除", QColor("#E74C3C"), QColor("#C0392B"));
+    warningTable->setItemDelegateForColumn(WarningTableModel::ActionColumn, actionDelegate);
+    warningTable->setMouseTracking(true);
+    connect(actionDelegate, &ActionButtonDelegate::buttonClicked, this, [this](const QModelIndex &index, int) {
+        onDeleteWarning(warningModel->warningIdAt(index.row()));
+    });
 
     layout->addWidget(topWidget);
     layout->addWidget(warningTable);
@@ -437,16 +466,39 @@ void ProjectManagementWindow::createExcavationInfoTab()
     exportBtn->setToolTip("导出");
     connect(exportBtn, &QPushButton::clicked, this, &ProjectManagementWindow::onExportExcavation);
     
+    QPushButton *importBtn = new QPushButton(topWidget);
+    importBtn->setIcon(QIcon(":/icons/folder.png"));
+    importBtn->setIconSize(QSize(20, 20));
+    importBtn->setFixedSize(40, 40);
+    importBtn->setStyleSheet(StyleHelper::getButtonStyle());
+    importBtn->setToolTip("导入列式文件");
+    connect(importBtn, &QPushButton::clicked, this, &ProjectManagementWindow::onImportExcavation);
+    
+    excavationStatusLabel = new QLabel(topWidget);
+    
     topLayout->addWidget(searchBox);
     topLayout->addWidget(searchBtn);
     topLayout->addWidget(refreshBtn);
     topLayout->addWidget(filterBtn);
     topLayout->addWidget(exportBtn);
+    topLayout->addWidget(importBtn);
     topLayout->addStretch();
+    topLayout->addWidget(excavationStatusLabel);
 
-    // 掘进参数表格
-    excavationTable = new QTableWidget(0, 8, tab);
-    excavationTable->setHorizontalHeaderLabels({"项目名称", "掘进时间", "掘进坐标/桩号", "掘进模式", "土仓土压力", "千斤顶推力", "刀盘转速", "刀盘扭矩"});
+    // 掘进参数表格：滚动到底部时由模型按游标加载下一批，点击时间/桩号列头在数据库中排序；
+    // 模型只保留最近几批，滚回顶部时重新读取已丢弃的记录
+    excavationModel = new ExcavationTableModel(this);
+    connect(excavationModel, &ExcavationTableModel::loadedRowsChanged, this, [this](int rowCount, bool hasMore) {
+        excavationStatusLabel->setText(QString("当前显示 %1 条%2").arg(rowCount).arg(hasMore ? "，滚动加载更多" : ""));
+    });
+    
+    excavationTable = new QTableView(tab);
+    excavationTable->setModel(excavationModel);
+    followPagedWindow(excavationTable, excavationModel);
+    excavationTable->verticalHeader()->setDefaultSectionSize(30);
+    excavationTable->horizontalHeader()->setSortIndicator(ExcavationTableModel::TimeColumn, Qt::DescendingOrder);
+    excavationTable->setSortingEnabled(true);
+    excavationTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     excavationTable->setStyleSheet(StyleHelper::getTableStyle());
     excavationTable->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     excavationTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
@@ -507,21 +559,27 @@ void ProjectManagementWindow::createSupplementaryDataTab()
     exportBtn->setToolTip("导出");
     connect(exportBtn, &QPushButton::clicked, this, &ProjectManagementWindow::onExportSupplementary);
     
+    supplementaryStatusLabel = new QLabel(topWidget);
+    
     topLayout->addWidget(searchBox);
     topLayout->addWidget(searchBtn);
     topLayout->addWidget(refreshBtn);
     topLayout->addWidget(filterBtn);
     topLayout->addWidget(exportBtn);
     topLayout->addStretch();
+    topLayout->addWidget(supplementaryStatusLabel);
 
-    // 补勘数据表格 - 扩展列数以包含更多字段
-    supplementaryTable = new QTableWidget(0, 18, tab);
-    supplementaryTable->setHorizontalHeaderLabels({
-        "项目名称", "掘进时间", "桩号", "刀盘受力", "刀具贯入阻力", 
-        "刀盘正面摩擦力矩", "视电阻率", "前方5m含水概率", "应力梯度", 
-        "前方岩石物性参数", "围岩危险等级", "横纵波反射系数", "横波波速", 
-        "纵波波速", "横纵波速比", "泊松比", "杨氏模量", "岩层类型"
+    // 补勘数据表格 - 按掘进时间降序，滚动到底部时由模型按游标加载下一批，
+    // 模型只保留最近几批，滚回顶部时重新读取已丢弃的记录
+    supplementaryModel = new ProspectingTableModel(this);
+    connect(supplementaryModel, &ProspectingTableModel::loadedRowsChanged, this, [this](int rowCount, bool hasMore) {
+        supplementaryStatusLabel->setText(QString("已加载 %1 条%2").arg(rowCount).arg(hasMore ? "，滚动加载更多" : ""));
     });
+    
+    supplementaryTable = new QTableView(tab);
+    supplementaryTable->setModel(supplementaryModel);
+    followPagedWindow(supplementaryTable, supplementaryModel);
+    supplementaryTable->verticalHeader()->setDefaultSectionSize(30);
     supplementaryTable->setStyleSheet(StyleHelper::getTableStyle());
     supplementaryTable->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     supplementaryTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
@@ -539,6 +597,26 @@ void ProjectManagementWindow::createSupplementaryDataTab()
     tabWidget->addTab(tab, "补勘数据");
 }
 
+// 按游标分批加载的表格：窗口首部增删行时按行数平移滚动条，使可见行保持不动；
+// 滚动到顶部时向前读取已丢弃的记录
+void ProjectManagementWindow::followPagedWindow(QTableView *view, PagedTableModel *model)
+{
+    view->setVerticalScrollMode(QAbstractItemView::ScrollPerItem);
+    
+    // 视图延迟更新滚动范围，先放宽上限以免新值被截断
+    connect(model, &PagedTableModel::windowShifted, view, [view](int rowDelta) {
+        QScrollBar *scrollBar = view->verticalScrollBar();
+        int value = std::max(0, scrollBar->value() + rowDelta);
+        scrollBar->setMaximum(std::max(scrollBar->maximum(), value));
+        scrollBar->setValue(value);
+    });
+    connect(view->verticalScrollBar(), &QScrollBar::valueChanged, model, [view, model](int value) {
+        if (value == view->verticalScrollBar()->minimum() && model->canFetchPrevious()) {
+            model->fetchPrevious();
+        }
+    });
+}
+
 void ProjectManagementWindow::createNewsModuleTab()
 {
     QWidget *tab = new QWidget(tabWidget);
@@ -665,42 +743,8 @@ void ProjectManagementWindow::loadProjectData()
         projectTable->setCellWidget(row, 7, operationWidget);
     }
     
-    // ========== 加载掘进信息数据（暂时清空，等待数据） ==========
-    excavationTable->setRowCount(0);
-    
-    // ========== 【修复】加载补勘数据 ==========
-    supplementaryTable->setRowCount(0);
-    
-    ProspectingDataDAO prospectingDAO;
-    QList<ProspectingData> prospectingList = prospectingDAO.getAllProspectingData();
-    
-    qDebug() << "加载补勘数据，共" << prospectingList.size() << "条";
-    
-    for (const ProspectingData &data : prospectingList) {
-        int row = supplementaryTable->rowCount();
-        supplementaryTable->insertRow(row);
-        
-        // 获取项目名称
-        ProjectDAO projectDAO;
-        Project project = projectDAO.getProjectById(data.getProjectId());
-        
-        // 填充表格数据
-        supplementaryTable->setItem(row, 0, new QTableWidgetItem(project.getProjectName()));
-        supplementaryTable->setItem(row, 1, new QTableWidgetItem(data.getExcavationTime().toString("yyyy-MM-dd HH:mm")));
-        supplementaryTable->setItem(row, 2, new QTableWidgetItem(data.getStakeMark()));
-        supplementaryTable->setItem(row, 3, new QTableWidgetItem(QString::number(data.getCutterForce(), 'f', 2)));
-        supplementaryTable->setItem(row, 4, new QTableWidgetItem(QString::number(data.getCutterPenetrationResistance(), 'f', 2)));
-        supplementaryTable->setItem(row, 5, new QTableWidgetItem(QString::number(data.getFaceFrictionTorque(), 'f', 2)));
-        supplementaryTable->setItem(row, 6, new QTableWidgetItem(QString::number(data.getApparentResistivity(), 'f', 2)));
-        supplementaryTable->setItem(row, 7, new QTableWidgetItem(QString::number(data.getWaterProbability(), 'f', 2)));
-        supplementaryTable->setItem(row, 8, new QTableWidgetItem(QString::number(data.getStressGradient(), 'f', 4)));
-        supplementaryTable->setItem(row, 9, new QTableWidgetItem(data.getRockProperties()));
-        
-        // 设置所有单元格为居中对齐
-        for (int i = 0; i < 10; ++i) {
-            supplementaryTable->item(row, i)->setTextAlignment(Qt::AlignCenter);
-        }
-    }
+    // ========== 加载补勘数据 ==========
+    loadSupplementaryData();
     
     // ========== 加载新闻数据 ==========
     NewsDAO newsDAO;
@@ -1041,7 +1085,7 @@ void ProjectManagementWindow::onEditProject(int projectId)
     // 创建编辑对话框
     QDialog dialog(this);
     dialog.setWindowTitle("编辑项目");
-    dialog.setFixedSize(700, 680);
+    dialog.setFixedSize(700, 720);
     dialog.setStyleSheet("QDialog { background-color: white; }");
 
     QVBoxLayout *layout = new QVBoxLayout(&dialog);
@@ -1136,6 +1180,18 @@ void ProjectManagementWindow::onEditProject(int projectId)
     contact2PhoneEdit->setText(project.getEmergencyContact2Phone());
     contact2PhoneEdit->setStyleSheet(StyleHelper::getInputStyle());
 
+    // 明细数据保留天数（超期明细由后台归档，累计统计与趋势聚合不受影响）
+    RetentionPolicyDAO retentionDAO;
+    int retentionDays = retentionDAO.getRetentionDays(projectId);
+    QLabel *retentionLabel = new QLabel("明细保留天数：", &dialog);
+    retentionLabel->setStyleSheet(labelStyle);
+    QSpinBox *retentionSpin = new QSpinBox(&dialog);
+    retentionSpin->setRange(0, 3650);
+    retentionSpin->setValue(retentionDays);
+    retentionSpin->setSpecialValueText("永久保留");
+    retentionSpin->setSuffix(" 天");
+    retentionSpin->setStyleSheet(StyleHelper::getInputStyle());
+
     formLayout->addRow(nameLabel, nameEdit);
     formLayout->addRow(briefLabel, briefEdit);
     formLayout->addRow(coordsLabel, coordsEdit);
@@ -1147,6 +1203,7 @@ void ProjectManagementWindow::onEditProject(int projectId)
     formLayout->addRow(contact1PhoneLabel, contact1PhoneEdit);
     formLayout->addRow(contact2NameLabel, contact2NameEdit);
     formLayout->addRow(contact2PhoneLabel, contact2PhoneEdit);
+    formLayout->addRow(retentionLabel, retentionSpin);
 
     layout->addLayout(formLayout);
 
@@ -1244,6 +1301,15 @@ void ProjectManagementWindow::onEditProject(int projectId)
         
         // 保存到数据库
         if (projectDAO.updateProject(project)) {
+            // 保留天数变化后立即按新策略扫描一次
+            if (retentionSpin->value() != retentionDays) {
+                if (retentionDAO.setRetentionDays(projectId, retentionSpin->value())) {
+                    DataArchiver::instance()->runNow();
+                } else {
+                    StyleHelper::showWarning(this, "错误", "保存保留天数失败：" + retentionDAO.getLastError());
+                }
+            }
+
             QMessageBox msgBox(this);
             msgBox.setIcon(QMessageBox::Information);
             msgBox.setWindowTitle("成功");
@@ -1622,38 +1688,9 @@ void ProjectManagementWindow::onImportGeoData()
 // 加载掘进信息数据
 void ProjectManagementWindow::loadExcavationData()
 {
-    excavationTable->setRowCount(0);  // 清空表格
-    
-    // 从数据库查询所有项目及其掘进参数
-    ProjectDAO projectDAO;
-    ExcavationParameterDAO excavDAO;
-    
-    QList<Project> projects = projectDAO.getAllProjects();
-    
-    for (const Project &project : projects) {
-        // 查询该项目的所有掘进参数（按时间降序）
-        QList<ExcavationParameter> params = excavDAO.getExcavationParametersByPage(
-            project.getProjectId(), 1, 100);  // 默认显示最近100条
-        
-        for (const ExcavationParameter &param : params) {
-            int row = excavationTable->rowCount();
-            excavationTable->insertRow(row);
-            
-            excavationTable->setItem(row, 0, new QTableWidgetItem(project.getProjectName()));
-            excavationTable->setItem(row, 1, new QTableWidgetItem(
-                param.getExcavationTime().toString("yyyy-MM-dd HH:mm:ss")));
-            excavationTable->setItem(row, 2, new QTableWidgetItem(param.getStakeMark()));
-            excavationTable->setItem(row, 3, new QTableWidgetItem(param.getExcavationMode()));
-            excavationTable->setItem(row, 4, new QTableWidgetItem(
-                QString::number(param.getChamberPressure(), 'f', 2)));
-            excavationTable->setItem(row, 5, new QTableWidgetItem(
-                QString::number(param.getThrustForce(), 'f', 0)));
-            excavationTable->setItem(row, 6, new QTableWidgetItem(
-                QString::number(param.getCutterSpeed(), 'f', 1)));
-            excavationTable->setItem(row, 7, new QTableWidgetItem(
-                QString::number(param.getCutterTorque(), 'f', 0)));
-        }
-    }
+    // 全部项目按时间降序，从最新的记录开始（模型已是该排序，列头指示不会触发重新加载）
+    showExcavationQueryResult(ExcavationParameterDAO::ExcavationQuery());
+    excavationTable->horizontalHeader()->setSortIndicator(ExcavationTableModel::TimeColumn, Qt::DescendingOrder);
 }
 
 // 搜索掘进信息
@@ -1668,18 +1705,13 @@ void ProjectManagementWindow::onSearchExcavation()
         return;
     }
     
-    // 隐藏不匹配的行
-    for (int row = 0; row < excavationTable->rowCount(); ++row) {
-        bool match = false;
-        for (int col = 0; col < excavationTable->columnCount(); ++col) {
-            QTableWidgetItem *item = excavationTable->item(row, col);
-            if (item && item->text().contains(keyword, Qt::CaseInsensitive)) {
-                match = true;
-                break;
-            }
-        }
-        excavationTable->setRowHidden(row, !match);
-    }
+    // 在数据库中按关键字查询所有项目，而不是只过滤已加载的行
+    ExcavationParameterDAO::ExcavationQuery filter = excavationModel->query();
+    filter.projectIds.clear();
+    filter.startTime = QDateTime();
+    filter.endTime = QDateTime();
+    filter.keyword = keyword;
+    showExcavationQueryResult(filter);
 }
 
 // 刷新掘进信息
@@ -1758,72 +1790,44 @@ void ProjectManagementWindow::onFilterExcavation()
     layout->addWidget(buttonBox);
     
     if (dialog.exec() == QDialog::Accepted) {
-        excavationTable->setRowCount(0);
-        
+        ExcavationParameterDAO::ExcavationQuery filter;
         int selectedProjectId = projectCombo->currentData().toInt();
-        QDateTime start = startTime->dateTime();
-        QDateTime end = endTime->dateTime();
-        
-        ExcavationParameterDAO excavDAO;
-        ProjectDAO projDAO;
-        
-        if (selectedProjectId == 0) {
-            // 全部项目
-            for (const Project &project : projects) {
-                QList<ExcavationParameter> params = excavDAO.getExcavationParametersByTimeRange(
-                    project.getProjectId(), start, end);
-                
-                for (const ExcavationParameter &param : params) {
-                    int row = excavationTable->rowCount();
-                    excavationTable->insertRow(row);
-                    
-                    excavationTable->setItem(row, 0, new QTableWidgetItem(project.getProjectName()));
-                    excavationTable->setItem(row, 1, new QTableWidgetItem(
-                        param.getExcavationTime().toString("yyyy-MM-dd HH:mm:ss")));
-                    excavationTable->setItem(row, 2, new QTableWidgetItem(param.getStakeMark()));
-                    excavationTable->setItem(row, 3, new QTableWidgetItem(param.getExcavationMode()));
-                    excavationTable->setItem(row, 4, new QTableWidgetItem(
-                        QString::number(param.getChamberPressure(), 'f', 2)));
-                    excavationTable->setItem(row, 5, new QTableWidgetItem(
-                        QString::number(param.getThrustForce(), 'f', 0)));
-                    excavationTable->setItem(row, 6, new QTableWidgetItem(
-                        QString::number(param.getCutterSpeed(), 'f', 1)));
-                    excavationTable->setItem(row, 7, new QTableWidgetItem(
-                        QString::number(param.getCutterTorque(), 'f', 0)));
-                }
-            }
-        } else {
-            // 指定项目
-            QString projectName = projectCombo->currentText();
-            QList<ExcavationParameter> params = excavDAO.getExcavationParametersByTimeRange(
-                selectedProjectId, start, end);
-            
-            for (const ExcavationParameter &param : params) {
-                int row = excavationTable->rowCount();
-                excavationTable->insertRow(row);
-                
-                excavationTable->setItem(row, 0, new QTableWidgetItem(projectName));
-                excavationTable->setItem(row, 1, new QTableWidgetItem(
-                    param.getExcavationTime().toString("yyyy-MM-dd HH:mm:ss")));
-                excavationTable->setItem(row, 2, new QTableWidgetItem(param.getStakeMark()));
-                excavationTable->setItem(row, 3, new QTableWidgetItem(param.getExcavationMode()));
-                excavationTable->setItem(row, 4, new QTableWidgetItem(
-                    QString::number(param.getChamberPressure(), 'f', 2)));
-                excavationTable->setItem(row, 5, new QTableWidgetItem(
-                    QString::number(param.getThrustForce(), 'f', 0)));
-                excavationTable->setItem(row, 6, new QTableWidgetItem(
-                    QString::number(param.getCutterSpeed(), 'f', 1)));
-                excavationTable->setItem(row, 7, new QTableWidgetItem(
-                    QString::number(param.getCutterTorque(), 'f', 0)));
-            }
+        if (selectedProjectId != 0) {
+            filter.projectIds << selectedProjectId;
         }
+        filter.startTime = startTime->dateTime();
+        filter.endTime = endTime->dateTime();
+        filter.order = excavationModel->query().order;
+        filter.sortOrder = excavationModel->query().sortOrder;
+        showExcavationQueryResult(filter);
     }
 }
 
+// 显示掘进信息查询结果：表格按需加载明细，状态栏显示分项目统计的总数
+void ProjectManagementWindow::showExcavationQueryResult(const ExcavationParameterDAO::ExcavationQuery &filter)
+{
+    excavationModel->setQuery(filter);
+    
+    // 不带条件时为全部数据，不显示筛选统计
+    if (filter.projectIds.isEmpty() && !filter.startTime.isValid() && !filter.endTime.isValid()
+        && filter.keyword.isEmpty()) {
+        return;
+    }
+    
+    ExcavationParameterDAO excavDAO;
+    QList<ExcavationParameterDAO::ExcavationGroupSummary> summaries = excavDAO.summarizeExcavationByProject(filter);
+    
+    int totalCount = 0;
+    for (const auto &summary : summaries) {
+        totalCount += summary.recordCount;
+    }
+    excavationStatusLabel->setText(QString("筛选结果：%1 个项目共 %2 条").arg(summaries.size()).arg(totalCount));
+}
+
 // 导出掘进信息
 void ProjectManagementWindow::onExportExcavation()
 {
-    if (excavationTable->rowCount() == 0) {
+    if (excavationModel->rowCount() == 0) {
         QMessageBox msgBox(this);
         msgBox.setIcon(QMessageBox::Warning);
         msgBox.setWindowTitle("警告");
@@ -1836,21 +1840,22 @@ void ProjectManagementWindow::onExportExcavation()
         return;
     }
     
-    QString fileName = QFileDialog::getSaveFileName(
-        this, "导出掘进信息", 
-        QDir::homePath() + "/excavation_data.csv",
-        "CSV文件 (*.csv)");
-    
-    if (fileName.isEmpty()) {
-        return;
-    }
-    
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    // 按当前查询条件从数据库导出全部记录，不受表格已加载行数限制
+    ExcavationParameterDAO::ExcavationQuery filter = excavationModel->query();
+    exportInBackground("导出掘进信息", "excavation_data",
+        [this, filter](const QString &fileName, DataExporter::Format format) {
+            return dataExporter->exportExcavation(filter, fileName, format);
+        });
+}
+
+// 导入掘进信息：读取导出的列式文件（.svc），在后台写入数据库
+void ProjectManagementWindow::onImportExcavation()
+{
+    if (dataExporter->isRunning()) {
         QMessageBox msgBox(this);
-        msgBox.setIcon(QMessageBox::Critical);
-        msgBox.setWindowTitle("错误");
-        msgBox.setText("无法创建文件！");
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.setWindowTitle("警告");
+        msgBox.setText("已有导出或导入任务正在进行，请稍后再试！");
         msgBox.setStyleSheet("QMessageBox { background-color: white; } "
                              "QLabel { color: black; } "
                              "QPushButton { background-color: #0078d4; color: white; "
@@ -1859,93 +1864,59 @@ void ProjectManagementWindow::onExportExcavation()
         return;
     }
     
-    QTextStream out(&file);
-    out.setEncoding(QStringConverter::Utf8);  // Qt 6方式
+    QString fileName = QFileDialog::getOpenFileName(
+        this, "导入掘进信息", QDir::homePath(), "列式压缩文件 (*.svc)");
     
-    // 写入表头
-    QStringList headers;
-    for (int col = 0; col < excavationTable->columnCount(); ++col) {
-        headers << excavationTable->horizontalHeaderItem(col)->text();
+    if (fileName.isEmpty()) {
+        return;
     }
-    out << headers.join(",") << "\n";
     
-    // 写入数据
-    for (int row = 0; row < excavationTable->rowCount(); ++row) {
-        if (excavationTable->isRowHidden(row)) {
-            continue;  // 跳过隐藏的行
-        }
+    QProgressDialog *progress = new QProgressDialog("正在导入...", "取消", 0, 0, this);
+    progress->setWindowTitle("导入掘进信息");
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+    progress->setMinimumDuration(300);
+    connect(progress, &QProgressDialog::canceled, dataExporter, &DataExporter::cancel);
+    
+    connect(dataExporter, &DataExporter::progressChanged, progress, [progress](qint64 importedRows, qint64) {
+        progress->setLabelText(QString("正在导入... %1 条").arg(importedRows));
+    });
+    
+    connect(dataExporter, &DataExporter::finished, progress,
+            [this, progress](bool success, const QString &message) {
+        progress->deleteLater();
         
-        QStringList rowData;
-        for (int col = 0; col < excavationTable->columnCount(); ++col) {
-            QTableWidgetItem *item = excavationTable->item(row, col);
-            rowData << (item ? item->text() : "");
+        QMessageBox msgBox(this);
+        if (success) {
+            msgBox.setIcon(QMessageBox::Information);
+            msgBox.setWindowTitle("成功");
+            // 导入的记录按当前条件重新加载
+            excavationModel->reload();
+        } else {
+            msgBox.setIcon(QMessageBox::Warning);
+            msgBox.setWindowTitle("导入未完成");
         }
-        out << rowData.join(",") << "\n";
-    }
-    
-    file.close();
+        msgBox.setText(message);
+        msgBox.setStyleSheet("QMessageBox { background-color: white; } "
+                             "QLabel { color: black; } "
+                             "QPushButton { background-color: #0078d4; color: white; "
+                             "border-radius: 4px; padding: 5px 15px; }");
+        msgBox.exec();
+    });
     
-    QMessageBox msgBox(this);
-    msgBox.setIcon(QMessageBox::Information);
-    msgBox.setWindowTitle("成功");
-    msgBox.setText(QString("数据已导出到：%1").arg(fileName));
-    msgBox.setStyleSheet("QMessageBox { background-color: white; } "
-                         "QLabel { color: black; } "
-                         "QPushButton { background-color: #0078d4; color: white; "
-                         "border-radius: 4px; padding: 5px 15px; }");
-    msgBox.exec();
+    if (!dataExporter->importExcavation(fileName)) {
+        progress->deleteLater();
+    }
 }
 
 // 加载补勘数据
 void ProjectManagementWindow::loadSupplementaryData()
 {
-    supplementaryTable->setRowCount(0);
+    // 全部项目按时间降序，从最新的记录开始
+    showSupplementaryQueryResult(ProspectingDataDAO::ProspectingQuery());
     
-    // 从数据库加载所有补勘数据
-    ProspectingDataDAO dao;
-    ProjectDAO projectDAO;
-    
-    // 获取所有项目
-    QList<Project> projects = projectDAO.getAllProjects();
-    
-    for (const Project &project : projects) {
-        // 获取该项目的补勘数据
-        QList<ProspectingData> dataList = dao.getProspectingDataByProjectId(project.getProjectId());
-        
-        for (const ProspectingData &data : dataList) {
-            int row = supplementaryTable->rowCount();
-            supplementaryTable->insertRow(row);
-            
-            // 设置数据
-            supplementaryTable->setItem(row, 0, new QTableWidgetItem(project.getProjectName()));
-            supplementaryTable->setItem(row, 1, new QTableWidgetItem(data.getExcavationTime().toString("yyyy-MM-dd HH:mm:ss")));
-            supplementaryTable->setItem(row, 2, new QTableWidgetItem(data.getStakeMark()));
-            supplementaryTable->setItem(row, 3, new QTableWidgetItem(QString::number(data.getCutterForce(), 'f', 2)));
-            supplementaryTable->setItem(row, 4, new QTableWidgetItem(QString::number(data.getCutterPenetrationResistance(), 'f', 2)));
-            supplementaryTable->setItem(row, 5, new QTableWidgetItem(QString::number(data.getFaceFrictionTorque(), 'f', 2)));
-            supplementaryTable->setItem(row, 6, new QTableWidgetItem(QString::number(data.getApparentResistivity(), 'f', 2)));
-            supplementaryTable->setItem(row, 7, new QTableWidgetItem(QString::number(data.getWaterProbability(), 'f', 1) + "%"));
-            supplementaryTable->setItem(row, 8, new QTableWidgetItem(QString::number(data.getStressGradient(), 'f', 4)));
-            supplementaryTable->setItem(row, 9, new QTableWidgetItem(data.getRockProperties()));
-            supplementaryTable->setItem(row, 10, new QTableWidgetItem(data.getRockDangerLevel()));
-            supplementaryTable->setItem(row, 11, new QTableWidgetItem(QString::number(data.getWaveReflectionCoeff(), 'f', 3)));
-            supplementaryTable->setItem(row, 12, new QTableWidgetItem(QString::number(data.getSWaveVelocity(), 'f', 1)));
-            supplementaryTable->setItem(row, 13, new QTableWidgetItem(QString::number(data.getPWaveVelocity(), 'f', 1)));
-            supplementaryTable->setItem(row, 14, new QTableWidgetItem(QString::number(data.getWaveVelocityRatio(), 'f', 3)));
-            supplementaryTable->setItem(row, 15, new QTableWidgetItem(QString::number(data.getPoissonRatio(), 'f', 3)));
-            supplementaryTable->setItem(row, 16, new QTableWidgetItem(QString::number(data.getYoungsModulus(), 'f', 2)));
-            supplementaryTable->setItem(row, 17, new QTableWidgetItem(data.getRockType()));
-            
-            // 设置所有单元格为只读
-            for (int col = 0; col < supplementaryTable->columnCount(); ++col) {
-                if (supplementaryTable->item(row, col)) {
-                    supplementaryTable->item(row, col)->setFlags(supplementaryTable->item(row, col)->flags() & ~Qt::ItemIsEditable);
-                }
-            }
-        }
-    }
-    
-    qDebug() << "补勘数据加载完成，共" << supplementaryTable->rowCount() << "条记录";
+    qDebug() << "补勘数据开始加载";
 }
 
 // 搜索补勘信息
@@ -1972,23 +1943,10 @@ void ProjectManagementWindow::onSearchSupplementary()
         return;
     }
     
-    // 执行搜索
-    int matchCount = 0;
-    for (int row = 0; row < supplementaryTable->rowCount(); ++row) {
-        bool match = false;
-        
-        // 在所有列中搜索
-        for (int col = 0; col < supplementaryTable->columnCount(); ++col) {
-            QTableWidgetItem *item = supplementaryTable->item(row, col);
-            if (item && item->text().contains(searchText, Qt::CaseInsensitive)) {
-                match = true;
-                break;
-            }
-        }
-        
-        supplementaryTable->setRowHidden(row, !match);
-        if (match) matchCount++;
-    }
+    // 在数据库中按关键字查询所有项目
+    ProspectingDataDAO::ProspectingQuery filter;
+    filter.keyword = searchText;
+    int matchCount = showSupplementaryQueryResult(filter);
     
     QMessageBox msgBox(this);
     msgBox.setWindowTitle("搜索结果");
@@ -2011,11 +1969,6 @@ void ProjectManagementWindow::onRefreshSupplementary()
         searchBox->clear();
     }
     
-    // 显示所有行
-    for (int row = 0; row < supplementaryTable->rowCount(); ++row) {
-        supplementaryTable->setRowHidden(row, false);
-    }
-    
     // 重新加载数据
     loadSupplementaryData();
     
@@ -2083,48 +2036,49 @@ void ProjectManagementWindow::onFilterSupplementary()
         QString projectName = projectFilter->text().trimmed();
         QString dangerLevel = dangerCombo->currentData().toString();
         
-        int matchCount = 0;
-        for (int row = 0; row < supplementaryTable->rowCount(); ++row) {
-            bool match = true;
-            
-            // 项目名称筛选
-            if (!projectName.isEmpty()) {
-                QTableWidgetItem *item = supplementaryTable->item(row, 0);
-                if (!item || !item->text().contains(projectName, Qt::CaseInsensitive)) {
-                    match = false;
-                }
-            }
-            
-            // 围岩危险等级筛选
-            if (!dangerLevel.isEmpty() && match) {
-                QTableWidgetItem *item = supplementaryTable->item(row, 10);
-                if (!item || item->text() != dangerLevel) {
-                    match = false;
-                }
-            }
-            
-            supplementaryTable->setRowHidden(row, !match);
-            if (match) matchCount++;
-        }
+        ProspectingDataDAO::ProspectingQuery filter;
+        filter.projectName = projectName;
+        filter.dangerLevel = dangerLevel;
+        int matchCount = showSupplementaryQueryResult(filter);
         
         QMessageBox msgBox(this);
         msgBox.setWindowTitle("筛选结果");
-        msgBox.setText(QString("筛选后显示 %1 条记录").arg(matchCount));
+        msgBox.setText(matchCount < 0 ? QString("已显示全部记录")
+                                      : QString("筛选后显示 %1 条记录").arg(matchCount));
         msgBox.setIcon(QMessageBox::Information);
         msgBox.setStyleSheet("QMessageBox { background-color: white; } "
                             "QLabel { color: black; } "
                             "QPushButton { background-color: white; color: black; border: 1px solid #ccc; padding: 5px 15px; }");
         msgBox.exec();
         
-        qDebug() << "补勘数据筛选完成，显示" << matchCount << "条记录";
+        qDebug() << "补勘数据筛选完成，匹配" << matchCount << "条记录（-1 为全部）";
+    }
+}
+
+// 显示补勘数据查询结果，返回匹配的记录数；不带条件时返回 -1
+int ProjectManagementWindow::showSupplementaryQueryResult(const ProspectingDataDAO::ProspectingQuery &filter)
+{
+    supplementaryModel->setQuery(filter);
+    
+    // 不带条件时为全部数据，不统计总数（模型在后台加载，此时还没有行）
+    if (filter.projectIds.isEmpty() && filter.projectName.isEmpty() && filter.dangerLevel.isEmpty()
+        && filter.keyword.isEmpty()) {
+        return -1;
     }
+    
+    ProspectingDataDAO dao;
+    int matchCount = dao.countRows(filter);
+    if (matchCount >= 0) {
+        supplementaryStatusLabel->setText(QString("筛选结果：共 %1 条").arg(matchCount));
+    }
+    return qMax(matchCount, 0);
 }
 
 // 导出补勘信息
 void ProjectManagementWindow::onExportSupplementary()
 {
     // 检查是否有数据
-    if (supplementaryTable->rowCount() == 0) {
+    if (supplementaryModel->rowCount() == 0) {
         QMessageBox msgBox(this);
         msgBox.setWindowTitle("提示");
         msgBox.setText("没有可导出的数据");
@@ -2136,73 +2090,11 @@ void ProjectManagementWindow::onExportSupplementary()
         return;
     }
     
-    // 选择保存位置
-    QString fileName = QFileDialog::getSaveFileName(
-        this,
-        "导出补勘数据",
-        QDir::homePath() + "/supplementary_data.csv",
-        "CSV Files (*.csv);;All Files (*)"
-    );
-    
-    if (fileName.isEmpty()) {
-        return;
-    }
-    
-    // 写入CSV文件
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox msgBox(this);
-        msgBox.setIcon(QMessageBox::Critical);
-        msgBox.setWindowTitle("错误");
-        msgBox.setText("无法创建文件！");
-        msgBox.setStyleSheet("QMessageBox { background-color: white; } "
-                            "QLabel { color: black; } "
-                            "QPushButton { background-color: white; color: black; border: 1px solid #ccc; padding: 5px 15px; }");
-        msgBox.exec();
-        return;
-    }
-    
-    QTextStream out(&file);
-    out.setEncoding(QStringConverter::Utf8);
-    
-    // 写入表头
-    QStringList headers;
-    for (int col = 0; col < supplementaryTable->columnCount(); ++col) {
-        headers << supplementaryTable->horizontalHeaderItem(col)->text();
-    }
-    out << headers.join(",") << "\n";
-    
-    // 写入数据
-    for (int row = 0; row < supplementaryTable->rowCount(); ++row) {
-        if (supplementaryTable->isRowHidden(row)) {
-            continue;  // 跳过隐藏的行
-        }
-        
-        QStringList rowData;
-        for (int col = 0; col < supplementaryTable->columnCount(); ++col) {
-            QTableWidgetItem *item = supplementaryTable->item(row, col);
-            QString text = item ? item->text() : "";
-            // 处理包含逗号或换行符的数据
-            if (text.contains(",") || text.contains("\n")) {
-                text = "\"" + text + "\"";
-            }
-            rowData << text;
-        }
-        out << rowData.join(",") << "\n";
-    }
-    
-    file.close();
-    
-    QMessageBox msgBox(this);
-    msgBox.setIcon(QMessageBox::Information);
-    msgBox.setWindowTitle("成功");
-    msgBox.setText(QString("数据已导出到：%1").arg(fileName));
-    msgBox.setStyleSheet("QMessageBox { background-color: white; } "
-                        "QLabel { color: black; } "
-                        "QPushButton { background-color: white; color: black; border: 1px solid #ccc; padding: 5px 15px; }");
-    msgBox.exec();
-    
-    qDebug() << "补勘数据已导出到:" << fileName;
+    ProspectingDataDAO::ProspectingQuery filter = supplementaryModel->query();
+    exportInBackground("导出补勘数据", "supplementary_data",
+        [this, filter](const QString &fileName, DataExporter::Format format) {
+            return dataExporter->exportProspecting(filter, fileName, format);
+        });
 }
 
 void ProjectManagementWindow::onSearchProject()
@@ -2244,27 +2136,10 @@ void ProjectManagementWindow::onSearchWarning()
     QLineEdit *searchBox = warningTable->parentWidget()->findChild<QLineEdit*>("warningSearchBox");
     if (!searchBox) return;
     
-    QString keyword = searchBox->text().trimmed();
-    if (keyword.isEmpty()) {
-        // 如果搜索框为空，显示所有行
-        for (int row = 0; row < warningTable->rowCount(); ++row) {
-            warningTable->setRowHidden(row, false);
-        }
-        return;
-    }
-    
-    // 隐藏不匹配的行
-    for (int row = 0; row < warningTable->rowCount(); ++row) {
-        bool match = false;
-        for (int col = 0; col < warningTable->columnCount(); ++col) {
-            QTableWidgetItem *item = warningTable->item(row, col);
-            if (item && item->text().contains(keyword, Qt::CaseInsensitive)) {
-                match = true;
-                break;
-            }
-        }
-        warningTable->setRowHidden(row, !match);
-    }
+    // 在数据库中按关键字匹配项目名称、预警编号、级别、类别；为空时显示全部
+    WarningDAO::WarningQuery filter;
+    filter.keyword = searchBox->text().trimmed();
+    showWarningQueryResult(filter);
 }
 
 // 刷新预警信息
@@ -2390,70 +2265,30 @@ void ProjectManagementWindow::onFilterWarning()
         QDateTime start = startTime->dateTime();
         QDateTime end = endTime->dateTime();
         
-        // 首先显示所有行（重置筛选状态）
-        for (int row = 0; row < warningTable->rowCount(); ++row) {
-            warningTable->setRowHidden(row, false);
-        }
-        
         // 检查是否所有筛选条件都是"全部"
         bool hasFilter = (selectedProjectId != 0) || (!selectedLevel.isEmpty()) || (!selectedType.isEmpty());
         
-        // 如果没有任何筛选条件，直接返回（显示所有数据）
-        if (!hasFilter) {
-            qDebug() << "未设置任何筛选条件，显示所有预警数据";
-            return;
-        }
-        
-        // 遍历表格，应用筛选条件
-        int matchCount = 0;
-        for (int row = 0; row < warningTable->rowCount(); ++row) {
-            bool match = true;
-            
-            // 项目筛选
+        // 时间范围只在有其他筛选条件时才应用；导出时使用相同的条件
+        WarningDAO::WarningQuery filter;
+        if (hasFilter) {
             if (selectedProjectId != 0) {
-                QString projectName = projectCombo->currentText();
-                if (warningTable->item(row, 0)->text() != projectName) {
-                    match = false;
-                }
-            }
-            
-            // 预警级别筛选
-            if (!selectedLevel.isEmpty() && match) {
-                if (warningTable->item(row, 2)->text() != selectedLevel) {
-                    match = false;
-                }
-            }
-            
-            // 预警类别筛选
-            if (!selectedType.isEmpty() && match) {
-                if (warningTable->item(row, 3)->text() != selectedType) {
-                    match = false;
-                }
-            }
-            
-            // 时间筛选（只有在有其他筛选条件时才应用）
-            if (match && hasFilter) {
-                QString timeStr = warningTable->item(row, 7)->text();
-                QDateTime warningTime = QDateTime::fromString(timeStr, "yyyy-MM-dd hh:mm:ss");
-                if (warningTime.isValid() && (warningTime < start || warningTime > end)) {
-                    match = false;
-                }
-            }
-            
-            warningTable->setRowHidden(row, !match);
-            if (match) {
-                matchCount++;
+                filter.projectIds << selectedProjectId;
             }
+            filter.warningLevel = selectedLevel;
+            filter.warningType = selectedType;
+            filter.startTime = start;
+            filter.endTime = end;
+        } else {
+            qDebug() << "未设置任何筛选条件，显示所有预警数据";
         }
-        
-        qDebug() << "预警筛选完成，显示" << matchCount << "条记录";
+        showWarningQueryResult(filter);
     }
 }
 
 // 导出预警信息
 void ProjectManagementWindow::onExportWarning()
 {
-    if (warningTable->rowCount() == 0) {
+    if (warningModel->rowCount() == 0) {
         QMessageBox msgBox(this);
         msgBox.setIcon(QMessageBox::Warning);
         msgBox.setWindowTitle("警告");
@@ -2466,21 +2301,23 @@ void ProjectManagementWindow::onExportWarning()
         return;
     }
     
-    QString fileName = QFileDialog::getSaveFileName(
-        this, "导出预警信息", 
-        QDir::homePath() + "/warning_data.csv",
-        "CSV文件 (*.csv)");
-    
-    if (fileName.isEmpty()) {
-        return;
-    }
-    
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    // 导出条件与当前的搜索/筛选一致
+    WarningDAO::WarningQuery filter = warningModel->query();
+    exportInBackground("导出预警信息", "warning_data",
+        [this, filter](const QString &fileName, DataExporter::Format format) {
+            return dataExporter->exportWarnings(filter, fileName, format);
+        });
+}
+
+// 选择导出文件并在后台导出，导出期间显示进度，可取消
+void ProjectManagementWindow::exportInBackground(const QString &title, const QString &defaultName,
+                                                 const std::function<bool(const QString &, DataExporter::Format)> &startExport)
+{
+    if (dataExporter->isRunning()) {
         QMessageBox msgBox(this);
-        msgBox.setIcon(QMessageBox::Critical);
-        msgBox.setWindowTitle("错误");
-        msgBox.setText("无法创建文件！");
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.setWindowTitle("警告");
+        msgBox.setText("已有导出任务正在进行，请稍后再试！");
         msgBox.setStyleSheet("QMessageBox { background-color: white; } "
                              "QLabel { color: black; } "
                              "QPushButton { background-color: #0078d4; color: white; "
@@ -2489,78 +2326,115 @@ void ProjectManagementWindow::onExportWarning()
         return;
     }
     
-    QTextStream out(&file);
-    out.setEncoding(QStringConverter::Utf8);
+    QString fileName = QFileDialog::getSaveFileName(
+        this, title,
+        QDir::homePath() + "/" + defaultName + ".csv",
+        "CSV文件 (*.csv);;列式压缩文件 (*.svc)");
     
-    // 写入表头
-    QStringList headers;
-    for (int col = 0; col < warningTable->columnCount(); ++col) {
-        headers << warningTable->horizontalHeaderItem(col)->text();
+    if (fileName.isEmpty()) {
+        return;
     }
-    out << headers.join(",") << "\n";
     
-    // 写入数据
-    for (int row = 0; row < warningTable->rowCount(); ++row) {
-        if (warningTable->isRowHidden(row)) {
-            continue;  // 跳过隐藏的行
+    QProgressDialog *progress = new QProgressDialog("正在导出...", "取消", 0, 0, this);
+    progress->setWindowTitle(title);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+    progress->setMinimumDuration(300);
+    connect(progress, &QProgressDialog::canceled, dataExporter, &DataExporter::cancel);
+    
+    connect(dataExporter, &DataExporter::progressChanged, progress,
+            [progress](qint64 exportedRows, qint64 totalRows) {
+        if (totalRows > 0) {
+            progress->setMaximum(1000);
+            progress->setValue(static_cast<int>(qMin<qint64>(exportedRows * 1000 / totalRows, 1000)));
+            progress->setLabelText(QString("正在导出... %1 / %2 条").arg(exportedRows).arg(totalRows));
+        } else {
+            progress->setLabelText(QString("正在导出... %1 条").arg(exportedRows));
         }
+    });
+    
+    connect(dataExporter, &DataExporter::finished, progress,
+            [this, progress, fileName](bool success, const QString &message) {
+        progress->deleteLater();
         
-        QStringList rowData;
-        for (int col = 0; col < warningTable->columnCount(); ++col) {
-            QTableWidgetItem *item = warningTable->item(row, col);
-            rowData << (item ? item->text() : "");
+        QMessageBox msgBox(this);
+        if (success) {
+            msgBox.setIcon(QMessageBox::Information);
+            msgBox.setWindowTitle("成功");
+            msgBox.setText(QString("%1，数据已导出到：\n%2").arg(message, fileName));
+        } else {
+            msgBox.setIcon(QMessageBox::Warning);
+            msgBox.setWindowTitle("导出未完成");
+            msgBox.setText(message);
         }
-        out << rowData.join(",") << "\n";
-    }
-    
-    file.close();
+        msgBox.setStyleSheet("QMessageBox { background-color: white; } "
+                             "QLabel { color: black; } "
+                             "QPushButton { background-color: #0078d4; color: white; "
+                             "border-radius: 4px; padding: 5px 15px; }");
+        msgBox.exec();
+    });
     
-    QMessageBox msgBox(this);
-    msgBox.setIcon(QMessageBox::Information);
-    msgBox.setWindowTitle("成功");
-    msgBox.setText(QString("预警信息已成功导出到：\n%1").arg(fileName));
-    msgBox.setStyleSheet("QMessageBox { background-color: white; } "
-                         "QLabel { color: black; } "
-                         "QPushButton { background-color: #0078d4; color: white; "
-                         "border-radius: 4px; padding: 5px 15px; }");
-    msgBox.exec();
+    if (!startExport(fileName, DataExporter::formatForFile(fileName))) {
+        progress->deleteLater();
+    }
 }
 
 // 加载预警信息数据
 void ProjectManagementWindow::loadWarningData()
 {
-    ProjectDAO projectDAO;
-    WarningDAO warningDAO;
+    // 全部项目按时间降序，从最新的预警开始
+    showWarningQueryResult(WarningDAO::WarningQuery());
+}
+
+// 显示预警查询结果，带条件时在状态栏显示匹配总数
+void ProjectManagementWindow::showWarningQueryResult(const WarningDAO::WarningQuery &filter)
+{
+    warningModel->setQuery(filter);
     
-    QList<Warning> warnings = warningDAO.getAllWarnings();
-    warningTable->setRowCount(warnings.size());
+    // 不带条件时为全部数据，不统计总数
+    if (filter.projectIds.isEmpty() && filter.warningLevel.isEmpty() && filter.warningType.isEmpty()
+        && !filter.startTime.isValid() && !filter.endTime.isValid() && filter.keyword.isEmpty()) {
+        return;
+    }
     
-    for (int row = 0; row < warnings.size(); row++) {
-        const Warning &warning = warnings[row];
-        
-        // 确保所有行都显示
-        warningTable->setRowHidden(row, false);
-        
-        // 根据项目ID获取项目名称
-        Project project = projectDAO.getProjectById(warning.getProjectId());
-        QString projectName = project.isValid() ? project.getProjectName() : "未知项目";
-        
-        warningTable->setItem(row, 0, new QTableWidgetItem(projectName));
-        warningTable->setItem(row, 1, new QTableWidgetItem(QString::number(warning.getWarningId())));
-        warningTable->setItem(row, 2, new QTableWidgetItem(warning.getWarningLevel()));
-        warningTable->setItem(row, 3, new QTableWidgetItem(warning.getWarningType()));
-        // 组合经纬度坐标
-        QString warningCoordinates = QString("%1,%2").arg(warning.getLatitude()).arg(warning.getLongitude());
-        warningTable->setItem(row, 4, new QTableWidgetItem(warningCoordinates));
-        // 深度
-        warningTable->setItem(row, 5, new QTableWidgetItem(QString::number(warning.getDepth())));
-        // 阈值
-        warningTable->setItem(row, 6, new QTableWidgetItem(QString::number(warning.getThresholdValue())));
-        // 时间 - 将QDateTime转换为QString
-        warningTable->setItem(row, 7, new QTableWidgetItem(warning.getWarningTime().toString("yyyy-MM-dd hh:mm:ss")));
-        
-        for (int col = 0; col < 8; col++) {
-            warningTable->item(row, col)->setTextAlignment(Qt::AlignCenter);
-        }
+    WarningDAO dao;
+    int matchCount = dao.countRows(filter);
+    if (matchCount >= 0) {
+        warningStatusLabel->setText(QString("筛选结果：共 %1 条").arg(matchCount));
+    }
+    qDebug() << "预警筛选完成，匹配" << matchCount << "条记录";
+}
+
+// 删除预警
+void ProjectManagementWindow::onDeleteWarning(int warningId)
+{
+    if (warningId <= 0) {
+        return;
+    }
+    
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle("删除预警");
+    msgBox.setIcon(QMessageBox::Question);
+    msgBox.setText(QString("确定要删除编号为 %1 的预警吗？").arg(warningId));
+    msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+    msgBox.setDefaultButton(QMessageBox::No);
+    msgBox.setStyleSheet("QMessageBox { background-color: white; } QLabel { color: black; }");
+    
+    if (msgBox.exec() != QMessageBox::Yes) {
+        return;
+    }
+    
+    WarningDAO warningDAO;
+    if (warningDAO.deleteWarning(warningId)) {
+        // 按当前条件重新加载
+        showWarningQueryResult(warningModel->query());
+    } else {
+        QMessageBox errorBox(this);
+        errorBox.setWindowTitle("错误");
+        errorBox.setIcon(QMessageBox::Critical);
+        errorBox.setText("删除预警失败：" + warningDAO.getLastError());
+        errorBox.setStyleSheet("QMessageBox { background-color: white; } QLabel { color: black; }");
+        errorBox.exec();
     }
 }
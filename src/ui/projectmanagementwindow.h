@@ -4,10 +4,22 @@
 #include <QMainWindow>
 #include <QTabWidget>
 #include <QTableWidget>
+#include <QTableView>
 #include <QPushButton>
 #include <QLabel>
 #include <QLineEdit>
 #include <QButtonGroup>
+#include <QHash>
+#include "../database/ExcavationParameterDAO.h"
+#include "../database/ProspectingDataDAO.h"
+#include "../database/WarningDAO.h"
+#include "../database/DataExporter.h"
+#include <functional>
+
+class PagedTableModel;
+class ExcavationTableModel;
+class ProspectingTableModel;
+class WarningTableModel;
 
 class ProjectManagementWindow : public QMainWindow
 {
@@ -32,6 +44,7 @@ private slots:
     void onRefreshExcavation();  // 刷新掘进信息
     void onFilterExcavation();  // 筛选掘进信息
     void onExportExcavation();  // 导出掘进信息
+    void onImportExcavation();  // 导入掘进信息列式文件
     void onSearchSupplementary();  // 搜索补勘信息
     void onRefreshSupplementary();  // 刷新补勘信息
     void onFilterSupplementary();  // 筛选补勘信息
@@ -42,6 +55,7 @@ private slots:
     void onRefreshWarning();  // 刷新预警信息
     void onFilterWarning();  // 筛选预警信息
     void onExportWarning();  // 导出预警信息
+    void onDeleteWarning(int warningId);  // 删除预警
 
 private:
     void setupUI();
@@ -55,8 +69,14 @@ private:
     void createNewsModuleTab();
     void loadProjectData();
     void loadWarningData();  // 加载预警信息数据
+    void showWarningQueryResult(const WarningDAO::WarningQuery &filter);  // 显示预警查询结果
     void loadExcavationData();  // 加载掘进信息数据
     void loadSupplementaryData();  // 加载补勘数据
+    void showExcavationQueryResult(const ExcavationParameterDAO::ExcavationQuery &filter);  // 显示掘进信息查询结果
+    int showSupplementaryQueryResult(const ProspectingDataDAO::ProspectingQuery &filter);   // 显示补勘数据查询结果，返回匹配记录数
+    void followPagedWindow(QTableView *view, PagedTableModel *model);  // 分批加载表格随窗口移动保持可见行
+    void exportInBackground(const QString &title, const QString &defaultName,
+                            const std::function<bool(const QString &, DataExporter::Format)> &startExport);  // 选择文件并在后台导出
     void showNewProjectDialog();
     
     QWidget *centralWidget;
@@ -72,11 +92,22 @@ private:
     QPushButton *refreshProjectButton;
     
     // 其他标签页表格
-    QTableWidget *warningTable;
-    QTableWidget *excavationTable;
-    QTableWidget *supplementaryTable;
+    QTableView *warningTable;
+    QTableView *excavationTable;
+    QTableView *supplementaryTable;
     QTableWidget *newsTable;
     
+    // 预警/掘进信息/补勘数据按游标滚动加载的表格模型，导出时按模型当前的查询条件从数据库读取
+    WarningTableModel *warningModel;
+    ExcavationTableModel *excavationModel;
+    ProspectingTableModel *supplementaryModel;
+    QLabel *warningStatusLabel;
+    QLabel *excavationStatusLabel;
+    QLabel *supplementaryStatusLabel;
+    
+    // 后台导出任务
+    DataExporter *dataExporter;
+    
     QPushButton *backButton;
     QPushButton *minimizeButton;
     QPushButton *closeButton;
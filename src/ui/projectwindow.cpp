@@ -3,6 +3,7 @@
 #include "geological2dwidget.h"
 #include "geological3dwidget.h"
 #include "positioningdialog.h"
+#include "excavationtrendchart.h"
 #include "../utils/stylehelper.h"
 #include "../utils/CoordinateConverter.h"
 #include "../database/BoreholeDAO.h"
@@ -10,6 +11,7 @@
 #include "../database/MileageDAO.h"
 #include "../database/ShieldPositionDAO.h"
 #include "../database/ExcavationParameterDAO.h"
+#include "../database/ExcavationColumnCache.h"
 #include "../database/ProspectingDataDAO.h"
 #include "../models/ProspectingData.h"
 #include <QVBoxLayout>
@@ -20,6 +22,7 @@
 #include <QDialog>
 #include <QDialogButtonBox>
 #include <QGroupBox>
+#include <QComboBox>
 #include <QHeaderView>
 #include <QPixmap>
 #include <QPainter>
@@ -704,32 +707,19 @@ void ProjectWindow::loadExcavationParams()
     statsLayout->setSpacing(15);
     statsLayout->setContentsMargins(20, 20, 20, 20);
 
-    // 计算累计统计数据
-    QList<ExcavationParameter> allParams = dao.getExcavationParametersByProjectId(projectId);
-    int totalDuration = 0;
-    int totalIdle = 0;
-    int totalFault = 0;
-    double totalDistance = 0.0;
-    
-    for (const ExcavationParameter &p : allParams) {
-        totalDuration += p.getExcavationDuration();
-        totalIdle += p.getIdleDuration();
-        totalFault += p.getFaultDuration();
-        totalDistance += p.getExcavationDistance();
-    }
-    
-    double faultRatio = (totalDuration + totalIdle + totalFault) > 0 ? 
-                        (double)totalFault / (totalDuration + totalIdle + totalFault) * 100.0 : 0.0;
+    // 累计统计数据由数据库增量维护，直接读取
+    ExcavationParameterDAO::ExcavationStatistics stats;
+    dao.getExcavationStatistics(projectId, stats);
 
     QStringList statsLabels = {"掘进时间：", "闲置时间：", "故障时间比例：", "掘进距离："};
     QStringList statsValues;
     
     if (hasData) {
         statsValues = {
-            QString::number(totalDuration) + " min",
-            QString::number(totalIdle) + " min",
-            QString::number(faultRatio, 'f', 1) + "%",
-            QString::number(totalDistance, 'f', 2) + " m"
+            QString::number(stats.excavationMinutes) + " min",
+            QString::number(stats.idleMinutes) + " min",
+            QString::number(stats.faultRatio(), 'f', 1) + "%",
+            QString::number(stats.distance, 'f', 2) + " m"
         };
     } else {
         statsValues = {"0 min", "0 min", "0%", "0 m"};
@@ -746,11 +736,182 @@ void ProjectWindow::loadExcavationParams()
         statsLayout->addWidget(value, i / 2, (i % 2) * 2 + 1);
     }
 
+    // 重新统计按钮：按明细记录对账累计数据
+    // 排队执行，重新加载页面时按钮自身会被销毁
+    QPushButton *reconcileButton = new QPushButton("重新统计", statsPanel);
+    reconcileButton->setStyleSheet(StyleHelper::getButtonStyle());
+    connect(reconcileButton, &QPushButton::clicked, this, [this]() {
+        ExcavationParameterDAO statsDao;
+        if (statsDao.reconcileExcavationStatistics(projectId)) {
+            loadExcavationParams();
+        } else {
+            StyleHelper::showWarning(this, "错误", statsDao.getLastError());
+        }
+    }, Qt::QueuedConnection);
+    statsLayout->addWidget(reconcileButton, 2, 3, Qt::AlignRight);
+
+    // 近24小时运行统计：在内存列缓存上按时间区间聚合，不逐行构造记录；
+    // 项目缓存后实时数据由接收信号追加，重新进入页面即为最新统计
+    QLabel *recentTitle = new QLabel("近24小时运行统计", mainContent);
+    recentTitle->setStyleSheet(QString("font-size: 16px; font-weight: bold; color: %1; margin-top: 20px;")
+                                   .arg(StyleHelper::COLOR_PRIMARY));
+
+    QWidget *recentPanel = new QWidget(mainContent);
+    recentPanel->setStyleSheet(QString(R"(
+        QWidget {
+            background-color: white;
+            border-radius: 10px;
+            border: 1px solid %1;
+        }
+    )").arg(StyleHelper::COLOR_BORDER));
+
+    QGridLayout *recentLayout = new QGridLayout(recentPanel);
+    recentLayout->setSpacing(10);
+    recentLayout->setContentsMargins(20, 15, 20, 15);
+
+    struct RecentField {
+        QString label;
+        ExcavationColumnCache::Field field;
+        int precision;
+    };
+    const QList<RecentField> recentFields = {
+        {"土仓土压力 (MPa)", ExcavationColumnCache::ChamberPressure, 2},
+        {"千斤顶推力 (t)", ExcavationColumnCache::ThrustForce, 0},
+        {"刀盘转速 (rpm)", ExcavationColumnCache::CutterSpeed, 1},
+        {"刀盘扭矩 (kN·m)", ExcavationColumnCache::CutterTorque, 0}
+    };
+
+    const QStringList recentHeaders = {"参数", "平均", "最小", "最大"};
+    for (int col = 0; col < recentHeaders.size(); col++) {
+        QLabel *header = new QLabel(recentHeaders[col], recentPanel);
+        header->setStyleSheet(QString("font-weight: bold; color: %1;").arg(StyleHelper::COLOR_TEXT_DARK));
+        recentLayout->addWidget(header, 0, col);
+    }
+
+    std::shared_ptr<const ExcavationColumnCache::ProjectColumns> columns =
+        ExcavationColumnCache::instance().getProject(projectId);
+    QDateTime recentEnd = QDateTime::currentDateTime();
+    std::pair<size_t, size_t> recentRange(0, 0);
+    if (columns) {
+        recentRange = ExcavationColumnCache::timeRange(*columns, recentEnd.addDays(-1), recentEnd);
+    }
+
+    for (int i = 0; i < recentFields.size(); i++) {
+        const RecentField &item = recentFields[i];
+        ExcavationColumnCache::ColumnStats fieldStats;
+        if (columns) {
+            fieldStats = ExcavationColumnCache::aggregate(*columns, item.field, recentRange.first, recentRange.second);
+        }
+
+        QStringList cells = {item.label, "-", "-", "-"};
+        if (fieldStats.count > 0) {
+            cells[1] = QString::number(fieldStats.mean(), 'f', item.precision);
+            cells[2] = QString::number(fieldStats.min, 'f', item.precision);
+            cells[3] = QString::number(fieldStats.max, 'f', item.precision);
+        }
+        for (int col = 0; col < cells.size(); col++) {
+            QLabel *cell = new QLabel(cells[col], recentPanel);
+            cell->setStyleSheet(QString("color: %1;").arg(StyleHelper::COLOR_TEXT_DARK));
+            recentLayout->addWidget(cell, i + 1, col);
+        }
+    }
+
+    QLabel *recentCountLabel = new QLabel(
+        QString("记录数：%1").arg(static_cast<qulonglong>(recentRange.second - recentRange.first)), recentPanel);
+    recentCountLabel->setStyleSheet(QString("color: %1; font-style: italic;").arg(StyleHelper::COLOR_TEXT_DARK));
+    recentLayout->addWidget(recentCountLabel, recentFields.size() + 1, 0, 1, 4);
+    columns.reset();
+
+    // 参数趋势：从多分辨率聚合读取，长时间范围也只取与图宽相当的点数
+    QLabel *trendTitle = new QLabel("参数趋势", mainContent);
+    trendTitle->setStyleSheet(QString("font-size: 16px; font-weight: bold; color: %1; margin-top: 20px;")
+                                  .arg(StyleHelper::COLOR_PRIMARY));
+
+    QWidget *trendPanel = new QWidget(mainContent);
+    trendPanel->setStyleSheet(QString(R"(
+        QWidget#trendPanel {
+            background-color: white;
+            border-radius: 10px;
+            border: 1px solid %1;
+        }
+    )").arg(StyleHelper::COLOR_BORDER));
+    trendPanel->setObjectName("trendPanel");
+
+    QVBoxLayout *trendLayout = new QVBoxLayout(trendPanel);
+    trendLayout->setContentsMargins(20, 15, 20, 15);
+
+    QHBoxLayout *trendControls = new QHBoxLayout();
+    QComboBox *trendFieldCombo = new QComboBox(trendPanel);
+    trendFieldCombo->addItem("土仓土压力 (MPa)", "chamber_pressure");
+    trendFieldCombo->addItem("千斤顶推力 (t)", "thrust_force");
+    trendFieldCombo->addItem("刀盘转速 (rpm)", "cutter_speed");
+    trendFieldCombo->addItem("刀盘扭矩 (kN·m)", "cutter_torque");
+    trendFieldCombo->addItem("掘进速度 (mm/min)", "excavation_speed");
+    trendFieldCombo->addItem("注浆压力 (kg/cm²)", "grouting_pressure");
+
+    // 数据为时间范围的小时数，0 表示按环，-1 表示段文件存储中近1小时的高频采样；
+    // 默认为第一项近24小时，高频采样放在聚合范围之后按需选择
+    QComboBox *trendRangeCombo = new QComboBox(trendPanel);
+    trendRangeCombo->addItem("近24小时", 24);
+    trendRangeCombo->addItem("近7天", 24 * 7);
+    trendRangeCombo->addItem("近30天", 24 * 30);
+    trendRangeCombo->addItem("全部（按环）", 0);
+    trendRangeCombo->addItem("近1小时（高频采样）", -1);
+
+    QLabel *trendInfoLabel = new QLabel(trendPanel);
+    trendInfoLabel->setStyleSheet(QString("color: %1;").arg(StyleHelper::COLOR_TEXT_DARK));
+
+    trendControls->addWidget(trendFieldCombo);
+    trendControls->addWidget(trendRangeCombo);
+    trendControls->addStretch();
+    trendControls->addWidget(trendInfoLabel);
+
+    ExcavationTrendChart *trendChart = new ExcavationTrendChart(trendPanel);
+    trendLayout->addLayout(trendControls);
+    trendLayout->addWidget(trendChart);
+
+    connect(trendChart, &ExcavationTrendChart::loaded, trendInfoLabel,
+            [trendInfoLabel, trendRangeCombo](ExcavationRollupDAO::Resolution resolution, int pointCount) {
+        if (trendRangeCombo->currentData().toInt() < 0) {
+            trendInfoLabel->setText(QString("高频采样，%1 个点（阴影为最小/最大值）").arg(pointCount));
+            return;
+        }
+        static const QMap<ExcavationRollupDAO::Resolution, QString> names = {
+            {ExcavationRollupDAO::Resolution::Raw, "原始记录"},
+            {ExcavationRollupDAO::Resolution::Minute, "按分钟"},
+            {ExcavationRollupDAO::Resolution::Hour, "按小时"},
+            {ExcavationRollupDAO::Resolution::Ring, "按环"}
+        };
+        trendInfoLabel->setText(QString("%1，%2 个点（阴影为最小/最大值）").arg(names.value(resolution)).arg(pointCount));
+    });
+
+    auto refreshTrend = [this, trendChart, trendFieldCombo, trendRangeCombo]() {
+        QString field = trendFieldCombo->currentData().toString();
+        int hours = trendRangeCombo->currentData().toInt();
+        if (hours < 0) {
+            QDateTime endTime = QDateTime::currentDateTime();
+            trendChart->showHighFrequency(projectId, field, endTime.addSecs(-3600), endTime);
+        } else if (hours > 0) {
+            QDateTime endTime = QDateTime::currentDateTime();
+            trendChart->showTimeSeries(projectId, field, endTime.addSecs(-3600LL * hours), endTime);
+        } else {
+            trendChart->showRings(projectId, field);
+        }
+    };
+    connect(trendFieldCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), trendChart, refreshTrend);
+    connect(trendRangeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), trendChart, refreshTrend);
+
     layout->addWidget(titleLabel);
     layout->addWidget(paramsPanel);
     layout->addWidget(statsTitle);
     layout->addWidget(statsPanel);
-    layout->addStretch();
+    layout->addWidget(recentTitle);
+    layout->addWidget(recentPanel);
+    layout->addWidget(trendTitle);
+    layout->addWidget(trendPanel, 1);
+
+    // 布局完成后再查询，点数预算按图的实际宽度计算
+    QMetaObject::invokeMethod(trendChart, refreshTrend, Qt::QueuedConnection);
 }
 
 void ProjectWindow::loadSupplementaryData()
@@ -0,0 +1,151 @@
+#include "prospectingtablemodel.h"
+#include <QDateTime>
+
+ProspectingTableModel::ProspectingTableModel(QObject *parent)
+    : PagedTableModel(parent)
+{
+}
+
+void ProspectingTableModel::setQuery(const ProspectingDataDAO::ProspectingQuery &query)
+{
+    currentQuery = query;
+    reload();
+}
+
+int ProspectingTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ProspectingTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    int offset = 0;
+    const RowPage *page = static_cast<const RowPage *>(pageAt(index.row(), offset));
+    if (!page) {
+        return QVariant();
+    }
+
+    const Row &row = page->rows[static_cast<size_t>(offset)];
+    const ExcavationColumnCache::StringDictionary &dictionary = page->dictionary;
+    switch (index.column()) {
+    case ProjectColumn:
+        return dictionary.decode(row.projectName);
+    case TimeColumn:
+        return QDateTime::fromMSecsSinceEpoch(row.timeMs).toString("yyyy-MM-dd HH:mm:ss");
+    case StakeMarkColumn:
+        return dictionary.decode(row.stakeMark);
+    case CutterForceColumn:
+        return QString::number(row.values[CutterForce], 'f', 2);
+    case PenetrationResistanceColumn:
+        return QString::number(row.values[PenetrationResistance], 'f', 2);
+    case FaceFrictionTorqueColumn:
+        return QString::number(row.values[FaceFrictionTorque], 'f', 2);
+    case ApparentResistivityColumn:
+        return QString::number(row.values[ApparentResistivity], 'f', 2);
+    case WaterProbabilityColumn:
+        return QString::number(row.values[WaterProbability], 'f', 1) + "%";
+    case StressGradientColumn:
+        return QString::number(row.values[StressGradient], 'f', 4);
+    case RockPropertiesColumn:
+        return dictionary.decode(row.rockProperties);
+    case DangerLevelColumn:
+        return dictionary.decode(row.dangerLevel);
+    case WaveReflectionCoeffColumn:
+        return QString::number(row.values[WaveReflectionCoeff], 'f', 3);
+    case SWaveVelocityColumn:
+        return QString::number(row.values[SWaveVelocity], 'f', 1);
+    case PWaveVelocityColumn:
+        return QString::number(row.values[PWaveVelocity], 'f', 1);
+    case WaveVelocityRatioColumn:
+        return QString::number(row.values[WaveVelocityRatio], 'f', 3);
+    case PoissonRatioColumn:
+        return QString::number(row.values[PoissonRatio], 'f', 3);
+    case YoungsModulusColumn:
+        return QString::number(row.values[YoungsModulus], 'f', 2);
+    case RockTypeColumn:
+        return dictionary.decode(row.rockType);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant ProspectingTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    static const QStringList headers = {
+        "项目名称", "掘进时间", "桩号", "刀盘受力", "刀具贯入阻力",
+        "刀盘正面摩擦力矩", "视电阻率", "前方5m含水概率", "应力梯度",
+        "前方岩石物性参数", "围岩危险等级", "横纵波反射系数", "横波波速",
+        "纵波波速", "横纵波速比", "泊松比", "杨氏模量", "岩层类型"
+    };
+    return headers.value(section);
+}
+
+PagedTableModel::Fetcher ProspectingTableModel::pageFetcher(const PageCursor &after, PageDirection direction,
+                                                            int limit) const
+{
+    ProspectingDataDAO::ProspectingQuery batchQuery = currentQuery;
+    batchQuery.after = after;
+    batchQuery.direction = direction;
+    batchQuery.limit = limit;
+    return [batchQuery] {
+        return fetchPage(batchQuery);
+    };
+}
+
+PagedTableModel::FetchResult ProspectingTableModel::fetchPage(const ProspectingDataDAO::ProspectingQuery &query)
+{
+    FetchResult result;
+
+    ProspectingDataDAO dao;
+    QList<ProspectingDataDAO::ProspectingRow> batch = dao.queryRows(query);
+    if (!dao.getLastError().isEmpty()) {
+        result.error = dao.getLastError();
+        return result;
+    }
+
+    result.rowCount = batch.size();
+    if (batch.isEmpty()) {
+        return result;
+    }
+
+    auto page = std::make_shared<RowPage>();
+    page->rowCount = batch.size();
+    page->rows.reserve(static_cast<size_t>(batch.size()));
+    for (const auto &entry : batch) {
+        const ProspectingData &data = entry.data;
+        Row row;
+        row.timeMs = data.getExcavationTime().toMSecsSinceEpoch();
+        row.values[CutterForce] = static_cast<float>(data.getCutterForce());
+        row.values[PenetrationResistance] = static_cast<float>(data.getCutterPenetrationResistance());
+        row.values[FaceFrictionTorque] = static_cast<float>(data.getFaceFrictionTorque());
+        row.values[ApparentResistivity] = static_cast<float>(data.getApparentResistivity());
+        row.values[WaterProbability] = static_cast<float>(data.getWaterProbability());
+        row.values[StressGradient] = static_cast<float>(data.getStressGradient());
+        row.values[WaveReflectionCoeff] = static_cast<float>(data.getWaveReflectionCoeff());
+        row.values[SWaveVelocity] = static_cast<float>(data.getSWaveVelocity());
+        row.values[PWaveVelocity] = static_cast<float>(data.getPWaveVelocity());
+        row.values[WaveVelocityRatio] = static_cast<float>(data.getWaveVelocityRatio());
+        row.values[PoissonRatio] = static_cast<float>(data.getPoissonRatio());
+        row.values[YoungsModulus] = static_cast<float>(data.getYoungsModulus());
+        row.projectName = page->dictionary.encode(entry.projectName);
+        row.stakeMark = page->dictionary.encode(data.getStakeMark());
+        row.rockProperties = page->dictionary.encode(data.getRockProperties());
+        row.dangerLevel = page->dictionary.encode(data.getRockDangerLevel());
+        row.rockType = page->dictionary.encode(data.getRockType());
+        page->rows.push_back(row);
+    }
+
+    // 首尾游标都保留，向后翻页从首行、向前翻页从末行开始查询
+    page->range.first = ProspectingDataDAO::cursorFor(batch.first().data);
+    page->range.last = ProspectingDataDAO::cursorFor(batch.last().data);
+    result.page = page;
+    return result;
+}
@@ -0,0 +1,95 @@
+#ifndef PROSPECTINGTABLEMODEL_H
+#define PROSPECTINGTABLEMODEL_H
+
+#include <vector>
+#include "pagedtablemodel.h"
+#include "../database/ProspectingDataDAO.h"
+#include "../database/ExcavationColumnCache.h"
+
+/**
+ * @brief 补勘数据表格模型
+ *
+ * 与 ExcavationTableModel 相同，按查询条件以 (掘进时间, ID) 游标分批读取并只保留
+ * 滑动窗口内的几批（见 PagedTableModel），按掘进时间降序排列；
+ * 每行保存紧凑字段，单元格文本按需生成。
+ */
+class ProspectingTableModel : public PagedTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        ProjectColumn,
+        TimeColumn,
+        StakeMarkColumn,
+        CutterForceColumn,
+        PenetrationResistanceColumn,
+        FaceFrictionTorqueColumn,
+        ApparentResistivityColumn,
+        WaterProbabilityColumn,
+        StressGradientColumn,
+        RockPropertiesColumn,
+        DangerLevelColumn,
+        WaveReflectionCoeffColumn,
+        SWaveVelocityColumn,
+        PWaveVelocityColumn,
+        WaveVelocityRatioColumn,
+        PoissonRatioColumn,
+        YoungsModulusColumn,
+        RockTypeColumn,
+        ColumnCount
+    };
+
+    explicit ProspectingTableModel(QObject *parent = nullptr);
+
+    // 设置查询条件并从头加载（limit、after 与 direction 由模型管理）
+    void setQuery(const ProspectingDataDAO::ProspectingQuery &query);
+    const ProspectingDataDAO::ProspectingQuery &query() const { return currentQuery; }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+protected:
+    Fetcher pageFetcher(const PageCursor &after, PageDirection direction, int limit) const override;
+
+private:
+    // 数值列在 Row::values 中的位置
+    enum NumericField {
+        CutterForce,
+        PenetrationResistance,
+        FaceFrictionTorque,
+        ApparentResistivity,
+        WaterProbability,
+        StressGradient,
+        WaveReflectionCoeff,
+        SWaveVelocity,
+        PWaveVelocity,
+        WaveVelocityRatio,
+        PoissonRatio,
+        YoungsModulus,
+        NumericFieldCount
+    };
+
+    // 一行的紧凑存储
+    struct Row {
+        qint64 timeMs = 0;
+        float values[NumericFieldCount] = {};
+        quint32 projectName = 0;        // 以下为字典编号
+        quint32 stakeMark = 0;
+        quint32 rockProperties = 0;
+        quint32 dangerLevel = 0;
+        quint32 rockType = 0;
+    };
+
+    struct RowPage : Page {
+        std::vector<Row> rows;
+        ExcavationColumnCache::StringDictionary dictionary;
+    };
+
+    static FetchResult fetchPage(const ProspectingDataDAO::ProspectingQuery &query);
+
+    ProspectingDataDAO::ProspectingQuery currentQuery;
+};
+
+#endif // PROSPECTINGTABLEMODEL_H
@@ -0,0 +1,161 @@
+#include "scenestatistics.h"
+#include <Qt3DLogic/QFrameAction>
+#include <Qt3DRender/QGeometryRenderer>
+#include <Qt3DRender/QMaterial>
+#include <Qt3DCore/QGeometry>
+#include <Qt3DCore/QAttribute>
+#include <Qt3DCore/QBuffer>
+#include <QTimer>
+#include <QSet>
+#include <QDebug>
+
+namespace {
+
+// 统计周期（毫秒）
+const int REPORT_INTERVAL_MS = 1000;
+
+// 递归统计启用的实体；禁用的实体连同其子实体都不渲染，不计入
+void collectEntity(Qt3DCore::QEntity *entity, SceneStatistics::Snapshot &snapshot,
+                   QSet<Qt3DCore::QBuffer *> &buffers)
+{
+    if (!entity->isEnabled()) {
+        return;
+    }
+    snapshot.entityCount++;
+
+    // 材质被禁用的网格不绘制（如隐藏钻孔）
+    bool materialEnabled = true;
+    for (Qt3DRender::QMaterial *material : entity->componentsOfType<Qt3DRender::QMaterial>()) {
+        materialEnabled = materialEnabled && material->isEnabled();
+    }
+
+    for (Qt3DRender::QGeometryRenderer *renderer : entity->componentsOfType<Qt3DRender::QGeometryRenderer>()) {
+        if (!renderer->isEnabled() || !renderer->geometry()) {
+            continue;
+        }
+        if (materialEnabled) {
+            snapshot.drawCalls++;
+        }
+        // 共用的缓冲只计一次
+        for (Qt3DCore::QAttribute *attribute : renderer->geometry()->attributes()) {
+            if (attribute->buffer() && !buffers.contains(attribute->buffer())) {
+                buffers.insert(attribute->buffer());
+                snapshot.bufferBytes += attribute->buffer()->data().size();
+            }
+        }
+    }
+
+    for (Qt3DCore::QNode *child : entity->childNodes()) {
+        if (Qt3DCore::QEntity *childEntity = qobject_cast<Qt3DCore::QEntity *>(child)) {
+            collectEntity(childEntity, snapshot, buffers);
+        }
+    }
+}
+
+} // namespace
+
+QString SceneStatistics::Snapshot::toString() const
+{
+    return QString("逻辑帧: %1 | 逻辑帧间隔: 平均 %2 ms，最长 %3 ms | 实体: %4 | 绘制调用: %5 | 缓冲: %6 MB")
+        .arg(tickCount)
+        .arg(averageTickMs, 0, 'f', 1)
+        .arg(maxTickMs, 0, 'f', 1)
+        .arg(entityCount)
+        .arg(drawCalls)
+        .arg(bufferBytes / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+SceneStatistics::SceneStatistics(QObject *parent)
+    : QObject(parent)
+    , enabled(false)
+    , reportTimer(new QTimer(this))
+    , tickCount(0)
+    , tickTimeSum(0.0)
+    , tickTimeMax(0.0)
+{
+    reportTimer->setInterval(REPORT_INTERVAL_MS);
+    connect(reportTimer, &QTimer::timeout, this, &SceneStatistics::report);
+}
+
+SceneStatistics::~SceneStatistics()
+{
+    detachFrameAction();
+}
+
+void SceneStatistics::setRootEntity(Qt3DCore::QEntity *root)
+{
+    detachFrameAction();
+    rootEntity = root;
+    if (enabled) {
+        attachFrameAction();
+    }
+}
+
+void SceneStatistics::setEnabled(bool on)
+{
+    if (enabled == on) {
+        return;
+    }
+    enabled = on;
+
+    tickCount = 0;
+    tickTimeSum = 0.0;
+    tickTimeMax = 0.0;
+    if (enabled) {
+        attachFrameAction();
+        reportTimer->start();
+    } else {
+        detachFrameAction();
+        reportTimer->stop();
+    }
+}
+
+SceneStatistics::Snapshot SceneStatistics::collect(Qt3DCore::QEntity *root)
+{
+    Snapshot snapshot;
+    if (root) {
+        QSet<Qt3DCore::QBuffer *> buffers;
+        collectEntity(root, snapshot, buffers);
+    }
+    return snapshot;
+}
+
+void SceneStatistics::attachFrameAction()
+{
+    if (!rootEntity || frameAction) {
+        return;
+    }
+    frameAction = new Qt3DLogic::QFrameAction(rootEntity);
+    connect(frameAction, &Qt3DLogic::QFrameAction::triggered, this, &SceneStatistics::onTick);
+    rootEntity->addComponent(frameAction);
+}
+
+void SceneStatistics::detachFrameAction()
+{
+    // 根实体释放时帧回调作为其子对象一并释放，QPointer 随之置空
+    delete frameAction;
+    frameAction = nullptr;
+}
+
+void SceneStatistics::onTick(float dt)
+{
+    const double ms = dt * 1000.0;
+    tickCount++;
+    tickTimeSum += ms;
+    tickTimeMax = qMax(tickTimeMax, ms);
+}
+
+void SceneStatistics::report()
+{
+    Snapshot snapshot = collect(rootEntity);
+    snapshot.tickCount = tickCount;
+    snapshot.averageTickMs = tickCount > 0 ? tickTimeSum / tickCount : 0.0;
+    snapshot.maxTickMs = tickTimeMax;
+
+    tickCount = 0;
+    tickTimeSum = 0.0;
+    tickTimeMax = 0.0;
+
+    qDebug().noquote() << "[三维性能]" << snapshot.toString();
+    emit updated(snapshot);
+}
@@ -0,0 +1,82 @@
+#ifndef SCENESTATISTICS_H
+#define SCENESTATISTICS_H
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <Qt3DCore/QEntity>
+
+class QTimer;
+
+namespace Qt3DLogic {
+class QFrameAction;
+}
+
+/**
+ * @brief 三维场景的性能统计
+ *
+ * 开启后在根实体上挂一个 QFrameAction 记录逻辑帧间隔，并按固定周期统计场景规模：
+ * 启用的实体数、绘制调用数（每个可见的网格实体一次，实例化网格也只算一次）、
+ * 几何缓冲字节数（前端保存的CPU副本，上传后GPU显存中的大小相同）。
+ * 统计结果通过 updated() 发出，同时输出到日志，便于发现场景规模的回退。
+ * 关闭时不挂帧回调，不影响按需渲染。
+ *
+ * QFrameAction 在 Qt3D 逻辑层每次推进时触发，不对应实际渲染出的画面：场景静止时
+ * 渲染器可能跳过绘制，而逻辑帧照常推进。统计的是逻辑帧间隔，不是渲染帧率；
+ * 实际渲染帧时间需要逐帧画面捕获，由基准测试（benchmarks/scene3dbenchmark.cpp）测量。
+ *
+ * 用法：
+ *   SceneStatistics *stats = new SceneStatistics(this);
+ *   stats->setRootEntity(rootEntity);
+ *   connect(stats, &SceneStatistics::updated, ...);
+ *   stats->setEnabled(true);
+ */
+class SceneStatistics : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Snapshot {
+        int tickCount = 0;              // 统计周期内的逻辑帧数
+        double averageTickMs = 0.0;     // 平均逻辑帧间隔（毫秒）
+        double maxTickMs = 0.0;         // 最长逻辑帧间隔（毫秒）
+        int entityCount = 0;
+        int drawCalls = 0;
+        qint64 bufferBytes = 0;
+
+        QString toString() const;
+    };
+
+    explicit SceneStatistics(QObject *parent = nullptr);
+    ~SceneStatistics() override;
+
+    // 场景重建后重新设置；旧根实体上的帧回调随之移除
+    void setRootEntity(Qt3DCore::QEntity *root);
+
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled; }
+
+    // 统计场景规模（不含逻辑帧间隔）
+    static Snapshot collect(Qt3DCore::QEntity *root);
+
+signals:
+    void updated(const SceneStatistics::Snapshot &snapshot);
+
+private:
+    void attachFrameAction();
+    void detachFrameAction();
+    void onTick(float dt);
+    void report();
+
+    bool enabled;
+    QPointer<Qt3DCore::QEntity> rootEntity;
+    QPointer<Qt3DLogic::QFrameAction> frameAction;
+    QTimer *reportTimer;
+
+    // 当前统计周期的逻辑帧间隔
+    int tickCount;
+    double tickTimeSum;
+    double tickTimeMax;
+};
+
+#endif // SCENESTATISTICS_H
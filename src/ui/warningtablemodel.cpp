@@ -0,0 +1,122 @@
+#include "warningtablemodel.h"
+
+WarningTableModel::WarningTableModel(QObject *parent)
+    : PagedTableModel(parent)
+{
+}
+
+void WarningTableModel::setQuery(const WarningDAO::WarningQuery &query)
+{
+    currentQuery = query;
+    reload();
+}
+
+const WarningDAO::WarningRow *WarningTableModel::rowAt(int row) const
+{
+    int offset = 0;
+    const RowPage *page = static_cast<const RowPage *>(pageAt(row, offset));
+    return page ? &page->rows[static_cast<size_t>(offset)] : nullptr;
+}
+
+int WarningTableModel::warningIdAt(int row) const
+{
+    const WarningDAO::WarningRow *entry = rowAt(row);
+    return entry ? entry->warning.getWarningId() : 0;
+}
+
+int WarningTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant WarningTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        return int(Qt::AlignCenter);
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    const WarningDAO::WarningRow *entry = rowAt(index.row());
+    if (!entry) {
+        return QVariant();
+    }
+
+    const Warning &warning = entry->warning;
+    switch (index.column()) {
+    case ProjectColumn:
+        return entry->projectName;
+    case IdColumn:
+        return QString::number(warning.getWarningId());
+    case LevelColumn:
+        return warning.getWarningLevel();
+    case TypeColumn:
+        return warning.getWarningType();
+    case CoordinateColumn:
+        return QString("%1,%2").arg(warning.getLatitude()).arg(warning.getLongitude());
+    case DepthColumn:
+        return QString::number(warning.getDepth());
+    case ThresholdColumn:
+        return QString::number(warning.getThresholdValue());
+    case TimeColumn:
+        return warning.getWarningTime().toString("yyyy-MM-dd hh:mm:ss");
+    default:
+        return QVariant();
+    }
+}
+
+QVariant WarningTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    static const QStringList headers = {
+        "项目名称", "编号", "预警级别", "预警类别", "预警坐标",
+        "预警深度", "预警阈值", "预警时间", "操作"
+    };
+    return headers.value(section);
+}
+
+PagedTableModel::Fetcher WarningTableModel::pageFetcher(const PageCursor &after, PageDirection direction,
+                                                        int limit) const
+{
+    WarningDAO::WarningQuery batchQuery = currentQuery;
+    batchQuery.after = after;
+    batchQuery.direction = direction;
+    batchQuery.limit = limit;
+    return [batchQuery] {
+        return fetchPage(batchQuery);
+    };
+}
+
+PagedTableModel::FetchResult WarningTableModel::fetchPage(const WarningDAO::WarningQuery &query)
+{
+    FetchResult result;
+
+    WarningDAO dao;
+    QList<WarningDAO::WarningRow> batch = dao.queryRows(query);
+    if (!dao.getLastError().isEmpty()) {
+        result.error = dao.getLastError();
+        return result;
+    }
+
+    result.rowCount = batch.size();
+    if (batch.isEmpty()) {
+        return result;
+    }
+
+    // 预警记录字段少，直接保存查询结果
+    auto page = std::make_shared<RowPage>();
+    page->rowCount = batch.size();
+    page->range.first = batch.first().cursor;
+    page->range.last = batch.last().cursor;
+    page->rows.assign(batch.begin(), batch.end());
+    result.page = page;
+    return result;
+}
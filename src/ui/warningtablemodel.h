@@ -0,0 +1,61 @@
+#ifndef WARNINGTABLEMODEL_H
+#define WARNINGTABLEMODEL_H
+
+#include <vector>
+#include "pagedtablemodel.h"
+#include "../database/WarningDAO.h"
+
+/**
+ * @brief 预警信息表格模型
+ *
+ * 按查询条件通过 WarningDAO::queryRows 以 (预警时间, ID) 游标分批读取，项目名称随查询一起关联返回；
+ * 只保留滑动窗口内的几批（见 PagedTableModel），按预警时间降序排列。
+ * 最后一列为操作列，按钮由 ActionButtonDelegate 绘制，模型只提供列头。
+ */
+class WarningTableModel : public PagedTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        ProjectColumn,
+        IdColumn,
+        LevelColumn,
+        TypeColumn,
+        CoordinateColumn,
+        DepthColumn,
+        ThresholdColumn,
+        TimeColumn,
+        ActionColumn,
+        ColumnCount
+    };
+
+    explicit WarningTableModel(QObject *parent = nullptr);
+
+    // 设置查询条件并从头加载（limit、after 与 direction 由模型管理）
+    void setQuery(const WarningDAO::WarningQuery &query);
+    const WarningDAO::WarningQuery &query() const { return currentQuery; }
+
+    // 行对应的预警ID，超出范围时返回0
+    int warningIdAt(int row) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+protected:
+    Fetcher pageFetcher(const PageCursor &after, PageDirection direction, int limit) const override;
+
+private:
+    struct RowPage : Page {
+        std::vector<WarningDAO::WarningRow> rows;
+    };
+
+    const WarningDAO::WarningRow *rowAt(int row) const;
+
+    static FetchResult fetchPage(const WarningDAO::WarningQuery &query);
+
+    WarningDAO::WarningQuery currentQuery;
+};
+
+#endif // WARNINGTABLEMODEL_H
@@ -0,0 +1,181 @@
+#include "ChainageAxis.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+// 相邻断面中心水平距离小于该值（米）时视为同一位置，不构成折线段
+const double MIN_STATION_SPACING = 1e-3;
+
+struct Point {
+    double x;
+    double y;
+};
+
+double distanceSquared(const Point &a, const Point &b)
+{
+    const double dx = a.x - b.x;
+    const double dy = a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+// 断面中心按相邻关系排序：从离任一中心最远的一端出发，依次取最近的未访问中心。
+// 数据库按投影里程返回断面，隧道走向与投影Y轴不一致时这个顺序不是沿隧道的顺序
+QVector<Point> orderAlongTunnel(const QVector<Point> &points)
+{
+    const int count = points.size();
+    int start = 0;
+    double farthest = -1.0;
+    for (int i = 0; i < count; i++) {
+        const double d2 = distanceSquared(points[i], points.first());
+        if (d2 > farthest) {
+            farthest = d2;
+            start = i;
+        }
+    }
+
+    QVector<Point> ordered;
+    ordered.reserve(count);
+    QVector<bool> visited(count, false);
+    int current = start;
+    for (int step = 0; step < count; step++) {
+        visited[current] = true;
+        ordered.append(points[current]);
+
+        int next = -1;
+        double best = DBL_MAX;
+        for (int i = 0; i < count; i++) {
+            if (visited[i]) {
+                continue;
+            }
+            const double d2 = distanceSquared(points[i], points[current]);
+            if (d2 < best) {
+                best = d2;
+                next = i;
+            }
+        }
+        if (next < 0) {
+            break;
+        }
+        current = next;
+    }
+    return ordered;
+}
+
+Point profileCenter(const TunnelProfileData &p)
+{
+    return Point{ (p.topLeftX + p.topRightX + p.bottomLeftX + p.bottomRightX) / 4.0,
+                  (p.topLeftY + p.topRightY + p.bottomLeftY + p.bottomRightY) / 4.0 };
+}
+
+} // namespace
+
+ChainageAxis::ChainageAxis(const QVector<BoreholeData> &boreholes, const QVector<TunnelProfileData> &profiles)
+{
+    QVector<Point> centers;
+    centers.reserve(profiles.size());
+    for (const TunnelProfileData &profile : profiles) {
+        centers.append(profileCenter(profile));
+    }
+    if (centers.isEmpty()) {
+        return;
+    }
+
+    // 中心线：沿隧道排列的断面中心，累计水平弧长
+    for (const Point &point : orderAlongTunnel(centers)) {
+        if (centerline.isEmpty()) {
+            centerline.append(Station{ point.x, point.y, 0.0 });
+            continue;
+        }
+        const Station &previous = centerline.last();
+        const double d2 = distanceSquared(point, Point{ previous.x, previous.y });
+        if (d2 < MIN_STATION_SPACING * MIN_STATION_SPACING) {
+            continue;
+        }
+        centerline.append(Station{ point.x, point.y, previous.arcLength + std::sqrt(d2) });
+    }
+    if (centerline.size() < 2 || boreholes.isEmpty()) {
+        return;
+    }
+
+    // 钻孔投影到中心线上，拟合桩号与弧长的关系：方向取协方差的符号，偏移取中位数
+    QVector<double> arcLengths;
+    arcLengths.reserve(boreholes.size());
+    double meanArc = 0.0;
+    double meanChainage = 0.0;
+    for (const BoreholeData &bh : boreholes) {
+        arcLengths.append(arcLengthAt(bh.x, bh.y));
+        meanArc += arcLengths.last();
+        meanChainage += bh.mileage;
+    }
+    meanArc /= boreholes.size();
+    meanChainage /= boreholes.size();
+
+    double covariance = 0.0;
+    for (int i = 0; i < boreholes.size(); i++) {
+        covariance += (arcLengths[i] - meanArc) * (boreholes[i].mileage - meanChainage);
+    }
+    direction = covariance < 0.0 ? -1.0 : 1.0;
+
+    QVector<double> offsets;
+    offsets.reserve(boreholes.size());
+    for (int i = 0; i < boreholes.size(); i++) {
+        offsets.append(boreholes[i].mileage - direction * arcLengths[i]);
+    }
+    auto middle = offsets.begin() + offsets.size() / 2;
+    std::nth_element(offsets.begin(), middle, offsets.end());
+    offset = *middle;
+    fitted = true;
+}
+
+double ChainageAxis::arcLengthAt(double x, double y) const
+{
+    // 投影到最近的折线段；首段向前、末段向后不截断，用于外推
+    const int last = centerline.size() - 2;
+    double best = DBL_MAX;
+    double arcLength = 0.0;
+    for (int i = 0; i <= last; i++) {
+        const Station &a = centerline[i];
+        const Station &b = centerline[i + 1];
+        const double ux = b.x - a.x;
+        const double uy = b.y - a.y;
+        double t = ((x - a.x) * ux + (y - a.y) * uy) / (ux * ux + uy * uy);
+        if (i > 0) {
+            t = qMax(0.0, t);
+        }
+        if (i < last) {
+            t = qMin(1.0, t);
+        }
+        const double dx = a.x + ux * t - x;
+        const double dy = a.y + uy * t - y;
+        const double d2 = dx * dx + dy * dy;
+        if (d2 < best) {
+            best = d2;
+            arcLength = a.arcLength + (b.arcLength - a.arcLength) * t;
+        }
+    }
+    return arcLength;
+}
+
+double ChainageAxis::chainageAt(double x, double y) const
+{
+    if (isEmpty()) {
+        return 0.0;
+    }
+    return direction * arcLengthAt(x, y) + offset;
+}
+
+QVector<TunnelProfileData> ChainageAxis::toChainage(const QVector<TunnelProfileData> &profiles) const
+{
+    if (isEmpty()) {
+        return profiles;
+    }
+
+    QVector<TunnelProfileData> result = profiles;
+    for (TunnelProfileData &profile : result) {
+        const Point center = profileCenter(profile);
+        profile.mileage = chainageAt(center.x, center.y);
+    }
+    return result;
+}
@@ -0,0 +1,58 @@
+#ifndef CHAINAGEAXIS_H
+#define CHAINAGEAXIS_H
+
+#include <QVector>
+#include "../database/BoreholeDAO.h"
+#include "../database/TunnelProfileDAO.h"
+
+/**
+ * @brief 桩号里程轴
+ *
+ * 钻孔的 mileage 是桩号里程（由 MileageDAO::stakeMarkToMileage 换算），实时掘进里程也是；
+ * 导入的隧道断面没有桩号，其 mileage 只是断面顶部中心的投影Y坐标，两者不在同一根轴上。
+ *
+ * 本类以隧道自身的中心线为轴：断面中心按相邻关系连成折线，沿折线累计弧长。
+ * 钻孔分布在隧道两侧，只把它们投影到中心线上求弧长，拟合弧长到桩号里程的方向与偏移
+ * （桩号 = 方向 × 弧长 + 偏移，偏移取各钻孔的中位数）。平面上任意一点投影到中心线上，
+ * 按同一关系换算；超出首尾断面时沿首尾段外推。
+ *
+ * 用法：
+ *   ChainageAxis axis(boreholes, tunnelProfiles);
+ *   const QVector<TunnelProfileData> profiles = axis.toChainage(tunnelProfiles);
+ *   const double chainage = axis.chainageAt(x, y);
+ */
+class ChainageAxis
+{
+public:
+    ChainageAxis() = default;
+    ChainageAxis(const QVector<BoreholeData> &boreholes, const QVector<TunnelProfileData> &profiles);
+
+    // 少于两个不重合的断面或没有钻孔时无法换算
+    bool isEmpty() const { return centerline.size() < 2 || !fitted; }
+
+    // 平面位置对应的桩号里程；无法换算时返回0
+    double chainageAt(double x, double y) const;
+
+    /**
+     * @brief 把断面里程换算为断面中心的桩号里程
+     * @return 换算后的断面，顺序不变；无法换算时原样返回
+     */
+    QVector<TunnelProfileData> toChainage(const QVector<TunnelProfileData> &profiles) const;
+
+private:
+    struct Station {
+        double x;
+        double y;
+        double arcLength;       // 从折线起点累计的水平弧长（米）
+    };
+
+    // 投影到中心线上的弧长，首段向前、末段向后外推
+    double arcLengthAt(double x, double y) const;
+
+    QVector<Station> centerline;    // 断面中心按相邻顺序排列，相邻点不重合
+    double direction = 1.0;         // 桩号随弧长增加为1，减少为-1
+    double offset = 0.0;
+    bool fitted = false;
+};
+
+#endif // CHAINAGEAXIS_H
@@ -0,0 +1,336 @@
+#include "CsvImportPipeline.h"
+#include "XlsxReader.h"
+#include "../database/DatabaseManager.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QDebug>
+#include <map>
+
+namespace {
+
+// 等待时的轮询间隔，用于及时响应取消
+const int WAIT_INTERVAL_MS = 100;
+
+} // namespace
+
+CsvImportPipeline::CsvImportPipeline(QObject *parent)
+    : QObject(parent)
+    , canceled(false)
+{
+}
+
+CsvImportPipeline::~CsvImportPipeline()
+{
+    // 后台导入引用本对象，销毁前取消并等待其结束
+    cancel();
+    if (worker) {
+        worker->wait();
+    }
+}
+
+CsvImportPipeline::Result CsvImportPipeline::run(const QString &filePath)
+{
+    canceled = false;
+    lastResult = execute(filePath);
+    return lastResult;
+}
+
+bool CsvImportPipeline::start(const QString &filePath)
+{
+    if (isRunning()) {
+        return false;
+    }
+    if (worker) {
+        worker->wait();
+    }
+
+    canceled = false;
+    worker.reset(QThread::create([this, filePath]() {
+        lastResult = execute(filePath);
+        QString message;
+        if (lastResult.success) {
+            message = QString("已导入 %1 条记录").arg(lastResult.recordCount);
+        } else if (lastResult.canceled) {
+            message = QString("导入已取消，已写入 %1 条记录").arg(lastResult.recordCount);
+        } else {
+            message = lastResult.errorMessage;
+        }
+        emit finished(lastResult.success, message);
+    }));
+    worker->start();
+    return true;
+}
+
+void CsvImportPipeline::cancel()
+{
+    canceled = true;
+}
+
+bool CsvImportPipeline::isRunning() const
+{
+    return worker && worker->isRunning();
+}
+
+CsvImportPipeline::Result CsvImportPipeline::execute(const QString &filePath)
+{
+    Result result;
+    if (!makeChunk || !parseLine || !writeChunk) {
+        result.errorMessage = "未设置解析与写入函数";
+        qWarning() << result.errorMessage;
+        return result;
+    }
+
+    // 映射在解析线程全部结束后才释放，解析出的字段视图在此期间有效
+    CsvTokenizer tokenizer;
+    XlsxReader xlsxReader;
+    const bool isXlsx = XlsxReader::isXlsxFile(filePath);
+    if (isXlsx ? !xlsxReader.open(filePath) : !tokenizer.open(filePath)) {
+        result.errorMessage = isXlsx ? xlsxReader.errorString() : tokenizer.errorString();
+        qWarning() << result.errorMessage;
+        return result;
+    }
+    // XLSX 的进度按工作表压缩数据计算
+    const qint64 totalBytes = isXlsx ? xlsxReader.size() : tokenizer.size();
+
+    const int parseThreads = options.parseThreads > 0
+        ? options.parseThreads : qMax(1, QThread::idealThreadCount() - 1);
+    const int chunkLines = qMax(1, options.chunkLines);
+
+    QThreadPool parsePool;
+    parsePool.setMaxThreadCount(parseThreads);
+
+    // 已切出但尚未写入的块数上限
+    QSemaphore freeSlots(parseThreads * 2 + 2);
+
+    QMutex mutex;
+    QWaitCondition chunkReady;
+    std::map<int, std::unique_ptr<ParsedChunk>> parsedChunks;     // 已解析、等待按序写入的块
+    int chunkCount = -1;                                            // 切块结束后为总块数
+    std::atomic_bool stopping(false);                               // 取消或写入出错
+    QString readError;                                              // 读取线程的错误，mutex 保护
+
+    auto shouldStop = [this, &stopping]() {
+        return canceled || stopping;
+    };
+
+    std::unique_ptr<QThread> reader(QThread::create([&]() {
+        QString header;
+        if (isXlsx) {
+            CsvTokenizer::Row row;
+            for (int i = 0; i < options.headerLines && xlsxReader.readRow(row); ++i) {
+                if (i == 0) {
+                    QStringList names;
+                    for (int column = 0; column < row.size(); ++column) {
+                        names.append(row[column].toString());
+                    }
+                    header = names.join(',');
+                }
+            }
+        } else {
+            QByteArrayView line;
+            for (int i = 0; i < options.headerLines && tokenizer.skipRow(&line); ++i) {
+                if (i == 0) {
+                    header = QString::fromUtf8(line);
+                }
+            }
+        }
+
+        int index = 0;
+        while (!shouldStop()) {
+            LineChunk chunk;
+            chunk.index = index;
+            if (!(isXlsx ? cutChunk(xlsxReader, chunkLines, chunk) : cutChunk(tokenizer, chunkLines, chunk))) {
+                break;
+            }
+
+            bool acquired = false;
+            while (!(acquired = freeSlots.tryAcquire(1, WAIT_INTERVAL_MS))) {
+                if (shouldStop()) {
+                    break;
+                }
+            }
+            if (!acquired) {
+                break;
+            }
+
+            parsePool.start([&, chunk]() {
+                std::unique_ptr<ParsedChunk> parsed = parseChunk(chunk);
+                QMutexLocker locker(&mutex);
+                parsedChunks[chunk.index] = std::move(parsed);
+                chunkReady.wakeAll();
+            });
+            ++index;
+        }
+
+        QMutexLocker locker(&mutex);
+        result.header = header;
+        if (xlsxReader.hasError()) {
+            readError = xlsxReader.errorString();
+            stopping = true;
+        }
+        chunkCount = index;
+        chunkReady.wakeAll();
+    }));
+    reader->start();
+
+    // 按块的原始顺序写入，每块一个事务；整个文件一个事务时在全部写完后提交
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    const bool perChunk = !options.singleTransaction;
+    bool fileTransaction = false;
+    if (!perChunk) {
+        if (db.transaction()) {
+            fileTransaction = true;
+        } else {
+            result.errorMessage = "开始事务失败: " + db.lastError().text();
+            stopping = true;
+        }
+    }
+    int nextIndex = 0;
+    for (;;) {
+        std::unique_ptr<ParsedChunk> chunk;
+        {
+            QMutexLocker locker(&mutex);
+            while (parsedChunks.find(nextIndex) == parsedChunks.end()
+                   && (chunkCount < 0 || nextIndex < chunkCount)
+                   && !shouldStop()) {
+                chunkReady.wait(&mutex, WAIT_INTERVAL_MS);
+            }
+            auto it = parsedChunks.find(nextIndex);
+            if (it == parsedChunks.end() || shouldStop()) {
+                break;
+            }
+            chunk = std::move(it->second);
+            parsedChunks.erase(it);
+        }
+
+        QString error;
+        if (perChunk) {
+            db.transaction();
+        }
+        if (!writeChunk(*chunk, error)) {
+            db.rollback();
+            fileTransaction = false;
+            result.errorMessage = error.isEmpty() ? QString("写入数据失败") : error;
+            stopping = true;
+            break;
+        }
+        if (perChunk && !db.commit()) {
+            result.errorMessage = "提交事务失败: " + db.lastError().text();
+            db.rollback();
+            stopping = true;
+            break;
+        }
+
+        result.lineCount += chunk->lineCount;
+        result.rejectedCount += chunk->rejectedCount;
+        result.recordCount += chunk->lineCount - chunk->rejectedCount;
+        emit progressChanged(chunk->endOffset, totalBytes, result.recordCount);
+
+        chunk.reset();
+        freeSlots.release();
+        ++nextIndex;
+    }
+
+    stopping = true;
+    reader->wait();
+    parsePool.waitForDone();
+
+    // 读取出错时已写入的块保留，与写入出错的处理一致
+    if (result.errorMessage.isEmpty() && !readError.isEmpty()) {
+        result.errorMessage = readError;
+    }
+
+    // 整个文件一个事务：取消或出错时全部回滚
+    if (fileTransaction) {
+        if (canceled || !result.errorMessage.isEmpty()) {
+            db.rollback();
+        } else if (!db.commit()) {
+            result.errorMessage = "提交事务失败: " + db.lastError().text();
+            db.rollback();
+        } else {
+            fileTransaction = false;
+        }
+    }
+    if (!perChunk && (canceled || !result.errorMessage.isEmpty())) {
+        result.recordCount = 0;
+    }
+
+    result.canceled = canceled;
+    result.success = !result.canceled && result.errorMessage.isEmpty();
+
+    if (!result.errorMessage.isEmpty()) {
+        qWarning() << "CSV导入失败:" << filePath << result.errorMessage;
+    } else {
+        qDebug() << "CSV导入结束:" << filePath << "写入" << result.recordCount << "条，无效"
+                 << result.rejectedCount << "行" << (result.canceled ? "（已取消）" : "");
+    }
+    return result;
+}
+
+bool CsvImportPipeline::cutChunk(CsvTokenizer &tokenizer, int chunkLines, LineChunk &chunk)
+{
+    if (tokenizer.atEnd()) {
+        return false;
+    }
+    chunk.firstRowNumber = tokenizer.nextRowNumber();
+    const qint64 start = tokenizer.position();
+    int rows = 0;
+    while (rows < chunkLines && tokenizer.skipRow()) {
+        ++rows;
+    }
+    chunk.endOffset = tokenizer.position();
+    chunk.data = tokenizer.data().sliced(start, chunk.endOffset - start);
+    return true;
+}
+
+bool CsvImportPipeline::cutChunk(XlsxReader &reader, int chunkLines, LineChunk &chunk)
+{
+    CsvTokenizer::Row row;
+    qint64 lastRowNumber = 0;
+    int rows = 0;
+    while (rows < chunkLines && reader.readRow(row)) {
+        if (rows == 0) {
+            chunk.firstRowNumber = row.number;
+        } else {
+            // 工作表中省略的空行补为空行，保持行号与工作表一致
+            for (qint64 gap = row.number - lastRowNumber - 1; gap > 0; --gap) {
+                chunk.buffer.append('\n');
+            }
+        }
+        CsvTokenizer::appendRow(chunk.buffer, row);
+        lastRowNumber = row.number;
+        ++rows;
+    }
+    if (rows == 0) {
+        return false;
+    }
+    chunk.data = chunk.buffer;
+    chunk.endOffset = reader.position();
+    return true;
+}
+
+std::unique_ptr<CsvImportPipeline::ParsedChunk> CsvImportPipeline::parseChunk(const LineChunk &lines) const
+{
+    CsvTokenizer tokenizer;
+    tokenizer.setData(lines.data, lines.firstRowNumber);
+
+    std::unique_ptr<ParsedChunk> chunk = makeChunk(options.chunkLines);
+    chunk->endOffset = lines.endOffset;
+
+    CsvTokenizer::Row row;
+    while (tokenizer.readRow(row)) {
+        if (row.isBlank()) {
+            continue;
+        }
+        ++chunk->lineCount;
+        if (row.size() < options.minFields || !parseLine(row, *chunk)) {
+            ++chunk->rejectedCount;
+        }
+    }
+    return chunk;
+}
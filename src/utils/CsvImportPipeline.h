@@ -0,0 +1,158 @@
+#ifndef CSVIMPORTPIPELINE_H
+#define CSVIMPORTPIPELINE_H
+
+#include "CsvTokenizer.h"
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QThread>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class XlsxReader;
+
+/**
+ * @brief CSV 流水线导入
+ *
+ * 三段流水线：
+ *   读取线程   在映射的文件上按行边界切块（Options::chunkLines 行），不拆分字段；
+ *              .xlsx 文件由 XlsxReader 边解压边读取，每块行转成 CSV 文本交给解析线程
+ *   解析线程池 各块并行用 CsvTokenizer 拆分字段并转换为记录，跳过空行与只有逗号的行；
+ *              字段为指向映射内存的视图，解析函数不能访问数据库
+ *   写入       在调用 run() 的线程中按块的原始顺序写库，每块一个事务
+ *              （Options::singleTransaction 时整个文件一个事务）
+ * 已切出但尚未写入的块数有上限，读取快于写入时读取线程等待。
+ *
+ * 取消只在块之间生效：正在写的块会完整提交，之后的块不再写入，
+ * 已提交的记录数在 Result 中给出。整个文件一个事务时，取消或出错都回滚全部记录。
+ *
+ * 用法：
+ *   CsvImportPipeline pipeline;
+ *   pipeline.setHandlers<Point>(
+ *       [](const CsvTokenizer::Row &row, Point &point) { point.x = row[2].toDouble(); ... return true; },
+ *       [](const QVector<Point> &points, QString &error) { ... return true; });
+ *   CsvImportPipeline::Result result = pipeline.run(filePath);       // 或 start() 后台执行
+ */
+class CsvImportPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int headerLines = 1;        // 跳过的表头行数
+        int minFields = 0;          // 字段数少于该值的行视为无效
+        int chunkLines = 2000;      // 每块行数，也是每个写事务的最大行数
+        int parseThreads = 0;       // 解析线程数，0 表示按CPU核数
+        bool singleTransaction = false; // 整个文件一个写事务，要么全部导入要么全部不导入
+    };
+
+    struct Result {
+        bool success = false;
+        bool canceled = false;
+        QString header;             // 第一行表头（已去除BOM）
+        qint64 lineCount = 0;       // 数据行数（不含表头与空行）
+        qint64 recordCount = 0;     // 已写入的记录数
+        qint64 rejectedCount = 0;   // 字段不足或解析失败的行数
+        QString errorMessage;
+    };
+
+    // 解析一行，返回 false 表示该行无效；在解析线程中调用
+    template <typename Record>
+    using ParseFunction = std::function<bool(const CsvTokenizer::Row &row, Record &record)>;
+
+    // 写入一块记录，调用时已开启事务，返回 false 时回滚该块并停止导入；在写入线程中按顺序调用
+    template <typename Record>
+    using WriteFunction = std::function<bool(const QVector<Record> &records, QString &error)>;
+
+    explicit CsvImportPipeline(QObject *parent = nullptr);
+    ~CsvImportPipeline();
+
+    void setOptions(const Options &options) { this->options = options; }
+    const Options &getOptions() const { return options; }
+
+    template <typename Record>
+    void setHandlers(ParseFunction<Record> parse, WriteFunction<Record> write)
+    {
+        struct Chunk : ParsedChunk {
+            QVector<Record> records;
+        };
+
+        makeChunk = [](int lineCount) {
+            auto chunk = std::make_unique<Chunk>();
+            chunk->records.reserve(lineCount);
+            return std::unique_ptr<ParsedChunk>(std::move(chunk));
+        };
+        parseLine = [parse](const CsvTokenizer::Row &row, ParsedChunk &chunk) {
+            Record record;
+            if (!parse(row, record)) {
+                return false;
+            }
+            static_cast<Chunk &>(chunk).records.append(std::move(record));
+            return true;
+        };
+        writeChunk = [write](const ParsedChunk &chunk, QString &error) {
+            return write(static_cast<const Chunk &>(chunk).records, error);
+        };
+    }
+
+    // 在当前线程执行导入（写入使用当前线程的数据库连接），阻塞到结束
+    Result run(const QString &filePath);
+
+    // 在后台线程执行导入，结束时发出 finished，返回 false 表示已有导入在进行
+    bool start(const QString &filePath);
+
+    // 请求取消
+    void cancel();
+
+    bool isRunning() const;
+
+    // 最近一次导入的结果
+    Result result() const { return lastResult; }
+
+signals:
+    // 导入进度：已写入部分对应的文件字节数、文件总字节数与已写入记录数
+    void progressChanged(qint64 processedBytes, qint64 totalBytes, qint64 recordCount);
+
+    // 后台导入结束（成功、失败或取消），详细结果见 result()
+    void finished(bool success, const QString &message);
+
+private:
+    // 解析后的一块记录，具体记录类型由 setHandlers() 决定
+    struct ParsedChunk {
+        virtual ~ParsedChunk() = default;
+        qint64 endOffset = 0;       // 该块最后一行之后的文件位置
+        qint64 lineCount = 0;
+        qint64 rejectedCount = 0;
+    };
+
+    // 读取线程交给解析线程的一块数据（映射内存中的一段完整行）
+    struct LineChunk {
+        int index = 0;
+        QByteArrayView data;
+        QByteArray buffer;          // XLSX 块转成的 CSV 文本，data 指向它（隐式共享，复制块不会失效）
+        qint64 firstRowNumber = 0;
+        qint64 endOffset = 0;
+    };
+
+    Result execute(const QString &filePath);
+
+    // 从 CSV 或 XLSX 切出下一块，已到末尾返回 false
+    static bool cutChunk(CsvTokenizer &tokenizer, int chunkLines, LineChunk &chunk);
+    static bool cutChunk(XlsxReader &reader, int chunkLines, LineChunk &chunk);
+
+    // 解析一块原始行，在解析线程中调用
+    std::unique_ptr<ParsedChunk> parseChunk(const LineChunk &lines) const;
+
+private:
+    Options options;
+    std::function<std::unique_ptr<ParsedChunk>(int)> makeChunk;
+    std::function<bool(const CsvTokenizer::Row &, ParsedChunk &)> parseLine;
+    std::function<bool(const ParsedChunk &, QString &)> writeChunk;
+
+    std::unique_ptr<QThread> worker;
+    std::atomic_bool canceled;
+    Result lastResult;
+};
+
+#endif // CSVIMPORTPIPELINE_H
@@ -0,0 +1,350 @@
+#include "CsvTokenizer.h"
+#include <QtAlgorithms>
+#include <QDebug>
+#include <charconv>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSV_TOKENIZER_SSE2
+#endif
+
+namespace {
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+// 查找 [p, end) 中第一个逗号、\n 或 \r，没有时返回 end
+const char *findDelimiter(const char *p, const char *end)
+{
+#ifdef CSV_TOKENIZER_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i lineFeed = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, comma),
+                                                 _mm_cmpeq_epi8(chunk, lineFeed)),
+                                    _mm_cmpeq_epi8(chunk, carriageReturn));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask != 0) {
+            return p + qCountTrailingZeroBits(static_cast<quint32>(mask));
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != ',' && *p != '\n' && *p != '\r') {
+        ++p;
+    }
+    return p;
+}
+
+// 查找 [p, end) 中第一个双引号、\n 或 \r，没有时返回 end
+const char *findQuoteOrLineEnd(const char *p, const char *end)
+{
+#ifdef CSV_TOKENIZER_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i lineFeed = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                 _mm_cmpeq_epi8(chunk, lineFeed)),
+                                    _mm_cmpeq_epi8(chunk, carriageReturn));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask != 0) {
+            return p + qCountTrailingZeroBits(static_cast<quint32>(mask));
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\n' && *p != '\r') {
+        ++p;
+    }
+    return p;
+}
+
+// 查找引号字段的结束引号（跳过 "" 转义），返回结束引号位置，未闭合时返回 end
+const char *findClosingQuote(const char *p, const char *end, bool &escaped)
+{
+    for (;;) {
+        // 单字符查找交给 memchr（C 库已向量化）
+        const void *hit = std::memchr(p, '"', static_cast<size_t>(end - p));
+        if (!hit) {
+            return end;
+        }
+        const char *quote = static_cast<const char *>(hit);
+        if (quote + 1 < end && quote[1] == '"') {
+            escaped = true;
+            p = quote + 2;
+            continue;
+        }
+        return quote;
+    }
+}
+
+} // namespace
+
+QByteArrayView CsvTokenizer::Field::trimmed() const
+{
+    const char *first = data;
+    const char *last = data + length;
+    while (first < last && isSpace(*first)) {
+        ++first;
+    }
+    while (last > first && isSpace(last[-1])) {
+        --last;
+    }
+    return QByteArrayView(first, last - first);
+}
+
+QString CsvTokenizer::Field::toString() const
+{
+    QString text = QString::fromUtf8(trimmed());
+    if (escapedQuotes) {
+        text.replace("\"\"", "\"");
+    }
+    return text;
+}
+
+double CsvTokenizer::Field::toDouble(bool *ok) const
+{
+    QByteArrayView text = trimmed();
+    if (!text.isEmpty() && text.front() == '+') {
+        text = text.sliced(1);
+    }
+
+    double value = 0.0;
+    bool valid = false;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    valid = !text.isEmpty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+#else
+    // 标准库不支持浮点 from_chars 时退回 Qt 的解析
+    value = QByteArray::fromRawData(text.data(), text.size()).toDouble(&valid);
+#endif
+    if (!valid) {
+        value = 0.0;
+    }
+    if (ok) {
+        *ok = valid;
+    }
+    return value;
+}
+
+qint64 CsvTokenizer::Field::toLongLong(bool *ok) const
+{
+    QByteArrayView text = trimmed();
+    if (!text.isEmpty() && text.front() == '+') {
+        text = text.sliced(1);
+    }
+
+    qint64 value = 0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    bool valid = !text.isEmpty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+    if (!valid) {
+        value = 0;
+    }
+    if (ok) {
+        *ok = valid;
+    }
+    return value;
+}
+
+const CsvTokenizer::Field &CsvTokenizer::Row::at(int index) const
+{
+    static const Field emptyField;
+    return (index >= 0 && index < fields.size()) ? fields[index] : emptyField;
+}
+
+bool CsvTokenizer::Row::isBlank() const
+{
+    for (const Field &field : fields) {
+        if (!field.isEmpty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+CsvTokenizer::CsvTokenizer()
+    : mapping(nullptr)
+    , begin(nullptr)
+    , cursor(nullptr)
+    , end(nullptr)
+    , rowNumber(1)
+{
+}
+
+CsvTokenizer::~CsvTokenizer()
+{
+    close();
+}
+
+bool CsvTokenizer::open(const QString &filePath)
+{
+    close();
+
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = "无法打开文件: " + file.errorString();
+        return false;
+    }
+
+    if (file.size() > 0) {
+        mapping = file.map(0, file.size());
+        if (mapping) {
+            begin = reinterpret_cast<const char *>(mapping);
+            end = begin + file.size();
+        } else {
+            qWarning() << "无法映射文件，改为整体读入:" << filePath << file.errorString();
+            buffer = file.readAll();
+            if (file.error() != QFileDevice::NoError) {
+                const QString message = "读取文件失败: " + file.errorString();
+                close();
+                error = message;
+                return false;
+            }
+            begin = buffer.constData();
+            end = begin + buffer.size();
+        }
+    }
+
+    // 跳过 UTF-8 BOM
+    if (end - begin >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0) {
+        begin += 3;
+    }
+    cursor = begin;
+    rowNumber = 1;
+    return true;
+}
+
+void CsvTokenizer::setData(QByteArrayView data, qint64 firstRowNumber)
+{
+    close();
+    begin = data.data();
+    end = begin + data.size();
+    cursor = begin;
+    rowNumber = firstRowNumber;
+}
+
+void CsvTokenizer::close()
+{
+    if (mapping) {
+        file.unmap(mapping);
+        mapping = nullptr;
+    }
+    if (file.isOpen()) {
+        file.close();
+    }
+    buffer.clear();
+    begin = cursor = end = nullptr;
+    rowNumber = 1;
+    error.clear();
+}
+
+bool CsvTokenizer::readRow(Row &row)
+{
+    row.fields.clear();
+    if (cursor >= end) {
+        return false;
+    }
+    row.number = rowNumber++;
+
+    const char *p = cursor;
+    for (;;) {
+        if (p < end && *p == '"') {
+            // 引号字段：内容到结束引号为止，其后到分隔符之间的字符忽略
+            bool escaped = false;
+            const char *closing = findClosingQuote(p + 1, end, escaped);
+            row.fields.append(Field(p + 1, closing - (p + 1), escaped));
+            p = (closing < end) ? findDelimiter(closing + 1, end) : end;
+        } else {
+            const char *delimiter = findDelimiter(p, end);
+            row.fields.append(Field(p, delimiter - p, false));
+            p = delimiter;
+        }
+
+        if (p < end && *p == ',') {
+            ++p;
+            continue;
+        }
+        break;
+    }
+
+    cursor = p;
+    skipLineEnd();
+    return true;
+}
+
+bool CsvTokenizer::skipRow(QByteArrayView *line)
+{
+    if (cursor >= end) {
+        return false;
+    }
+    ++rowNumber;
+
+    const char *rowStart = cursor;
+    const char *p = cursor;
+    for (;;) {
+        p = findQuoteOrLineEnd(p, end);
+        if (p >= end || *p != '"') {
+            break;
+        }
+        // 只有字段开头的引号开始引号字段，其余按字面处理
+        if (p == rowStart || p[-1] == ',') {
+            bool escaped = false;
+            const char *closing = findClosingQuote(p + 1, end, escaped);
+            p = (closing < end) ? closing + 1 : end;
+        } else {
+            ++p;
+        }
+    }
+
+    if (line) {
+        *line = QByteArrayView(rowStart, p - rowStart);
+    }
+    cursor = p;
+    skipLineEnd();
+    return true;
+}
+
+void CsvTokenizer::appendRow(QByteArray &out, const Row &row)
+{
+    for (int i = 0; i < row.size(); ++i) {
+        if (i > 0) {
+            out.append(',');
+        }
+        const Field &field = row.fields[i];
+        const QByteArrayView raw = field.raw();
+        if (field.hasEscapedQuotes()) {
+            // 原始内容中的 "" 已是转义形式
+            out.append('"').append(raw).append('"');
+        } else if (findQuoteOrLineEnd(raw.data(), raw.data() + raw.size()) != raw.data() + raw.size()
+                   || raw.contains(',')) {
+            out.append('"');
+            for (char c : raw) {
+                if (c == '"') {
+                    out.append('"');
+                }
+                out.append(c);
+            }
+            out.append('"');
+        } else {
+            out.append(raw);
+        }
+    }
+    out.append('\n');
+}
+
+void CsvTokenizer::skipLineEnd()
+{
+    if (cursor < end && *cursor == '\r') {
+        ++cursor;
+    }
+    if (cursor < end && *cursor == '\n') {
+        ++cursor;
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef CSVTOKENIZER_H
+#define CSVTOKENIZER_H
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QVarLengthArray>
+
+/**
+ * @brief 内存映射的 CSV 分词器
+ *
+ * 把整个文件映射到内存后按行拆分字段，字段为指向映射内存的视图，不复制数据，
+ * 只有调用 Field::toString() 时才解码为 QString；数值字段用 std::from_chars 直接解析。
+ * 逗号、换行与引号的查找按 16 字节一组用 SSE2 比较（不支持时逐字节查找）。
+ *
+ * 按 RFC 4180 处理：字段开头为双引号时为引号字段，其中的逗号与换行按字面处理，
+ * "" 表示一个双引号；行以 \n、\r\n 或 \r 结束；文件开头的 UTF-8 BOM 被跳过。
+ * 无法映射的文件（如某些网络文件系统）整体读入内存后同样处理。
+ *
+ * 用法：
+ *   CsvTokenizer tokenizer;
+ *   if (!tokenizer.open(filePath)) { ... tokenizer.errorString() ... }
+ *   CsvTokenizer::Row row;
+ *   while (tokenizer.readRow(row)) {
+ *       double x = row.at(3).toDouble();
+ *       QString code = row.at(2).toString();
+ *   }
+ */
+class CsvTokenizer
+{
+public:
+    /**
+     * @brief 字段视图，在分词器数据有效期间有效
+     */
+    class Field
+    {
+    public:
+        Field() = default;
+        Field(const char *data, qsizetype size, bool escapedQuotes)
+            : data(data), length(size), escapedQuotes(escapedQuotes) {}
+
+        // 原始内容：不含包围的引号，"" 未还原，未去除空白
+        QByteArrayView raw() const { return QByteArrayView(data, length); }
+
+        // 原始内容中是否有 "" 转义
+        bool hasEscapedQuotes() const { return escapedQuotes; }
+
+        // 去除两端空格与制表符后的内容
+        QByteArrayView trimmed() const;
+
+        bool isEmpty() const { return trimmed().isEmpty(); }
+
+        // 解码为 QString（UTF-8，去除两端空白，"" 还原为 "）
+        QString toString() const;
+
+        // 解析数值，格式无效时返回0并置 ok 为 false
+        double toDouble(bool *ok = nullptr) const;
+        qint64 toLongLong(bool *ok = nullptr) const;
+        int toInt(bool *ok = nullptr) const { return static_cast<int>(toLongLong(ok)); }
+
+    private:
+        const char *data = nullptr;
+        qsizetype length = 0;
+        bool escapedQuotes = false;
+    };
+
+    /**
+     * @brief 一行的字段，可反复传入 readRow() 以复用存储
+     */
+    struct Row {
+        qint64 number = 0;                      // 行号（从1开始，含表头）
+        QVarLengthArray<Field, 32> fields;
+
+        int size() const { return static_cast<int>(fields.size()); }
+
+        // 越界时返回空字段
+        const Field &at(int index) const;
+        const Field &operator[](int index) const { return at(index); }
+
+        // 空行或所有字段都为空（如只有逗号的分隔行）
+        bool isBlank() const;
+    };
+
+    CsvTokenizer();
+    ~CsvTokenizer();
+
+    CsvTokenizer(const CsvTokenizer &) = delete;
+    CsvTokenizer &operator=(const CsvTokenizer &) = delete;
+
+    // 打开并映射文件
+    bool open(const QString &filePath);
+
+    // 解析调用方持有的数据（不复制，不跳过BOM），firstRowNumber 为第一行的行号
+    void setData(QByteArrayView data, qint64 firstRowNumber = 1);
+
+    void close();
+
+    QString errorString() const { return error; }
+
+    // 全部数据（不含BOM）
+    QByteArrayView data() const { return QByteArrayView(begin, end - begin); }
+
+    qint64 size() const { return end - begin; }
+    qint64 position() const { return cursor - begin; }
+    bool atEnd() const { return cursor >= end; }
+
+    // 读取下一行，已到末尾返回 false
+    bool readRow(Row &row);
+
+    /**
+     * @brief 跳过下一行，不拆分字段
+     * @param line 输出该行原始内容（不含行尾），可为空
+     * @return 已到末尾返回 false
+     */
+    bool skipRow(QByteArrayView *line = nullptr);
+
+    // 下一行的行号
+    qint64 nextRowNumber() const { return rowNumber; }
+
+    // 把一行按 CSV 格式追加到 out（以 \n 结束），含逗号、引号或换行的字段加引号
+    static void appendRow(QByteArray &out, const Row &row);
+
+private:
+    // 跳过行尾（\n、\r\n 或 \r）
+    void skipLineEnd();
+
+    QFile file;
+    uchar *mapping;
+    QByteArray buffer;          // 无法映射时的文件内容
+    const char *begin;
+    const char *cursor;
+    const char *end;
+    qint64 rowNumber;
+    QString error;
+};
+
+#endif // CSVTOKENIZER_H
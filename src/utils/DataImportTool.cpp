@@ -1,30 +1,53 @@
 #include "DataImportTool.h"
-#include "../database/BoreholeDAO.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QFile>
-#include <QTextStream>
 #include <QDebug>
 #include <QRegularExpression>
 
-// Qt 6需要的编码支持
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    #include <QStringConverter>
-#endif
+namespace {
+
+/**
+ * @brief 钻孔数据表中的一行
+ * 序号与勘探点编号都不为空的行开始一个新钻孔，有地层编号与岩土名称的行带一个地层
+ */
+struct BoreholeRow {
+    bool startsBorehole = false;
+    BoreholeData borehole;          // startsBorehole 为 true 时有效，不含地层
+    bool hasLayer = false;
+    BoreholeLayerData layer;
+};
+
+} // namespace
 
 DataImportTool::DataImportTool(QWidget *parent)
     : QDialog(parent)
+    , pipeline(new CsvImportPipeline(this))
+    , currentBorehole()
+    , currentBoreholeId(-1)
+    , currentLayerCount(0)
+    , boreholeCount(0)
+    , layerCount(0)
 {
     setupUI();
     setWindowTitle("钻孔数据导入工具");
     resize(700, 500);
+    
+    connect(pipeline, &CsvImportPipeline::progressChanged, this,
+            [this](qint64 processedBytes, qint64 totalBytes, qint64) {
+        if (totalBytes > 0) {
+            progressBar->setValue(static_cast<int>(processedBytes * 100 / totalBytes));
+        }
+    });
+    connect(pipeline, &CsvImportPipeline::finished, this, &DataImportTool::onImportFinished);
 }
 
 DataImportTool::~DataImportTool()
 {
+    // 导入线程会写本对象的成员，先取消并等待其结束
+    delete pipeline;
 }
 
 void DataImportTool::setupUI()
@@ -45,7 +68,7 @@ void DataImportTool::setupUI()
     QLabel *fileLabel = new QLabel("Excel文件:", this);
     excelPathEdit = new QLineEdit(this);
     excelPathEdit->setReadOnly(true);
-    excelPathEdit->setPlaceholderText("请选择 起大区间.xlsx 文件...");
+    excelPathEdit->setPlaceholderText("请选择 起大区间.xlsx 或 起大区间.csv 文件...");
     selectFileButton = new QPushButton("浏览...", this);
     
     fileLayout->addWidget(fileLabel);
@@ -55,9 +78,9 @@ void DataImportTool::setupUI()
     
     // 说明文字
     QLabel *infoLabel = new QLabel(
-        "说明：本工具支持导入CSV格式的钻孔数据。\n"
-        "      如果Excel文件是.xlsx格式，请先在Excel中另存为CSV格式。\n"
-        "      文件格式：起大区间.csv", this);
+        "说明：本工具直接导入Excel（.xlsx，读取第一个工作表）或CSV格式的钻孔数据。\n"
+        "      旧版.xls文件请先在Excel中另存为.xlsx或CSV格式。\n"
+        "      文件格式：起大区间.xlsx / 起大区间.csv", this);
     infoLabel->setStyleSheet("color: #666; padding: 10px; background-color: #f5f5f5; border-radius: 5px;");
     mainLayout->addWidget(infoLabel);
     
@@ -72,6 +95,7 @@ void DataImportTool::setupUI()
     
     // 进度条
     progressBar = new QProgressBar(this);
+    progressBar->setRange(0, 100);
     progressBar->setVisible(false);
     mainLayout->addWidget(progressBar);
     
@@ -89,7 +113,15 @@ void DataImportTool::setupUI()
     // 连接信号
     connect(selectFileButton, &QPushButton::clicked, this, &DataImportTool::onSelectExcelFile);
     connect(importButton, &QPushButton::clicked, this, &DataImportTool::onImportData);
-    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+    connect(closeButton, &QPushButton::clicked, this, [this]() {
+        // 导入进行中时先取消，当前批次提交后停止
+        if (pipeline->isRunning()) {
+            pipeline->cancel();
+            logMessage("⚠ 正在取消导入...");
+            return;
+        }
+        close();
+    });
 }
 
 void DataImportTool::onSelectExcelFile()
@@ -98,7 +130,7 @@ void DataImportTool::onSelectExcelFile()
         this,
         "选择钻孔数据文件",
         "",
-        "CSV文件 (*.csv);;所有文件 (*.*)"
+        "数据文件 (*.xlsx *.csv);;Excel文件 (*.xlsx);;CSV文件 (*.csv);;所有文件 (*.*)"
     );
     
     if (!fileName.isEmpty()) {
@@ -119,26 +151,54 @@ void DataImportTool::onImportData()
     // 禁用按钮
     importButton->setEnabled(false);
     selectFileButton->setEnabled(false);
+    progressBar->setValue(0);
     progressBar->setVisible(true);
     
     logMessage("======================================");
     logMessage("开始导入数据...");
     logMessage("======================================");
     
-    // 执行导入
-    bool success = importFromExcel(excelPath, 1);
+    // 在后台执行导入，结束时调用 onImportFinished
+    if (!importFromExcel(excelPath, 1)) {
+        onImportFinished(false, "无法启动导入");
+    }
+}
+
+void DataImportTool::onImportFinished(bool success, const QString &message)
+{
+    CsvImportPipeline::Result result = pipeline->result();
+    
+    // 最后一个钻孔在导入结束后才能确定地层数
+    QString lastBorehole = finishCurrentBorehole();
+    if (!lastBorehole.isEmpty()) {
+        logMessage(lastBorehole);
+    }
+    
+    if (!result.header.isEmpty()) {
+        logMessage("跳过标题行: " + result.header.left(50) + "...");
+    }
+    if (result.rejectedCount > 0) {
+        logMessage(QString("⚠ %1 行字段数不足，已跳过").arg(result.rejectedCount));
+    }
+    logMessage("");
+    logMessage(QString("导入完成！共导入 %1 个钻孔，%2 个地层").arg(boreholeCount).arg(layerCount));
     
     // 恢复按钮
     importButton->setEnabled(true);
     selectFileButton->setEnabled(true);
     progressBar->setVisible(false);
     
-    if (success) {
+    if (success && boreholeCount > 0) {
         logMessage("======================================", false);
         logMessage("✓ 数据导入成功！", false);
         logMessage("======================================", false);
         QMessageBox::information(this, "成功", "钻孔数据导入成功！\n可以重新运行程序查看数据。");
+    } else if (result.canceled) {
+        logMessage("⚠ " + message);
     } else {
+        if (!success) {
+            logMessage("✗ " + message, true);
+        }
         logMessage("======================================", true);
         logMessage("✗ 数据导入失败！", true);
         logMessage("======================================", true);
@@ -165,14 +225,10 @@ void DataImportTool::logMessage(const QString &message, bool isError)
 
 bool DataImportTool::importFromExcel(const QString &excelPath, int projectId)
 {
-    QFile file(excelPath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        logMessage("✗ 无法打开文件: " + excelPath, true);
+    if (pipeline->isRunning()) {
         return false;
     }
     
-    logMessage("✓ 文件打开成功");
-    
     BoreholeDAO dao;
     
     // 先删除旧数据
@@ -183,136 +239,104 @@ bool DataImportTool::importFromExcel(const QString &excelPath, int projectId)
         logMessage("✓ 旧数据已清空");
     }
     
-    QTextStream in(&file);
-    // Qt 6默认使用UTF-8编码
-    #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        in.setCodec("UTF-8");
-    #endif
-    // Qt 6无需设置编码，默认即为UTF-8
-    
-    QString line;
-    int lineNumber = 0;
-    int boreholeCount = 0;
-    int layerCount = 0;
+    currentBorehole = BoreholeData();
+    currentBoreholeId = -1;
+    currentLayerCount = 0;
+    boreholeCount = 0;
+    layerCount = 0;
     
-    BoreholeData currentBorehole;
-    bool hasBorehole = false;
-    
-    // 跳过第一行标题
-    if (!in.atEnd()) {
-        line = in.readLine();
-        lineNumber++;
-        logMessage("跳过标题行: " + line.left(50) + "...");
-    }
+    CsvImportPipeline::Options options;
+    options.minFields = 14;
+    pipeline->setOptions(options);
     
-    while (!in.atEnd()) {
-        line = in.readLine();
-        lineNumber++;
-        
-        if (line.trimmed().isEmpty()) {
-            continue;
-        }
-        
-        // 解析CSV行（简单的逗号分隔，不处理引号内的逗号）
-        QStringList fields = line.split(',');
-        
-        if (fields.size() < 14) {
-            logMessage(QString("⚠ 行 %1: 字段数不足，跳过").arg(lineNumber));
-            continue;
-        }
-        
-        // 字段索引
-        QString seriesNum = fields[0].trimmed();      // 序号
-        QString boreholeCode = fields[2].trimmed();   // 勘探点编号
-        QString xCoord = fields[3].trimmed();         // x坐标
-        QString yCoord = fields[4].trimmed();         // y坐标
-        QString surfaceElev = fields[5].trimmed();    // 孔口高程
-        QString mileage = fields[6].trimmed();        // 里程
-        QString layerCode = fields[7].trimmed();      // 地层编号
-        QString eraGenesis = fields[8].trimmed();     // 时代成因
-        QString rockName = fields[12].trimmed();      // 岩土名称
-        QString bottomElev = fields[9].trimmed();     // 层底标高
-        QString bottomDepth = fields[10].trimmed();   // 层底深度
-        QString thickness = fields[11].trimmed();     // 分层厚度
-        QString characteristics = fields[13].trimmed(); // 特征
-        
-        // 判断是否是新钻孔（序号不为空）
-        bool isNewBorehole = !seriesNum.isEmpty() && !boreholeCode.isEmpty();
-        
-        if (isNewBorehole) {
-            // 保存上一个钻孔
-            if (hasBorehole) {
-                int bhId = dao.insertBorehole(currentBorehole);
-                if (bhId > 0) {
-                    boreholeCount++;
-                    layerCount += currentBorehole.layers.size();
-                    logMessage(QString("  ✓ 钻孔 %1: %2 (高程: %3m, 里程: %4m, 地层数: %5)")
-                              .arg(boreholeCount)
-                              .arg(currentBorehole.boreholeCode)
-                              .arg(currentBorehole.surfaceElevation, 0, 'f', 2)
-                              .arg(currentBorehole.mileage, 0, 'f', 1)
-                              .arg(currentBorehole.layers.size()));
-                } else {
-                    logMessage("✗ 插入钻孔失败: " + dao.getLastError(), true);
-                }
+    // 字段索引：0 序号，2 勘探点编号，3/4 x/y坐标，5 孔口高程，6 里程，7 地层编号，
+    // 8 时代成因，9 层底标高，10 层底深度，11 分层厚度，12 岩土名称，13 特征
+    pipeline->setHandlers<BoreholeRow>(
+        [projectId](const CsvTokenizer::Row &fields, BoreholeRow &row) {
+            // 判断是否是新钻孔（序号不为空）
+            row.startsBorehole = !fields[0].isEmpty() && !fields[2].isEmpty();
+            if (row.startsBorehole) {
+                row.borehole = BoreholeData();
+                row.borehole.projectId = projectId;
+                row.borehole.boreholeCode = fields[2].toString();
+                row.borehole.x = fields[3].toDouble();
+                row.borehole.y = fields[4].toDouble();
+                row.borehole.surfaceElevation = fields[5].toDouble();
+                row.borehole.mileage = fields[6].toDouble();
             }
             
-            // 创建新钻孔
-            currentBorehole = BoreholeData();
-            currentBorehole.projectId = projectId;
-            currentBorehole.boreholeCode = boreholeCode;
-            currentBorehole.x = xCoord.toDouble();
-            currentBorehole.y = yCoord.toDouble();
-            currentBorehole.surfaceElevation = surfaceElev.toDouble();
-            currentBorehole.mileage = mileage.toDouble();
-            hasBorehole = true;
-        }
-        
-        // 添加地层数据（只要有地层编号和岩土名称）
-        if (hasBorehole && !layerCode.isEmpty() && !rockName.isEmpty()) {
-            BoreholeLayerData layer;
-            layer.layerCode = layerCode;
-            layer.eraGenesis = eraGenesis;
-            layer.rockName = rockName;
-            layer.bottomElevation = bottomElev.toDouble();
-            layer.bottomDepth = bottomDepth.toDouble();
-            layer.thickness = thickness.toDouble();
-            layer.characteristics = characteristics;
-            
-            // 提取地层序号
-            QRegularExpression re("\\d+");
-            QRegularExpressionMatch match = re.match(layerCode);
-            if (match.hasMatch()) {
-                layer.layerNumber = match.captured(0).toInt();
-            } else {
-                layer.layerNumber = 0;
+            // 添加地层数据（只要有地层编号和岩土名称）
+            row.layer = BoreholeLayerData();
+            row.layer.layerCode = fields[7].toString();
+            row.layer.rockName = fields[12].toString();
+            row.hasLayer = !row.layer.layerCode.isEmpty() && !row.layer.rockName.isEmpty();
+            if (row.hasLayer) {
+                row.layer.eraGenesis = fields[8].toString();
+                row.layer.bottomElevation = fields[9].toDouble();
+                row.layer.bottomDepth = fields[10].toDouble();
+                row.layer.thickness = fields[11].toDouble();
+                row.layer.characteristics = fields[13].toString();
+                
+                // 提取地层序号
+                static const QRegularExpression re("\\d+");
+                QRegularExpressionMatch match = re.match(row.layer.layerCode);
+                row.layer.layerNumber = match.hasMatch() ? match.captured(0).toInt() : 0;
             }
-            
-            currentBorehole.layers.append(layer);
-        }
-    }
+            return true;
+        },
+        [this](const QVector<BoreholeRow> &rows, QString &error) {
+            // 钻孔的地层可能跨块，当前钻孔保存在成员中
+            BoreholeDAO dao;
+            for (const BoreholeRow &row : rows) {
+                if (row.startsBorehole) {
+                    QString summary = finishCurrentBorehole();
+                    if (!summary.isEmpty()) {
+                        QMetaObject::invokeMethod(this, [this, summary]() {
+                            logMessage(summary);
+                        }, Qt::QueuedConnection);
+                    }
+                    currentBorehole = row.borehole;
+                    currentBoreholeId = dao.insertBorehole(currentBorehole);
+                    currentLayerCount = 0;
+                    if (currentBoreholeId <= 0) {
+                        error = "插入钻孔失败: " + dao.getLastError();
+                        return false;
+                    }
+                }
+                
+                if (currentBoreholeId <= 0 || !row.hasLayer) {
+                    continue;
+                }
+                
+                BoreholeLayerData layer = row.layer;
+                layer.boreholeId = currentBoreholeId;
+                if (!dao.insertBoreholeLayer(layer)) {
+                    error = "插入地层失败: " + dao.getLastError();
+                    return false;
+                }
+                currentLayerCount++;
+            }
+            return true;
+        });
     
-    // 保存最后一个钻孔
-    if (hasBorehole) {
-        int bhId = dao.insertBorehole(currentBorehole);
-        if (bhId > 0) {
-            boreholeCount++;
-            layerCount += currentBorehole.layers.size();
-            logMessage(QString("  ✓ 钻孔 %1: %2 (高程: %3m, 里程: %4m, 地层数: %5)")
-                      .arg(boreholeCount)
-                      .arg(currentBorehole.boreholeCode)
-                      .arg(currentBorehole.surfaceElevation, 0, 'f', 2)
-                      .arg(currentBorehole.mileage, 0, 'f', 1)
-                      .arg(currentBorehole.layers.size()));
-        } else {
-            logMessage("✗ 插入钻孔失败: " + dao.getLastError(), true);
-        }
+    logMessage("正在读取文件: " + excelPath);
+    return pipeline->start(excelPath);
+}
+
+QString DataImportTool::finishCurrentBorehole()
+{
+    if (currentBoreholeId <= 0) {
+        return QString();
     }
     
-    file.close();
-    
-    logMessage("");
-    logMessage(QString("导入完成！共导入 %1 个钻孔，%2 个地层").arg(boreholeCount).arg(layerCount));
-    
-    return boreholeCount > 0;
+    boreholeCount++;
+    layerCount += currentLayerCount;
+    QString summary = QString("  ✓ 钻孔 %1: %2 (高程: %3m, 里程: %4m, 地层数: %5)")
+                          .arg(boreholeCount)
+                          .arg(currentBorehole.boreholeCode)
+                          .arg(currentBorehole.surfaceElevation, 0, 'f', 2)
+                          .arg(currentBorehole.mileage, 0, 'f', 1)
+                          .arg(currentLayerCount);
+    currentBoreholeId = -1;
+    return summary;
 }
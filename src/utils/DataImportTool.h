@@ -7,12 +7,14 @@
 #include <QTextEdit>
 #include <QProgressBar>
 #include <QString>
+#include "CsvImportPipeline.h"
+#include "../database/BoreholeDAO.h"
 
 /**
  * @brief 数据导入工具对话框
  * 
  * 用于从Excel文件导入钻孔数据到数据库
- * 不需要Python环境，直接使用Qt读取Excel
+ * 不需要Python环境，直接读取 .xlsx 或 CSV 文件，导入在后台线程进行
  */
 class DataImportTool : public QDialog
 {
@@ -25,12 +27,28 @@ public:
 private slots:
     void onSelectExcelFile();
     void onImportData();
+    void onImportFinished(bool success, const QString &message);
 
 private:
     void setupUI();
     void logMessage(const QString &message, bool isError = false);
+    
+    // 在后台开始导入，结束时调用 onImportFinished，成功启动返回true
     bool importFromExcel(const QString &excelPath, int projectId = 1);
     
+    // 结束当前钻孔并计数，返回其日志；没有当前钻孔时返回空
+    QString finishCurrentBorehole();
+    
+    // 后台导入流水线
+    CsvImportPipeline *pipeline;
+    
+    // 导入线程中的写入状态，导入结束后在UI线程读取
+    BoreholeData currentBorehole;       // 当前钻孔（不含地层）
+    int currentBoreholeId;
+    int currentLayerCount;
+    int boreholeCount;
+    int layerCount;
+    
     // UI组件
     QLineEdit *excelPathEdit;
     QPushButton *selectFileButton;
@@ -5,18 +5,76 @@
 #include <QHBoxLayout>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QApplication>
-#include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QDebug>
 
+namespace {
+
+/**
+ * @brief 钻孔数据CSV中的一行
+ * 序号与钻孔编号都不为空的行开始一个新钻孔，每行都带一个地层
+ */
+struct BoreholeRow {
+    bool startsBorehole = false;
+    BoreholeData borehole;          // startsBorehole 为 true 时有效，不含地层
+    BoreholeLayerData layer;
+};
+
+// 解析里程字段，处理可能的桩号前缀（如"YCK02+540.400"）
+double parseBoreholeMileage(const QString &mileageStr)
+{
+    if (!mileageStr.contains('+')) {
+        // 没有'+'，直接是绝对里程
+        return mileageStr.toDouble();
+    }
+    
+    // 格式：YCK##+offset，需要计算绝对里程
+    QStringList parts = mileageStr.split('+');
+    if (parts.size() < 2) {
+        return mileageStr.toDouble();
+    }
+    
+    QString stakePrefix = parts[0].trimmed();  // "YCK02"
+    double offset = parts[1].trimmed().toDouble();  // 540.400
+    
+    // 提取桩号数字部分（YCK02 → 02 → 2）
+    QString stakeNumStr = stakePrefix;
+    stakeNumStr.remove(QRegularExpression("[^0-9]"));  // 移除非数字字符
+    int stakeNum = stakeNumStr.toInt();
+    
+    // 计算绝对里程：桩号×1000 + 偏移
+    // YCK02+540.400 = 2×1000 + 540.400 = 2540.400
+    return stakeNum * 1000.0 + offset;
+}
+
+} // namespace
+
 GeoDataImporter::GeoDataImporter(int projectId, const QString &projectName, QWidget *parent)
     : QWidget(parent)
     , projectId(projectId)
     , projectName(projectName)
+    , pipeline(new CsvImportPipeline(this))
+    , currentStep(ImportStep::Borehole)
+    , totalSteps(0)
+    , finishedSteps(0)
+    , currentBoreholeId(-1)
+    , currentLayerNumber(0)
+    , importedBoreholes(0)
+    , importedLayers(0)
+    , importedProfiles(0)
 {
     setupUI();
+    
+    connect(pipeline, &CsvImportPipeline::progressChanged, this,
+            [this](qint64 processedBytes, qint64 totalBytes, qint64) {
+        if (totalSteps <= 0 || totalBytes <= 0) {
+            return;
+        }
+        double stepProgress = static_cast<double>(processedBytes) / totalBytes;
+        progressBar->setValue(static_cast<int>((finishedSteps + stepProgress) * 100 / totalSteps));
+    });
+    connect(pipeline, &CsvImportPipeline::finished, this, &GeoDataImporter::onImportStepFinished);
     setWindowTitle("导入地质数据");
     setWindowModality(Qt::ApplicationModal);
     resize(700, 650);
@@ -24,6 +82,8 @@ GeoDataImporter::GeoDataImporter(int projectId, const QString &projectName, QWid
 
 GeoDataImporter::~GeoDataImporter()
 {
+    // 导入线程会写本对象的成员，在成员析构之前取消并等待其结束
+    delete pipeline;
 }
 
 void GeoDataImporter::setupUI()
@@ -83,8 +143,8 @@ void GeoDataImporter::setupUI()
     QLabel *tipLabel = new QLabel(this);
     tipLabel->setText(QString::fromUtf8(
         "💡 <b>使用提示：</b><br>"
-        "• 支持Excel文件（.xlsx）和CSV文件（.csv）<br>"
-        "• <b>如果Excel无法直接导入</b>，请在Excel中将文件另存为\"CSV UTF-8（逗号分隔）\"格式<br>"
+        "• 支持Excel文件（.xlsx，读取第一个工作表）和CSV文件（.csv）<br>"
+        "• <b>旧版.xls文件</b>请先在Excel中另存为.xlsx或\"CSV UTF-8（逗号分隔）\"格式<br>"
         "• 确保文件编码为UTF-8，避免中文乱码"
     ));
     tipLabel->setWordWrap(true);
@@ -171,7 +231,7 @@ void GeoDataImporter::onSelectBoreholeFile()
         this,
         "选择钻孔数据文件",
         "",
-        "数据文件 (*.xlsx *.xls *.csv);;Excel Files (*.xlsx *.xls);;CSV Files (*.csv);;All Files (*.*)"
+        "数据文件 (*.xlsx *.csv);;Excel Files (*.xlsx);;CSV Files (*.csv);;All Files (*.*)"
     );
     
     if (!fileName.isEmpty()) {
@@ -194,7 +254,7 @@ void GeoDataImporter::onSelectTunnelProfileFile()
         this,
         "选择隧道轮廓文件",
         "",
-        "数据文件 (*.xlsx *.xls *.csv);;Excel Files (*.xlsx *.xls);;CSV Files (*.csv);;All Files (*.*)"
+        "数据文件 (*.xlsx *.csv);;Excel Files (*.xlsx);;CSV Files (*.csv);;All Files (*.*)"
     );
     
     if (!fileName.isEmpty()) {
@@ -236,9 +296,7 @@ void GeoDataImporter::onStartImport()
     bool clearOldData = (reply == QMessageBox::Yes);
     
     // 禁用按钮防止重复点击
-    importButton->setEnabled(false);
-    selectBoreholeButton->setEnabled(false);
-    selectTunnelButton->setEnabled(false);
+    setImportControlsEnabled(false);
     
     addLog(QString::fromUtf8("========== 开始导入数据 =========="), "info");
     progressBar->setValue(0);
@@ -259,39 +317,74 @@ void GeoDataImporter::onStartImport()
         }
     }
     
-    bool success = true;
-    int totalSteps = 0;
-    int currentStep = 0;
-    
-    if (!boreholeFilePath.isEmpty()) totalSteps++;
-    if (!tunnelProfileFilePath.isEmpty()) totalSteps++;
-    
-    // 导入钻孔数据
-    if (!boreholeFilePath.isEmpty()) {
-        addLog(QString::fromUtf8("正在导入钻孔数据..."), "info");
-        if (importBoreholeData(boreholeFilePath)) {
-            currentStep++;
-            progressBar->setValue((currentStep * 100) / totalSteps);
-            addLog(QString::fromUtf8("✓ 钻孔数据导入成功！"), "success");
-        } else {
-            addLog(QString::fromUtf8("✗ 钻孔数据导入失败！"), "error");
-            success = false;
-        }
+    // 依次导入钻孔数据与隧道轮廓数据，每个文件在后台导入
+    pendingSteps.clear();
+    if (!boreholeFilePath.isEmpty()) pendingSteps.append(ImportStep::Borehole);
+    if (!tunnelProfileFilePath.isEmpty()) pendingSteps.append(ImportStep::TunnelProfile);
+    totalSteps = pendingSteps.size();
+    finishedSteps = 0;
+    
+    startNextImport();
+}
+
+void GeoDataImporter::startNextImport()
+{
+    if (pendingSteps.isEmpty()) {
+        finishImport(true);
+        return;
     }
     
-    // 导入隧道轮廓数据
-    if (!tunnelProfileFilePath.isEmpty() && success) {
-        addLog(QString::fromUtf8("正在导入隧道轮廓数据..."), "info");
-        if (importTunnelProfileData(tunnelProfileFilePath)) {
-            currentStep++;
-            progressBar->setValue((currentStep * 100) / totalSteps);
-            addLog(QString::fromUtf8("✓ 隧道轮廓数据导入成功！"), "success");
-        } else {
-            addLog(QString::fromUtf8("✗ 隧道轮廓数据导入失败！"), "error");
-            success = false;
-        }
+    currentStep = pendingSteps.takeFirst();
+    bool started = (currentStep == ImportStep::Borehole)
+        ? importBoreholeData(boreholeFilePath)
+        : importTunnelProfileData(tunnelProfileFilePath);
+    
+    if (!started) {
+        addLog(QString::fromUtf8("✗ 无法启动导入！"), "error");
+        finishImport(false);
     }
+}
+
+void GeoDataImporter::onImportStepFinished(bool success, const QString &message)
+{
+    CsvImportPipeline::Result result = pipeline->result();
+    QString stepName = (currentStep == ImportStep::Borehole) ? QString::fromUtf8("钻孔数据") : QString::fromUtf8("隧道轮廓数据");
     
+    if (!result.header.isEmpty()) {
+        addLog(QString::fromUtf8("表头: ") + result.header.left(50) + "...");
+    }
+    if (result.rejectedCount > 0) {
+        addLog(QString("跳过 %1 行字段不完整的数据").arg(result.rejectedCount), "warning");
+    }
+    
+    if (currentStep == ImportStep::Borehole) {
+        addLog(QString("成功导入 %1 个钻孔, %2 个地层").arg(importedBoreholes).arg(importedLayers),
+               success ? "success" : "info");
+    } else {
+        addLog(QString("成功导入 %1 个隧道断面").arg(importedProfiles), success ? "success" : "info");
+    }
+    
+    if (success) {
+        finishedSteps++;
+        progressBar->setValue((finishedSteps * 100) / totalSteps);
+        addLog(QString::fromUtf8("✓ %1导入成功！").arg(stepName), "success");
+        startNextImport();
+        return;
+    }
+    
+    pendingSteps.clear();
+    if (result.canceled) {
+        addLog(QString::fromUtf8("========== 导入已取消 =========="), "warning");
+        setImportControlsEnabled(true);
+        return;
+    }
+    
+    addLog(QString::fromUtf8("✗ %1导入失败: %2").arg(stepName, message), "error");
+    finishImport(false);
+}
+
+void GeoDataImporter::finishImport(bool success)
+{
     if (success) {
         progressBar->setValue(100);
         addLog(QString::fromUtf8("========== 导入完成！ =========="), "success");
@@ -316,14 +409,27 @@ void GeoDataImporter::onStartImport()
         msgBox3.exec();
         
         // 重新启用按钮
-        importButton->setEnabled(true);
-        selectBoreholeButton->setEnabled(true);
-        selectTunnelButton->setEnabled(true);
+        setImportControlsEnabled(true);
     }
 }
 
+void GeoDataImporter::setImportControlsEnabled(bool enabled)
+{
+    importButton->setEnabled(enabled);
+    selectBoreholeButton->setEnabled(enabled);
+    selectTunnelButton->setEnabled(enabled);
+}
+
 void GeoDataImporter::onCancel()
 {
+    // 导入进行中时只取消导入，当前批次提交后停止
+    if (pipeline->isRunning()) {
+        pendingSteps.clear();
+        pipeline->cancel();
+        addLog(QString::fromUtf8("正在取消导入..."), "warning");
+        return;
+    }
+    
     emit importCancelled();
     close();
 }
@@ -342,271 +448,125 @@ void GeoDataImporter::addLog(const QString &message, const QString &type)
     QTextCursor cursor = logText->textCursor();
     cursor.movePosition(QTextCursor::End);
     logText->setTextCursor(cursor);
-    
-    QApplication::processEvents();
 }
 
 bool GeoDataImporter::importBoreholeData(const QString &filePath)
 {
-    try {
-        QFile file(filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            addLog(QString("无法打开文件: %1").arg(file.errorString()), "error");
-            return false;
-        }
-        
-        QTextStream in(&file);
-        
-        // 设置编码为UTF-8
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        in.setCodec("UTF-8");
-#endif
-        // Qt 6默认使用UTF-8编码
-        
-        // 读取第一行并处理UTF-8 BOM
-        QString firstLine = in.readLine();
-        if (firstLine.startsWith("\xEF\xBB\xBF") || firstLine.startsWith(QChar(0xFEFF))) {
-            // 移除BOM标记
-            if (firstLine.startsWith("\xEF\xBB\xBF")) {
-                firstLine = firstLine.mid(3);
-            } else {
-                firstLine = firstLine.mid(1);
-            }
-        }
-        addLog(QString::fromUtf8("表头: ") + firstLine.left(50) + "...");
-        
-        // 检查下一行是否为空行（只包含逗号）
-        qint64 pos = in.pos();  // 保存当前位置
-        QString nextLine = in.readLine();
-        
-        // 如果下一行是空行或全是逗号，跳过它
-        if (nextLine.trimmed().isEmpty() || 
-            nextLine.remove(QRegularExpression("[,\\s]")).isEmpty()) {
-            addLog(QString::fromUtf8("跳过空行"));
-        } else {
-            // 不是空行，回退到保存的位置
-            in.seek(pos);
-            addLog(QString::fromUtf8("没有空行，直接读取数据"));
-        }
-        
-        addLog(QString::fromUtf8("正在读取钻孔数据..."));
-        
-        BoreholeDAO dao;
-        
-        int totalRows = 0;
-        int importedBoreholes = 0;
-        int importedLayers = 0;
-        
-        // 用于跟踪当前钻孔
-        QString currentBoreholeCode;
-        int currentBoreholeId = -1;
-        BoreholeData currentBorehole;
-        
-        while (!in.atEnd()) {
-            QString line = in.readLine();
-            QStringList fields = line.split(',');
-            
-            if (fields.count() < 14) {
-                continue;  // 跳过不完整的行
+    addLog(QString::fromUtf8("正在导入钻孔数据..."), "info");
+    
+    currentBoreholeId = -1;
+    currentLayerNumber = 0;
+    importedBoreholes = 0;
+    importedLayers = 0;
+    
+    CsvImportPipeline::Options options;
+    options.minFields = 14;
+    pipeline->setOptions(options);
+    
+    const int targetProjectId = projectId;
+    pipeline->setHandlers<BoreholeRow>(
+        [targetProjectId](const CsvTokenizer::Row &fields, BoreholeRow &row) {
+            // 序号（第0列）与钻孔编号都不为空，说明是新钻孔
+            row.startsBorehole = !fields[0].isEmpty() && !fields[2].isEmpty();
+            if (row.startsBorehole) {
+                row.borehole = BoreholeData();
+                row.borehole.projectId = targetProjectId;
+                row.borehole.boreholeCode = fields[2].toString();
+                row.borehole.x = fields[3].toDouble();
+                row.borehole.y = fields[4].toDouble();
+                row.borehole.surfaceElevation = fields[5].toDouble();
+                row.borehole.mileage = parseBoreholeMileage(fields[6].toString());
             }
             
-            totalRows++;
-            
-            // 检查序号列（第0列），判断是否是新钻孔
-            QString seqStr = fields[0].trimmed();
-            QString boreholeCode = fields[2].trimmed();
-            
-            // 如果序号不为空且钻孔编号不为空，说明是新钻孔
-            if (!seqStr.isEmpty() && !boreholeCode.isEmpty()) {
-                // 保存前一个钻孔的地层
-                if (currentBoreholeId != -1 && !currentBorehole.layers.isEmpty()) {
-                    for (const auto &layer : currentBorehole.layers) {
-                        if (dao.insertBoreholeLayer(layer)) {
-                            importedLayers++;
-                        }
+            row.layer.layerCode = fields[7].toString();
+            row.layer.eraGenesis = fields[8].toString();
+            row.layer.bottomElevation = fields[9].toDouble();
+            row.layer.bottomDepth = fields[10].toDouble();
+            row.layer.thickness = fields[11].toDouble();
+            row.layer.rockName = fields[12].toString();
+            row.layer.characteristics = fields[13].toString();
+            return true;
+        },
+        [this](const QVector<BoreholeRow> &rows, QString &error) {
+            // 按文件顺序写入，钻孔的地层可能跨块，当前钻孔保存在成员中
+            BoreholeDAO dao;
+            for (const BoreholeRow &row : rows) {
+                if (row.startsBorehole) {
+                    currentBoreholeId = dao.insertBorehole(row.borehole);
+                    currentLayerNumber = 0;
+                    if (currentBoreholeId <= 0) {
+                        error = dao.getLastError();
+                        return false;
                     }
+                    importedBoreholes++;
                 }
                 
-                // 开始新钻孔
-                currentBorehole = BoreholeData();
-                currentBorehole.projectId = projectId;
-                currentBorehole.boreholeCode = boreholeCode;
-                
-                // 解析数字字段，trimmed()去除空格
-                currentBorehole.x = fields[3].trimmed().toDouble();
-                currentBorehole.y = fields[4].trimmed().toDouble();
-                currentBorehole.surfaceElevation = fields[5].trimmed().toDouble();
-                
-                // 解析里程字段，处理可能的桩号前缀（如"YCK02+540.400"）
-                QString mileageStr = fields[6].trimmed();
-                if (mileageStr.contains('+')) {
-                    // 格式：YCK##+offset，需要计算绝对里程
-                    QStringList parts = mileageStr.split('+');
-                    if (parts.size() >= 2) {
-                        QString stakePrefix = parts[0].trimmed();  // "YCK02"
-                        double offset = parts[1].trimmed().toDouble();  // 540.400
-                        
-                        // 提取桩号数字部分（YCK02 → 02 → 2）
-                        QString stakeNumStr = stakePrefix;
-                        stakeNumStr.remove(QRegularExpression("[^0-9]"));  // 移除非数字字符
-                        int stakeNum = stakeNumStr.toInt();
-                        
-                        // 计算绝对里程：桩号×1000 + 偏移
-                        // YCK02+540.400 = 2×1000 + 540.400 = 2540.400
-                        currentBorehole.mileage = stakeNum * 1000.0 + offset;
-                    } else {
-                        currentBorehole.mileage = mileageStr.toDouble();
-                    }
-                } else {
-                    // 没有'+'，直接是绝对里程
-                    currentBorehole.mileage = mileageStr.toDouble();
+                // 第一个钻孔之前的地层行没有归属，忽略
+                if (currentBoreholeId <= 0) {
+                    continue;
                 }
                 
-                currentBoreholeId = dao.insertBorehole(currentBorehole);
-                if (currentBoreholeId > 0) {
-                    importedBoreholes++;
-                    currentBoreholeCode = boreholeCode;
-                    currentBorehole.layers.clear();
-                }
-            }
-            
-            // 读取地层数据
-            if (currentBoreholeId > 0) {
-                BoreholeLayerData layer;
+                BoreholeLayerData layer = row.layer;
                 layer.boreholeId = currentBoreholeId;
-                layer.layerCode = fields[7].trimmed();
-                layer.eraGenesis = fields[8].trimmed();
-                // 数字字段也需要trim掉空格
-                layer.bottomElevation = fields[9].trimmed().toDouble();
-                layer.bottomDepth = fields[10].trimmed().toDouble();
-                layer.thickness = fields[11].trimmed().toDouble();
-                layer.rockName = fields[12].trimmed();
-                layer.characteristics = fields[13].trimmed();
-                
-                currentBorehole.layers.append(layer);
-            }
-            
-            // 更新进度
-            if (totalRows % 10 == 0) {
-                QApplication::processEvents();
-            }
-        }
-        
-        // 保存最后一个钻孔的地层
-        if (currentBoreholeId != -1 && !currentBorehole.layers.isEmpty()) {
-            for (const auto &layer : currentBorehole.layers) {
-                if (dao.insertBoreholeLayer(layer)) {
-                    importedLayers++;
+                layer.layerNumber = ++currentLayerNumber;
+                if (!dao.insertBoreholeLayer(layer)) {
+                    error = dao.getLastError();
+                    return false;
                 }
+                importedLayers++;
             }
-        }
-        
-        file.close();
-        
-        addLog(QString("成功导入 %1 个钻孔, %2 个地层").arg(importedBoreholes).arg(importedLayers), "success");
-        return true;
-        
-    } catch (const std::exception &e) {
-        addLog(QString("导入钻孔数据时发生异常: %1").arg(e.what()), "error");
-        return false;
-    }
+            return true;
+        });
+    
+    return pipeline->start(filePath);
 }
 
 bool GeoDataImporter::importTunnelProfileData(const QString &filePath)
 {
-    try {
-        QFile file(filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            addLog(QString("无法打开文件: %1").arg(file.errorString()), "error");
-            return false;
-        }
-        
-        QTextStream in(&file);
-        
-        // 设置编码为UTF-8
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        in.setCodec("UTF-8");
-#endif
-        // Qt 6默认使用UTF-8编码
-        
-        TunnelProfileDAO dao;
-        
-        // 读取第一行并处理UTF-8 BOM
-        QString firstLine = in.readLine();
-        if (firstLine.startsWith("\xEF\xBB\xBF") || firstLine.startsWith(QChar(0xFEFF))) {
-            // 移除BOM标记
-            if (firstLine.startsWith("\xEF\xBB\xBF")) {
-                firstLine = firstLine.mid(3);
-            } else {
-                firstLine = firstLine.mid(1);
-            }
-        }
-        addLog(QString::fromUtf8("表头: ") + firstLine.left(50) + "...");
-        
-        // 检查下一行是否为空行（只包含逗号）
-        qint64 pos = in.pos();  // 保存当前位置
-        QString nextLine = in.readLine();
-        
-        // 如果下一行是空行或全是逗号，跳过它
-        if (nextLine.trimmed().isEmpty() || 
-            nextLine.remove(QRegularExpression("[,\\s]")).isEmpty()) {
-            addLog(QString::fromUtf8("跳过空行"));
-        } else {
-            // 不是空行，回退到保存的位置
-            in.seek(pos);
-            addLog(QString::fromUtf8("没有空行，直接读取数据"));
-        }
-        
-        addLog(QString::fromUtf8("正在读取隧道轮廓数据..."));
-        
-        int importedProfiles = 0;
-        
-        while (!in.atEnd()) {
-            QString line = in.readLine();
-            QStringList fields = line.split(',');
-            
-            if (fields.count() < 18) {
-                continue;  // 跳过不完整的行
-            }
-            
-            TunnelProfileData profile;
-            profile.projectId = projectId;
+    addLog(QString::fromUtf8("正在导入隧道轮廓数据..."), "info");
+    
+    importedProfiles = 0;
+    
+    CsvImportPipeline::Options options;
+    options.minFields = 18;
+    pipeline->setOptions(options);
+    
+    const int targetProjectId = projectId;
+    pipeline->setHandlers<TunnelProfileData>(
+        [targetProjectId](const CsvTokenizer::Row &fields, TunnelProfileData &profile) {
+            profile.profileId = 0;
+            profile.projectId = targetProjectId;
             
-            // 读取数据（根据CSV结构），trim去除空格
-            profile.nearBorehole = fields[1].trimmed();
-            profile.topLeftX = fields[2].trimmed().toDouble();
-            profile.topLeftY = fields[3].trimmed().toDouble();
-            profile.topLeftZ = fields[4].trimmed().toDouble();
-            profile.bottomLeftX = fields[6].trimmed().toDouble();
-            profile.bottomLeftY = fields[7].trimmed().toDouble();
-            profile.bottomLeftZ = fields[8].trimmed().toDouble();
-            profile.topRightX = fields[10].trimmed().toDouble();
-            profile.topRightY = fields[11].trimmed().toDouble();
-            profile.topRightZ = fields[12].trimmed().toDouble();
-            profile.bottomRightX = fields[14].trimmed().toDouble();
-            profile.bottomRightY = fields[15].trimmed().toDouble();
-            profile.bottomRightZ = fields[16].trimmed().toDouble();
+            // 读取数据（根据CSV结构）
+            profile.nearBorehole = fields[1].toString();
+            profile.topLeftX = fields[2].toDouble();
+            profile.topLeftY = fields[3].toDouble();
+            profile.topLeftZ = fields[4].toDouble();
+            profile.bottomLeftX = fields[6].toDouble();
+            profile.bottomLeftY = fields[7].toDouble();
+            profile.bottomLeftZ = fields[8].toDouble();
+            profile.topRightX = fields[10].toDouble();
+            profile.topRightY = fields[11].toDouble();
+            profile.topRightZ = fields[12].toDouble();
+            profile.bottomRightX = fields[14].toDouble();
+            profile.bottomRightY = fields[15].toDouble();
+            profile.bottomRightZ = fields[16].toDouble();
             
             // 计算里程（使用顶部中心点的Y坐标作为里程近似值）
             profile.mileage = (profile.topLeftY + profile.topRightY) / 2.0;
-            
-            if (dao.insertProfile(profile) > 0) {
+            return true;
+        },
+        [this](const QVector<TunnelProfileData> &profiles, QString &error) {
+            TunnelProfileDAO dao;
+            for (const auto &profile : profiles) {
+                if (dao.insertProfile(profile) <= 0) {
+                    error = dao.getLastError();
+                    return false;
+                }
                 importedProfiles++;
             }
-            
-            // 更新进度
-            if (importedProfiles % 5 == 0) {
-                QApplication::processEvents();
-            }
-        }
-        
-        file.close();
-        
-        addLog(QString("成功导入 %1 个隧道断面").arg(importedProfiles), "success");
-        return true;
-        
-    } catch (const std::exception &e) {
-        addLog(QString("导入隧道轮廓数据时发生异常: %1").arg(e.what()), "error");
-        return false;
-    }
+            return true;
+        });
+    
+    return pipeline->start(filePath);
 }
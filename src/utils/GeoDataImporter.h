@@ -6,6 +6,8 @@
 #include <QProgressBar>
 #include <QTextEdit>
 #include <QLabel>
+#include <QList>
+#include "CsvImportPipeline.h"
 
 /**
  * @brief 地质数据导入器 - 用户友好的图形化导入工具
@@ -33,22 +35,37 @@ private slots:
     void onSelectTunnelProfileFile();  // 选择隧道轮廓文件
     void onStartImport();              // 开始导入
     void onCancel();                   // 取消
+    void onImportStepFinished(bool success, const QString &message);  // 一个文件导入结束
     
 private:
+    // 导入步骤（每个文件一步）
+    enum class ImportStep {
+        Borehole,
+        TunnelProfile
+    };
+    
     void setupUI();
     void addLog(const QString &message, const QString &type = "info");
     
+    // 开始下一个待导入文件，全部完成时结束导入
+    void startNextImport();
+    
+    // 导入结束，提示结果
+    void finishImport(bool success);
+    
+    void setImportControlsEnabled(bool enabled);
+    
     /**
-     * @brief 导入钻孔数据
-     * @param filePath Excel文件路径
-     * @return 成功返回true
+     * @brief 在后台开始导入钻孔数据，结束时调用 onImportStepFinished
+     * @param filePath CSV或XLSX文件路径
+     * @return 成功启动返回true
      */
     bool importBoreholeData(const QString &filePath);
     
     /**
-     * @brief 导入隧道轮廓数据
-     * @param filePath Excel文件路径
-     * @return 成功返回true
+     * @brief 在后台开始导入隧道轮廓数据，结束时调用 onImportStepFinished
+     * @param filePath CSV或XLSX文件路径
+     * @return 成功启动返回true
      */
     bool importTunnelProfileData(const QString &filePath);
     
@@ -57,6 +74,20 @@ private:
     QString boreholeFilePath;
     QString tunnelProfileFilePath;
     
+    // 后台导入流水线与进行中的步骤
+    CsvImportPipeline *pipeline;
+    QList<ImportStep> pendingSteps;
+    ImportStep currentStep;
+    int totalSteps;
+    int finishedSteps;
+    
+    // 钻孔导入的写入状态，仅在导入线程中修改，导入结束后读取
+    int currentBoreholeId;
+    int currentLayerNumber;
+    int importedBoreholes;
+    int importedLayers;
+    int importedProfiles;
+    
     // UI组件
     QLabel *titleLabel;
     QLabel *projectLabel;
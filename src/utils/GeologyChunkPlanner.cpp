@@ -0,0 +1,166 @@
+#include "GeologyChunkPlanner.h"
+#include "GeologySceneBuilder.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+namespace {
+
+// 块长度下限（米），防止配置错误时分块过多
+const double MIN_CHUNK_LENGTH = 10.0;
+
+} // namespace
+
+GeologyChunkPlanner::GeologyChunkPlanner()
+    : GeologyChunkPlanner(Options())
+{
+}
+
+GeologyChunkPlanner::GeologyChunkPlanner(const Options &options)
+    : opts(options)
+{
+    opts.chunkLength = qMax(MIN_CHUNK_LENGTH, opts.chunkLength);
+    opts.boreholeMargin = qMax(0, opts.boreholeMargin);
+    if (opts.levelDistances.isEmpty()) {
+        opts.levelDistances.append(DBL_MAX);
+    }
+}
+
+void GeologyChunkPlanner::plan(const QVector<BoreholeData> &boreholes, const QVector<TunnelProfileData> &profiles)
+{
+    chunkMap.clear();
+    landmarks.clear();
+
+    QVector<BoreholeData> sortedBoreholes = boreholes;
+    std::sort(sortedBoreholes.begin(), sortedBoreholes.end(), [](const BoreholeData &a, const BoreholeData &b) {
+        return a.mileage < b.mileage;
+    });
+    // 断面里程是投影坐标，换算到钻孔的桩号里程后才能与钻孔、实时里程放在同一根轴上分块
+    axis = ChainageAxis(sortedBoreholes, profiles);
+    QVector<TunnelProfileData> sortedProfiles = axis.toChainage(profiles);
+    std::sort(sortedProfiles.begin(), sortedProfiles.end(), [](const TunnelProfileData &a, const TunnelProfileData &b) {
+        return a.mileage < b.mileage;
+    });
+
+    // 建模参数与隧道裁剪范围按全部钻孔确定，各块一致
+    modelBase = GeologyModelBuilder::resolveOptions(sortedBoreholes, GeologyModelBuilder::Options());
+    tunnelClip = GeologySceneBuilder::tunnelClipRect(sortedBoreholes);
+
+    const double length = opts.chunkLength;
+    auto chunkIndex = [length](double mileage) {
+        return static_cast<int>(std::floor(mileage / length));
+    };
+    auto chunkAt = [&](int index) -> GeologyChunk & {
+        auto it = chunkMap.find(index);
+        if (it == chunkMap.end()) {
+            GeologyChunk chunk;
+            chunk.index = index;
+            chunk.startMileage = index * length;
+            chunk.endMileage = (index + 1) * length;
+            it = chunkMap.insert(index, chunk);
+        }
+        return it.value();
+    };
+
+    // 钻孔：本块范围内的钻孔，两侧各多取 boreholeMargin 个参与插值
+    const int boreholeCount = sortedBoreholes.size();
+    for (int first = 0; first < boreholeCount; ) {
+        const int index = chunkIndex(sortedBoreholes[first].mileage);
+        int last = first;
+        while (last < boreholeCount && chunkIndex(sortedBoreholes[last].mileage) == index) {
+            last++;
+        }
+        const int from = qMax(0, first - opts.boreholeMargin);
+        const int to = qMin(boreholeCount, last + opts.boreholeMargin);
+        chunkAt(index).boreholes = sortedBoreholes.mid(from, to - from);
+        first = last;
+    }
+
+    // 断面：本块范围内的断面，再加上其后的第一个断面，使隧道在块之间连续
+    const int profileCount = sortedProfiles.size();
+    for (int first = 0; first < profileCount; ) {
+        const int index = chunkIndex(sortedProfiles[first].mileage);
+        int last = first;
+        while (last < profileCount && chunkIndex(sortedProfiles[last].mileage) == index) {
+            last++;
+        }
+        const int to = qMin(profileCount, last + 1);
+        chunkAt(index).tunnelProfiles = sortedProfiles.mid(first, to - first);
+        first = last;
+    }
+
+    for (GeologyChunk &chunk : chunkMap) {
+        chunk.contentHash = GeologySceneBuilder::contentHash(chunk.boreholes, chunk.tunnelProfiles);
+    }
+
+    // 没有钻孔或断面不足两个时无法换算桩号里程，退回到最近断面中心的里程
+    if (!axis.isEmpty()) {
+        return;
+    }
+    landmarks.reserve(profileCount);
+    for (const TunnelProfileData &profile : sortedProfiles) {
+        const double x = (profile.topLeftX + profile.topRightX + profile.bottomLeftX + profile.bottomRightX) / 4.0;
+        const double y = (profile.topLeftY + profile.topRightY + profile.bottomLeftY + profile.bottomRightY) / 4.0;
+        landmarks.append(Landmark{ x, y, profile.mileage });
+    }
+}
+
+int GeologyChunkPlanner::levelFor(const GeologyChunk &chunk, const QVector<double> &focusMileages) const
+{
+    const int coarsest = qMin(levelCount(), opts.levelDistances.size()) - 1;
+    if (focusMileages.isEmpty()) {
+        return coarsest;
+    }
+
+    // 焦点在块内时距离为0
+    double distance = DBL_MAX;
+    for (double mileage : focusMileages) {
+        const double d = qMax(0.0, qMax(chunk.startMileage - mileage, mileage - chunk.endMileage));
+        distance = qMin(distance, d);
+    }
+
+    for (int level = 0; level <= coarsest; level++) {
+        if (distance <= opts.levelDistances[level]) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+double GeologyChunkPlanner::mileageAt(double x, double y) const
+{
+    if (!axis.isEmpty()) {
+        return axis.chainageAt(x, y);
+    }
+
+    double best = DBL_MAX;
+    double mileage = 0.0;
+    for (const Landmark &landmark : landmarks) {
+        const double dx = landmark.x - x;
+        const double dy = landmark.y - y;
+        const double d2 = dx * dx + dy * dy;
+        if (d2 < best) {
+            best = d2;
+            mileage = landmark.mileage;
+        }
+    }
+    return mileage;
+}
+
+GeologyModelBuilder::Options GeologyChunkPlanner::modelOptions(const GeologyChunk &chunk, int level) const
+{
+    GeologyModelBuilder::Options options = modelBase;
+    options.cellSize = modelBase.cellSize * (1 << qBound(0, level, levelCount() - 1));
+    // 单元须四角都在 maxDistance 内，单元加大时走廊随之变窄，按单元增量的一半放宽，保持模型范围大致不变
+    options.maxDistance = modelBase.maxDistance + (options.cellSize - modelBase.cellSize) / 2.0;
+    options.ownerStart = chunk.startMileage;
+    options.ownerEnd = chunk.endMileage;
+    return options;
+}
+
+TunnelMeshBuilder::Options GeologyChunkPlanner::tunnelOptions(int level) const
+{
+    TunnelMeshBuilder::Options options = TunnelMeshBuilder::levelOfDetail(qBound(0, level, levelCount() - 1));
+    options.clipRect = tunnelClip;
+    return options;
+}
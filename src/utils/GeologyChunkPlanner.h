@@ -0,0 +1,116 @@
+#ifndef GEOLOGYCHUNKPLANNER_H
+#define GEOLOGYCHUNKPLANNER_H
+
+#include <QVector>
+#include <QMap>
+#include <QByteArray>
+#include <QRectF>
+#include "GeologyModelBuilder.h"
+#include "TunnelMeshBuilder.h"
+#include "ChainageAxis.h"
+#include "../database/BoreholeDAO.h"
+#include "../database/TunnelProfileDAO.h"
+
+/**
+ * @brief 三维场景的一个里程分块
+ *
+ * 负责桩号里程 [startMileage, endMileage) 内的地质模型与隧道。钻孔包含两侧各若干个相邻钻孔，
+ * 只用于插值；断面多含下一块的第一个断面，使隧道在块之间连续。
+ */
+struct GeologyChunk {
+    int index = 0;                              // 块序号，里程 / 块长度向下取整，重新划分后不变
+    double startMileage = 0.0;
+    double endMileage = 0.0;
+    QVector<BoreholeData> boreholes;            // 按里程排序
+    QVector<TunnelProfileData> tunnelProfiles;  // 按里程排序，mileage 已换算为桩号里程
+    QByteArray contentHash;                     // 钻孔与断面内容的散列，用于判断分块是否需要重建
+};
+
+/**
+ * @brief 三维场景按里程分块
+ *
+ * 长隧道的场景按固定里程长度分块，每块可在不同细节级别下独立生成网格。
+ * 离焦点（盾构机当前里程、相机视点所在里程）越远的块细节级别越低，超出最远距离的块卸载，
+ * 界面同时持有的网格数量与隧道总长无关。
+ *
+ * 分块、焦点与细节级别都使用钻孔的桩号里程。断面导入时的 mileage 是投影坐标，
+ * 划分前沿隧道中心线换算为桩号里程（见 ChainageAxis），分块中的断面为换算后的副本。
+ *
+ * 地质建模参数（单元边长、地层顺序、网格对齐点）由全部钻孔一次确定，各块按细节级别
+ * 加大单元边长，保证相邻块的网格节点与地层顺序一致（见 GeologyModelBuilder）。
+ *
+ * 不依赖 Qt3D，可在任意线程中使用；块的网格由 GeologySceneBuilder::buildChunk() 生成。
+ *
+ * 用法：
+ *   GeologyChunkPlanner planner;
+ *   planner.plan(boreholes, profiles);
+ *   for (const GeologyChunk &chunk : planner.chunks()) {
+ *       const int level = planner.levelFor(chunk, { shieldMileage });
+ *       if (level >= 0) {
+ *           GeologySceneBuilder::buildChunk(chunk, level, planner.modelOptions(chunk, level),
+ *                                           planner.tunnelOptions(level));
+ *       }
+ *   }
+ */
+class GeologyChunkPlanner
+{
+public:
+    struct Options {
+        double chunkLength = 200.0;     // 每块的里程长度（米）
+        int boreholeMargin = 12;        // 两侧各多取的钻孔数，不少于插值邻域时接缝两侧插值结果一致
+        // 块到最近焦点的里程距离不超过第 i 项时使用细节级别 i，超过最后一项时卸载
+        QVector<double> levelDistances = { 300.0, 1000.0, 3000.0 };
+    };
+
+    GeologyChunkPlanner();
+    explicit GeologyChunkPlanner(const Options &options);
+
+    const Options &options() const { return opts; }
+
+    /**
+     * @brief 按桩号里程划分钻孔与断面
+     * @param boreholes 钻孔（顺序任意）
+     * @param profiles 隧道断面（顺序任意，里程按钻孔换算后再划分）
+     */
+    void plan(const QVector<BoreholeData> &boreholes, const QVector<TunnelProfileData> &profiles);
+
+    // 非空的分块，按块序号排列
+    const QMap<int, GeologyChunk> &chunks() const { return chunkMap; }
+
+    /**
+     * @brief 分块应使用的细节级别
+     * @param focusMileages 焦点里程（盾构机、相机视点等），为空时所有块使用最低细节级别
+     * @return 细节级别，0最精细；超出最远距离时返回 -1，表示应卸载
+     */
+    int levelFor(const GeologyChunk &chunk, const QVector<double> &focusMileages) const;
+
+    // 平面位置的桩号里程，用于把相机视点换算为里程；无法换算时取最近断面中心的里程，没有数据时返回0
+    double mileageAt(double x, double y) const;
+
+    // 本次划分使用的桩号里程轴
+    const ChainageAxis &chainageAxis() const { return axis; }
+
+    // 分块在指定细节级别下的建模参数：单元边长按级别加倍，只生成本块里程范围内的单元
+    GeologyModelBuilder::Options modelOptions(const GeologyChunk &chunk, int level) const;
+    TunnelMeshBuilder::Options tunnelOptions(int level) const;
+
+    // 细节级别数量，与隧道网格一致
+    static int levelCount() { return TunnelMeshBuilder::LOD_LEVELS; }
+
+private:
+    // 无法换算桩号里程时用于里程换算的断面中心
+    struct Landmark {
+        double x;
+        double y;
+        double mileage;
+    };
+
+    Options opts;
+    QMap<int, GeologyChunk> chunkMap;
+    GeologyModelBuilder::Options modelBase;     // 按全部钻孔确定的建模参数
+    QRectF tunnelClip;
+    ChainageAxis axis;
+    QVector<Landmark> landmarks;
+};
+
+#endif // GEOLOGYCHUNKPLANNER_H
@@ -0,0 +1,47 @@
+#include "GeologyMeshLayout.h"
+#include <QDataStream>
+#include <cstring>
+
+QByteArray GeologyMeshLayout::Batch::vertexBytes() const
+{
+    QByteArray bytes;
+    bytes.resize(vertices.size() * VERTEX_STRIDE);
+    std::memcpy(bytes.data(), vertices.constData(), bytes.size());
+    return bytes;
+}
+
+QByteArray GeologyMeshLayout::Batch::indexBytes() const
+{
+    QByteArray bytes;
+    bytes.resize(indices.size() * sizeof(quint32));
+    std::memcpy(bytes.data(), indices.constData(), bytes.size());
+    return bytes;
+}
+
+void GeologyMeshLayout::Batch::save(QDataStream &out) const
+{
+    out << rockName << rockId << vertexBytes() << indexBytes() << boundsMin << boundsMax;
+}
+
+bool GeologyMeshLayout::Batch::load(QDataStream &in)
+{
+    QByteArray vertexData, indexData;
+    in >> rockName >> rockId >> vertexData >> indexData >> boundsMin >> boundsMax;
+    if (in.status() != QDataStream::Ok
+        || vertexData.size() % VERTEX_STRIDE != 0 || indexData.size() % sizeof(quint32) != 0) {
+        return false;
+    }
+
+    vertices.resize(vertexData.size() / VERTEX_STRIDE);
+    std::memcpy(vertices.data(), vertexData.constData(), vertexData.size());
+    indices.resize(indexData.size() / sizeof(quint32));
+    std::memcpy(indices.data(), indexData.constData(), indexData.size());
+
+    // 索引必须指向已有顶点
+    for (quint32 index : indices) {
+        if (index >= static_cast<quint32>(vertices.size())) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef GEOLOGYMESHLAYOUT_H
+#define GEOLOGYMESHLAYOUT_H
+
+#include <QVector>
+#include <QVector3D>
+#include <QString>
+#include <QByteArray>
+
+class QDataStream;
+
+/**
+ * @brief 地层合并网格的顶点与批次格式
+ *
+ * 同一地层单元的所有三角形合并到一个交错顶点缓冲（位置、法线、岩性序号）和一个索引缓冲中，
+ * 渲染时每个地层一个实体、一个材质、一次绘制。网格由 GeologyModelBuilder 生成，
+ * 网格缓存与 Qt3D 几何体都按这里的布局读写。
+ *
+ * 只定义顶点与索引数据，不依赖 Qt3D，可在任意线程中使用。
+ */
+class GeologyMeshLayout
+{
+public:
+    // 交错顶点：位置、法线与岩性序号，岩性序号用于拾取
+    struct Vertex {
+        float position[3];
+        float normal[3];
+        quint32 rockId;
+    };
+
+    static const int POSITION_OFFSET = 0;
+    static const int NORMAL_OFFSET = 3 * sizeof(float);
+    static const int ROCK_ID_OFFSET = 6 * sizeof(float);
+    static const int VERTEX_STRIDE = sizeof(Vertex);
+
+    // 同一岩性的合并网格
+    struct Batch {
+        QString rockName;
+        quint32 rockId = 0;                 // 批次序号，同时写入每个顶点
+        QVector<Vertex> vertices;
+        QVector<quint32> indices;
+        QVector3D boundsMin;
+        QVector3D boundsMax;
+
+        QByteArray vertexBytes() const;
+        QByteArray indexBytes() const;
+
+        // 保存与恢复，用于网格缓存
+        void save(QDataStream &out) const;
+        bool load(QDataStream &in);
+    };
+};
+
+#endif // GEOLOGYMESHLAYOUT_H
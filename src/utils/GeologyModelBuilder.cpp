@@ -0,0 +1,506 @@
+#include "GeologyModelBuilder.h"
+#include <QHash>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+namespace {
+
+// 厚度小于此值（米）视为地层缺失，不生成网格
+const float MIN_THICKNESS = 0.01f;
+
+// 自动确定 maxDistance 时的下限（米）与相邻钻孔平均间距的倍数
+const double MIN_AUTO_DISTANCE = 30.0;
+const double AUTO_DISTANCE_FACTOR = 1.5;
+
+// 与钻孔重合的判定（距离平方，平方米）
+const double COINCIDENT_DISTANCE2 = 1e-6;
+
+} // namespace
+
+GeologyModelBuilder::GeologyModelBuilder()
+    : GeologyModelBuilder(Options())
+{
+}
+
+GeologyModelBuilder::GeologyModelBuilder(const Options &options)
+    : opts(options)
+    , originX(0.0)
+    , originY(0.0)
+    , cell(1.0)
+    , cols(0)
+    , rowCount(0)
+    , nodeCount(0)
+    , maxDistance(0.0)
+    , binOriginX(0.0)
+    , binOriginY(0.0)
+    , binSize(1.0)
+    , binCols(0)
+    , binRows(0)
+    , activeCells(0)
+{
+    opts.maxCells = qMax(1, opts.maxCells);
+    opts.neighbours = qMax(1, opts.neighbours);
+    opts.power = qMax(0.0, opts.power);
+}
+
+GeologyModelBuilder::Options GeologyModelBuilder::resolveOptions(const QVector<BoreholeData> &boreholes,
+                                                                 const Options &options)
+{
+    Options resolved = options;
+
+    GeologyModelBuilder builder(options);
+    builder.collectSamples(boreholes);
+    if (builder.samples.isEmpty()) {
+        return resolved;
+    }
+    builder.buildBins();
+
+    if (resolved.maxDistance <= 0.0) {
+        resolved.maxDistance = builder.autoMaxDistance();
+    }
+    if (resolved.cellSize <= 0.0) {
+        resolved.cellSize = resolved.maxDistance / 4.0;
+    }
+    resolved.unitOrder = builder.units;
+    resolved.alignGrid = true;
+    resolved.gridAnchor = QPointF(builder.binOriginX, builder.binOriginY);
+    return resolved;
+}
+
+bool GeologyModelBuilder::build(const QVector<BoreholeData> &boreholes)
+{
+    batchList.clear();
+    activeCells = 0;
+
+    collectSamples(boreholes);
+    if (samples.isEmpty() || units.isEmpty()) {
+        return false;
+    }
+
+    buildBins();
+    setupGrid();
+
+    const int levelCount = units.size() + 1;
+    nodeValid.fill(0, nodeCount);
+    nodeOwned.fill(0, nodeCount);
+    boundaries.fill(0.0f, levelCount * nodeCount);
+
+    // 各行节点互不依赖，按行并行插值
+    QVector<int> rowList(rowCount + 1);
+    std::iota(rowList.begin(), rowList.end(), 0);
+    QtConcurrent::blockingMap(rowList, [this](int row) {
+        interpolateRow(row);
+    });
+
+    for (int row = 0; row < rowCount; row++) {
+        for (int col = 0; col < cols; col++) {
+            if (cellActive(col, row)) {
+                activeCells++;
+            }
+        }
+    }
+
+    // 各地层的网格互不依赖，按地层并行生成
+    QVector<GeologyMeshLayout::Batch> unitBatches(units.size());
+    QVector<int> unitList(units.size());
+    std::iota(unitList.begin(), unitList.end(), 0);
+    QtConcurrent::blockingMap(unitList, [this, &unitBatches](int unit) {
+        buildUnitMesh(unit, unitBatches[unit]);
+    });
+
+    // 批次序号按实际生成网格的地层依次编号，同时写入每个顶点
+    for (GeologyMeshLayout::Batch &batch : unitBatches) {
+        if (batch.indices.isEmpty()) {
+            continue;
+        }
+        batch.rockId = static_cast<quint32>(batchList.size());
+        for (GeologyMeshLayout::Vertex &vertex : batch.vertices) {
+            vertex.rockId = batch.rockId;
+        }
+        batchList.append(batch);
+    }
+    return true;
+}
+
+void GeologyModelBuilder::collectSamples(const QVector<BoreholeData> &boreholes)
+{
+    units.clear();
+    samples.clear();
+
+    // 第一遍：登记岩性并统计其在各钻孔中的中点深度
+    QHash<QString, int> firstIndex;
+    QStringList names;
+    QVector<double> depthSum;
+    QVector<int> depthCount;
+
+    for (const BoreholeData &bh : boreholes) {
+        double top = 0.0;
+        for (const BoreholeLayerData &layer : bh.layers) {
+            const double bottom = qMax(top, layer.bottomDepth);
+            auto it = firstIndex.constFind(layer.rockName);
+            int index;
+            if (it == firstIndex.constEnd()) {
+                index = names.size();
+                firstIndex.insert(layer.rockName, index);
+                names.append(layer.rockName);
+                depthSum.append(0.0);
+                depthCount.append(0);
+            } else {
+                index = it.value();
+            }
+            depthSum[index] += (top + bottom) / 2.0;
+            depthCount[index]++;
+            top = bottom;
+        }
+    }
+
+    // 按平均深度自上而下排序，深度相同时保持首次出现的顺序
+    QVector<int> order(names.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return depthSum[a] / depthCount[a] < depthSum[b] / depthCount[b];
+    });
+
+    // 指定了全局顺序时以其为准，本次钻孔中新出现的岩性按平均深度排在最后
+    units = opts.unitOrder;
+    for (int index : order) {
+        if (!units.contains(names[index])) {
+            units.append(names[index]);
+        }
+    }
+
+    QVector<int> unitOf(names.size());
+    for (int i = 0; i < names.size(); i++) {
+        unitOf[i] = units.indexOf(names[i]);
+    }
+
+    // 第二遍：各钻孔按全局顺序的地层厚度，同一岩性出现多次时厚度累加
+    samples.reserve(boreholes.size());
+    for (const BoreholeData &bh : boreholes) {
+        Sample sample;
+        sample.x = bh.x;
+        sample.y = bh.y;
+        sample.surface = bh.surfaceElevation;
+        sample.mileage = bh.mileage;
+        sample.thickness.fill(0.0f, units.size());
+
+        double top = 0.0;
+        for (const BoreholeLayerData &layer : bh.layers) {
+            const double bottom = qMax(top, layer.bottomDepth);
+            sample.thickness[unitOf[firstIndex.value(layer.rockName)]] += static_cast<float>(bottom - top);
+            top = bottom;
+        }
+        samples.append(sample);
+    }
+}
+
+void GeologyModelBuilder::buildBins()
+{
+    double minX = samples.first().x, maxX = minX;
+    double minY = samples.first().y, maxY = minY;
+    for (const Sample &sample : samples) {
+        minX = qMin(minX, sample.x);
+        maxX = qMax(maxX, sample.x);
+        minY = qMin(minY, sample.y);
+        maxY = qMax(maxY, sample.y);
+    }
+
+    // 每个桶平均约一个钻孔；沿线状走廊分布时面积很小，限制桶的总数
+    const double width = qMax(maxX - minX, 1.0);
+    const double height = qMax(maxY - minY, 1.0);
+    binSize = qMax(std::sqrt(width * height / samples.size()), 1.0);
+    const int maxBins = 4 * samples.size() + 16;
+    while ((std::floor(width / binSize) + 1) * (std::floor(height / binSize) + 1) > maxBins) {
+        binSize *= 2.0;
+    }
+    binCols = static_cast<int>(width / binSize) + 1;
+    binRows = static_cast<int>(height / binSize) + 1;
+
+    binOriginX = minX;
+    binOriginY = minY;
+
+    bins.fill(QVector<int>(), binCols * binRows);
+    for (int i = 0; i < samples.size(); i++) {
+        const int bx = qBound(0, static_cast<int>((samples[i].x - minX) / binSize), binCols - 1);
+        const int by = qBound(0, static_cast<int>((samples[i].y - minY) / binSize), binRows - 1);
+        bins[by * binCols + bx].append(i);
+    }
+}
+
+void GeologyModelBuilder::setupGrid()
+{
+    // 钻孔范围的最小角点即桶索引的原点
+    const double minX = binOriginX;
+    const double minY = binOriginY;
+    double maxX = minX, maxY = minY;
+    for (const Sample &sample : samples) {
+        maxX = qMax(maxX, sample.x);
+        maxY = qMax(maxY, sample.y);
+    }
+
+    maxDistance = opts.maxDistance > 0.0 ? opts.maxDistance : autoMaxDistance();
+
+    // 四周各扩展 maxDistance，钻孔走廊两侧都有模型
+    const double width = (maxX - minX) + 2.0 * maxDistance;
+    const double height = (maxY - minY) + 2.0 * maxDistance;
+    // 默认单元边长使钻孔走廊横向至少有8个单元；单元总数超出上限时按上限加大
+    cell = opts.cellSize > 0.0 ? opts.cellSize : maxDistance / 4.0;
+    if (width * height / (cell * cell) > opts.maxCells) {
+        cell = std::sqrt(width * height / opts.maxCells);
+    }
+
+    originX = minX - maxDistance;
+    originY = minY - maxDistance;
+    if (opts.alignGrid) {
+        // 原点落在对齐点的整数倍单元上，分块建模时相邻块的节点重合
+        originX = opts.gridAnchor.x() + std::floor((originX - opts.gridAnchor.x()) / cell) * cell;
+        originY = opts.gridAnchor.y() + std::floor((originY - opts.gridAnchor.y()) / cell) * cell;
+    }
+
+    cols = qMax(1, static_cast<int>(std::ceil((maxX + maxDistance - originX) / cell)));
+    rowCount = qMax(1, static_cast<int>(std::ceil((maxY + maxDistance - originY) / cell)));
+    nodeCount = (cols + 1) * (rowCount + 1);
+}
+
+double GeologyModelBuilder::autoMaxDistance() const
+{
+    // 相邻钻孔平均间距：各钻孔到最近的另一个钻孔的距离的平均值
+    double spacingSum = 0.0;
+    int spacingCount = 0;
+    QVector<QPair<double, int>> nearest;
+    for (const Sample &sample : samples) {
+        nearestSamples(sample.x, sample.y, 2, nearest);
+        if (nearest.size() == 2) {
+            spacingSum += std::sqrt(nearest[1].first);
+            spacingCount++;
+        }
+    }
+    const double spacing = spacingCount > 0 ? spacingSum / spacingCount : 0.0;
+    return qMax(MIN_AUTO_DISTANCE, spacing * AUTO_DISTANCE_FACTOR);
+}
+
+void GeologyModelBuilder::nearestSamples(double x, double y, int k, QVector<QPair<double, int>> &result) const
+{
+    result.clear();
+    k = qMin(k, samples.size());
+    if (k <= 0) {
+        return;
+    }
+
+    const int bx = qBound(0, static_cast<int>(std::floor((x - binOriginX) / binSize)), binCols - 1);
+    const int by = qBound(0, static_cast<int>(std::floor((y - binOriginY) / binSize)), binRows - 1);
+
+    auto scanBin = [&](int cx, int cy) {
+        for (int index : bins[cy * binCols + cx]) {
+            const double dx = samples[index].x - x;
+            const double dy = samples[index].y - y;
+            result.append(qMakePair(dx * dx + dy * dy, index));
+        }
+    };
+
+    // 由近及远逐圈扫描桶：扫完第 r 圈后，距离不超过 r 个桶宽的钻孔都已找到
+    for (int r = 0; ; r++) {
+        const int x0 = bx - r, x1 = bx + r;
+        const int y0 = by - r, y1 = by + r;
+        for (int cy = qMax(0, y0); cy <= qMin(binRows - 1, y1); cy++) {
+            const bool edgeRow = (cy == y0 || cy == y1);
+            for (int cx = qMax(0, x0); cx <= qMin(binCols - 1, x1); cx++) {
+                if (edgeRow || cx == x0 || cx == x1) {
+                    scanBin(cx, cy);
+                }
+            }
+        }
+
+        const bool coversAll = x0 <= 0 && y0 <= 0 && x1 >= binCols - 1 && y1 >= binRows - 1;
+        if (result.size() >= k) {
+            std::nth_element(result.begin(), result.begin() + (k - 1), result.end());
+            const double reach = r * binSize;
+            if (result[k - 1].first <= reach * reach || coversAll) {
+                break;
+            }
+        } else if (coversAll) {
+            break;
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.resize(k);
+}
+
+void GeologyModelBuilder::interpolateRow(int row)
+{
+    const int unitCount = units.size();
+    const double limit2 = maxDistance * maxDistance;
+    const double halfPower = opts.power / 2.0;
+
+    QVector<QPair<double, int>> nearest;
+    QVector<double> thickness(unitCount);
+
+    for (int col = 0; col <= cols; col++) {
+        const int node = nodeIndex(col, row);
+        const double x = originX + col * cell;
+        const double y = originY + row * cell;
+
+        nearestSamples(x, y, opts.neighbours, nearest);
+        nodeValid[node] = nearest.first().first <= limit2;
+        const double ownerMileage = samples[nearest.first().second].mileage;
+        nodeOwned[node] = ownerMileage >= opts.ownerStart && ownerMileage < opts.ownerEnd;
+
+        // 反距离加权；节点与钻孔重合时直接取该钻孔的值
+        double surface = 0.0;
+        thickness.fill(0.0);
+        if (nearest.first().first < COINCIDENT_DISTANCE2) {
+            const Sample &sample = samples[nearest.first().second];
+            surface = sample.surface;
+            for (int u = 0; u < unitCount; u++) {
+                thickness[u] = sample.thickness[u];
+            }
+        } else {
+            double weightSum = 0.0;
+            for (const auto &candidate : nearest) {
+                const Sample &sample = samples[candidate.second];
+                const double weight = 1.0 / std::pow(candidate.first, halfPower);
+                weightSum += weight;
+                surface += weight * sample.surface;
+                for (int u = 0; u < unitCount; u++) {
+                    thickness[u] += weight * sample.thickness[u];
+                }
+            }
+            surface /= weightSum;
+            for (int u = 0; u < unitCount; u++) {
+                thickness[u] /= weightSum;
+            }
+        }
+
+        // 地表依次减去各层厚度得到各层底面
+        double level = surface;
+        boundaries[node] = static_cast<float>(surface);
+        for (int u = 0; u < unitCount; u++) {
+            level -= thickness[u];
+            boundaries[(u + 1) * nodeCount + node] = static_cast<float>(level);
+        }
+    }
+}
+
+bool GeologyModelBuilder::cellActive(int col, int row) const
+{
+    if (col < 0 || row < 0 || col >= cols || row >= rowCount || !nodeOwned[nodeIndex(col, row)]) {
+        return false;
+    }
+    return nodeValid[nodeIndex(col, row)] && nodeValid[nodeIndex(col + 1, row)]
+        && nodeValid[nodeIndex(col, row + 1)] && nodeValid[nodeIndex(col + 1, row + 1)];
+}
+
+QVector3D GeologyModelBuilder::boundaryNormal(int level, int col, int row) const
+{
+    // 中心差分求分界面梯度，边界处退化为单侧差分
+    const int left = qMax(0, col - 1), right = qMin(cols, col + 1);
+    const int down = qMax(0, row - 1), up = qMin(rowCount, row + 1);
+    const float dzdx = (boundary(level, nodeIndex(right, row)) - boundary(level, nodeIndex(left, row)))
+                       / static_cast<float>((right - left) * cell);
+    const float dzdy = (boundary(level, nodeIndex(col, up)) - boundary(level, nodeIndex(col, down)))
+                       / static_cast<float>((up - down) * cell);
+    return QVector3D(-dzdx, -dzdy, 1.0f).normalized();
+}
+
+void GeologyModelBuilder::buildUnitMesh(int unit, GeologyMeshLayout::Batch &batch) const
+{
+    batch.rockName = units[unit];
+
+    const int topLevel = unit;
+    const int bottomLevel = unit + 1;
+
+    auto thicknessAt = [&](int node) {
+        return boundary(topLevel, node) - boundary(bottomLevel, node);
+    };
+
+    auto addVertex = [&](const QVector3D &p, const QVector3D &n) {
+        if (batch.vertices.isEmpty()) {
+            batch.boundsMin = p;
+            batch.boundsMax = p;
+        }
+        batch.vertices.append(GeologyMeshLayout::Vertex{ { p.x(), p.y(), p.z() }, { n.x(), n.y(), n.z() }, 0 });
+        batch.boundsMin = QVector3D(qMin(batch.boundsMin.x(), p.x()), qMin(batch.boundsMin.y(), p.y()),
+                                    qMin(batch.boundsMin.z(), p.z()));
+        batch.boundsMax = QVector3D(qMax(batch.boundsMax.x(), p.x()), qMax(batch.boundsMax.y(), p.y()),
+                                    qMax(batch.boundsMax.z(), p.z()));
+        return static_cast<quint32>(batch.vertices.size() - 1);
+    };
+
+    auto position = [&](int level, int col, int row) {
+        return QVector3D(static_cast<float>(originX + col * cell), static_cast<float>(originY + row * cell),
+                         boundary(level, nodeIndex(col, row)));
+    };
+
+    // 顶面与底面的顶点按节点共享（法线平滑），侧面顶点单独生成
+    QVector<qint32> topVertex(nodeCount, -1);
+    QVector<qint32> bottomVertex(nodeCount, -1);
+
+    auto surfaceVertex = [&](QVector<qint32> &map, int level, int col, int row, bool facingDown) {
+        const int node = nodeIndex(col, row);
+        if (map[node] < 0) {
+            const QVector3D normal = boundaryNormal(level, col, row);
+            map[node] = static_cast<qint32>(addVertex(position(level, col, row), facingDown ? -normal : normal));
+        }
+        return static_cast<quint32>(map[node]);
+    };
+
+    // 侧面：沿 p0 -> p1 的边，边方向 × Z 为外法线，四边形为 底p0、底p1、顶p1、顶p0
+    auto addWall = [&](int c0, int r0, int c1, int r1, const QVector3D &outward) {
+        if (thicknessAt(nodeIndex(c0, r0)) < MIN_THICKNESS && thicknessAt(nodeIndex(c1, r1)) < MIN_THICKNESS) {
+            return;
+        }
+        const quint32 first = addVertex(position(bottomLevel, c0, r0), outward);
+        addVertex(position(bottomLevel, c1, r1), outward);
+        addVertex(position(topLevel, c1, r1), outward);
+        addVertex(position(topLevel, c0, r0), outward);
+        batch.indices << first << first + 1 << first + 2
+                      << first << first + 2 << first + 3;
+    };
+
+    for (int row = 0; row < rowCount; row++) {
+        for (int col = 0; col < cols; col++) {
+            if (!cellActive(col, row)) {
+                continue;
+            }
+
+            const float maxThickness = qMax(qMax(thicknessAt(nodeIndex(col, row)), thicknessAt(nodeIndex(col + 1, row))),
+                                            qMax(thicknessAt(nodeIndex(col, row + 1)), thicknessAt(nodeIndex(col + 1, row + 1))));
+            if (maxThickness < MIN_THICKNESS) {
+                continue;       // 此处地层尖灭
+            }
+
+            // 顶面（从上方看逆时针，法线向上）
+            const quint32 t00 = surfaceVertex(topVertex, topLevel, col, row, false);
+            const quint32 t10 = surfaceVertex(topVertex, topLevel, col + 1, row, false);
+            const quint32 t11 = surfaceVertex(topVertex, topLevel, col + 1, row + 1, false);
+            const quint32 t01 = surfaceVertex(topVertex, topLevel, col, row + 1, false);
+            batch.indices << t00 << t10 << t11
+                          << t00 << t11 << t01;
+
+            // 底面（顺序相反，法线向下）
+            const quint32 b00 = surfaceVertex(bottomVertex, bottomLevel, col, row, true);
+            const quint32 b10 = surfaceVertex(bottomVertex, bottomLevel, col + 1, row, true);
+            const quint32 b11 = surfaceVertex(bottomVertex, bottomLevel, col + 1, row + 1, true);
+            const quint32 b01 = surfaceVertex(bottomVertex, bottomLevel, col, row + 1, true);
+            batch.indices << b00 << b11 << b10
+                          << b00 << b01 << b11;
+
+            // 模型边界处封闭侧面
+            if (!cellActive(col, row - 1)) {
+                addWall(col, row, col + 1, row, QVector3D(0, -1, 0));
+            }
+            if (!cellActive(col, row + 1)) {
+                addWall(col + 1, row + 1, col, row + 1, QVector3D(0, 1, 0));
+            }
+            if (!cellActive(col - 1, row)) {
+                addWall(col, row + 1, col, row, QVector3D(-1, 0, 0));
+            }
+            if (!cellActive(col + 1, row)) {
+                addWall(col + 1, row, col + 1, row + 1, QVector3D(1, 0, 0));
+            }
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef GEOLOGYMODELBUILDER_H
+#define GEOLOGYMODELBUILDER_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QPair>
+#include <QPointF>
+#include <cfloat>
+#include "GeologyMeshLayout.h"
+#include "../database/BoreholeDAO.h"
+
+/**
+ * @brief 钻孔插值地质模型
+ *
+ * 用全部钻孔在规则平面网格上插值出各地层的分界面，生成连续的层状地质体，
+ * 取代相邻钻孔之间的直线六面体。
+ *
+ * 建模方法（2.5D 层状模型）：
+ *   1. 按各岩性在钻孔中的平均深度确定全局地层顺序；
+ *   2. 每个网格节点用最近的若干钻孔做反距离加权（IDW）插值，
+ *      得到地表标高和各地层厚度（钻孔中缺失的地层厚度为0，即尖灭）；
+ *   3. 地表依次减去各层厚度得到各层底面，分界面不会交叉。
+ * 插值按网格行分配到全部 CPU 核心并行计算，网格生成按地层并行。
+ *
+ * 每个地层生成一个合并网格（顶面、底面与模型边界处的侧面），格式与
+ * GeologyMeshLayout::Batch 相同，可直接上传并写入网格缓存。
+ * 距最近钻孔超过 maxDistance 的网格单元不生成，模型沿钻孔走廊分布。
+ *
+ * 分块建模：先用全部钻孔调用 resolveOptions() 确定单元边长、地层顺序与网格对齐点，
+ * 各块再以本块及两侧若干钻孔建模，并用 ownerStart/ownerEnd 只保留最近钻孔落在本块里程范围内的单元。
+ * 相邻块的网格节点重合、单元互不重叠，块边界处的侧面可遮住不同细节级别之间的缝隙。
+ *
+ * 只生成顶点与索引数据，不依赖 Qt3D，可在任意线程中使用。
+ *
+ * 用法：
+ *   GeologyModelBuilder model;
+ *   model.build(boreholes);
+ *   for (const GeologyMeshLayout::Batch &batch : model.batches()) { ... }
+ */
+class GeologyModelBuilder
+{
+public:
+    struct Options {
+        double cellSize = 0.0;      // 网格单元边长（米），0时取 maxDistance 的1/4
+        int maxCells = 262144;      // 单元总数上限，超出时加大单元边长，限制建模耗时
+        int neighbours = 12;        // 每个节点参与插值的最近钻孔数
+        double power = 2.0;         // IDW 距离幂次
+        double maxDistance = 0.0;   // 单元到最近钻孔的最大距离（米），0时取相邻钻孔平均间距的1.5倍，至少30米
+
+        QStringList unitOrder;      // 全局地层顺序（自上而下），空时按本次钻孔自动确定，未列出的岩性排在最后
+        bool alignGrid = false;     // 网格原点是否对齐到 gridAnchor 的整数倍单元
+        QPointF gridAnchor;
+        double ownerStart = -DBL_MAX;   // 只生成最近钻孔里程在 [ownerStart, ownerEnd) 内的单元
+        double ownerEnd = DBL_MAX;
+    };
+
+    GeologyModelBuilder();
+    explicit GeologyModelBuilder(const Options &options);
+
+    const Options &options() const { return opts; }
+
+    /**
+     * @brief 按全部钻孔确定自动参数
+     * @return maxDistance、cellSize 与 unitOrder 已填入且网格对齐到钻孔范围角点的参数，
+     *         分块建模时各块在此基础上只修改 cellSize（细节级别）与 ownerStart/ownerEnd
+     */
+    static Options resolveOptions(const QVector<BoreholeData> &boreholes, const Options &options);
+
+    /**
+     * @brief 插值并生成各地层网格
+     * @param boreholes 钻孔（顺序任意）
+     * @return 没有钻孔或没有地层时返回 false
+     */
+    bool build(const QVector<BoreholeData> &boreholes);
+
+    const QVector<GeologyMeshLayout::Batch> &batches() const { return batchList; }
+
+    // 全局地层顺序（自上而下）
+    QStringList unitNames() const { return units; }
+
+    int columns() const { return cols; }
+    int rows() const { return rowCount; }
+    double cellSize() const { return cell; }
+    int activeCellCount() const { return activeCells; }
+
+private:
+    // 参与插值的钻孔：位置、地表标高与按全局顺序的各层厚度
+    struct Sample {
+        double x = 0.0;
+        double y = 0.0;
+        double surface = 0.0;
+        double mileage = 0.0;
+        QVector<float> thickness;
+    };
+
+    void collectSamples(const QVector<BoreholeData> &boreholes);
+    void setupGrid();
+    void buildBins();
+    void interpolateRow(int row);
+    void buildUnitMesh(int unit, GeologyMeshLayout::Batch &batch) const;
+    double autoMaxDistance() const;
+
+    // 最近的 k 个样本（按距离平方升序）
+    void nearestSamples(double x, double y, int k, QVector<QPair<double, int>> &result) const;
+
+    int nodeIndex(int col, int row) const { return row * (cols + 1) + col; }
+    bool cellActive(int col, int row) const;
+    float boundary(int level, int node) const { return boundaries[level * nodeCount + node]; }
+    QVector3D boundaryNormal(int level, int col, int row) const;
+
+    Options opts;
+    QStringList units;
+    QVector<Sample> samples;
+
+    // 网格：原点、单元尺寸、单元列数与行数（节点数各多一）
+    double originX;
+    double originY;
+    double cell;
+    int cols;
+    int rowCount;
+    int nodeCount;
+    double maxDistance;
+
+    // 样本的分桶索引，用于最近邻查询；原点为钻孔范围的最小角点
+    double binOriginX;
+    double binOriginY;
+    double binSize;
+    int binCols;
+    int binRows;
+    QVector<QVector<int>> bins;
+
+    QVector<char> nodeValid;                // 节点是否在 maxDistance 内
+    QVector<char> nodeOwned;                // 节点的最近钻孔是否在 [ownerStart, ownerEnd) 内，以左下角节点代表单元
+    QVector<float> boundaries;              // 分界面标高：第0层为地表，第 i+1 层为第 i 个地层的底面
+    int activeCells;
+
+    QVector<GeologyMeshLayout::Batch> batchList;
+};
+
+#endif // GEOLOGYMODELBUILDER_H
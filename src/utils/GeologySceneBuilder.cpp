@@ -0,0 +1,301 @@
+#include "GeologySceneBuilder.h"
+#include "../database/ShieldPositionDAO.h"
+#include "../database/MileageDAO.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+#include <cfloat>
+#include <algorithm>
+
+namespace {
+
+// 缓存文件魔数与版本；网格生成方式改变时递增版本，旧缓存自动失效
+const quint32 CACHE_MAGIC = 0x53564d31;     // "SVM1"
+const quint16 CACHE_VERSION = 4;
+
+// 缓存目录的总大小上限，超出时删除最旧的文件；分块缓存每块每个细节级别一个文件
+const qint64 MAX_CACHE_BYTES = 512LL * 1024 * 1024;
+
+void prepareStream(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+void writeModelOptions(QDataStream &out, const GeologyModelBuilder::Options &options)
+{
+    out << options.cellSize << static_cast<qint32>(options.maxCells) << static_cast<qint32>(options.neighbours)
+        << options.power << options.maxDistance << options.unitOrder
+        << options.alignGrid << options.gridAnchor << options.ownerStart << options.ownerEnd;
+}
+
+// 粗略级别按间隔取样，但始终保留最后一个断面（下一块的第一个断面），块之间的隧道不断开
+QVector<TunnelProfileData> sampleChunkProfiles(const QVector<TunnelProfileData> &profiles, int stride)
+{
+    QVector<TunnelProfileData> sampled;
+    for (int i = 0; i < profiles.size(); i++) {
+        if (i % stride == 0 || i == profiles.size() - 1) {
+            sampled.append(profiles[i]);
+        }
+    }
+    return sampled;
+}
+
+// 拾取用的包围体层次与网格一起在工作线程中建立，不写入缓存（建立耗时远小于生成网格）
+void buildPickIndex(GeologyChunkMeshes &meshes)
+{
+    for (int i = 0; i < meshes.layerBatches.size(); i++) {
+        const GeologyMeshLayout::Batch &batch = meshes.layerBatches[i];
+        meshes.pickIndex.addMesh(batch.vertices, batch.indices, PickingBvh::Kind::Layer, i);
+    }
+    meshes.pickIndex.addMesh(meshes.tunnel.vertices(), meshes.tunnel.indices(), PickingBvh::Kind::Tunnel, meshes.index);
+    meshes.pickIndex.build();
+}
+
+} // namespace
+
+GeologyScene GeologySceneBuilder::read(int projectId)
+{
+    GeologyScene scene;
+    scene.projectId = projectId;
+
+    BoreholeDAO boreholeDAO;
+    scene.boreholes = boreholeDAO.getBoreholesByProjectId(projectId);
+    if (!boreholeDAO.getLastError().isEmpty()) {
+        scene.error = boreholeDAO.getLastError();
+    }
+
+    TunnelProfileDAO tunnelDAO;
+    scene.tunnelProfiles = tunnelDAO.getProfilesByProjectId(projectId);
+    if (!tunnelDAO.getLastError().isEmpty()) {
+        scene.error = tunnelDAO.getLastError();
+    }
+
+    ShieldPositionDAO shieldDAO;
+    const ShieldPositionDAO::ShieldPosition shield = shieldDAO.getPosition(projectId);
+    if (shield.id > 0 && !shield.frontStakeMark.isEmpty()) {
+        scene.hasShieldPosition = true;
+        scene.shieldMileage = MileageDAO::stakeMarkToMileage(shield.frontStakeMark);
+    }
+
+    // 按照里程排序钻孔
+    std::sort(scene.boreholes.begin(), scene.boreholes.end(), [](const BoreholeData &a, const BoreholeData &b) {
+        return a.mileage < b.mileage;
+    });
+
+    return scene;
+}
+
+GeologyChunkMeshes GeologySceneBuilder::buildChunk(const GeologyChunk &chunk, int level,
+                                                   const GeologyModelBuilder::Options &model,
+                                                   const TunnelMeshBuilder::Options &tunnel)
+{
+    GeologyChunkMeshes meshes;
+    meshes.index = chunk.index;
+    meshes.level = level;
+    meshes.contentHash = chunk.contentHash;
+
+    // 缓存键包含分块内容与全部生成参数
+    QByteArray key;
+    QDataStream out(&key, QIODevice::WriteOnly);
+    prepareStream(out);
+    out << CACHE_MAGIC << CACHE_VERSION << chunk.contentHash
+        << chunk.startMileage << chunk.endMileage << static_cast<qint32>(level);
+    writeModelOptions(out, model);
+    out << static_cast<qint32>(tunnel.ringSegments) << static_cast<qint32>(tunnel.profileStride) << tunnel.clipRect;
+
+    const QByteArray hash = QCryptographicHash::hash(key, QCryptographicHash::Sha256);
+    const QString path = cachePath(hash);
+
+    if (QFile::exists(path)) {
+        if (readCache(path, hash, meshes)) {
+            meshes.fromCache = true;
+            buildPickIndex(meshes);
+            return meshes;
+        }
+        qWarning() << "分块网格缓存无效，重新生成:" << path;
+        QFile::remove(path);
+    }
+
+    GeologyModelBuilder modelBuilder(model);
+    if (modelBuilder.build(chunk.boreholes)) {
+        meshes.layerBatches = modelBuilder.batches();
+        meshes.layerCellCount = modelBuilder.activeCellCount();
+    }
+
+    TunnelMeshBuilder::Options tunnelOptions = tunnel;
+    tunnelOptions.profileStride = 1;
+    meshes.tunnel = TunnelMeshBuilder(tunnelOptions);
+    meshes.tunnel.appendProfiles(sampleChunkProfiles(chunk.tunnelProfiles, qMax(1, tunnel.profileStride)));
+
+    if (writeCache(path, hash, meshes)) {
+        pruneCache();
+    }
+    buildPickIndex(meshes);
+    return meshes;
+}
+
+QRectF GeologySceneBuilder::tunnelClipRect(const QVector<BoreholeData> &boreholes)
+{
+    if (boreholes.isEmpty()) {
+        return QRectF();
+    }
+
+    float minBoreholeX = FLT_MAX, maxBoreholeX = -FLT_MAX;
+    float minBoreholeY = FLT_MAX, maxBoreholeY = -FLT_MAX;
+
+    for (const auto &bh : boreholes) {
+        minBoreholeX = qMin(minBoreholeX, static_cast<float>(bh.x));
+        maxBoreholeX = qMax(maxBoreholeX, static_cast<float>(bh.x));
+        minBoreholeY = qMin(minBoreholeY, static_cast<float>(bh.y));
+        maxBoreholeY = qMax(maxBoreholeY, static_cast<float>(bh.y));
+    }
+
+    // 扩展钻孔范围20%作为隧道渲染边界
+    float rangeX = maxBoreholeX - minBoreholeX;
+    float rangeY = maxBoreholeY - minBoreholeY;
+    float extendRatio = 0.2f;
+    minBoreholeX -= rangeX * extendRatio;
+    maxBoreholeX += rangeX * extendRatio;
+    minBoreholeY -= rangeY * extendRatio;
+    maxBoreholeY += rangeY * extendRatio;
+
+    return QRectF(QPointF(minBoreholeX, minBoreholeY), QPointF(maxBoreholeX, maxBoreholeY));
+}
+
+QByteArray GeologySceneBuilder::contentHash(const QVector<BoreholeData> &boreholes,
+                                            const QVector<TunnelProfileData> &profiles)
+{
+    // 只包含参与网格生成的字段
+    QByteArray content;
+    QDataStream out(&content, QIODevice::WriteOnly);
+    prepareStream(out);
+
+    const GeologyModelBuilder::Options model;
+    out << CACHE_MAGIC << CACHE_VERSION << static_cast<qint32>(TunnelMeshBuilder::LOD_LEVELS)
+        << model.cellSize << static_cast<qint32>(model.maxCells) << static_cast<qint32>(model.neighbours)
+        << model.power << model.maxDistance;
+
+    out << static_cast<qint32>(boreholes.size());
+    for (const BoreholeData &bh : boreholes) {
+        out << bh.x << bh.y << bh.surfaceElevation << bh.mileage;
+        out << static_cast<qint32>(bh.layers.size());
+        for (const BoreholeLayerData &layer : bh.layers) {
+            out << layer.rockName << layer.bottomDepth;
+        }
+    }
+
+    out << static_cast<qint32>(profiles.size());
+    for (const TunnelProfileData &profile : profiles) {
+        out << profile.mileage
+            << profile.topLeftX << profile.topLeftY << profile.topLeftZ
+            << profile.bottomLeftX << profile.bottomLeftY << profile.bottomLeftZ
+            << profile.topRightX << profile.topRightY << profile.topRightZ
+            << profile.bottomRightX << profile.bottomRightY << profile.bottomRightZ;
+    }
+
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha256);
+}
+
+QString GeologySceneBuilder::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/meshes";
+}
+
+QString GeologySceneBuilder::cachePath(const QByteArray &hash)
+{
+    return cacheDirectory() + "/" + QString::fromLatin1(hash.toHex()) + ".mesh";
+}
+
+bool GeologySceneBuilder::readCache(const QString &path, const QByteArray &key, GeologyChunkMeshes &meshes)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    prepareStream(in);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    QByteArray hash;
+    qint32 batchCount = 0;
+    in >> magic >> version >> hash;
+    if (in.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION
+        || hash != key) {
+        return false;
+    }
+
+    // 读到局部变量，失败时不改动分块
+    QVector<GeologyMeshLayout::Batch> batches;
+    qint32 layerCellCount = 0;
+    in >> layerCellCount >> batchCount;
+    for (qint32 i = 0; i < batchCount && in.status() == QDataStream::Ok; i++) {
+        GeologyMeshLayout::Batch batch;
+        if (!batch.load(in)) {
+            return false;
+        }
+        batches.append(batch);
+    }
+
+    TunnelMeshBuilder tunnel;
+    if (in.status() != QDataStream::Ok || !tunnel.load(in)) {
+        return false;
+    }
+
+    meshes.layerBatches = batches;
+    meshes.layerCellCount = layerCellCount;
+    meshes.tunnel = tunnel;
+    return true;
+}
+
+bool GeologySceneBuilder::writeCache(const QString &path, const QByteArray &key, const GeologyChunkMeshes &meshes)
+{
+    if (!QDir().mkpath(cacheDirectory())) {
+        qWarning() << "无法创建三维网格缓存目录:" << cacheDirectory();
+        return false;
+    }
+
+    // 写完后才替换目标文件，并发打开同一项目时不会读到半个文件
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法写入三维网格缓存:" << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    prepareStream(out);
+
+    out << CACHE_MAGIC << CACHE_VERSION << key;
+    out << static_cast<qint32>(meshes.layerCellCount) << static_cast<qint32>(meshes.layerBatches.size());
+    for (const GeologyMeshLayout::Batch &batch : meshes.layerBatches) {
+        batch.save(out);
+    }
+    meshes.tunnel.save(out);
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "写入三维网格缓存失败:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void GeologySceneBuilder::pruneCache()
+{
+    // 按修改时间从新到旧累计大小，超出上限的旧文件删除
+    QDir dir(cacheDirectory());
+    const QFileInfoList files = dir.entryInfoList(QStringList() << "*.mesh", QDir::Files, QDir::Time);
+    qint64 total = 0;
+    for (const QFileInfo &file : files) {
+        total += file.size();
+        if (total > MAX_CACHE_BYTES) {
+            QFile::remove(file.absoluteFilePath());
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef GEOLOGYSCENEBUILDER_H
+#define GEOLOGYSCENEBUILDER_H
+
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+#include <QRectF>
+#include "GeologyMeshLayout.h"
+#include "GeologyModelBuilder.h"
+#include "TunnelMeshBuilder.h"
+#include "GeologyChunkPlanner.h"
+#include "PickingBvh.h"
+#include "../database/BoreholeDAO.h"
+#include "../database/TunnelProfileDAO.h"
+
+/**
+ * @brief 三维地质场景的数据
+ *
+ * 在数据库线程中读取，完成后交给界面线程按里程分块（见 GeologyChunkPlanner），
+ * 各块的网格由 GeologySceneBuilder::buildChunk() 生成。
+ */
+struct GeologyScene {
+    int projectId = 0;
+    QVector<BoreholeData> boreholes;                    // 按里程排序
+    QVector<TunnelProfileData> tunnelProfiles;          // 按里程排序
+    bool hasShieldPosition = false;
+    double shieldMileage = 0.0;                         // 盾构机前盾里程（米）
+    QString error;
+};
+
+/**
+ * @brief 一个里程分块在某一细节级别下的网格
+ */
+struct GeologyChunkMeshes {
+    int index = 0;                                      // 块序号，见 GeologyChunk
+    int level = 0;
+    QByteArray contentHash;                             // 生成时分块内容的散列
+    QVector<GeologyMeshLayout::Batch> layerBatches;    // 每个地层一个合并网格
+    int layerCellCount = 0;
+    TunnelMeshBuilder tunnel;
+    PickingBvh pickIndex;                               // 拾取用，地层的对象序号为 layerBatches 中的序号
+    bool fromCache = false;
+};
+
+/**
+ * @brief 三维地质场景构建
+ *
+ * 在数据库线程中读取钻孔与隧道断面；场景按里程分块（见 GeologyChunkPlanner）后，
+ * 由 buildChunk() 在工作线程中逐块按需插值生成地质模型（见 GeologyModelBuilder）与隧道网格，
+ * 界面线程只负责上传缓冲。
+ *
+ * 分块缓存：每块每个细节级别一个文件，文件名为分块内容散列、块的里程范围、细节级别
+ * 与全部生成参数的 SHA-256，项目数据或参数未变时直接读入网格。
+ * 文件内容为地层网格与该级别的隧道网格；目录总大小超出上限时删除最旧的文件。
+ *
+ * 用法：
+ *   AsyncDAO::run(this, [projectId] { return GeologySceneBuilder::read(projectId); })
+ *       .then(this, [this](const GeologyScene &scene) { ... 分块 ... });
+ *   // 工作线程中
+ *   GeologyChunkMeshes meshes = GeologySceneBuilder::buildChunk(chunk, level, model, tunnel);
+ */
+class GeologySceneBuilder
+{
+public:
+    // 读取项目的钻孔、隧道断面与盾构机位置，须在有数据库连接的线程中调用
+    static GeologyScene read(int projectId);
+
+    /**
+     * @brief 生成或从缓存读入一个分块在指定细节级别下的网格，不访问数据库，可在任意线程中调用
+     * @param model 建模参数，取自 GeologyChunkPlanner::modelOptions()
+     * @param tunnel 隧道网格参数，取自 GeologyChunkPlanner::tunnelOptions()
+     */
+    static GeologyChunkMeshes buildChunk(const GeologyChunk &chunk, int level,
+                                         const GeologyModelBuilder::Options &model,
+                                         const TunnelMeshBuilder::Options &tunnel);
+
+    // 隧道渲染范围：钻孔范围向外扩展20%，没有钻孔时不裁剪
+    static QRectF tunnelClipRect(const QVector<BoreholeData> &boreholes);
+
+    // 钻孔与断面内容的散列，包含网格生成参数的版本
+    static QByteArray contentHash(const QVector<BoreholeData> &boreholes,
+                                  const QVector<TunnelProfileData> &profiles);
+
+    static QString cacheDirectory();
+
+private:
+    static QString cachePath(const QByteArray &hash);
+    static bool readCache(const QString &path, const QByteArray &key, GeologyChunkMeshes &meshes);
+    static bool writeCache(const QString &path, const QByteArray &key, const GeologyChunkMeshes &meshes);
+    static void pruneCache();
+};
+
+#endif // GEOLOGYSCENEBUILDER_H
@@ -0,0 +1,310 @@
+#include "PickingBvh.h"
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 叶节点图元数：不超过 MIN_LEAF_SIZE 时不再划分；SAH 认为不值得划分时最多保留 MAX_LEAF_SIZE 个
+const int MIN_LEAF_SIZE = 2;
+const int MAX_LEAF_SIZE = 8;
+
+// SAH 划分时沿最长轴的分桶数
+const int BIN_COUNT = 12;
+
+// 射线与三角形平行的判定，以及射线起点处的自相交容差
+const float PARALLEL_EPSILON = 1e-12f;
+const float DISTANCE_EPSILON = 1e-5f;
+
+QVector3D minVector(const QVector3D &a, const QVector3D &b)
+{
+    return QVector3D(qMin(a.x(), b.x()), qMin(a.y(), b.y()), qMin(a.z(), b.z()));
+}
+
+QVector3D maxVector(const QVector3D &a, const QVector3D &b)
+{
+    return QVector3D(qMax(a.x(), b.x()), qMax(a.y(), b.y()), qMax(a.z(), b.z()));
+}
+
+// 包围盒表面积的一半，SAH 只比较相对大小
+float halfArea(const QVector3D &boundsMin, const QVector3D &boundsMax)
+{
+    const QVector3D d = boundsMax - boundsMin;
+    if (d.x() < 0.0f || d.y() < 0.0f || d.z() < 0.0f) {
+        return 0.0f;
+    }
+    return d.x() * d.y() + d.y() * d.z() + d.z() * d.x();
+}
+
+// 射线与包围盒的板块（slab）求交，tNear 为进入距离（起点在盒内时为0）
+bool intersectBounds(const QVector3D &boundsMin, const QVector3D &boundsMax, const QVector3D &origin,
+                     const QVector3D &inverse, float maxDistance, float &tNear)
+{
+    const QVector3D t1 = (boundsMin - origin) * inverse;
+    const QVector3D t2 = (boundsMax - origin) * inverse;
+    const float tMin = qMax(qMax(qMin(t1.x(), t2.x()), qMin(t1.y(), t2.y())), qMax(qMin(t1.z(), t2.z()), 0.0f));
+    const float tMax = qMin(qMin(qMax(t1.x(), t2.x()), qMax(t1.y(), t2.y())), qMin(qMax(t1.z(), t2.z()), maxDistance));
+    tNear = tMin;
+    return tMin <= tMax;
+}
+
+float inverseComponent(float d)
+{
+    if (std::abs(d) > PARALLEL_EPSILON) {
+        return 1.0f / d;
+    }
+    return d < 0.0f ? -1e30f : 1e30f;
+}
+
+} // namespace
+
+void PickingBvh::clear()
+{
+    primitives.clear();
+    nodes.clear();
+}
+
+void PickingBvh::addTriangle(const QVector3D &a, const QVector3D &b, const QVector3D &c, Kind kind, int objectId)
+{
+    primitives.append(Primitive{ a, b, c, objectId, kind, false });
+}
+
+void PickingBvh::addBox(const QVector3D &boxMin, const QVector3D &boxMax, Kind kind, int objectId)
+{
+    primitives.append(Primitive{ minVector(boxMin, boxMax), maxVector(boxMin, boxMax), QVector3D(), objectId, kind, true });
+}
+
+void PickingBvh::build()
+{
+    nodes.clear();
+    const int count = primitives.size();
+    if (count == 0) {
+        return;
+    }
+
+    QVector<QVector3D> primMin(count);
+    QVector<QVector3D> primMax(count);
+    QVector<QVector3D> centroids(count);
+    QVector<int> order(count);
+    for (int i = 0; i < count; i++) {
+        const Primitive &p = primitives[i];
+        if (p.box) {
+            primMin[i] = p.p0;
+            primMax[i] = p.p1;
+        } else {
+            primMin[i] = minVector(minVector(p.p0, p.p1), p.p2);
+            primMax[i] = maxVector(maxVector(p.p0, p.p1), p.p2);
+        }
+        centroids[i] = (primMin[i] + primMax[i]) * 0.5f;
+        order[i] = i;
+    }
+
+    nodes.reserve(2 * count / MIN_LEAF_SIZE + 1);
+    buildNode(order, 0, count, primMin, primMax, centroids);
+
+    // 图元按叶节点顺序重排，叶节点直接引用连续的一段图元
+    QVector<Primitive> sorted;
+    sorted.reserve(count);
+    for (int index : order) {
+        sorted.append(primitives[index]);
+    }
+    primitives = sorted;
+    nodes.squeeze();
+}
+
+int PickingBvh::buildNode(QVector<int> &order, int first, int count,
+                          const QVector<QVector3D> &primMin, const QVector<QVector3D> &primMax,
+                          const QVector<QVector3D> &centroids)
+{
+    QVector3D boundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+    QVector3D boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    QVector3D centroidMin = boundsMin;
+    QVector3D centroidMax = boundsMax;
+    for (int i = first; i < first + count; i++) {
+        const int index = order[i];
+        boundsMin = minVector(boundsMin, primMin[index]);
+        boundsMax = maxVector(boundsMax, primMax[index]);
+        centroidMin = minVector(centroidMin, centroids[index]);
+        centroidMax = maxVector(centroidMax, centroids[index]);
+    }
+
+    const int nodeIndex = nodes.size();
+    nodes.append(Node{ boundsMin, boundsMax, first, count });
+    if (count <= MIN_LEAF_SIZE) {
+        return nodeIndex;
+    }
+
+    // 沿质心范围最长的轴划分，质心重合时无法划分
+    const QVector3D extent = centroidMax - centroidMin;
+    int axis = 0;
+    if (extent.y() > extent[axis]) {
+        axis = 1;
+    }
+    if (extent.z() > extent[axis]) {
+        axis = 2;
+    }
+    if (extent[axis] <= 0.0f) {
+        return nodeIndex;
+    }
+
+    // 分桶统计，按 SAH 代价选择划分位置
+    struct Bin {
+        QVector3D boundsMin = QVector3D(FLT_MAX, FLT_MAX, FLT_MAX);
+        QVector3D boundsMax = QVector3D(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        int count = 0;
+    };
+    Bin bins[BIN_COUNT];
+    const float scale = BIN_COUNT / extent[axis];
+    auto binOf = [&](int index) {
+        return qMin(BIN_COUNT - 1, static_cast<int>((centroids[index][axis] - centroidMin[axis]) * scale));
+    };
+    for (int i = first; i < first + count; i++) {
+        const int index = order[i];
+        Bin &bin = bins[binOf(index)];
+        bin.boundsMin = minVector(bin.boundsMin, primMin[index]);
+        bin.boundsMax = maxVector(bin.boundsMax, primMax[index]);
+        bin.count++;
+    }
+
+    float rightCost[BIN_COUNT];
+    QVector3D accMin(FLT_MAX, FLT_MAX, FLT_MAX);
+    QVector3D accMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    int accCount = 0;
+    for (int b = BIN_COUNT - 1; b > 0; b--) {
+        accMin = minVector(accMin, bins[b].boundsMin);
+        accMax = maxVector(accMax, bins[b].boundsMax);
+        accCount += bins[b].count;
+        rightCost[b] = accCount * halfArea(accMin, accMax);
+    }
+
+    float bestCost = FLT_MAX;
+    int bestSplit = -1;
+    accMin = QVector3D(FLT_MAX, FLT_MAX, FLT_MAX);
+    accMax = QVector3D(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    accCount = 0;
+    for (int b = 0; b < BIN_COUNT - 1; b++) {
+        accMin = minVector(accMin, bins[b].boundsMin);
+        accMax = maxVector(accMax, bins[b].boundsMax);
+        accCount += bins[b].count;
+        const float cost = accCount * halfArea(accMin, accMax) + rightCost[b + 1];
+        if (accCount > 0 && accCount < count && cost < bestCost) {
+            bestCost = cost;
+            bestSplit = b;
+        }
+    }
+
+    // 划分代价不低于不划分时，图元不多则作为叶节点
+    const float leafCost = count * halfArea(boundsMin, boundsMax);
+    if (count <= MAX_LEAF_SIZE && (bestSplit < 0 || bestCost >= leafCost)) {
+        return nodeIndex;
+    }
+
+    int mid = first;
+    if (bestSplit >= 0) {
+        mid = static_cast<int>(std::partition(order.begin() + first, order.begin() + first + count,
+                                              [&](int index) { return binOf(index) <= bestSplit; })
+                               - order.begin());
+    }
+    if (mid == first || mid == first + count) {
+        // 分桶无法分开时按质心中位数对半划分
+        mid = first + count / 2;
+        std::nth_element(order.begin() + first, order.begin() + mid, order.begin() + first + count,
+                         [&](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+    }
+
+    buildNode(order, first, mid - first, primMin, primMax, centroids);
+    const int right = buildNode(order, mid, first + count - mid, primMin, primMax, centroids);
+    nodes[nodeIndex].first = right;
+    nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
+
+PickingBvh::Hit PickingBvh::intersect(const QVector3D &origin, const QVector3D &direction, float maxDistance) const
+{
+    Hit hit;
+    if (nodes.isEmpty()) {
+        return hit;
+    }
+
+    const QVector3D inverse(inverseComponent(direction.x()), inverseComponent(direction.y()),
+                            inverseComponent(direction.z()));
+    float closest = maxDistance;
+
+    // 由近及远遍历，已找到的交点比节点包围盒更近时跳过该节点
+    QVarLengthArray<int, 64> stack;
+    stack.append(0);
+    while (!stack.isEmpty()) {
+        const int nodeIndex = stack.takeLast();
+        const Node &node = nodes[nodeIndex];
+        float tNear = 0.0f;
+        if (!intersectBounds(node.boundsMin, node.boundsMax, origin, inverse, closest, tNear)) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                float distance = 0.0f;
+                if (intersectPrimitive(primitives[i], origin, direction, inverse, distance) && distance < closest) {
+                    closest = distance;
+                    hit.kind = primitives[i].kind;
+                    hit.objectId = primitives[i].objectId;
+                }
+            }
+            continue;
+        }
+
+        const int left = nodeIndex + 1;
+        const int right = node.first;
+        float tLeft = 0.0f;
+        float tRight = 0.0f;
+        const bool hitLeft = intersectBounds(nodes[left].boundsMin, nodes[left].boundsMax, origin, inverse, closest, tLeft);
+        const bool hitRight = intersectBounds(nodes[right].boundsMin, nodes[right].boundsMax, origin, inverse, closest, tRight);
+        if (hitLeft && hitRight) {
+            // 近的子节点后入栈、先出栈
+            stack.append(tLeft <= tRight ? right : left);
+            stack.append(tLeft <= tRight ? left : right);
+        } else if (hitLeft) {
+            stack.append(left);
+        } else if (hitRight) {
+            stack.append(right);
+        }
+    }
+
+    if (hit.kind != Kind::None) {
+        hit.distance = closest;
+        hit.point = origin + direction * closest;
+    }
+    return hit;
+}
+
+bool PickingBvh::intersectPrimitive(const Primitive &primitive, const QVector3D &origin, const QVector3D &direction,
+                                    const QVector3D &inverse, float &distance) const
+{
+    if (primitive.box) {
+        return intersectBounds(primitive.p0, primitive.p1, origin, inverse, FLT_MAX, distance);
+    }
+
+    // Möller–Trumbore 射线-三角形求交，不区分正反面
+    const QVector3D edge1 = primitive.p1 - primitive.p0;
+    const QVector3D edge2 = primitive.p2 - primitive.p0;
+    const QVector3D p = QVector3D::crossProduct(direction, edge2);
+    const float det = QVector3D::dotProduct(edge1, p);
+    if (std::abs(det) < PARALLEL_EPSILON) {
+        return false;
+    }
+    const float inverseDet = 1.0f / det;
+
+    const QVector3D t = origin - primitive.p0;
+    const float u = QVector3D::dotProduct(t, p) * inverseDet;
+    if (u < 0.0f || u > 1.0f) {
+        return false;
+    }
+    const QVector3D q = QVector3D::crossProduct(t, edge1);
+    const float v = QVector3D::dotProduct(direction, q) * inverseDet;
+    if (v < 0.0f || u + v > 1.0f) {
+        return false;
+    }
+
+    distance = QVector3D::dotProduct(edge2, q) * inverseDet;
+    return distance > DISTANCE_EPSILON;
+}
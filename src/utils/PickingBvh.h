@@ -0,0 +1,102 @@
+#ifndef PICKINGBVH_H
+#define PICKINGBVH_H
+
+#include <QVector>
+#include <QVector3D>
+#include <cfloat>
+
+/**
+ * @brief 拾取用的包围体层次（BVH）
+ *
+ * 把合并网格的三角形（地层、隧道）和钻孔标记的包围盒组织成一棵按表面积启发（SAH）
+ * 划分的包围盒树，鼠标点击的射线只需检测少数几个叶节点，数万个三角形中求最近交点
+ * 也只需微秒级时间。每个图元带有对象类型与序号，命中后由调用方换算为钻孔、地层或断面。
+ *
+ * 只在 CPU 上计算，不依赖 Qt3D，可与网格一起在工作线程中建立。
+ *
+ * 用法：
+ *   PickingBvh bvh;
+ *   bvh.addMesh(batch.vertices, batch.indices, PickingBvh::Kind::Layer, batchIndex);
+ *   bvh.build();
+ *   const PickingBvh::Hit hit = bvh.intersect(origin, direction);
+ *   if (hit.kind == PickingBvh::Kind::Layer) { ... hit.objectId ... }
+ */
+class PickingBvh
+{
+public:
+    enum class Kind : quint8 {
+        None,
+        Borehole,
+        Layer,
+        Tunnel,
+    };
+
+    struct Hit {
+        Kind kind = Kind::None;
+        int objectId = -1;
+        float distance = FLT_MAX;   // 沿射线方向的距离（方向向量为单位长度时为米）
+        QVector3D point;
+    };
+
+    void clear();
+
+    // 添加三角网格，Vertex 须有 float position[3]（GeologyMeshLayout、TunnelMeshBuilder 的顶点）
+    template <typename Vertex>
+    void addMesh(const QVector<Vertex> &vertices, const QVector<quint32> &indices, Kind kind, int objectId)
+    {
+        primitives.reserve(primitives.size() + indices.size() / 3);
+        for (int i = 0; i + 2 < indices.size(); i += 3) {
+            addTriangle(toVector(vertices[indices[i]].position), toVector(vertices[indices[i + 1]].position),
+                        toVector(vertices[indices[i + 2]].position), kind, objectId);
+        }
+    }
+
+    void addTriangle(const QVector3D &a, const QVector3D &b, const QVector3D &c, Kind kind, int objectId);
+    void addBox(const QVector3D &boxMin, const QVector3D &boxMax, Kind kind, int objectId);
+
+    // 添加完图元后建立层次结构，之前 intersect() 不会命中任何图元
+    void build();
+
+    /**
+     * @brief 求射线与图元的最近交点
+     * @param direction 射线方向，不必为单位向量
+     * @param maxDistance 只检测此距离以内的交点
+     */
+    Hit intersect(const QVector3D &origin, const QVector3D &direction, float maxDistance = FLT_MAX) const;
+
+    bool isEmpty() const { return nodes.isEmpty(); }
+    int primitiveCount() const { return primitives.size(); }
+    int nodeCount() const { return nodes.size(); }
+
+private:
+    // 三角形：三个顶点；包围盒：p0、p1 为最小、最大角点
+    struct Primitive {
+        QVector3D p0;
+        QVector3D p1;
+        QVector3D p2;
+        int objectId;
+        Kind kind;
+        bool box;
+    };
+
+    // 深度优先排列：内部节点的左子节点紧随其后；叶节点 count > 0
+    struct Node {
+        QVector3D boundsMin;
+        QVector3D boundsMax;
+        int first;                  // 叶节点：第一个图元；内部节点：右子节点
+        int count;
+    };
+
+    static QVector3D toVector(const float position[3]) { return QVector3D(position[0], position[1], position[2]); }
+
+    int buildNode(QVector<int> &order, int first, int count,
+                  const QVector<QVector3D> &primMin, const QVector<QVector3D> &primMax,
+                  const QVector<QVector3D> &centroids);
+    bool intersectPrimitive(const Primitive &primitive, const QVector3D &origin, const QVector3D &direction,
+                            const QVector3D &inverse, float &distance) const;
+
+    QVector<Primitive> primitives;
+    QVector<Node> nodes;
+};
+
+#endif // PICKINGBVH_H
@@ -0,0 +1,111 @@
+#include "TunnelAlignment.h"
+#include <algorithm>
+
+namespace {
+
+// 求前进方向时前后取样的里程间隔（米）
+const double DIRECTION_STEP = 1.0;
+
+// 断面的十二个角点坐标分量，插值与缩放时逐一处理
+double TunnelProfileData::* const CORNER_COORDINATES[] = {
+    &TunnelProfileData::topLeftX, &TunnelProfileData::topLeftY, &TunnelProfileData::topLeftZ,
+    &TunnelProfileData::bottomLeftX, &TunnelProfileData::bottomLeftY, &TunnelProfileData::bottomLeftZ,
+    &TunnelProfileData::topRightX, &TunnelProfileData::topRightY, &TunnelProfileData::topRightZ,
+    &TunnelProfileData::bottomRightX, &TunnelProfileData::bottomRightY, &TunnelProfileData::bottomRightZ,
+};
+
+QVector3D profileCenter(const TunnelProfileData &p)
+{
+    return QVector3D(p.topLeftX + p.topRightX + p.bottomLeftX + p.bottomRightX,
+                     p.topLeftY + p.topRightY + p.bottomLeftY + p.bottomRightY,
+                     p.topLeftZ + p.topRightZ + p.bottomLeftZ + p.bottomRightZ) / 4.0f;
+}
+
+} // namespace
+
+void TunnelAlignment::setProfiles(const QVector<TunnelProfileData> &profiles)
+{
+    profileList = profiles;
+    std::stable_sort(profileList.begin(), profileList.end(), [](const TunnelProfileData &a, const TunnelProfileData &b) {
+        return a.mileage < b.mileage;
+    });
+    auto last = std::unique(profileList.begin(), profileList.end(), [](const TunnelProfileData &a, const TunnelProfileData &b) {
+        return a.mileage == b.mileage;
+    });
+    profileList.erase(last, profileList.end());
+}
+
+double TunnelAlignment::startMileage() const
+{
+    return profileList.isEmpty() ? 0.0 : profileList.first().mileage;
+}
+
+double TunnelAlignment::endMileage() const
+{
+    return profileList.isEmpty() ? 0.0 : profileList.last().mileage;
+}
+
+TunnelProfileData TunnelAlignment::profileAt(double mileage, double scale) const
+{
+    if (profileList.isEmpty()) {
+        return TunnelProfileData{};
+    }
+
+    // 超出断面范围的里程取端点，外推会把错误的里程放到远离隧道的位置
+    mileage = qBound(startMileage(), mileage, endMileage());
+
+    TunnelProfileData profile = profileList.first();
+    if (profileList.size() > 1) {
+        // 所在的断面区间
+        auto it = std::upper_bound(profileList.constBegin(), profileList.constEnd(), mileage,
+                                   [](double m, const TunnelProfileData &p) { return m < p.mileage; });
+        const int i = qBound(0, static_cast<int>(it - profileList.constBegin()) - 1, static_cast<int>(profileList.size()) - 2);
+        const TunnelProfileData &a = profileList[i];
+        const TunnelProfileData &b = profileList[i + 1];
+        const double t = (mileage - a.mileage) / (b.mileage - a.mileage);
+
+        profile = a;
+        for (double TunnelProfileData::*coordinate : CORNER_COORDINATES) {
+            profile.*coordinate = a.*coordinate + (b.*coordinate - a.*coordinate) * t;
+        }
+    }
+    profile.mileage = mileage;
+
+    if (scale != 1.0) {
+        const QVector3D center = profileCenter(profile);
+        const double c[3] = { center.x(), center.y(), center.z() };
+        for (int k = 0; k < 12; k++) {
+            double &value = profile.*CORNER_COORDINATES[k];
+            value = c[k % 3] + (value - c[k % 3]) * scale;
+        }
+    }
+    return profile;
+}
+
+QVector3D TunnelAlignment::centerAt(double mileage) const
+{
+    return profileCenter(profileAt(mileage));
+}
+
+QVector3D TunnelAlignment::directionAt(double mileage) const
+{
+    const QVector3D delta = centerAt(mileage + DIRECTION_STEP) - centerAt(mileage - DIRECTION_STEP);
+    if (delta.lengthSquared() < 1e-8f) {
+        return QVector3D(1.0f, 0.0f, 0.0f);
+    }
+    return delta.normalized();
+}
+
+float TunnelAlignment::radiusAt(double mileage) const
+{
+    const TunnelProfileData p = profileAt(mileage);
+    const QVector3D topLeft(p.topLeftX, p.topLeftY, p.topLeftZ);
+    const QVector3D topRight(p.topRightX, p.topRightY, p.topRightZ);
+    const QVector3D bottomLeft(p.bottomLeftX, p.bottomLeftY, p.bottomLeftZ);
+    const QVector3D bottomRight(p.bottomRightX, p.bottomRightY, p.bottomRightZ);
+
+    // 与 TunnelMeshBuilder 相同的半轴定义
+    const float halfWidth = (((topRight + bottomRight) - (topLeft + bottomLeft)) / 4.0f).length();
+    const float halfHeight = (((topLeft + topRight) - (bottomLeft + bottomRight)) / 4.0f).length();
+    return (halfWidth + halfHeight) / 2.0f;
+}
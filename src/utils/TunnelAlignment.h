@@ -0,0 +1,51 @@
+#ifndef TUNNELALIGNMENT_H
+#define TUNNELALIGNMENT_H
+
+#include <QVector>
+#include <QVector3D>
+#include "../database/TunnelProfileDAO.h"
+
+/**
+ * @brief 隧道轴线
+ *
+ * 由按里程排列的隧道断面在任意里程处插值出断面、中心、前进方向与半径，
+ * 用于在三维视图中按实时里程摆放盾构机、生成已掘进段的衬砌环。
+ * 里程与断面的 mileage 一致，应为桩号里程（见 ChainageAxis）。
+ * 超出 [startMileage(), endMileage()] 的里程按端点处理，不外推。
+ *
+ * 用法：
+ *   TunnelAlignment alignment;
+ *   alignment.setProfiles(profiles);
+ *   const QVector3D position = alignment.centerAt(mileage);
+ *   const QVector3D forward = alignment.directionAt(mileage);
+ */
+class TunnelAlignment
+{
+public:
+    // 断面按里程排序，里程重复的只保留第一个
+    void setProfiles(const QVector<TunnelProfileData> &profiles);
+
+    bool isEmpty() const { return profileList.isEmpty(); }
+    double startMileage() const;
+    double endMileage() const;
+
+    /**
+     * @brief 指定里程处的断面
+     * @param mileage 里程，超出断面范围时取最近的端点
+     * @param scale 四个角点相对断面中心的缩放，大于1时截面略大于设计断面
+     */
+    TunnelProfileData profileAt(double mileage, double scale = 1.0) const;
+
+    QVector3D centerAt(double mileage) const;
+
+    // 里程增加方向的单位向量；只有一个断面时为 X 轴方向
+    QVector3D directionAt(double mileage) const;
+
+    // 截面两个半轴的平均值
+    float radiusAt(double mileage) const;
+
+private:
+    QVector<TunnelProfileData> profileList;
+};
+
+#endif // TUNNELALIGNMENT_H
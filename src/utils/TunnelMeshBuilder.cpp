@@ -0,0 +1,241 @@
+#include "TunnelMeshBuilder.h"
+#include <QtMath>
+#include <QDataStream>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 半轴短于此值的断面视为无效（米）
+const float MIN_HALF_AXIS = 0.01f;
+
+// 相邻环中心距离短于此值时不生成管段（米）
+const float MIN_SEGMENT_LENGTH = 0.01f;
+
+// 细节级别0的环顶点数，每降一级减半
+const int FINEST_RING_SEGMENTS = 32;
+
+} // namespace
+
+TunnelMeshBuilder::Options TunnelMeshBuilder::levelOfDetail(int level)
+{
+    level = qBound(0, level, LOD_LEVELS - 1);
+
+    Options options;
+    options.ringSegments = FINEST_RING_SEGMENTS >> level;
+    options.profileStride = 1 << level;
+    return options;
+}
+
+TunnelMeshBuilder::TunnelMeshBuilder()
+    : TunnelMeshBuilder(Options())
+{
+}
+
+TunnelMeshBuilder::TunnelMeshBuilder(const Options &options)
+    : opts(options)
+{
+    opts.ringSegments = qMax(3, opts.ringSegments);
+    opts.profileStride = qMax(1, opts.profileStride);
+    clear();
+}
+
+void TunnelMeshBuilder::clear()
+{
+    vertexList.clear();
+    indexList.clear();
+    profilesSeen = 0;
+    rings = 0;
+    segments = 0;
+    lastMileage = 0.0;
+    radiusSum = 0.0;
+    hasLastRing = false;
+    lastCenter = QVector3D();
+    lastAxis = QVector3D();
+    lastRingFirst = 0;
+    minCorner = QVector3D();
+    maxCorner = QVector3D();
+}
+
+QByteArray TunnelMeshBuilder::vertexBytes(int first) const
+{
+    first = qBound(0, first, vertexList.size());
+    QByteArray bytes;
+    bytes.resize((vertexList.size() - first) * VERTEX_STRIDE);
+    std::memcpy(bytes.data(), vertexList.constData() + first, bytes.size());
+    return bytes;
+}
+
+QByteArray TunnelMeshBuilder::indexBytes(int first) const
+{
+    first = qBound(0, first, indexList.size());
+    QByteArray bytes;
+    bytes.resize((indexList.size() - first) * sizeof(quint32));
+    std::memcpy(bytes.data(), indexList.constData() + first, bytes.size());
+    return bytes;
+}
+
+float TunnelMeshBuilder::averageRadius() const
+{
+    return rings > 0 ? static_cast<float>(radiusSum / rings) : 0.0f;
+}
+
+void TunnelMeshBuilder::save(QDataStream &out) const
+{
+    out << static_cast<qint32>(opts.ringSegments) << static_cast<qint32>(opts.profileStride) << opts.clipRect
+        << vertexBytes() << indexBytes()
+        << static_cast<qint32>(profilesSeen) << static_cast<qint32>(rings) << static_cast<qint32>(segments)
+        << lastMileage << radiusSum
+        << hasLastRing << lastCenter << lastAxis << lastRingFirst
+        << minCorner << maxCorner;
+}
+
+bool TunnelMeshBuilder::load(QDataStream &in)
+{
+    qint32 ringSegments = 0, profileStride = 0, profileTotal = 0, ringTotal = 0, segmentTotal = 0;
+    QRectF clipRect;
+    QByteArray vertexData, indexData;
+    TunnelMeshBuilder loaded;
+
+    in >> ringSegments >> profileStride >> clipRect
+       >> vertexData >> indexData
+       >> profileTotal >> ringTotal >> segmentTotal
+       >> loaded.lastMileage >> loaded.radiusSum
+       >> loaded.hasLastRing >> loaded.lastCenter >> loaded.lastAxis >> loaded.lastRingFirst
+       >> loaded.minCorner >> loaded.maxCorner;
+
+    if (in.status() != QDataStream::Ok || ringSegments < 3 || profileStride < 1
+        || vertexData.size() % VERTEX_STRIDE != 0 || indexData.size() % sizeof(quint32) != 0) {
+        return false;
+    }
+
+    loaded.opts.ringSegments = ringSegments;
+    loaded.opts.profileStride = profileStride;
+    loaded.opts.clipRect = clipRect;
+    loaded.vertexList.resize(vertexData.size() / VERTEX_STRIDE);
+    std::memcpy(loaded.vertexList.data(), vertexData.constData(), vertexData.size());
+    loaded.indexList.resize(indexData.size() / sizeof(quint32));
+    std::memcpy(loaded.indexList.data(), indexData.constData(), indexData.size());
+    loaded.profilesSeen = profileTotal;
+    loaded.rings = ringTotal;
+    loaded.segments = segmentTotal;
+
+    // 索引必须指向已有顶点
+    for (quint32 index : loaded.indexList) {
+        if (index >= static_cast<quint32>(loaded.vertexList.size())) {
+            return false;
+        }
+    }
+
+    *this = loaded;
+    return true;
+}
+
+bool TunnelMeshBuilder::appendProfiles(const QVector<TunnelProfileData> &profiles)
+{
+    // 先检查顺序，保证失败时不留下半截数据
+    double previous = lastMileage;
+    bool first = (profilesSeen == 0);
+    for (const TunnelProfileData &profile : profiles) {
+        if (!first && profile.mileage < previous) {
+            return false;
+        }
+        previous = profile.mileage;
+        first = false;
+    }
+
+    for (const TunnelProfileData &profile : profiles) {
+        addProfile(profile);
+        lastMileage = profile.mileage;
+    }
+    return true;
+}
+
+void TunnelMeshBuilder::addProfile(const TunnelProfileData &profile)
+{
+    // 粗略级别按间隔取样，间隔跨越多次追加时仍保持连续
+    const int profileIndex = profilesSeen++;
+    if (profileIndex % opts.profileStride != 0) {
+        return;
+    }
+
+    const QVector3D topLeft(profile.topLeftX, profile.topLeftY, profile.topLeftZ);
+    const QVector3D topRight(profile.topRightX, profile.topRightY, profile.topRightZ);
+    const QVector3D bottomLeft(profile.bottomLeftX, profile.bottomLeftY, profile.bottomLeftZ);
+    const QVector3D bottomRight(profile.bottomRightX, profile.bottomRightY, profile.bottomRightZ);
+
+    // 截面中心与两个半轴：左右取左右两边中点之差，上下取上下两边中点之差
+    const QVector3D center = (topLeft + topRight + bottomLeft + bottomRight) / 4.0f;
+    const QVector3D halfWidth = ((topRight + bottomRight) - (topLeft + bottomLeft)) / 4.0f;
+    QVector3D halfHeight = ((topLeft + topRight) - (bottomLeft + bottomRight)) / 4.0f;
+
+    QVector3D axis = QVector3D::crossProduct(halfWidth, halfHeight);
+    if (halfWidth.length() < MIN_HALF_AXIS || halfHeight.length() < MIN_HALF_AXIS
+        || axis.length() < MIN_HALF_AXIS * MIN_HALF_AXIS) {
+        return;
+    }
+    axis.normalize();
+
+    // 截面法向与上一环相反时翻转上下半轴，保证各环取样方向一致，管壁不扭转
+    if (hasLastRing && QVector3D::dotProduct(axis, lastAxis) < 0.0f) {
+        halfHeight = -halfHeight;
+        axis = -axis;
+    }
+
+    const int n = opts.ringSegments;
+    const quint32 ringFirst = static_cast<quint32>(vertexList.size());
+
+    if (vertexList.isEmpty()) {
+        minCorner = center;
+        maxCorner = center;
+    }
+
+    for (int k = 0; k < n; k++) {
+        const float theta = 2.0f * static_cast<float>(M_PI) * k / n;
+        const float c = std::cos(theta);
+        const float s = std::sin(theta);
+
+        // 椭圆上的点与切向，切向 × 截面法向 指向截面外侧
+        const QVector3D p = center + halfWidth * c + halfHeight * s;
+        const QVector3D tangent = halfHeight * c - halfWidth * s;
+        const QVector3D normal = QVector3D::crossProduct(tangent, axis).normalized();
+
+        vertexList.append(Vertex{ { p.x(), p.y(), p.z() }, { normal.x(), normal.y(), normal.z() } });
+
+        minCorner = QVector3D(qMin(minCorner.x(), p.x()), qMin(minCorner.y(), p.y()), qMin(minCorner.z(), p.z()));
+        maxCorner = QVector3D(qMax(maxCorner.x(), p.x()), qMax(maxCorner.y(), p.y()), qMax(maxCorner.z(), p.z()));
+    }
+    radiusSum += (halfWidth.length() + halfHeight.length()) / 2.0f;
+    rings++;
+
+    if (hasLastRing) {
+        const QVector3D direction = center - lastCenter;
+        const QVector3D midPoint = (center + lastCenter) / 2.0f;
+        const bool inside = opts.clipRect.isEmpty() || opts.clipRect.contains(midPoint.x(), midPoint.y());
+
+        if (inside && direction.length() >= MIN_SEGMENT_LENGTH) {
+            // 三角形 (a_k, a_k+1, b_k) 的法线为 环切向 × 前进方向，
+            // 截面法向与前进方向同向时朝外，反向时交换顶点顺序
+            const bool forward = QVector3D::dotProduct(lastAxis, direction) > 0.0f;
+            for (int k = 0; k < n; k++) {
+                const quint32 a0 = lastRingFirst + k;
+                const quint32 a1 = lastRingFirst + (k + 1) % n;
+                const quint32 b0 = ringFirst + k;
+                const quint32 b1 = ringFirst + (k + 1) % n;
+                if (forward) {
+                    indexList << a0 << a1 << b0
+                              << b0 << a1 << b1;
+                } else {
+                    indexList << a0 << b0 << a1
+                              << b0 << b1 << a1;
+                }
+            }
+            segments++;
+        }
+    }
+
+    hasLastRing = true;
+    lastCenter = center;
+    lastAxis = axis;
+    lastRingFirst = ringFirst;
+}
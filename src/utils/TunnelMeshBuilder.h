@@ -0,0 +1,111 @@
+#ifndef TUNNELMESHBUILDER_H
+#define TUNNELMESHBUILDER_H
+
+#include <QVector>
+#include <QVector3D>
+#include <QRectF>
+#include <QByteArray>
+#include "../database/TunnelProfileDAO.h"
+
+class QDataStream;
+
+/**
+ * @brief 隧道扫掠网格构建
+ *
+ * 每个隧道断面按四个角点确定一个截面环：中心取四角平均，左右、上下两个半轴
+ * 取自角点，截面沿各自的方向与尺寸取样为椭圆环。相邻断面的环首尾相连，
+ * 整条隧道合成一个交错顶点缓冲（位置、法线）和一个索引缓冲，渲染时只需一个实体。
+ *
+ * 顶点按环依次排列，追加断面只在缓冲末尾增加新的环与三角形，已有数据不变，
+ * 可以只上传新增部分。环的取样数与断面间隔可配置，用于生成不同细节级别。
+ *
+ * 只生成顶点与索引数据，不依赖 Qt3D，可在任意线程中使用。
+ *
+ * 用法：
+ *   TunnelMeshBuilder builder(TunnelMeshBuilder::levelOfDetail(0));
+ *   builder.appendProfiles(profiles);            // 按里程排好序的断面
+ *   ... builder.vertexBytes() / builder.indexBytes() 上传为 Qt3D 缓冲 ...
+ */
+class TunnelMeshBuilder
+{
+public:
+    // 交错顶点：位置与法线
+    struct Vertex {
+        float position[3];
+        float normal[3];
+    };
+
+    static const int POSITION_OFFSET = 0;
+    static const int NORMAL_OFFSET = 3 * sizeof(float);
+    static const int VERTEX_STRIDE = sizeof(Vertex);
+
+    // 细节级别数量，级别0最精细
+    static const int LOD_LEVELS = 3;
+
+    struct Options {
+        int ringSegments = 32;      // 每个截面环的顶点数
+        int profileStride = 1;      // 每隔几个断面取一个环
+        QRectF clipRect;            // 只生成中点在此水平范围内的管段，为空时不裁剪
+    };
+
+    // 各细节级别的取样参数：环顶点数 32/16/8，断面间隔 1/2/4
+    static Options levelOfDetail(int level);
+
+    TunnelMeshBuilder();
+    explicit TunnelMeshBuilder(const Options &options);
+
+    void clear();
+
+    const Options &options() const { return opts; }
+
+    /**
+     * @brief 追加断面，生成新的环并与上一环连成管段
+     * @param profiles 按里程递增排序的断面
+     * @return 新断面里程小于已有断面时返回 false，不做任何修改，需 clear() 后重建
+     */
+    bool appendProfiles(const QVector<TunnelProfileData> &profiles);
+
+    const QVector<Vertex> &vertices() const { return vertexList; }
+    const QVector<quint32> &indices() const { return indexList; }
+
+    // 从第 first 个顶点 / 索引开始的数据，用于只上传追加的部分
+    QByteArray vertexBytes(int first = 0) const;
+    QByteArray indexBytes(int first = 0) const;
+
+    int profileCount() const { return profilesSeen; }
+    int ringCount() const { return rings; }
+    int segmentCount() const { return segments; }
+
+    // 各截面环半轴的平均值
+    float averageRadius() const;
+
+    QVector3D boundsMin() const { return minCorner; }
+    QVector3D boundsMax() const { return maxCorner; }
+
+    // 保存与恢复完整状态（含网格数据与末端环），恢复后可继续追加断面
+    void save(QDataStream &out) const;
+    bool load(QDataStream &in);
+
+private:
+    void addProfile(const TunnelProfileData &profile);
+
+    Options opts;
+    QVector<Vertex> vertexList;
+    QVector<quint32> indexList;
+    int profilesSeen;               // 已接收的断面数（含未取样的）
+    int rings;
+    int segments;
+    double lastMileage;
+    double radiusSum;
+
+    // 上一个环，用于连接下一个管段
+    bool hasLastRing;
+    QVector3D lastCenter;
+    QVector3D lastAxis;             // 截面法向（左右半轴 × 上下半轴）
+    quint32 lastRingFirst;
+
+    QVector3D minCorner;
+    QVector3D maxCorner;
+};
+
+#endif // TUNNELMESHBUILDER_H
@@ -0,0 +1,373 @@
+#include "XlsxReader.h"
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+namespace {
+
+const char *WORKBOOK_ENTRY = "xl/workbook.xml";
+const char *WORKBOOK_RELS_ENTRY = "xl/_rels/workbook.xml.rels";
+const char *DEFAULT_SHARED_STRINGS_ENTRY = "xl/sharedStrings.xml";
+
+// Excel 的最大列数（XFD）
+const int MAX_COLUMNS = 16384;
+
+// 单元格引用（如 "AB12"）的列号，从0开始；没有列字母时返回 -1
+int columnIndex(QStringView reference)
+{
+    int column = 0;
+    for (QChar c : reference) {
+        if (c < QLatin1Char('A') || c > QLatin1Char('Z')) {
+            break;
+        }
+        column = column * 26 + (c.unicode() - 'A' + 1);
+        if (column > MAX_COLUMNS) {
+            break;
+        }
+    }
+    return column - 1;
+}
+
+// 读取 <si> 或 <is> 中的文本：拼接所有 <t>（富文本分段），跳过注音 <rPh>
+QString readRichText(QXmlStreamReader &xml)
+{
+    QString text;
+    int depth = 1;
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            if (xml.name() == u"t") {
+                text += xml.readElementText();
+            } else if (xml.name() == u"rPh") {
+                xml.skipCurrentElement();
+            } else {
+                ++depth;
+            }
+        } else if (xml.isEndElement()) {
+            if (--depth == 0) {
+                break;
+            }
+        }
+    }
+    return text;
+}
+
+// 关系中的目标路径相对于 xl/，以 / 开头时为包内绝对路径
+QString resolveTarget(const QString &target)
+{
+    if (target.startsWith('/')) {
+        return target.mid(1);
+    }
+    return QDir::cleanPath("xl/" + target);
+}
+
+} // namespace
+
+XlsxReader::XlsxReader()
+    : lastRowNumber(0)
+    , finished(true)
+{
+}
+
+XlsxReader::~XlsxReader()
+{
+    close();
+}
+
+bool XlsxReader::isXlsxFile(const QString &filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix();
+    return suffix.compare("xlsx", Qt::CaseInsensitive) == 0
+        || suffix.compare("xlsm", Qt::CaseInsensitive) == 0;
+}
+
+bool XlsxReader::open(const QString &filePath, int sheetIndex)
+{
+    close();
+
+    if (!archive.open(filePath)) {
+        return fail(archive.errorString());
+    }
+
+    QString sheetPath;
+    QString sharedStringsPath;
+    if (!openWorkbook(sheetIndex, sheetPath, sharedStringsPath)) {
+        return false;
+    }
+    if (archive.contains(sharedStringsPath) && !loadSharedStrings(sharedStringsPath)) {
+        return false;
+    }
+
+    sheetDevice = archive.openEntry(sheetPath);
+    if (!sheetDevice) {
+        return fail(archive.errorString());
+    }
+    xml.setDevice(sheetDevice.get());
+
+    // 定位到 <sheetData>，之后每个 <row> 为一行
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement() && xml.name() == u"sheetData") {
+            finished = false;
+            return true;
+        }
+    }
+    if (xml.hasError()) {
+        return fail("读取工作表失败: " + xml.errorString());
+    }
+    // 没有数据的工作表
+    return true;
+}
+
+void XlsxReader::close()
+{
+    xml.clear();
+    sheetDevice.reset();
+    archive.close();
+    currentSheetName.clear();
+    sharedStrings.clear();
+    rowBuffer.clear();
+    cells.clear();
+    lastRowNumber = 0;
+    finished = true;
+    error.clear();
+}
+
+qint64 XlsxReader::size() const
+{
+    return sheetDevice ? sheetDevice->compressedSize() : 0;
+}
+
+qint64 XlsxReader::position() const
+{
+    return sheetDevice ? sheetDevice->compressedPosition() : 0;
+}
+
+bool XlsxReader::fail(const QString &message)
+{
+    error = message;
+    qWarning() << "XLSX读取失败:" << message;
+    return false;
+}
+
+QByteArray XlsxReader::readEntry(const QString &entryName)
+{
+    std::unique_ptr<ZipEntryReader> device = archive.openEntry(entryName);
+    if (!device) {
+        fail(archive.errorString());
+        return QByteArray();
+    }
+    QByteArray content = device->readAll();
+    if (device->hasError() || content.size() != device->entry().uncompressedSize) {
+        fail(device->errorString());
+        return QByteArray();
+    }
+    return content;
+}
+
+bool XlsxReader::openWorkbook(int sheetIndex, QString &sheetPath, QString &sharedStringsPath)
+{
+    if (!archive.contains(WORKBOOK_ENTRY)) {
+        return fail("不是有效的 XLSX 文件（缺少 xl/workbook.xml），旧版 .xls 请在 Excel 中另存为 .xlsx");
+    }
+    const QByteArray workbook = readEntry(WORKBOOK_ENTRY);
+    if (hasError()) {
+        return false;
+    }
+
+    // 工作表按工作簿中的顺序排列，r:id 指向关系文件中的目标
+    QStringList sheetNames;
+    QStringList relationIds;
+    QXmlStreamReader reader(workbook);
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.isStartElement() && reader.name() == u"sheet") {
+            QString relationId;
+            for (const QXmlStreamAttribute &attribute : reader.attributes()) {
+                if (attribute.name() == u"id") {
+                    relationId = attribute.value().toString();
+                }
+            }
+            sheetNames.append(reader.attributes().value(u"name").toString());
+            relationIds.append(relationId);
+        }
+    }
+    if (reader.hasError()) {
+        return fail("读取工作簿失败: " + reader.errorString());
+    }
+    if (sheetIndex < 0 || sheetIndex >= sheetNames.size()) {
+        return fail(QString("工作簿中没有第 %1 个工作表").arg(sheetIndex + 1));
+    }
+    currentSheetName = sheetNames[sheetIndex];
+
+    if (archive.contains(WORKBOOK_RELS_ENTRY)) {
+        const QByteArray relations = readEntry(WORKBOOK_RELS_ENTRY);
+        if (hasError()) {
+            return false;
+        }
+        QXmlStreamReader relationReader(relations);
+        while (!relationReader.atEnd()) {
+            relationReader.readNext();
+            if (!relationReader.isStartElement() || relationReader.name() != u"Relationship") {
+                continue;
+            }
+            const QXmlStreamAttributes attributes = relationReader.attributes();
+            const QString target = resolveTarget(attributes.value(u"Target").toString());
+            if (attributes.value(u"Id") == relationIds[sheetIndex]) {
+                sheetPath = target;
+            } else if (attributes.value(u"Type").endsWith(u"/sharedStrings")) {
+                sharedStringsPath = target;
+            }
+        }
+    }
+
+    // 关系文件缺失或不完整时使用 Excel 的默认路径
+    if (sheetPath.isEmpty()) {
+        sheetPath = QString("xl/worksheets/sheet%1.xml").arg(sheetIndex + 1);
+    }
+    if (sharedStringsPath.isEmpty()) {
+        sharedStringsPath = DEFAULT_SHARED_STRINGS_ENTRY;
+    }
+    return true;
+}
+
+bool XlsxReader::loadSharedStrings(const QString &entryName)
+{
+    std::unique_ptr<ZipEntryReader> device = archive.openEntry(entryName);
+    if (!device) {
+        return fail(archive.errorString());
+    }
+
+    QXmlStreamReader reader(device.get());
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (!reader.isStartElement()) {
+            continue;
+        }
+        if (reader.name() == u"sst") {
+            const int uniqueCount = reader.attributes().value(u"uniqueCount").toInt();
+            if (uniqueCount > 0) {
+                sharedStrings.reserve(uniqueCount);
+            }
+        } else if (reader.name() == u"si") {
+            sharedStrings.append(readRichText(reader).toUtf8());
+        }
+    }
+    if (reader.hasError()) {
+        const QString reason = device->hasError() ? device->errorString() : reader.errorString();
+        return fail("读取共享字符串失败: " + reason);
+    }
+    return true;
+}
+
+bool XlsxReader::readRow(CsvTokenizer::Row &row)
+{
+    row.fields.clear();
+    if (finished) {
+        return false;
+    }
+
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isEndElement() && xml.name() == u"sheetData") {
+            finished = true;
+            return false;
+        }
+        if (!xml.isStartElement() || xml.name() != u"row") {
+            continue;
+        }
+
+        bool ok = false;
+        const qint64 number = xml.attributes().value(u"r").toLongLong(&ok);
+        lastRowNumber = ok ? number : lastRowNumber + 1;
+
+        rowBuffer.clear();
+        cells.clear();
+        while (!xml.atEnd()) {
+            xml.readNext();
+            if (xml.isStartElement()) {
+                if (xml.name() == u"c") {
+                    if (!readCell()) {
+                        break;
+                    }
+                } else {
+                    xml.skipCurrentElement();
+                }
+            } else if (xml.isEndElement()) {
+                break;      // </row>
+            }
+        }
+        if (hasError() || xml.hasError()) {
+            break;
+        }
+
+        // rowBuffer 已完整，此时取指针不会因扩容失效
+        row.number = lastRowNumber;
+        for (const CellSpan &cell : cells) {
+            row.fields.append(CsvTokenizer::Field(rowBuffer.constData() + cell.offset, cell.length, false));
+        }
+        return true;
+    }
+
+    if (xml.hasError() && !hasError()) {
+        const QString reason = sheetDevice->hasError() ? sheetDevice->errorString() : xml.errorString();
+        fail(QString("读取工作表失败（第 %1 行附近）: %2").arg(lastRowNumber).arg(reason));
+    }
+    row.fields.clear();
+    finished = true;
+    return false;
+}
+
+bool XlsxReader::readCell()
+{
+    const QXmlStreamAttributes attributes = xml.attributes();
+    int column = columnIndex(attributes.value(u"r"));
+    if (column < 0) {
+        column = cells.size();
+    }
+    const QStringView type = attributes.value(u"t");
+
+    QString value;
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            if (xml.name() == u"v") {
+                value = xml.readElementText();
+            } else if (xml.name() == u"is") {
+                value = readRichText(xml);
+            } else {
+                xml.skipCurrentElement();     // <f> 公式等
+            }
+        } else if (xml.isEndElement()) {
+            break;      // </c>
+        }
+    }
+    if (xml.hasError()) {
+        return false;
+    }
+
+    QByteArray text;
+    if (type == u"s") {
+        bool ok = false;
+        const int index = value.toInt(&ok);
+        if (!ok || index < 0 || index >= sharedStrings.size()) {
+            return fail(QString("第 %1 行的共享字符串序号无效: %2").arg(lastRowNumber).arg(value));
+        }
+        text = sharedStrings[index];
+    } else if (type == u"b") {
+        text = (value == QLatin1String("1")) ? QByteArray("TRUE") : QByteArray("FALSE");
+    } else {
+        text = value.toUtf8();
+    }
+
+    if (column >= MAX_COLUMNS) {
+        return true;
+    }
+    if (column >= cells.size()) {
+        cells.resize(column + 1);
+    }
+    cells[column].offset = rowBuffer.size();
+    cells[column].length = text.size();
+    rowBuffer.append(text);
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef XLSXREADER_H
+#define XLSXREADER_H
+
+#include "CsvTokenizer.h"
+#include "ZipArchive.h"
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QXmlStreamReader>
+#include <memory>
+
+/**
+ * @brief 流式 XLSX 工作表读取
+ *
+ * 直接读取 .xlsx（Office Open XML）文件，无需先在 Excel 中另存为 CSV。
+ * 工作表 XML 边解压边用 QXmlStreamReader 拉取解析，每次只保留当前一行，
+ * 百万行的工作表内存占用也只有共享字符串表加上固定的缓冲区。
+ *
+ * 行以 CsvTokenizer::Row 的形式给出，与 CSV 导入使用同一套解析函数：
+ *   共享字符串、内联字符串与公式字符串给出文本，数值给出 XML 中的原文（如 "1.5E-3"），
+ *   布尔值为 TRUE/FALSE，日期为 Excel 序列号；单元格缺失的列为空字段。
+ * 行号取自工作表（从1开始），空行在 XLSX 中不存在，行号可能不连续。
+ *
+ * 用法：
+ *   XlsxReader reader;
+ *   if (!reader.open(filePath)) { ... reader.errorString() ... }
+ *   CsvTokenizer::Row row;
+ *   while (reader.readRow(row)) { ... row[2].toString() ... }
+ *   if (reader.hasError()) { ... }
+ */
+class XlsxReader
+{
+public:
+    XlsxReader();
+    ~XlsxReader();
+
+    XlsxReader(const XlsxReader &) = delete;
+    XlsxReader &operator=(const XlsxReader &) = delete;
+
+    // 按扩展名判断是否为 XLSX 文件（.xlsx / .xlsm）
+    static bool isXlsxFile(const QString &filePath);
+
+    /**
+     * @brief 打开文件中的工作表
+     * @param sheetIndex 工作表序号（按工作簿中的顺序，从0开始）
+     */
+    bool open(const QString &filePath, int sheetIndex = 0);
+    void close();
+
+    QString errorString() const { return error; }
+    bool hasError() const { return !error.isEmpty(); }
+
+    QString sheetName() const { return currentSheetName; }
+
+    // 读取下一行，字段在下次调用前有效；已到末尾或出错返回 false
+    bool readRow(CsvTokenizer::Row &row);
+
+    // 工作表压缩数据的大小与已读取的位置，用于显示进度
+    qint64 size() const;
+    qint64 position() const;
+
+private:
+    struct CellSpan {
+        int offset = 0;
+        int length = 0;
+    };
+
+    bool openWorkbook(int sheetIndex, QString &sheetPath, QString &sharedStringsPath);
+    bool loadSharedStrings(const QString &entryName);
+    QByteArray readEntry(const QString &entryName);
+
+    // 读取当前 <c> 元素，按其列号存入当前行
+    bool readCell();
+
+    bool fail(const QString &message);
+
+    ZipArchive archive;
+    std::unique_ptr<ZipEntryReader> sheetDevice;
+    QXmlStreamReader xml;
+    QString currentSheetName;
+    QVector<QByteArray> sharedStrings;      // UTF-8，按序号
+    QByteArray rowBuffer;                   // 当前行所有单元格的文本
+    QVector<CellSpan> cells;                // 当前行各列在 rowBuffer 中的位置
+    qint64 lastRowNumber;
+    bool finished;
+    QString error;
+};
+
+#endif // XLSXREADER_H
@@ -0,0 +1,863 @@
+#include "ZipArchive.h"
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const quint32 LOCAL_HEADER_SIGNATURE = 0x04034b50;
+const quint32 CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+const quint32 END_OF_DIRECTORY_SIGNATURE = 0x06054b50;
+const quint32 ZIP64_END_OF_DIRECTORY_SIGNATURE = 0x06064b50;
+const quint32 ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+const quint16 ZIP64_EXTRA_ID = 0x0001;
+
+const int LOCAL_HEADER_SIZE = 30;
+const int CENTRAL_HEADER_SIZE = 46;
+const int END_OF_DIRECTORY_SIZE = 22;
+const int ZIP64_LOCATOR_SIZE = 20;
+const int ZIP64_END_OF_DIRECTORY_SIZE = 56;
+const int MAX_COMMENT_SIZE = 0xFFFF;
+
+const quint16 FLAG_ENCRYPTED = 0x0001;
+
+// 中央目录上限，防止损坏的文件导致巨大分配（XLSX 的目录通常只有几KB）
+const qint64 MAX_CENTRAL_DIRECTORY_SIZE = 64 * 1024 * 1024;
+
+// 每次从文件读入的压缩数据
+const qint64 INPUT_BUFFER_SIZE = 64 * 1024;
+
+quint16 readU16(const char *p)
+{
+    return qFromLittleEndian<quint16>(p);
+}
+
+quint32 readU32(const char *p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+quint64 readU64(const char *p)
+{
+    return qFromLittleEndian<quint64>(p);
+}
+
+const std::array<quint32, 256> &crcTable()
+{
+    static const std::array<quint32, 256> table = []() {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+quint32 updateCrc(quint32 crc, const char *data, qint64 size)
+{
+    const std::array<quint32, 256> &table = crcTable();
+    crc = ~crc;
+    for (qint64 i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<quint8>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+} // namespace
+
+/**
+ * @brief deflate（RFC 1951）流式解压
+ *
+ * 按需从输入设备读取压缩数据，每次调用解压到输出缓冲区写满或数据结束为止，
+ * 未完成的长度/距离复制保存在状态中，下次调用继续。
+ * Huffman 解码先查 FAST_BITS 位的表，更长的码逐位解码。
+ */
+class ZipEntryReader::Inflater
+{
+public:
+    Inflater(QIODevice *input, qint64 compressedSize);
+
+    // 解压最多 maxSize 字节，返回实际字节数，出错返回 -1
+    qint64 inflate(char *out, qint64 maxSize);
+
+    bool isFinished() const { return state == State::Done; }
+    qint64 consumedBytes() const { return totalInput - remainingInput - (inputBuffer.size() - inputPos); }
+    QString errorString() const { return error; }
+
+private:
+    static const int MAX_BITS = 15;
+    static const int FAST_BITS = 10;
+    static const int MAX_LITERAL_CODES = 288;
+    static const int MAX_DISTANCE_CODES = 32;
+    static const quint32 WINDOW_SIZE = 32768;
+
+    enum class State {
+        BlockHeader,
+        Stored,
+        Compressed,
+        Done
+    };
+
+    struct Huffman {
+        quint16 fast[1 << FAST_BITS];       // 低 FAST_BITS 位 -> 符号 | 码长 << 9，0 表示需逐位解码
+        quint16 count[MAX_BITS + 1];        // 各码长的符号数
+        quint16 symbol[MAX_LITERAL_CODES];  // 按码排序的符号
+    };
+
+    // 确保缓冲中至少有 bits 位，输入不足时返回 false
+    bool fill(int bits);
+
+    // 取出 bits 位，调用前须已 fill()
+    quint32 take(int bits);
+
+    // fill() 并取出，输入不足时记录错误
+    bool read(int bits, quint32 &value);
+
+    bool build(Huffman &huffman, const quint8 *lengths, int count);
+    int decode(const Huffman &huffman);
+
+    bool readBlockHeader();
+    bool readDynamicTables();
+    void buildFixedTables();
+
+    bool fail(const QString &message);
+
+    void emitByte(char *out, qint64 &produced, quint8 byte)
+    {
+        window[windowPos & (WINDOW_SIZE - 1)] = byte;
+        ++windowPos;
+        out[produced++] = static_cast<char>(byte);
+    }
+
+    QIODevice *input;
+    qint64 totalInput;
+    qint64 remainingInput;
+    QByteArray inputBuffer;
+    int inputPos;
+
+    quint64 bitBuffer;
+    int bitCount;
+
+    State state;
+    bool lastBlock;
+    quint32 storedRemaining;
+    int copyLength;
+    quint32 copyDistance;
+
+    std::vector<quint8> window;
+    quint64 windowPos;                      // 已输出的总字节数
+
+    Huffman literalCodes;
+    Huffman distanceCodes;
+    QString error;
+};
+
+namespace {
+
+const quint16 LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const quint8 LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+const quint16 DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+const quint8 DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+const quint8 CODE_LENGTH_ORDER[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+quint32 reverseBits(quint32 code, int length)
+{
+    quint32 reversed = 0;
+    for (int i = 0; i < length; ++i) {
+        reversed = (reversed << 1) | (code & 1);
+        code >>= 1;
+    }
+    return reversed;
+}
+
+} // namespace
+
+ZipEntryReader::Inflater::Inflater(QIODevice *input, qint64 compressedSize)
+    : input(input)
+    , totalInput(compressedSize)
+    , remainingInput(compressedSize)
+    , inputPos(0)
+    , bitBuffer(0)
+    , bitCount(0)
+    , state(State::BlockHeader)
+    , lastBlock(false)
+    , storedRemaining(0)
+    , copyLength(0)
+    , copyDistance(0)
+    , window(WINDOW_SIZE)
+    , windowPos(0)
+{
+}
+
+bool ZipEntryReader::Inflater::fill(int bits)
+{
+    while (bitCount < bits) {
+        if (inputPos >= inputBuffer.size()) {
+            if (remainingInput <= 0) {
+                return false;
+            }
+            inputBuffer = input->read(qMin(remainingInput, INPUT_BUFFER_SIZE));
+            inputPos = 0;
+            if (inputBuffer.isEmpty()) {
+                remainingInput = 0;
+                return false;
+            }
+            remainingInput -= inputBuffer.size();
+        }
+        bitBuffer |= static_cast<quint64>(static_cast<quint8>(inputBuffer[inputPos++])) << bitCount;
+        bitCount += 8;
+    }
+    return true;
+}
+
+quint32 ZipEntryReader::Inflater::take(int bits)
+{
+    const quint32 value = static_cast<quint32>(bitBuffer & ((quint64(1) << bits) - 1));
+    bitBuffer >>= bits;
+    bitCount -= bits;
+    return value;
+}
+
+bool ZipEntryReader::Inflater::read(int bits, quint32 &value)
+{
+    if (!fill(bits)) {
+        return fail("压缩数据不完整");
+    }
+    value = take(bits);
+    return true;
+}
+
+bool ZipEntryReader::Inflater::fail(const QString &message)
+{
+    if (error.isEmpty()) {
+        error = message;
+    }
+    return false;
+}
+
+bool ZipEntryReader::Inflater::build(Huffman &huffman, const quint8 *lengths, int count)
+{
+    std::memset(huffman.count, 0, sizeof(huffman.count));
+    for (int symbol = 0; symbol < count; ++symbol) {
+        huffman.count[lengths[symbol]]++;
+    }
+    huffman.count[0] = 0;
+
+    // 码长分配不能超出编码空间（不完整的码是允许的，如只有一个距离码）
+    int left = 1;
+    for (int length = 1; length <= MAX_BITS; ++length) {
+        left <<= 1;
+        left -= huffman.count[length];
+        if (left < 0) {
+            return fail("Huffman 码长无效");
+        }
+    }
+
+    quint16 offsets[MAX_BITS + 2];
+    quint32 nextCode[MAX_BITS + 1];
+    offsets[1] = 0;
+    quint32 code = 0;
+    for (int length = 1; length <= MAX_BITS; ++length) {
+        offsets[length + 1] = offsets[length] + huffman.count[length];
+        code = (code + huffman.count[length - 1]) << 1;
+        nextCode[length] = code;
+    }
+
+    std::memset(huffman.fast, 0, sizeof(huffman.fast));
+    for (int symbol = 0; symbol < count; ++symbol) {
+        const int length = lengths[symbol];
+        if (length == 0) {
+            continue;
+        }
+        huffman.symbol[offsets[length]++] = static_cast<quint16>(symbol);
+
+        const quint32 symbolCode = nextCode[length]++;
+        if (length <= FAST_BITS) {
+            // 码按高位在前存储，流中按低位在前读取
+            const quint16 entry = static_cast<quint16>(symbol | (length << 9));
+            for (quint32 index = reverseBits(symbolCode, length); index < (1u << FAST_BITS); index += 1u << length) {
+                huffman.fast[index] = entry;
+            }
+        }
+    }
+    return true;
+}
+
+int ZipEntryReader::Inflater::decode(const Huffman &huffman)
+{
+    // 数据末尾可能不足 MAX_BITS 位，下面按实际位数校验
+    fill(MAX_BITS);
+
+    const quint16 entry = huffman.fast[bitBuffer & ((1u << FAST_BITS) - 1)];
+    if (entry != 0) {
+        const int length = entry >> 9;
+        if (length > bitCount) {
+            fail("压缩数据不完整");
+            return -1;
+        }
+        take(length);
+        return entry & 0x1FF;
+    }
+
+    // 长码逐位解码（规范 Huffman 码按码长递增排列）
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int length = 1; length <= MAX_BITS; ++length) {
+        if (length > bitCount) {
+            fail("压缩数据不完整");
+            return -1;
+        }
+        code |= static_cast<int>((bitBuffer >> (length - 1)) & 1);
+        const int count = huffman.count[length];
+        if (code - count < first) {
+            take(length);
+            return huffman.symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    fail("Huffman 码无效");
+    return -1;
+}
+
+void ZipEntryReader::Inflater::buildFixedTables()
+{
+    quint8 lengths[MAX_LITERAL_CODES];
+    std::fill(lengths, lengths + 144, 8);
+    std::fill(lengths + 144, lengths + 256, 9);
+    std::fill(lengths + 256, lengths + 280, 7);
+    std::fill(lengths + 280, lengths + MAX_LITERAL_CODES, 8);
+    build(literalCodes, lengths, MAX_LITERAL_CODES);
+
+    std::fill(lengths, lengths + MAX_DISTANCE_CODES, 5);
+    build(distanceCodes, lengths, MAX_DISTANCE_CODES);
+}
+
+bool ZipEntryReader::Inflater::readDynamicTables()
+{
+    quint32 literalCount = 0;
+    quint32 distanceCount = 0;
+    quint32 codeLengthCount = 0;
+    if (!read(5, literalCount) || !read(5, distanceCount) || !read(4, codeLengthCount)) {
+        return false;
+    }
+    literalCount += 257;
+    distanceCount += 1;
+    codeLengthCount += 4;
+    if (literalCount > 286 || distanceCount > 30) {
+        return fail("动态 Huffman 表头无效");
+    }
+
+    quint8 lengths[MAX_LITERAL_CODES + MAX_DISTANCE_CODES] = {};
+    for (quint32 i = 0; i < codeLengthCount; ++i) {
+        quint32 length = 0;
+        if (!read(3, length)) {
+            return false;
+        }
+        lengths[CODE_LENGTH_ORDER[i]] = static_cast<quint8>(length);
+    }
+
+    Huffman codeLengthCodes;
+    if (!build(codeLengthCodes, lengths, 19)) {
+        return false;
+    }
+
+    std::memset(lengths, 0, sizeof(lengths));
+    const quint32 total = literalCount + distanceCount;
+    quint32 index = 0;
+    while (index < total) {
+        const int symbol = decode(codeLengthCodes);
+        if (symbol < 0) {
+            return false;
+        }
+        if (symbol < 16) {
+            lengths[index++] = static_cast<quint8>(symbol);
+            continue;
+        }
+
+        quint8 length = 0;
+        quint32 repeat = 0;
+        if (symbol == 16) {
+            if (index == 0) {
+                return fail("动态 Huffman 表无效");
+            }
+            length = lengths[index - 1];
+            if (!read(2, repeat)) {
+                return false;
+            }
+            repeat += 3;
+        } else if (symbol == 17) {
+            if (!read(3, repeat)) {
+                return false;
+            }
+            repeat += 3;
+        } else {
+            if (!read(7, repeat)) {
+                return false;
+            }
+            repeat += 11;
+        }
+        if (index + repeat > total) {
+            return fail("动态 Huffman 表无效");
+        }
+        while (repeat-- > 0) {
+            lengths[index++] = length;
+        }
+    }
+
+    if (lengths[256] == 0) {
+        return fail("动态 Huffman 表缺少块结束码");
+    }
+    return build(literalCodes, lengths, static_cast<int>(literalCount))
+        && build(distanceCodes, lengths + literalCount, static_cast<int>(distanceCount));
+}
+
+bool ZipEntryReader::Inflater::readBlockHeader()
+{
+    quint32 header = 0;
+    if (!read(3, header)) {
+        return false;
+    }
+    lastBlock = (header & 1) != 0;
+
+    switch (header >> 1) {
+    case 0: {
+        // 未压缩块：跳到字节边界，之后是 LEN 与 NLEN
+        take(bitCount % 8);
+        quint32 length = 0;
+        quint32 complement = 0;
+        if (!read(16, length) || !read(16, complement)) {
+            return false;
+        }
+        if (length != (~complement & 0xFFFF)) {
+            return fail("未压缩块长度校验失败");
+        }
+        storedRemaining = length;
+        state = State::Stored;
+        return true;
+    }
+    case 1:
+        buildFixedTables();
+        state = State::Compressed;
+        return true;
+    case 2:
+        if (!readDynamicTables()) {
+            return false;
+        }
+        state = State::Compressed;
+        return true;
+    default:
+        return fail("压缩块类型无效");
+    }
+}
+
+qint64 ZipEntryReader::Inflater::inflate(char *out, qint64 maxSize)
+{
+    qint64 produced = 0;
+    while (produced < maxSize) {
+        if (copyLength > 0) {
+            const qint64 count = qMin<qint64>(copyLength, maxSize - produced);
+            for (qint64 i = 0; i < count; ++i) {
+                emitByte(out, produced, window[(windowPos - copyDistance) & (WINDOW_SIZE - 1)]);
+            }
+            copyLength -= static_cast<int>(count);
+            continue;
+        }
+
+        switch (state) {
+        case State::BlockHeader:
+            if (lastBlock) {
+                state = State::Done;
+            } else if (!readBlockHeader()) {
+                return -1;
+            }
+            break;
+
+        case State::Stored:
+            if (storedRemaining == 0) {
+                state = State::BlockHeader;
+                break;
+            }
+            while (storedRemaining > 0 && produced < maxSize) {
+                quint32 byte = 0;
+                if (!read(8, byte)) {
+                    return -1;
+                }
+                emitByte(out, produced, static_cast<quint8>(byte));
+                --storedRemaining;
+            }
+            break;
+
+        case State::Compressed: {
+            const int symbol = decode(literalCodes);
+            if (symbol < 0) {
+                return -1;
+            }
+            if (symbol < 256) {
+                emitByte(out, produced, static_cast<quint8>(symbol));
+                break;
+            }
+            if (symbol == 256) {
+                state = State::BlockHeader;
+                break;
+            }
+
+            const int lengthIndex = symbol - 257;
+            if (lengthIndex >= 29) {
+                fail("长度码无效");
+                return -1;
+            }
+            quint32 extra = 0;
+            if (!read(LENGTH_EXTRA[lengthIndex], extra)) {
+                return -1;
+            }
+            const int length = LENGTH_BASE[lengthIndex] + static_cast<int>(extra);
+
+            const int distanceIndex = decode(distanceCodes);
+            if (distanceIndex < 0) {
+                return -1;
+            }
+            if (distanceIndex >= 30) {
+                fail("距离码无效");
+                return -1;
+            }
+            if (!read(DISTANCE_EXTRA[distanceIndex], extra)) {
+                return -1;
+            }
+            const quint32 distance = DISTANCE_BASE[distanceIndex] + extra;
+            if (distance > windowPos) {
+                fail("距离超出已解压的数据");
+                return -1;
+            }
+            copyLength = length;
+            copyDistance = distance;
+            break;
+        }
+
+        case State::Done:
+            return produced;
+        }
+    }
+    return produced;
+}
+
+ZipArchive::ZipArchive()
+{
+}
+
+ZipArchive::~ZipArchive()
+{
+}
+
+bool ZipArchive::open(const QString &filePath)
+{
+    close();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = "无法打开文件: " + file.errorString();
+        return false;
+    }
+    if (!readCentralDirectory(file)) {
+        entries.clear();
+        return false;
+    }
+    path = filePath;
+    return true;
+}
+
+void ZipArchive::close()
+{
+    path.clear();
+    entries.clear();
+    error.clear();
+}
+
+const ZipArchive::Entry *ZipArchive::entry(const QString &name) const
+{
+    auto it = entries.constFind(name);
+    return it == entries.constEnd() ? nullptr : &it.value();
+}
+
+bool ZipArchive::readCentralDirectory(QFile &file)
+{
+    const qint64 fileSize = file.size();
+    if (fileSize < END_OF_DIRECTORY_SIZE) {
+        error = "不是有效的 ZIP 文件";
+        return false;
+    }
+
+    // 目录结束记录位于文件末尾，其后最多跟一段注释
+    const qint64 tailSize = qMin<qint64>(fileSize, END_OF_DIRECTORY_SIZE + MAX_COMMENT_SIZE);
+    const qint64 tailOffset = fileSize - tailSize;
+    file.seek(tailOffset);
+    const QByteArray tail = file.read(tailSize);
+    if (tail.size() != tailSize) {
+        error = "读取文件失败: " + file.errorString();
+        return false;
+    }
+
+    qint64 endRecord = -1;
+    for (qint64 i = tail.size() - END_OF_DIRECTORY_SIZE; i >= 0; --i) {
+        if (readU32(tail.constData() + i) == END_OF_DIRECTORY_SIGNATURE) {
+            endRecord = i;
+            break;
+        }
+    }
+    if (endRecord < 0) {
+        error = "不是有效的 ZIP 文件（找不到目录结束记录）";
+        return false;
+    }
+
+    const char *record = tail.constData() + endRecord;
+    quint64 entryCount = readU16(record + 10);
+    quint64 directorySize = readU32(record + 12);
+    quint64 directoryOffset = readU32(record + 16);
+
+    // ZIP64：目录结束记录前有定位记录，给出 ZIP64 目录结束记录的位置
+    if (entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF) {
+        const qint64 locatorOffset = tailOffset + endRecord - ZIP64_LOCATOR_SIZE;
+        if (locatorOffset < 0 || !file.seek(locatorOffset)) {
+            error = "ZIP64 目录定位记录缺失";
+            return false;
+        }
+        const QByteArray locator = file.read(ZIP64_LOCATOR_SIZE);
+        if (locator.size() != ZIP64_LOCATOR_SIZE || readU32(locator.constData()) != ZIP64_LOCATOR_SIGNATURE) {
+            error = "ZIP64 目录定位记录缺失";
+            return false;
+        }
+        const quint64 zip64Offset = readU64(locator.constData() + 8);
+        if (!file.seek(static_cast<qint64>(zip64Offset))) {
+            error = "ZIP64 目录结束记录无效";
+            return false;
+        }
+        const QByteArray zip64Record = file.read(ZIP64_END_OF_DIRECTORY_SIZE);
+        if (zip64Record.size() != ZIP64_END_OF_DIRECTORY_SIZE
+            || readU32(zip64Record.constData()) != ZIP64_END_OF_DIRECTORY_SIGNATURE) {
+            error = "ZIP64 目录结束记录无效";
+            return false;
+        }
+        entryCount = readU64(zip64Record.constData() + 32);
+        directorySize = readU64(zip64Record.constData() + 40);
+        directoryOffset = readU64(zip64Record.constData() + 48);
+    }
+
+    if (directorySize > static_cast<quint64>(MAX_CENTRAL_DIRECTORY_SIZE)
+        || directoryOffset + directorySize > static_cast<quint64>(fileSize)) {
+        error = "ZIP 中央目录无效";
+        return false;
+    }
+
+    file.seek(static_cast<qint64>(directoryOffset));
+    const QByteArray directory = file.read(static_cast<qint64>(directorySize));
+    if (directory.size() != static_cast<qint64>(directorySize)) {
+        error = "读取 ZIP 中央目录失败: " + file.errorString();
+        return false;
+    }
+
+    const char *p = directory.constData();
+    const char *end = p + directory.size();
+    entries.reserve(static_cast<int>(qMin<quint64>(entryCount, 65536)));
+    for (quint64 i = 0; i < entryCount; ++i) {
+        if (end - p < CENTRAL_HEADER_SIZE || readU32(p) != CENTRAL_HEADER_SIGNATURE) {
+            error = "ZIP 中央目录损坏";
+            return false;
+        }
+
+        Entry entry;
+        entry.flags = readU16(p + 8);
+        entry.method = readU16(p + 10);
+        entry.crc32 = readU32(p + 16);
+        entry.compressedSize = readU32(p + 20);
+        entry.uncompressedSize = readU32(p + 24);
+        const int nameLength = readU16(p + 28);
+        const int extraLength = readU16(p + 30);
+        const int commentLength = readU16(p + 32);
+        entry.localHeaderOffset = readU32(p + 42);
+
+        const char *name = p + CENTRAL_HEADER_SIZE;
+        const char *extra = name + nameLength;
+        const char *next = extra + extraLength + commentLength;
+        if (next > end) {
+            error = "ZIP 中央目录损坏";
+            return false;
+        }
+        // XLSX 中的条目名都是 ASCII，未标记 UTF-8 的名称也按 UTF-8 解码
+        entry.name = QString::fromUtf8(name, nameLength);
+
+        // ZIP64 扩展字段按顺序给出取值为 0xFFFFFFFF 的字段
+        for (const char *field = extra; field + 4 <= extra + extraLength;) {
+            const quint16 id = readU16(field);
+            const quint16 size = readU16(field + 2);
+            const char *value = field + 4;
+            const char *valueEnd = value + size;
+            if (valueEnd > extra + extraLength) {
+                break;
+            }
+            if (id == ZIP64_EXTRA_ID) {
+                if (entry.uncompressedSize == 0xFFFFFFFF && value + 8 <= valueEnd) {
+                    entry.uncompressedSize = static_cast<qint64>(readU64(value));
+                    value += 8;
+                }
+                if (entry.compressedSize == 0xFFFFFFFF && value + 8 <= valueEnd) {
+                    entry.compressedSize = static_cast<qint64>(readU64(value));
+                    value += 8;
+                }
+                if (entry.localHeaderOffset == 0xFFFFFFFF && value + 8 <= valueEnd) {
+                    entry.localHeaderOffset = static_cast<qint64>(readU64(value));
+                }
+            }
+            field = valueEnd;
+        }
+
+        entries.insert(entry.name, entry);
+        p = next;
+    }
+    return true;
+}
+
+std::unique_ptr<ZipEntryReader> ZipArchive::openEntry(const QString &name)
+{
+    const Entry *info = entry(name);
+    if (!info) {
+        error = "ZIP 中缺少条目: " + name;
+        return nullptr;
+    }
+    if (info->flags & FLAG_ENCRYPTED) {
+        error = "不支持加密的条目: " + name;
+        return nullptr;
+    }
+    if (info->method != METHOD_STORED && info->method != METHOD_DEFLATE) {
+        error = QString("不支持的压缩方式 %1: %2").arg(info->method).arg(name);
+        return nullptr;
+    }
+
+    std::unique_ptr<ZipEntryReader> reader(new ZipEntryReader(*info, path));
+    QString startError;
+    if (!reader->start(startError)) {
+        error = startError;
+        return nullptr;
+    }
+    return reader;
+}
+
+ZipEntryReader::ZipEntryReader(const ZipArchive::Entry &entry, const QString &filePath)
+    : info(entry)
+    , file(filePath)
+    , storedPosition(0)
+    , produced(0)
+    , crc(0)
+    , failed(false)
+{
+}
+
+ZipEntryReader::~ZipEntryReader()
+{
+}
+
+bool ZipEntryReader::start(QString &error)
+{
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = "无法打开文件: " + file.errorString();
+        return false;
+    }
+
+    // 本地文件头的名称与扩展字段长度可能与中央目录不同，以本地头为准
+    QByteArray header;
+    if (file.seek(info.localHeaderOffset)) {
+        header = file.read(LOCAL_HEADER_SIZE);
+    }
+    if (header.size() != LOCAL_HEADER_SIZE || readU32(header.constData()) != LOCAL_HEADER_SIGNATURE) {
+        error = "ZIP 本地文件头无效: " + info.name;
+        return false;
+    }
+    const qint64 dataOffset = info.localHeaderOffset + LOCAL_HEADER_SIZE
+        + readU16(header.constData() + 26) + readU16(header.constData() + 28);
+    if (!file.seek(dataOffset) || dataOffset + info.compressedSize > file.size()) {
+        error = "ZIP 条目数据不完整: " + info.name;
+        return false;
+    }
+
+    if (info.method == ZipArchive::METHOD_DEFLATE) {
+        inflater = std::make_unique<Inflater>(&file, info.compressedSize);
+    }
+    return QIODevice::open(QIODevice::ReadOnly);
+}
+
+qint64 ZipEntryReader::bytesAvailable() const
+{
+    return QIODevice::bytesAvailable() + (info.uncompressedSize - produced);
+}
+
+qint64 ZipEntryReader::compressedPosition() const
+{
+    return inflater ? inflater->consumedBytes() : storedPosition;
+}
+
+qint64 ZipEntryReader::readData(char *data, qint64 maxSize)
+{
+    qint64 count = 0;
+    if (inflater) {
+        count = inflater->inflate(data, maxSize);
+        if (count < 0) {
+            setErrorString(inflater->errorString() + ": " + info.name);
+            failed = true;
+            qWarning() << "ZIP 条目解压失败:" << errorString();
+            return -1;
+        }
+    } else {
+        count = file.read(data, qMin(maxSize, info.compressedSize - storedPosition));
+        if (count < 0) {
+            setErrorString(file.errorString());
+            failed = true;
+            return -1;
+        }
+        storedPosition += count;
+    }
+
+    crc = updateCrc(crc, data, count);
+    produced += count;
+
+    const bool finished = inflater ? inflater->isFinished() : storedPosition >= info.compressedSize;
+    if (count == 0 || finished) {
+        if (produced != info.uncompressedSize || crc != info.crc32) {
+            setErrorString("ZIP 条目校验失败: " + info.name);
+            failed = true;
+            qWarning() << errorString();
+            return -1;
+        }
+    }
+    return count;
+}
+
+qint64 ZipEntryReader::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
@@ -0,0 +1,113 @@
+#ifndef ZIPARCHIVE_H
+#define ZIPARCHIVE_H
+
+#include <QIODevice>
+#include <QFile>
+#include <QString>
+#include <QHash>
+#include <memory>
+
+class ZipEntryReader;
+
+/**
+ * @brief 只读 ZIP 归档
+ *
+ * 读取中央目录（支持 ZIP64），按名称打开条目的解压流。
+ * 只支持未压缩（stored）与 deflate 两种方式，不支持加密条目。
+ * 条目流边读边解压，内存占用与条目大小无关，可用于 XLSX 等大文件。
+ *
+ * 用法：
+ *   ZipArchive archive;
+ *   if (!archive.open(filePath)) { ... archive.errorString() ... }
+ *   std::unique_ptr<ZipEntryReader> entry = archive.openEntry("xl/workbook.xml");
+ *   QByteArray content = entry->readAll();
+ */
+class ZipArchive
+{
+public:
+    struct Entry {
+        QString name;
+        quint16 flags = 0;
+        quint16 method = 0;             // 0 未压缩，8 deflate
+        quint32 crc32 = 0;
+        qint64 compressedSize = 0;
+        qint64 uncompressedSize = 0;
+        qint64 localHeaderOffset = 0;
+    };
+
+    static const quint16 METHOD_STORED = 0;
+    static const quint16 METHOD_DEFLATE = 8;
+
+    ZipArchive();
+    ~ZipArchive();
+
+    // 打开归档并读取中央目录
+    bool open(const QString &filePath);
+    void close();
+
+    QString errorString() const { return error; }
+
+    bool contains(const QString &name) const { return entries.contains(name); }
+
+    // 条目信息，不存在时返回 nullptr
+    const Entry *entry(const QString &name) const;
+
+    // 打开条目的解压流（顺序读取），失败返回 nullptr
+    std::unique_ptr<ZipEntryReader> openEntry(const QString &name);
+
+private:
+    bool readCentralDirectory(QFile &file);
+
+    QString path;
+    QHash<QString, Entry> entries;
+    QString error;
+};
+
+/**
+ * @brief ZIP 条目的解压流
+ *
+ * 顺序设备：每次 read() 从文件读入所需的压缩数据并解压，解压窗口固定 32KB。
+ * 读到末尾时校验 CRC32，数据损坏时 read() 返回 -1，原因见 errorString()。
+ */
+class ZipEntryReader : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    ~ZipEntryReader() override;
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+    const ZipArchive::Entry &entry() const { return info; }
+
+    // 解压或校验是否出错，原因见 errorString()
+    bool hasError() const { return failed; }
+
+    // 已读取的压缩数据字节数，用于显示进度
+    qint64 compressedPosition() const;
+    qint64 compressedSize() const { return info.compressedSize; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    friend class ZipArchive;
+    class Inflater;
+
+    ZipEntryReader(const ZipArchive::Entry &entry, const QString &filePath);
+
+    // 打开文件并定位到条目数据
+    bool start(QString &error);
+
+    ZipArchive::Entry info;
+    QFile file;
+    std::unique_ptr<Inflater> inflater;     // deflate 条目
+    qint64 storedPosition;                  // 未压缩条目已读字节数
+    qint64 produced;                        // 已输出的解压字节数
+    quint32 crc;
+    bool failed;
+};
+
+#endif // ZIPARCHIVE_H
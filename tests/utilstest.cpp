@@ -0,0 +1,806 @@
+/**
+ * 工具类单元测试
+ *
+ * ZipArchive：未压缩条目、固定/动态 Huffman 的 deflate 条目、ZIP64 目录与 CRC 校验失败；
+ * XlsxReader：共享字符串、内联字符串与 r= 行列号不连续的工作表；
+ * CsvTokenizer：RFC 4180 的引号字段、"" 转义、字段内换行与各种行尾；
+ * PickingBvh：随机场景中与逐个图元暴力求交的结果比对。
+ *
+ * 测试用的 ZIP 文件在临时目录中生成，deflate 数据取自 qCompress（zlib）去掉头尾后的原始流。
+ *
+ * 用法：
+ *   qmake UtilsTest.pro && make && make check
+ */
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include <cmath>
+#include "../src/utils/ZipArchive.h"
+#include "../src/utils/XlsxReader.h"
+#include "../src/utils/CsvTokenizer.h"
+#include "../src/utils/PickingBvh.h"
+
+namespace {
+
+// ZIP 记录签名
+const quint32 LOCAL_HEADER_SIGNATURE = 0x04034b50;
+const quint32 CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+const quint32 END_OF_DIRECTORY_SIGNATURE = 0x06054b50;
+const quint32 ZIP64_END_OF_DIRECTORY_SIGNATURE = 0x06064b50;
+const quint32 ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+const quint16 ZIP64_EXTRA_ID = 0x0001;
+
+// deflate 块头中的块类型（BTYPE）
+const int BLOCK_FIXED_HUFFMAN = 1;
+const int BLOCK_DYNAMIC_HUFFMAN = 2;
+
+// BVH 比对：随机场景的规模与射线数，固定种子保证结果可复现
+const quint32 BVH_SEED = 20240611;
+const int BVH_TRIANGLE_COUNT = 2000;
+const int BVH_BOX_COUNT = 200;
+const int BVH_RAY_COUNT = 2000;
+const float BVH_DISTANCE_TOLERANCE = 1e-3f;
+
+struct ZipItem {
+    QByteArray name;
+    QByteArray data;                                // 解压后的内容
+    quint16 method = ZipArchive::METHOD_STORED;
+    quint32 crcMask = 0;                            // 非0时写入错误的 CRC
+};
+
+template <typename T>
+void put(QByteArray &out, T value)
+{
+    value = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+quint32 crc32(const QByteArray &data)
+{
+    quint32 crc = 0xFFFFFFFFu;
+    for (char c : data) {
+        crc ^= static_cast<uchar>(c);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+// qCompress 的输出为 4 字节长度 + zlib 流（2 字节头、原始 deflate、4 字节 Adler-32）
+QByteArray rawDeflate(const QByteArray &data)
+{
+    const QByteArray zlib = qCompress(data);
+    return zlib.mid(6, zlib.size() - 10);
+}
+
+int firstBlockType(const QByteArray &deflated)
+{
+    return (static_cast<uchar>(deflated.at(0)) >> 1) & 3;
+}
+
+// 生成 ZIP 文件内容；zip64 为 true 时大小与偏移只写在 ZIP64 扩展字段和 ZIP64 目录结束记录中
+QByteArray buildZip(const QVector<ZipItem> &items, bool zip64 = false)
+{
+    QByteArray out;
+    QByteArray directory;
+    for (const ZipItem &item : items) {
+        const QByteArray payload = (item.method == ZipArchive::METHOD_DEFLATE) ? rawDeflate(item.data) : item.data;
+        const quint32 crc = crc32(item.data) ^ item.crcMask;
+        const quint64 offset = out.size();
+
+        put<quint32>(out, LOCAL_HEADER_SIGNATURE);
+        put<quint16>(out, 20);                      // 解压所需版本
+        put<quint16>(out, 0);                       // 标志
+        put<quint16>(out, item.method);
+        put<quint32>(out, 0);                       // 修改时间与日期
+        put<quint32>(out, crc);
+        put<quint32>(out, static_cast<quint32>(payload.size()));
+        put<quint32>(out, static_cast<quint32>(item.data.size()));
+        put<quint16>(out, static_cast<quint16>(item.name.size()));
+        put<quint16>(out, 0);                       // 扩展字段长度
+        out.append(item.name);
+        out.append(payload);
+
+        QByteArray extra;
+        if (zip64) {
+            put<quint16>(extra, ZIP64_EXTRA_ID);
+            put<quint16>(extra, 24);
+            put<quint64>(extra, static_cast<quint64>(item.data.size()));
+            put<quint64>(extra, static_cast<quint64>(payload.size()));
+            put<quint64>(extra, offset);
+        }
+
+        put<quint32>(directory, CENTRAL_HEADER_SIGNATURE);
+        put<quint16>(directory, zip64 ? 45 : 20);   // 创建版本
+        put<quint16>(directory, zip64 ? 45 : 20);   // 解压所需版本
+        put<quint16>(directory, 0);
+        put<quint16>(directory, item.method);
+        put<quint32>(directory, 0);
+        put<quint32>(directory, crc);
+        put<quint32>(directory, zip64 ? 0xFFFFFFFFu : static_cast<quint32>(payload.size()));
+        put<quint32>(directory, zip64 ? 0xFFFFFFFFu : static_cast<quint32>(item.data.size()));
+        put<quint16>(directory, static_cast<quint16>(item.name.size()));
+        put<quint16>(directory, static_cast<quint16>(extra.size()));
+        put<quint16>(directory, 0);                 // 注释长度
+        put<quint16>(directory, 0);                 // 起始磁盘
+        put<quint16>(directory, 0);                 // 内部属性
+        put<quint32>(directory, 0);                 // 外部属性
+        put<quint32>(directory, zip64 ? 0xFFFFFFFFu : static_cast<quint32>(offset));
+        directory.append(item.name);
+        directory.append(extra);
+    }
+
+    const quint64 directoryOffset = out.size();
+    out.append(directory);
+
+    if (zip64) {
+        const quint64 zip64Offset = out.size();
+        put<quint32>(out, ZIP64_END_OF_DIRECTORY_SIGNATURE);
+        put<quint64>(out, 44);                      // 记录其余部分的长度
+        put<quint16>(out, 45);
+        put<quint16>(out, 45);
+        put<quint32>(out, 0);                       // 本磁盘号
+        put<quint32>(out, 0);                       // 目录所在磁盘
+        put<quint64>(out, static_cast<quint64>(items.size()));
+        put<quint64>(out, static_cast<quint64>(items.size()));
+        put<quint64>(out, static_cast<quint64>(directory.size()));
+        put<quint64>(out, directoryOffset);
+
+        put<quint32>(out, ZIP64_LOCATOR_SIGNATURE);
+        put<quint32>(out, 0);
+        put<quint64>(out, zip64Offset);
+        put<quint32>(out, 1);                       // 磁盘总数
+    }
+
+    put<quint32>(out, END_OF_DIRECTORY_SIGNATURE);
+    put<quint16>(out, 0);
+    put<quint16>(out, 0);
+    put<quint16>(out, zip64 ? 0xFFFF : static_cast<quint16>(items.size()));
+    put<quint16>(out, zip64 ? 0xFFFF : static_cast<quint16>(items.size()));
+    put<quint32>(out, zip64 ? 0xFFFFFFFFu : static_cast<quint32>(directory.size()));
+    put<quint32>(out, zip64 ? 0xFFFFFFFFu : static_cast<quint32>(directoryOffset));
+    put<quint16>(out, 0);                           // 注释长度
+    return out;
+}
+
+QString writeFile(const QTemporaryDir &dir, const QString &name, const QByteArray &content)
+{
+    const QString path = dir.filePath(name);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+        return QString();
+    }
+    return path;
+}
+
+// 字段多、重复度适中的文本，zlib 会使用动态 Huffman 编码
+QByteArray excavationLog(int rows)
+{
+    QByteArray text;
+    for (int i = 0; i < rows; ++i) {
+        text += QByteArray::number(i) + ',' + QByteArray::number(i * 7 % 1000) + '.'
+              + QByteArray::number(i % 100).rightJustified(2, '0') + ",segment-" + QByteArray::number(i % 37) + '\n';
+    }
+    return text;
+}
+
+const QByteArray WORKBOOK_XML =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+    "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\""
+    " xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+    "<sheets><sheet name=\"掘进参数\" sheetId=\"1\" r:id=\"rId1\"/></sheets></workbook>";
+
+const QByteArray WORKBOOK_RELS_XML =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+    "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\""
+    " Target=\"worksheets/data.xml\"/>"
+    "<Relationship Id=\"rId2\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings\""
+    " Target=\"strings.xml\"/></Relationships>";
+
+const QByteArray SHARED_STRINGS_XML =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+    "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" count=\"3\" uniqueCount=\"3\">"
+    "<si><t>环号</t></si>"
+    "<si><r><t>总</t></r><r><rPr><b/></rPr><t>推力</t></r><rPh><t>すいりょく</t></rPh></si>"
+    "<si><t>含 &amp; 符号</t></si></sst>";
+
+// 关系文件把工作表与共享字符串指向非默认路径，验证按关系文件解析
+QString writeXlsx(const QTemporaryDir &dir, const QString &name, const QByteArray &sheetData)
+{
+    const QByteArray sheet =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">"
+        "<dimension ref=\"A1:D6\"/><sheetData>" + sheetData + "</sheetData></worksheet>";
+
+    QVector<ZipItem> items(4);
+    items[0].name = "xl/workbook.xml";
+    items[0].data = WORKBOOK_XML;
+    items[1].name = "xl/_rels/workbook.xml.rels";
+    items[1].data = WORKBOOK_RELS_XML;
+    items[2].name = "xl/strings.xml";
+    items[2].data = SHARED_STRINGS_XML;
+    items[2].method = ZipArchive::METHOD_DEFLATE;
+    items[3].name = "xl/worksheets/data.xml";
+    items[3].data = sheet;
+    items[3].method = ZipArchive::METHOD_DEFLATE;
+    return writeFile(dir, name, buildZip(items));
+}
+
+QStringList rowFields(const CsvTokenizer::Row &row)
+{
+    QStringList fields;
+    for (int i = 0; i < row.size(); ++i) {
+        fields.append(row[i].toString());
+    }
+    return fields;
+}
+
+float uniform(QRandomGenerator &random, float low, float high)
+{
+    return low + static_cast<float>(random.generateDouble()) * (high - low);
+}
+
+QVector3D randomPoint(QRandomGenerator &random, float extent)
+{
+    return QVector3D(uniform(random, -extent, extent), uniform(random, -extent, extent),
+                     uniform(random, -extent, extent));
+}
+
+// 暴力求交的对照实现：与 PickingBvh 相同的判定（不区分正反面、起点容差、起点在盒内时距离为0）
+struct ReferenceTriangle {
+    QVector3D a;
+    QVector3D b;
+    QVector3D c;
+    int id;
+};
+
+struct ReferenceBox {
+    QVector3D boxMin;
+    QVector3D boxMax;
+    int id;
+};
+
+bool referenceTriangle(const ReferenceTriangle &triangle, const QVector3D &origin, const QVector3D &direction,
+                       float &distance)
+{
+    const QVector3D edge1 = triangle.b - triangle.a;
+    const QVector3D edge2 = triangle.c - triangle.a;
+    const QVector3D p = QVector3D::crossProduct(direction, edge2);
+    const float det = QVector3D::dotProduct(edge1, p);
+    if (std::abs(det) < 1e-12f) {
+        return false;
+    }
+    const float inverseDet = 1.0f / det;
+    const QVector3D t = origin - triangle.a;
+    const float u = QVector3D::dotProduct(t, p) * inverseDet;
+    const QVector3D q = QVector3D::crossProduct(t, edge1);
+    const float v = QVector3D::dotProduct(direction, q) * inverseDet;
+    if (u < 0.0f || v < 0.0f || u > 1.0f || u + v > 1.0f) {
+        return false;
+    }
+    distance = QVector3D::dotProduct(edge2, q) * inverseDet;
+    return distance > 1e-5f;
+}
+
+bool referenceBox(const ReferenceBox &box, const QVector3D &origin, const QVector3D &direction, float &distance)
+{
+    float tNear = 0.0f;
+    float tFar = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (direction[axis] == 0.0f) {
+            if (origin[axis] < box.boxMin[axis] || origin[axis] > box.boxMax[axis]) {
+                return false;
+            }
+            continue;
+        }
+        const float inverse = 1.0f / direction[axis];
+        float t1 = (box.boxMin[axis] - origin[axis]) * inverse;
+        float t2 = (box.boxMax[axis] - origin[axis]) * inverse;
+        if (t1 > t2) {
+            std::swap(t1, t2);
+        }
+        tNear = qMax(tNear, t1);
+        tFar = qMin(tFar, t2);
+    }
+    distance = tNear;
+    return tNear <= tFar;
+}
+
+} // namespace
+
+class UtilsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // ZipArchive
+    void zipStoredEntry();
+    void zipFixedHuffman();
+    void zipDynamicHuffman();
+    void zip64Directory();
+    void zipBadCrc_data();
+    void zipBadCrc();
+    void zipNotAnArchive();
+
+    // XlsxReader
+    void xlsxSharedAndInlineStrings();
+    void xlsxInvalidSharedString();
+
+    // CsvTokenizer
+    void csvFields_data();
+    void csvFields();
+    void csvEscapedQuotes();
+    void csvBlankRowsAndNumbers();
+    void csvOpenSkipsBom();
+    void csvAppendRowRoundTrip();
+
+    // PickingBvh
+    void bvhMatchesBruteForce();
+    void bvhAxisAlignedRay();
+
+private:
+    QTemporaryDir dir;
+};
+
+void UtilsTest::initTestCase()
+{
+    QVERIFY(dir.isValid());
+}
+
+void UtilsTest::zipStoredEntry()
+{
+    ZipItem item;
+    item.name = "notes/readme.txt";
+    item.data = "盾构掘进参数\nring,thrust\n";
+    const QString path = writeFile(dir, "stored.zip", buildZip({ item }));
+    QVERIFY(!path.isEmpty());
+
+    ZipArchive archive;
+    QVERIFY2(archive.open(path), qPrintable(archive.errorString()));
+    QVERIFY(archive.contains("notes/readme.txt"));
+    QVERIFY(!archive.contains("notes/other.txt"));
+    QCOMPARE(archive.entry("notes/readme.txt")->method, quint16(ZipArchive::METHOD_STORED));
+
+    std::unique_ptr<ZipEntryReader> reader = archive.openEntry("notes/readme.txt");
+    QVERIFY2(reader, qPrintable(archive.errorString()));
+    QCOMPARE(reader->readAll(), item.data);
+    QVERIFY(!reader->hasError());
+
+    QVERIFY(!archive.openEntry("notes/other.txt"));
+}
+
+void UtilsTest::zipFixedHuffman()
+{
+    ZipItem item;
+    item.name = "short.txt";
+    item.data = "hello hello hello shield tunnel";
+    item.method = ZipArchive::METHOD_DEFLATE;
+    QCOMPARE(firstBlockType(rawDeflate(item.data)), BLOCK_FIXED_HUFFMAN);
+
+    const QString path = writeFile(dir, "fixed.zip", buildZip({ item }));
+    ZipArchive archive;
+    QVERIFY2(archive.open(path), qPrintable(archive.errorString()));
+    std::unique_ptr<ZipEntryReader> reader = archive.openEntry("short.txt");
+    QVERIFY2(reader, qPrintable(archive.errorString()));
+    QCOMPARE(reader->readAll(), item.data);
+    QVERIFY(!reader->hasError());
+}
+
+void UtilsTest::zipDynamicHuffman()
+{
+    ZipItem item;
+    item.name = "log.csv";
+    item.data = excavationLog(2000);
+    item.method = ZipArchive::METHOD_DEFLATE;
+    QCOMPARE(firstBlockType(rawDeflate(item.data)), BLOCK_DYNAMIC_HUFFMAN);
+
+    const QString path = writeFile(dir, "dynamic.zip", buildZip({ item }));
+    ZipArchive archive;
+    QVERIFY2(archive.open(path), qPrintable(archive.errorString()));
+    std::unique_ptr<ZipEntryReader> reader = archive.openEntry("log.csv");
+    QVERIFY2(reader, qPrintable(archive.errorString()));
+
+    // 小块读取，覆盖跨越回溯窗口与块边界的增量解压
+    QByteArray content;
+    char buffer[997];
+    qint64 count = 0;
+    while ((count = reader->read(buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, count);
+    }
+    QCOMPARE(count, qint64(0));
+    QVERIFY(!reader->hasError());
+    QCOMPARE(content.size(), item.data.size());
+    QCOMPARE(content, item.data);
+    QCOMPARE(reader->compressedPosition(), reader->compressedSize());
+}
+
+void UtilsTest::zip64Directory()
+{
+    QVector<ZipItem> items(2);
+    items[0].name = "first.txt";
+    items[0].data = "first entry";
+    items[1].name = "second.csv";
+    items[1].data = excavationLog(300);
+    items[1].method = ZipArchive::METHOD_DEFLATE;
+    const QString path = writeFile(dir, "zip64.zip", buildZip(items, true));
+
+    ZipArchive archive;
+    QVERIFY2(archive.open(path), qPrintable(archive.errorString()));
+    const ZipArchive::Entry *second = archive.entry("second.csv");
+    QVERIFY(second);
+    QCOMPARE(second->uncompressedSize, qint64(items[1].data.size()));
+    QCOMPARE(second->compressedSize, qint64(rawDeflate(items[1].data).size()));
+    QVERIFY(second->localHeaderOffset > 0);
+
+    for (const ZipItem &item : items) {
+        std::unique_ptr<ZipEntryReader> reader = archive.openEntry(QString::fromUtf8(item.name));
+        QVERIFY2(reader, qPrintable(archive.errorString()));
+        QCOMPARE(reader->readAll(), item.data);
+        QVERIFY(!reader->hasError());
+    }
+}
+
+void UtilsTest::zipBadCrc_data()
+{
+    QTest::addColumn<quint16>("method");
+    QTest::newRow("stored") << quint16(ZipArchive::METHOD_STORED);
+    QTest::newRow("deflate") << quint16(ZipArchive::METHOD_DEFLATE);
+}
+
+void UtilsTest::zipBadCrc()
+{
+    QFETCH(quint16, method);
+
+    ZipItem item;
+    item.name = "corrupt.csv";
+    item.data = excavationLog(100);
+    item.method = method;
+    item.crcMask = 0x00010000;
+    const QString path = writeFile(dir, QString("badcrc-%1.zip").arg(method), buildZip({ item }));
+
+    ZipArchive archive;
+    QVERIFY2(archive.open(path), qPrintable(archive.errorString()));
+    std::unique_ptr<ZipEntryReader> reader = archive.openEntry("corrupt.csv");
+    QVERIFY2(reader, qPrintable(archive.errorString()));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("ZIP 条目校验失败"));
+    reader->readAll();
+    QVERIFY(reader->hasError());
+    QVERIFY(reader->errorString().contains("校验失败"));
+}
+
+void UtilsTest::zipNotAnArchive()
+{
+    const QString path = writeFile(dir, "plain.zip", QByteArray(512, 'x'));
+    ZipArchive archive;
+    QVERIFY(!archive.open(path));
+    QVERIFY(!archive.errorString().isEmpty());
+}
+
+void UtilsTest::xlsxSharedAndInlineStrings()
+{
+    // 第2行缺 B 列，第3、4行整行缺失，第5行从 B 列开始，最后一行没有 r 属性
+    const QByteArray sheetData =
+        "<row r=\"1\"><c r=\"A1\" t=\"s\"><v>0</v></c><c r=\"B1\" t=\"s\"><v>1</v></c>"
+        "<c r=\"C1\" t=\"inlineStr\"><is><t>备注</t></is></c></row>"
+        "<row r=\"2\"><c r=\"A2\"><v>12.5</v></c>"
+        "<c r=\"C2\" t=\"inlineStr\"><is><r><t>inline, </t></r><r><t>\"text\"</t></r></is></c></row>"
+        "<row r=\"5\" spans=\"2:4\"><c r=\"B5\" t=\"b\"><v>1</v></c><c r=\"D5\" t=\"s\"><v>2</v></c></row>"
+        "<row><c><f>SUM(A1:A2)</f><v>7</v></c><c><v>8</v></c></row>";
+    const QString path = writeXlsx(dir, "strings.xlsx", sheetData);
+    QVERIFY(!path.isEmpty());
+
+    XlsxReader reader;
+    QVERIFY2(reader.open(path), qPrintable(reader.errorString()));
+    QCOMPARE(reader.sheetName(), QString("掘进参数"));
+
+    CsvTokenizer::Row row;
+    QVERIFY(reader.readRow(row));
+    QCOMPARE(row.number, qint64(1));
+    QCOMPARE(rowFields(row), QStringList{ "环号", "总推力", "备注" });
+
+    QVERIFY(reader.readRow(row));
+    QCOMPARE(row.number, qint64(2));
+    QCOMPARE(rowFields(row), QStringList{ "12.5", "", "inline, \"text\"" });
+    QCOMPARE(row[0].toDouble(), 12.5);
+
+    QVERIFY(reader.readRow(row));
+    QCOMPARE(row.number, qint64(5));
+    QCOMPARE(rowFields(row), QStringList{ "", "TRUE", "", "含 & 符号" });
+
+    QVERIFY(reader.readRow(row));
+    QCOMPARE(row.number, qint64(6));
+    QCOMPARE(rowFields(row), QStringList{ "7", "8" });
+
+    QVERIFY(!reader.readRow(row));
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+}
+
+void UtilsTest::xlsxInvalidSharedString()
+{
+    const QByteArray sheetData =
+        "<row r=\"1\"><c r=\"A1\" t=\"s\"><v>0</v></c></row>"
+        "<row r=\"2\"><c r=\"A2\" t=\"s\"><v>9</v></c></row>";
+    const QString path = writeXlsx(dir, "invalid.xlsx", sheetData);
+
+    XlsxReader reader;
+    QVERIFY2(reader.open(path), qPrintable(reader.errorString()));
+    CsvTokenizer::Row row;
+    QVERIFY(reader.readRow(row));
+    QCOMPARE(rowFields(row), QStringList{ "环号" });
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("共享字符串序号无效"));
+    QVERIFY(!reader.readRow(row));
+    QVERIFY(reader.hasError());
+}
+
+void UtilsTest::csvFields_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QStringList>("rows");      // 每行的字段以 | 连接
+
+    QTest::newRow("plain") << QByteArray("a,b,c\n1,2,3\n")
+                           << QStringList{ "a|b|c", "1|2|3" };
+    QTest::newRow("no final line break") << QByteArray("a,b\n1,2")
+                                         << QStringList{ "a|b", "1|2" };
+    QTest::newRow("crlf") << QByteArray("a,b\r\n1,2\r\n")
+                          << QStringList{ "a|b", "1|2" };
+    QTest::newRow("bare cr") << QByteArray("a,b\r1,2\r")
+                             << QStringList{ "a|b", "1|2" };
+    QTest::newRow("empty fields") << QByteArray(",,\na,,b\n")
+                                  << QStringList{ "||", "a||b" };
+    QTest::newRow("quoted comma") << QByteArray("\"a,b\",c\n")
+                                  << QStringList{ "a,b|c" };
+    QTest::newRow("quoted line breaks") << QByteArray("\"line1\nline2\",x\r\n\"crlf\r\ninside\",y\n")
+                                        << QStringList{ "line1\nline2|x", "crlf\r\ninside|y" };
+    QTest::newRow("escaped quotes") << QByteArray("\"say \"\"hi\"\"\",\"\"\"\"\n")
+                                    << QStringList{ "say \"hi\"|\"" };
+    QTest::newRow("empty quoted") << QByteArray("\"\",\"\"\n")
+                                  << QStringList{ "|" };
+    QTest::newRow("quote inside unquoted") << QByteArray("5\" pipe,x\n")
+                                           << QStringList{ "5\" pipe|x" };
+    QTest::newRow("trimmed") << QByteArray(" a ,\tb\t\n")
+                             << QStringList{ "a|b" };
+    QTest::newRow("unterminated quote") << QByteArray("a,\"open\nstill open")
+                                        << QStringList{ "a|open\nstill open" };
+    QTest::newRow("utf8") << QByteArray("环号,推力\n")
+                          << QStringList{ "环号|推力" };
+}
+
+void UtilsTest::csvFields()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QStringList, rows);
+
+    CsvTokenizer tokenizer;
+    tokenizer.setData(data);
+    CsvTokenizer::Row row;
+    for (int i = 0; i < rows.size(); ++i) {
+        QVERIFY(tokenizer.readRow(row));
+        QCOMPARE(row.number, qint64(i + 1));
+        QCOMPARE(rowFields(row).join('|'), rows[i]);
+    }
+    QVERIFY(!tokenizer.readRow(row));
+    QVERIFY(tokenizer.atEnd());
+
+    // skipRow 与 readRow 的行边界一致
+    CsvTokenizer skipper;
+    skipper.setData(data);
+    int skipped = 0;
+    while (skipper.skipRow()) {
+        ++skipped;
+    }
+    QCOMPARE(skipped, rows.size());
+}
+
+void UtilsTest::csvEscapedQuotes()
+{
+    const QByteArray data("\"a\"\"b\",\"plain\"\n");
+    CsvTokenizer tokenizer;
+    tokenizer.setData(data);
+    CsvTokenizer::Row row;
+    QVERIFY(tokenizer.readRow(row));
+    QCOMPARE(row.size(), 2);
+    QVERIFY(row[0].hasEscapedQuotes());
+    QCOMPARE(row[0].raw(), QByteArrayView("a\"\"b"));
+    QCOMPARE(row[0].toString(), QString("a\"b"));
+    QVERIFY(!row[1].hasEscapedQuotes());
+    QCOMPARE(row[1].raw(), QByteArrayView("plain"));
+
+    // 越界字段为空
+    QVERIFY(row[5].isEmpty());
+    QCOMPARE(row[5].toString(), QString());
+}
+
+void UtilsTest::csvBlankRowsAndNumbers()
+{
+    const QByteArray data("ring,thrust\n\n,,\n 12 , 3.5e2\nabc,\n");
+    CsvTokenizer tokenizer;
+    tokenizer.setData(data, 10);
+    CsvTokenizer::Row row;
+
+    QVERIFY(tokenizer.readRow(row));
+    QCOMPARE(row.number, qint64(10));
+    QVERIFY(!row.isBlank());
+
+    QVERIFY(tokenizer.readRow(row));
+    QCOMPARE(row.number, qint64(11));
+    QVERIFY(row.isBlank());
+
+    QVERIFY(tokenizer.readRow(row));
+    QCOMPARE(row.size(), 3);
+    QVERIFY(row.isBlank());
+
+    QVERIFY(tokenizer.readRow(row));
+    QCOMPARE(row.number, qint64(13));
+    bool ok = false;
+    QCOMPARE(row[0].toLongLong(&ok), qint64(12));
+    QVERIFY(ok);
+    QCOMPARE(row[1].toDouble(&ok), 350.0);
+    QVERIFY(ok);
+
+    QVERIFY(tokenizer.readRow(row));
+    QCOMPARE(row[0].toInt(&ok), 0);
+    QVERIFY(!ok);
+    QCOMPARE(row[1].toDouble(&ok), 0.0);
+    QVERIFY(!ok);
+
+    QVERIFY(!tokenizer.readRow(row));
+    QCOMPARE(tokenizer.nextRowNumber(), qint64(15));
+}
+
+void UtilsTest::csvOpenSkipsBom()
+{
+    const QString path = writeFile(dir, "bom.csv", QByteArray("\xEF\xBB\xBF序号,深度\n1,2.5\n"));
+    CsvTokenizer tokenizer;
+    QVERIFY2(tokenizer.open(path), qPrintable(tokenizer.errorString()));
+    QVERIFY(!tokenizer.data().startsWith("\xEF\xBB\xBF"));
+
+    CsvTokenizer::Row row;
+    QVERIFY(tokenizer.readRow(row));
+    QCOMPARE(rowFields(row), QStringList{ "序号", "深度" });
+    QVERIFY(tokenizer.readRow(row));
+    QCOMPARE(row[1].toDouble(), 2.5);
+    QVERIFY(!tokenizer.readRow(row));
+}
+
+void UtilsTest::csvAppendRowRoundTrip()
+{
+    const QByteArray data("plain,\"a,b\",\"q\"\"uote\",\"multi\nline\",\"cr\rinside\"\n");
+    CsvTokenizer tokenizer;
+    tokenizer.setData(data);
+    CsvTokenizer::Row row;
+    QVERIFY(tokenizer.readRow(row));
+    const QStringList expected = rowFields(row);
+    QCOMPARE(expected, QStringList{ "plain", "a,b", "q\"uote", "multi\nline", "cr\rinside" });
+
+    QByteArray written;
+    CsvTokenizer::appendRow(written, row);
+    QVERIFY(written.endsWith('\n'));
+
+    CsvTokenizer reparsed;
+    reparsed.setData(written);
+    CsvTokenizer::Row copy;
+    QVERIFY(reparsed.readRow(copy));
+    QCOMPARE(rowFields(copy), expected);
+    QVERIFY(!reparsed.readRow(copy));
+}
+
+void UtilsTest::bvhMatchesBruteForce()
+{
+    QRandomGenerator random(BVH_SEED);
+    PickingBvh bvh;
+    QVector<ReferenceTriangle> triangles;
+    QVector<ReferenceBox> boxes;
+
+    // 小三角形与小包围盒散布在 200m 见方的空间内，另加几块大三角形模拟地层面
+    for (int i = 0; i < BVH_TRIANGLE_COUNT; ++i) {
+        const QVector3D center = randomPoint(random, 100.0f);
+        const float size = (i < 10) ? 150.0f : 5.0f;
+        const ReferenceTriangle triangle = { center + randomPoint(random, size), center + randomPoint(random, size),
+                                             center + randomPoint(random, size), i };
+        triangles.append(triangle);
+        bvh.addTriangle(triangle.a, triangle.b, triangle.c, PickingBvh::Kind::Layer, i);
+    }
+    for (int i = 0; i < BVH_BOX_COUNT; ++i) {
+        const QVector3D center = randomPoint(random, 100.0f);
+        const QVector3D half(uniform(random, 0.2f, 4.0f), uniform(random, 0.2f, 4.0f), uniform(random, 0.2f, 4.0f));
+        const ReferenceBox box = { center - half, center + half, i };
+        boxes.append(box);
+        bvh.addBox(box.boxMin, box.boxMax, PickingBvh::Kind::Borehole, i);
+    }
+
+    QVERIFY(bvh.intersect(QVector3D(), QVector3D(1, 0, 0)).kind == PickingBvh::Kind::None);
+    bvh.build();
+    QCOMPARE(bvh.primitiveCount(), BVH_TRIANGLE_COUNT + BVH_BOX_COUNT);
+    QVERIFY(bvh.nodeCount() > 1);
+
+    int hits = 0;
+    for (int ray = 0; ray < BVH_RAY_COUNT; ++ray) {
+        // 射线指向场景内的随机点，保证多数射线有交点
+        const QVector3D origin = randomPoint(random, 150.0f);
+        const QVector3D direction = (randomPoint(random, 100.0f) - origin).normalized();
+        const float maxDistance = (ray % 4 == 0) ? uniform(random, 10.0f, 100.0f) : FLT_MAX;
+
+        PickingBvh::Kind expectedKind = PickingBvh::Kind::None;
+        int expectedId = -1;
+        float expectedDistance = maxDistance;
+        float distance = 0.0f;
+        for (const ReferenceTriangle &triangle : triangles) {
+            if (referenceTriangle(triangle, origin, direction, distance) && distance < expectedDistance) {
+                expectedKind = PickingBvh::Kind::Layer;
+                expectedId = triangle.id;
+                expectedDistance = distance;
+            }
+        }
+        for (const ReferenceBox &box : boxes) {
+            if (referenceBox(box, origin, direction, distance) && distance < expectedDistance) {
+                expectedKind = PickingBvh::Kind::Borehole;
+                expectedId = box.id;
+                expectedDistance = distance;
+            }
+        }
+
+        const PickingBvh::Hit hit = bvh.intersect(origin, direction, maxDistance);
+        const QByteArray context = QString("ray %1").arg(ray).toUtf8();
+        QVERIFY2((hit.kind == PickingBvh::Kind::None) == (expectedKind == PickingBvh::Kind::None), context);
+        if (expectedKind == PickingBvh::Kind::None) {
+            continue;
+        }
+        ++hits;
+
+        // 只比较距离：多个图元距离相同（共点、相交）时命中哪一个都可以
+        const float tolerance = BVH_DISTANCE_TOLERANCE * qMax(1.0f, expectedDistance);
+        QVERIFY2(std::abs(hit.distance - expectedDistance) <= tolerance, context);
+        if (std::abs(hit.distance - expectedDistance) > 1e-6f) {
+            QVERIFY2(hit.kind == expectedKind && hit.objectId == expectedId, context);
+        }
+        QVERIFY2((hit.point - (origin + direction * hit.distance)).length() <= tolerance, context);
+    }
+
+    // 随机射线大部分应命中，否则比对没有意义
+    QVERIFY(hits > BVH_RAY_COUNT / 4);
+}
+
+void UtilsTest::bvhAxisAlignedRay()
+{
+    // 竖直射线的方向分量为0，验证倒数取极大值时仍能命中水平地层面与钻孔
+    PickingBvh bvh;
+    bvh.addTriangle(QVector3D(-10, -10, -5), QVector3D(10, -10, -5), QVector3D(0, 10, -5), PickingBvh::Kind::Layer, 1);
+    bvh.addTriangle(QVector3D(-10, -10, -8), QVector3D(0, 10, -8), QVector3D(10, -10, -8), PickingBvh::Kind::Layer, 2);
+    bvh.addBox(QVector3D(4, -1, -20), QVector3D(6, 1, 0), PickingBvh::Kind::Borehole, 7);
+    bvh.build();
+
+    PickingBvh::Hit hit = bvh.intersect(QVector3D(0, 0, 10), QVector3D(0, 0, -1));
+    QVERIFY(hit.kind == PickingBvh::Kind::Layer);
+    QCOMPARE(hit.objectId, 1);
+    QCOMPARE(hit.distance, 15.0f);
+
+    // 反面同样命中
+    hit = bvh.intersect(QVector3D(0, 0, -20), QVector3D(0, 0, 1));
+    QVERIFY(hit.kind == PickingBvh::Kind::Layer);
+    QCOMPARE(hit.objectId, 2);
+    QCOMPARE(hit.distance, 12.0f);
+
+    hit = bvh.intersect(QVector3D(5, 0, 10), QVector3D(0, 0, -1));
+    QVERIFY(hit.kind == PickingBvh::Kind::Borehole);
+    QCOMPARE(hit.objectId, 7);
+    QCOMPARE(hit.distance, 10.0f);
+
+    // 起点在包围盒内时距离为0
+    hit = bvh.intersect(QVector3D(5, 0, -10), QVector3D(1, 0, 0));
+    QVERIFY(hit.kind == PickingBvh::Kind::Borehole);
+    QCOMPARE(hit.distance, 0.0f);
+
+    QVERIFY(bvh.intersect(QVector3D(0, 0, 10), QVector3D(0, 0, -1), 14.0f).kind == PickingBvh::Kind::None);
+    QVERIFY(bvh.intersect(QVector3D(50, 50, 10), QVector3D(0, 0, -1)).kind == PickingBvh::Kind::None);
+}
+
+QTEST_GUILESS_MAIN(UtilsTest)
+
+#include "utilstest.moc"